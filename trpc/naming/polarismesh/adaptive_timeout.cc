@@ -0,0 +1,83 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#include "trpc/naming/polarismesh/adaptive_timeout.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace trpc::naming::polarismesh {
+
+std::shared_ptr<AdaptiveTimeout::Method> AdaptiveTimeout::GetMethod(const std::string& key, bool create) {
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto iter = methods_.find(key);
+    if (iter != methods_.end() || !create) {
+      return iter != methods_.end() ? iter->second : nullptr;
+    }
+  }
+
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  auto& entry = methods_[key];
+  if (!entry) {
+    entry = std::make_shared<Method>(options_.window_ms);
+  }
+  return entry;
+}
+
+void AdaptiveTimeout::Record(const std::string& key, uint64_t cost_ms, uint64_t now_ms) {
+  GetMethod(key, true)->latencies.Add(cost_ms, now_ms);
+}
+
+uint64_t AdaptiveTimeout::GetTimeout(const std::string& key, uint64_t now_ms) {
+  auto entry = GetMethod(key, false);
+  if (!entry) {
+    return 0;
+  }
+
+  // Only the caller which moves the update time forward updates the timeout, the others keep the current one
+  uint64_t next_update_ms = entry->next_update_ms.load(std::memory_order_relaxed);
+  if (now_ms >= next_update_ms &&
+      entry->next_update_ms.compare_exchange_strong(next_update_ms, now_ms + options_.interval_ms,
+                                                    std::memory_order_relaxed)) {
+    double latency_ms = 0;
+    uint64_t timeout_ms = 0;
+    if (entry->latencies.GetQuantile(options_.quantile, now_ms, options_.min_samples, latency_ms)) {
+      timeout_ms = static_cast<uint64_t>(std::ceil(latency_ms * options_.multiplier));
+      timeout_ms = std::max<uint64_t>(1, std::clamp(timeout_ms, options_.min_timeout_ms,
+                                                    std::max(options_.min_timeout_ms, options_.max_timeout_ms)));
+    }
+    entry->timeout_ms.store(timeout_ms, std::memory_order_relaxed);
+  }
+  return entry->timeout_ms.load(std::memory_order_relaxed);
+}
+
+uint64_t AdaptiveTimeout::LimitTimeout(uint64_t static_timeout_ms, uint64_t adaptive_timeout_ms, int64_t remaining_ms) {
+  uint64_t timeout_ms = static_timeout_ms;
+  if (adaptive_timeout_ms > 0) {
+    timeout_ms = std::min(timeout_ms, adaptive_timeout_ms);
+  }
+  if (remaining_ms > 0) {
+    timeout_ms = std::min(timeout_ms, static_cast<uint64_t>(remaining_ms));
+  }
+  return timeout_ms;
+}
+
+void AdaptiveTimeout::Clear() {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  methods_.clear();
+}
+
+}  // namespace trpc::naming::polarismesh
@@ -0,0 +1,88 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include "trpc/naming/polarismesh/latency_sketch.h"
+
+namespace trpc::naming::polarismesh {
+
+/// @brief Timeout recommended by the latency of the calls. The latency quantile of every method of a callee is
+///        measured over a sliding window from the cost of its calls, and the recommended timeout is the quantile times
+///        a multiplier, clamped to a range.
+class AdaptiveTimeout {
+ public:
+  struct Options {
+    /// Quantile of the latencies the timeout is based on, in [0, 1]
+    double quantile{0.99};
+    /// Ratio of the timeout to the quantile
+    double multiplier{2.0};
+    /// Minimum timeout, in ms
+    uint64_t min_timeout_ms{10};
+    /// Maximum timeout, in ms
+    uint64_t max_timeout_ms{10000};
+    /// Window of the latency samples, in ms
+    uint64_t window_ms{60000};
+    /// Number of samples in the window needed to recommend a timeout
+    uint32_t min_samples{100};
+    /// Interval of updating the timeout of a method, in ms
+    uint64_t interval_ms{1000};
+  };
+
+  void SetOptions(const Options& options) { options_ = options; }
+
+  const Options& GetOptions() const { return options_; }
+
+  /// @brief Record the cost of a call
+  /// @param key Method of the callee of the call
+  void Record(const std::string& key, uint64_t cost_ms, uint64_t now_ms);
+
+  /// @brief Get the recommended timeout of the calls of key, it is updated first if it is due
+  /// @return uint64_t The timeout in ms, 0 if there are too few samples
+  uint64_t GetTimeout(const std::string& key, uint64_t now_ms);
+
+  /// @brief Get the timeout a call runs with, the adaptive timeout only ever shortens the static one
+  /// @param static_timeout_ms Timeout of the call set by the caller, in ms
+  /// @param adaptive_timeout_ms Recommended timeout, 0 if there is none
+  /// @param remaining_ms Remaining time before the deadline of the call, ignored if it is not positive
+  /// @return uint64_t The smallest of the three timeouts, in ms
+  static uint64_t LimitTimeout(uint64_t static_timeout_ms, uint64_t adaptive_timeout_ms, int64_t remaining_ms);
+
+  void Clear();
+
+ private:
+  struct Method {
+    explicit Method(uint64_t window_ms) : latencies(window_ms) {}
+
+    WindowedLatencySketch latencies;
+    std::atomic<uint64_t> timeout_ms{0};
+    std::atomic<uint64_t> next_update_ms{0};
+  };
+
+  std::shared_ptr<Method> GetMethod(const std::string& key, bool create);
+
+ private:
+  Options options_;
+  std::shared_mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<Method>> methods_;
+};
+
+}  // namespace trpc::naming::polarismesh
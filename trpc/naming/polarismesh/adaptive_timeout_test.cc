@@ -0,0 +1,95 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#include "trpc/naming/polarismesh/adaptive_timeout.h"
+
+#include "gtest/gtest.h"
+
+namespace trpc::naming::polarismesh::testing {
+
+AdaptiveTimeout::Options MakeOptions() {
+  AdaptiveTimeout::Options options;
+  options.quantile = 0.9;
+  options.multiplier = 2.0;
+  options.min_timeout_ms = 50;
+  options.max_timeout_ms = 1000;
+  options.window_ms = 10000;
+  options.min_samples = 10;
+  options.interval_ms = 1000;
+  return options;
+}
+
+TEST(AdaptiveTimeoutTest, QuantileTimesMultiplier) {
+  AdaptiveTimeout timeout;
+  timeout.SetOptions(MakeOptions());
+  ASSERT_EQ(0, timeout.GetTimeout("service|method", 1000));
+
+  // Too few samples
+  for (int i = 0; i < 5; ++i) {
+    timeout.Record("service|method", 100, 1000);
+  }
+  ASSERT_EQ(0, timeout.GetTimeout("service|method", 1000));
+
+  // Updated after the interval, 95% of the calls answer in 100ms
+  for (int i = 0; i < 90; ++i) {
+    timeout.Record("service|method", 100, 1000);
+  }
+  for (int i = 0; i < 5; ++i) {
+    timeout.Record("service|method", 900, 1000);
+  }
+  ASSERT_EQ(0, timeout.GetTimeout("service|method", 1500));
+  uint64_t timeout_ms = timeout.GetTimeout("service|method", 2000);
+  ASSERT_GE(timeout_ms, 190);
+  ASSERT_LE(timeout_ms, 210);
+  ASSERT_EQ(0, timeout.GetTimeout("service|other", 2000));
+
+  // The samples leave the window
+  ASSERT_EQ(0, timeout.GetTimeout("service|method", 30000));
+
+  timeout.Clear();
+  ASSERT_EQ(0, timeout.GetTimeout("service|method", 30000));
+}
+
+TEST(AdaptiveTimeoutTest, Clamped) {
+  AdaptiveTimeout timeout;
+  timeout.SetOptions(MakeOptions());
+  for (int i = 0; i < 20; ++i) {
+    timeout.Record("fast", 1, 1000);
+    timeout.Record("slow", 5000, 1000);
+  }
+  ASSERT_EQ(50, timeout.GetTimeout("fast", 1000));
+  ASSERT_EQ(1000, timeout.GetTimeout("slow", 1000));
+}
+
+TEST(AdaptiveTimeoutTest, NeverRaisesTimeout) {
+  // The adaptive timeout shortens the static one
+  ASSERT_EQ(200, AdaptiveTimeout::LimitTimeout(1000, 200, 1000));
+  // It never raises it
+  ASSERT_EQ(100, AdaptiveTimeout::LimitTimeout(100, 200, 1000));
+  ASSERT_EQ(100, AdaptiveTimeout::LimitTimeout(100, 0, 1000));
+  // Nor goes past the deadline of the call
+  ASSERT_EQ(50, AdaptiveTimeout::LimitTimeout(1000, 200, 50));
+  ASSERT_EQ(200, AdaptiveTimeout::LimitTimeout(1000, 200, 0));
+
+  AdaptiveTimeout timeout;
+  timeout.SetOptions(MakeOptions());
+  for (int i = 0; i < 10; ++i) {
+    timeout.Record("service|method", 400, 1000);
+  }
+  uint64_t adaptive_timeout_ms = timeout.GetTimeout("service|method", 1000);
+  ASSERT_GT(adaptive_timeout_ms, 300);
+  ASSERT_EQ(300, AdaptiveTimeout::LimitTimeout(300, adaptive_timeout_ms, 300));
+}
+
+}  // namespace trpc::naming::polarismesh::testing
@@ -0,0 +1,285 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#include "trpc/naming/polarismesh/circuit_breaker.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "trpc/naming/polarismesh/snapshot_cache.h"
+
+namespace trpc::naming::polarismesh {
+
+CircuitBreaker::CircuitBreaker(const CircuitBreakerOptions& options)
+    : options_(options),
+      window_(options.window_ms, options.bucket_num),
+      slow_window_(options.window_ms, options.slow_call_ms > 0 ? options.bucket_num : 1) {}
+
+BreakerState CircuitBreaker::UpdateState(uint64_t now_ms) {
+  BreakerState state = state_.load(std::memory_order_acquire);
+  if (state == BreakerState::kOpen && now_ms >= open_until_ms_.load(std::memory_order_acquire)) {
+    if (state_.compare_exchange_strong(state, BreakerState::kHalfOpen, std::memory_order_acq_rel)) {
+      half_open_successes_.store(0, std::memory_order_relaxed);
+      half_open_probes_.store(0, std::memory_order_relaxed);
+      return BreakerState::kHalfOpen;
+    }
+  }
+  return state;
+}
+
+BreakerState CircuitBreaker::GetState(uint64_t now_ms) {
+  BreakerState state = UpdateState(now_ms);
+  if (state != BreakerState::kHalfOpen) {
+    return state;
+  }
+
+  uint32_t max_probes = std::max<uint32_t>(1, options_.success_to_close);
+  if (half_open_probes_.load(std::memory_order_relaxed) < max_probes) {
+    return BreakerState::kHalfOpen;
+  }
+  // The results of the probes were not reported within a sleep window, they are given back
+  uint64_t since_ms = probe_since_ms_.load(std::memory_order_relaxed);
+  if (now_ms >= since_ms + options_.sleep_window_ms &&
+      probe_since_ms_.compare_exchange_strong(since_ms, now_ms, std::memory_order_relaxed)) {
+    half_open_probes_.store(0, std::memory_order_relaxed);
+    return BreakerState::kHalfOpen;
+  }
+  return BreakerState::kOpen;
+}
+
+bool CircuitBreaker::Acquire(uint64_t now_ms) {
+  if (GetState(now_ms) != BreakerState::kHalfOpen) {
+    return false;
+  }
+
+  uint32_t max_probes = std::max<uint32_t>(1, options_.success_to_close);
+  uint32_t probes = half_open_probes_.load(std::memory_order_relaxed);
+  while (probes < max_probes) {
+    if (half_open_probes_.compare_exchange_weak(probes, probes + 1, std::memory_order_relaxed)) {
+      if (probes == 0) {
+        probe_since_ms_.store(now_ms, std::memory_order_relaxed);
+      }
+      return probes + 1 == max_probes;
+    }
+  }
+  return false;
+}
+
+bool CircuitBreaker::Open(BreakerState from, uint64_t now_ms) {
+  // Stored first, a reader seeing the breaker open must not find the sleep window of a previous opening
+  open_until_ms_.store(now_ms + options_.sleep_window_ms, std::memory_order_release);
+  return state_.compare_exchange_strong(from, BreakerState::kOpen, std::memory_order_acq_rel);
+}
+
+bool CircuitBreaker::Report(bool success, uint64_t latency_ms, uint64_t now_ms) {
+  bool slow = options_.slow_call_ms > 0 && latency_ms > options_.slow_call_ms;
+  // The probes of a half-open breaker are counted even while it is open for the other calls
+  switch (UpdateState(now_ms)) {
+    case BreakerState::kClosed: {
+      uint64_t min_requests = std::max<uint32_t>(1, options_.min_requests);
+      window_.Add(success, now_ms);
+      if (!success) {
+        auto counts = window_.Get(now_ms);
+        if (counts.Total() >= min_requests && counts.failure * 100 >= counts.Total() * options_.error_rate_percent) {
+          return Open(BreakerState::kClosed, now_ms);
+        }
+      }
+      if (options_.slow_call_ms > 0) {
+        slow_window_.Add(!slow, now_ms);
+        if (slow) {
+          auto counts = slow_window_.Get(now_ms);
+          if (counts.Total() >= min_requests && counts.failure * 100 >= counts.Total() * options_.slow_rate_percent) {
+            return Open(BreakerState::kClosed, now_ms);
+          }
+        }
+      }
+      return false;
+    }
+    case BreakerState::kOpen:
+      // A call selected before the breaker opened
+      return false;
+    case BreakerState::kHalfOpen: {
+      if (!success || slow) {
+        return Open(BreakerState::kHalfOpen, now_ms);
+      }
+      if (half_open_successes_.fetch_add(1, std::memory_order_relaxed) + 1 >= options_.success_to_close) {
+        BreakerState expected = BreakerState::kHalfOpen;
+        if (state_.compare_exchange_strong(expected, BreakerState::kClosed, std::memory_order_acq_rel)) {
+          window_.Reset();
+          slow_window_.Reset();
+          return true;
+        }
+      }
+      return ReleaseProbe();
+    }
+  }
+  return false;
+}
+
+bool CircuitBreaker::ReleaseProbe() {
+  uint32_t max_probes = std::max<uint32_t>(1, options_.success_to_close);
+  uint32_t probes = half_open_probes_.load(std::memory_order_relaxed);
+  while (probes > 0) {
+    if (half_open_probes_.compare_exchange_weak(probes, probes - 1, std::memory_order_relaxed)) {
+      return probes == max_probes;
+    }
+  }
+  return false;
+}
+
+bool CircuitBreaker::IsIdle(uint64_t now_ms) const {
+  return state_.load(std::memory_order_acquire) == BreakerState::kClosed && window_.Get(now_ms).Total() == 0;
+}
+
+std::shared_ptr<CircuitBreakerGroups::Group> CircuitBreakerGroups::GetGroup(const std::string& group, bool create) {
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto iter = groups_.find(group);
+    if (iter != groups_.end() || !create) {
+      return iter != groups_.end() ? iter->second : nullptr;
+    }
+  }
+
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  auto& entry = groups_[group];
+  if (!entry) {
+    entry = std::make_shared<Group>();
+  }
+  return entry;
+}
+
+void CircuitBreakerGroups::Report(const std::string& group, const std::string& member, bool success,
+                                  uint64_t latency_ms, uint64_t now_ms) {
+  auto entry = GetGroup(group, true);
+  std::shared_lock<std::shared_mutex> lock(entry->mutex);
+  auto iter = entry->breakers.find(member);
+  if (iter == entry->breakers.end()) {
+    lock.unlock();
+    {
+      std::unique_lock<std::shared_mutex> unique_lock(entry->mutex);
+      auto& breaker = entry->breakers[member];
+      if (!breaker) {
+        breaker = std::make_unique<CircuitBreaker>(options_);
+      }
+    }
+    lock.lock();
+    iter = entry->breakers.find(member);
+    if (iter == entry->breakers.end()) {
+      return;
+    }
+  }
+
+  if (iter->second->Report(success, latency_ms, now_ms)) {
+    entry->version.fetch_add(1, std::memory_order_release);
+  }
+}
+
+BreakerState CircuitBreakerGroups::GetState(const std::string& group, const std::string& member, uint64_t now_ms) {
+  auto entry = GetGroup(group, false);
+  if (!entry) {
+    return BreakerState::kClosed;
+  }
+  std::shared_lock<std::shared_mutex> lock(entry->mutex);
+  auto iter = entry->breakers.find(member);
+  return iter != entry->breakers.end() ? iter->second->GetState(now_ms) : BreakerState::kClosed;
+}
+
+void CircuitBreakerGroups::Acquire(const std::string& group, const std::string& member, uint64_t now_ms) {
+  auto entry = GetGroup(group, false);
+  if (!entry) {
+    return;
+  }
+  std::shared_lock<std::shared_mutex> lock(entry->mutex);
+  auto iter = entry->breakers.find(member);
+  if (iter != entry->breakers.end() && iter->second->Acquire(now_ms)) {
+    entry->version.fetch_add(1, std::memory_order_release);
+  }
+}
+
+OpenBreakersPtr CircuitBreakerGroups::GetOpenBreakers(const std::string& group, uint64_t now_ms) {
+  auto entry = GetGroup(group, false);
+  if (!entry) {
+    return nullptr;
+  }
+
+  uint64_t version = entry->version.load(std::memory_order_acquire);
+  auto open = std::atomic_load(&entry->open);
+  if (open && entry->open_version.load(std::memory_order_acquire) == version && now_ms < open->expire_ms) {
+    return open->members.empty() ? nullptr : open;
+  }
+
+  // Rebuilt when a breaker opened or closed, when one turns half-open and at least once per window, which also
+  // forgets the breakers of the members no longer called
+  std::vector<std::string> members;
+  std::vector<std::string> idle;
+  uint64_t expire_ms = now_ms + std::max<uint64_t>(1, options_.window_ms);
+  {
+    std::shared_lock<std::shared_mutex> lock(entry->mutex);
+    for (auto& [member, breaker] : entry->breakers) {
+      BreakerState state = breaker->GetState(now_ms);
+      if (state == BreakerState::kOpen) {
+        members.push_back(member);
+        // A half-open breaker whose probes are in flight changes with the version
+        if (breaker->GetOpenUntilMs() > now_ms) {
+          expire_ms = std::min(expire_ms, breaker->GetOpenUntilMs());
+        }
+      } else if (breaker->IsIdle(now_ms)) {
+        idle.push_back(member);
+      }
+    }
+  }
+  if (!idle.empty()) {
+    std::unique_lock<std::shared_mutex> lock(entry->mutex);
+    for (const auto& member : idle) {
+      auto iter = entry->breakers.find(member);
+      if (iter != entry->breakers.end() && iter->second->IsIdle(now_ms)) {
+        entry->breakers.erase(iter);
+      }
+    }
+  }
+
+  std::sort(members.begin(), members.end());
+  SignatureHasher hasher;
+  for (const auto& member : members) {
+    hasher.Add(member);
+  }
+  auto result = std::make_shared<OpenBreakers>();
+  result->members.insert(members.begin(), members.end());
+  result->revision = hasher.Get();
+  result->expire_ms = expire_ms;
+  std::atomic_store(&entry->open, OpenBreakersPtr(result));
+  entry->open_version.store(version, std::memory_order_release);
+  return members.empty() ? nullptr : result;
+}
+
+std::vector<std::string> CircuitBreakerGroups::GetMembers(const std::string& group) {
+  std::vector<std::string> members;
+  auto entry = GetGroup(group, false);
+  if (!entry) {
+    return members;
+  }
+  std::shared_lock<std::shared_mutex> lock(entry->mutex);
+  members.reserve(entry->breakers.size());
+  for (const auto& item : entry->breakers) {
+    members.push_back(item.first);
+  }
+  return members;
+}
+
+void CircuitBreakerGroups::Clear() {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  groups_.clear();
+}
+
+}  // namespace trpc::naming::polarismesh
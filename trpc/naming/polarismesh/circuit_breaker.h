@@ -0,0 +1,167 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "trpc/naming/polarismesh/sliding_window.h"
+
+namespace trpc::naming::polarismesh {
+
+/// @brief States of a circuit breaker
+enum class BreakerState : uint8_t {
+  /// The calls pass, their results are counted
+  kClosed,
+  /// The calls are cut off until the sleep window ends
+  kOpen,
+  /// Probe calls pass again, the breaker closes after enough successes and opens again on the first failure. The
+  /// calls beyond the probes in flight see the breaker open
+  kHalfOpen,
+};
+
+struct CircuitBreakerOptions {
+  /// Window of the results, in ms
+  uint64_t window_ms{10000};
+  /// Number of buckets of the window
+  uint32_t bucket_num{10};
+  /// Number of calls in the window needed to open the breaker
+  uint32_t min_requests{10};
+  /// Error rate opening the breaker, in percent
+  uint32_t error_rate_percent{50};
+  /// A call taking longer is slow, in ms. 0 means the latency is not checked
+  uint64_t slow_call_ms{0};
+  /// Rate of the slow calls opening the breaker, in percent
+  uint32_t slow_rate_percent{50};
+  /// Time the breaker stays open before the calls are let through again, in ms
+  uint64_t sleep_window_ms{30000};
+  /// Number of successes closing a half-open breaker, also the number of probe calls in flight it lets through
+  uint32_t success_to_close{3};
+};
+
+/// @brief Circuit breaker over a sliding window of call results. It opens when the error rate or the slow call rate of
+///        the window reaches its threshold, stays open for the sleep window, then lets the calls through half-open
+///        until enough successes close it or a failure opens it again. A half-open breaker lets through at most
+///        success_to_close probes in flight, the probes whose result is never reported are given back after a sleep
+///        window. The operations take no lock, the counts of the window are approximate: the results added while a
+///        bucket is being recycled may be lost.
+class CircuitBreaker {
+ public:
+  explicit CircuitBreaker(const CircuitBreakerOptions& options);
+
+  /// @brief Record the result of a call, a slow success counts as a failure in half-open state
+  /// @return bool Whether the breaker opened or closed, or gave back the last probe of its half-open state
+  bool Report(bool success, uint64_t latency_ms, uint64_t now_ms);
+
+  /// @brief State at now_ms, an open breaker whose sleep window ended turns half-open. A half-open breaker whose
+  ///        probes are all in flight is open for the calls
+  BreakerState GetState(uint64_t now_ms);
+
+  /// @brief A call was selected on the breaker, it takes a probe if the breaker is half-open
+  /// @return bool Whether the call took the last probe, the breaker is then open for the other calls
+  bool Acquire(uint64_t now_ms);
+
+  /// @brief Time when the sleep window of the open breaker ends, in ms
+  uint64_t GetOpenUntilMs() const { return open_until_ms_.load(std::memory_order_acquire); }
+
+  /// @brief Whether the breaker is closed and no call is counted in the window of now_ms
+  bool IsIdle(uint64_t now_ms) const;
+
+ private:
+  // State at now_ms whatever the probes in flight, an open breaker whose sleep window ended turns half-open
+  BreakerState UpdateState(uint64_t now_ms);
+
+  bool Open(BreakerState from, uint64_t now_ms);
+
+  // Give a probe of the half-open state back, returns whether all of them were in flight
+  bool ReleaseProbe();
+
+ private:
+  const CircuitBreakerOptions options_;
+  SlidingWindow window_;
+  // Successes are the calls within the latency threshold, failures the slow ones
+  SlidingWindow slow_window_;
+  std::atomic<BreakerState> state_{BreakerState::kClosed};
+  std::atomic<uint64_t> open_until_ms_{0};
+  std::atomic<uint32_t> half_open_successes_{0};
+  // Probes in flight of the half-open state and the time when the first of them was taken
+  std::atomic<uint32_t> half_open_probes_{0};
+  std::atomic<uint64_t> probe_since_ms_{0};
+};
+
+/// @brief Members of a group whose breaker is open
+struct OpenBreakers {
+  std::unordered_set<std::string> members;
+  /// Signature of the members, the same set has the same revision
+  uint64_t revision{0};
+  /// Time when the first of the breakers turns half-open, in ms
+  uint64_t expire_ms{0};
+};
+
+using OpenBreakersPtr = std::shared_ptr<const OpenBreakers>;
+
+/// @brief Circuit breakers of the members of groups, such as the endpoints of a method of a callee. Finding the breaker
+///        of a member takes a shared lock of the groups and of its group, an exclusive one only when it is created.
+///        The open members of a group are kept until a breaker of the group opens or closes.
+class CircuitBreakerGroups {
+ public:
+  void SetOptions(const CircuitBreakerOptions& options) { options_ = options; }
+
+  const CircuitBreakerOptions& GetOptions() const { return options_; }
+
+  /// @brief Record the result of a call of a member
+  void Report(const std::string& group, const std::string& member, bool success, uint64_t latency_ms, uint64_t now_ms);
+
+  /// @brief State of the breaker of a member at now_ms, closed if unknown
+  BreakerState GetState(const std::string& group, const std::string& member, uint64_t now_ms);
+
+  /// @brief A call was selected on a member, it takes a probe of its breaker if half-open
+  void Acquire(const std::string& group, const std::string& member, uint64_t now_ms);
+
+  /// @brief Get the members of group whose breaker is open at now_ms, or half-open with all its probes in flight
+  /// @return OpenBreakersPtr nullptr if none is open
+  OpenBreakersPtr GetOpenBreakers(const std::string& group, uint64_t now_ms);
+
+  /// @brief Members of group having a breaker, the members without calls are forgotten after a window
+  std::vector<std::string> GetMembers(const std::string& group);
+
+  void Clear();
+
+ private:
+  struct Group {
+    std::shared_mutex mutex;
+    std::unordered_map<std::string, std::unique_ptr<CircuitBreaker>> breakers;
+    // Bumped whenever a breaker opens or closes, and whenever its half-open probes are used up or given back
+    std::atomic<uint64_t> version{0};
+    // Open breakers built from the version, read and written with atomic_load and atomic_store
+    OpenBreakersPtr open;
+    std::atomic<uint64_t> open_version{0};
+  };
+
+  std::shared_ptr<Group> GetGroup(const std::string& group, bool create);
+
+ private:
+  CircuitBreakerOptions options_;
+  std::shared_mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<Group>> groups_;
+};
+
+}  // namespace trpc::naming::polarismesh
@@ -0,0 +1,124 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#include "trpc/naming/polarismesh/circuit_breaker.h"
+
+#include "gtest/gtest.h"
+
+namespace trpc::naming::polarismesh::testing {
+
+TEST(CircuitBreakerTest, ErrorRate) {
+  CircuitBreakerOptions options;
+  options.min_requests = 4;
+  options.error_rate_percent = 50;
+  options.sleep_window_ms = 1000;
+  options.success_to_close = 1;
+  CircuitBreaker breaker(options);
+
+  ASSERT_FALSE(breaker.Report(true, 10, 0));
+  ASSERT_FALSE(breaker.Report(false, 10, 0));
+  ASSERT_FALSE(breaker.Report(true, 10, 0));
+  ASSERT_TRUE(breaker.Report(false, 10, 0));
+  ASSERT_EQ(BreakerState::kOpen, breaker.GetState(500));
+  ASSERT_EQ(1000, breaker.GetOpenUntilMs());
+  ASSERT_FALSE(breaker.IsIdle(500));
+
+  ASSERT_EQ(BreakerState::kHalfOpen, breaker.GetState(1000));
+  ASSERT_TRUE(breaker.Report(true, 10, 1000));
+  ASSERT_EQ(BreakerState::kClosed, breaker.GetState(1000));
+  // The window starts over once closed
+  ASSERT_TRUE(breaker.IsIdle(1000));
+}
+
+TEST(CircuitBreakerTest, SlowCalls) {
+  CircuitBreakerOptions options;
+  options.min_requests = 4;
+  options.slow_call_ms = 100;
+  options.slow_rate_percent = 50;
+  options.sleep_window_ms = 1000;
+  CircuitBreaker breaker(options);
+
+  ASSERT_FALSE(breaker.Report(true, 10, 0));
+  ASSERT_FALSE(breaker.Report(true, 500, 0));
+  ASSERT_FALSE(breaker.Report(true, 10, 0));
+  ASSERT_TRUE(breaker.Report(true, 500, 0));
+  ASSERT_EQ(BreakerState::kOpen, breaker.GetState(0));
+
+  // A slow call opens the half-open breaker again
+  ASSERT_EQ(BreakerState::kHalfOpen, breaker.GetState(1000));
+  ASSERT_TRUE(breaker.Report(true, 500, 1000));
+  ASSERT_EQ(BreakerState::kOpen, breaker.GetState(1000));
+}
+
+TEST(CircuitBreakerTest, BoundedProbes) {
+  CircuitBreakerOptions options;
+  options.min_requests = 1;
+  options.sleep_window_ms = 1000;
+  options.success_to_close = 2;
+  CircuitBreaker breaker(options);
+
+  ASSERT_TRUE(breaker.Report(false, 10, 0));
+  ASSERT_EQ(BreakerState::kHalfOpen, breaker.GetState(1000));
+  ASSERT_FALSE(breaker.Acquire(1000));
+  ASSERT_TRUE(breaker.Acquire(1000));
+  // The other calls wait for the results of the probes
+  ASSERT_EQ(BreakerState::kOpen, breaker.GetState(1000));
+  ASSERT_FALSE(breaker.Acquire(1000));
+
+  // A probe gives its place back to another one
+  ASSERT_TRUE(breaker.Report(true, 10, 1100));
+  ASSERT_EQ(BreakerState::kHalfOpen, breaker.GetState(1100));
+  ASSERT_TRUE(breaker.Acquire(1100));
+  ASSERT_TRUE(breaker.Report(true, 10, 1200));
+  ASSERT_EQ(BreakerState::kClosed, breaker.GetState(1200));
+}
+
+TEST(CircuitBreakerTest, LostProbes) {
+  CircuitBreakerOptions options;
+  options.min_requests = 1;
+  options.sleep_window_ms = 1000;
+  options.success_to_close = 1;
+  CircuitBreaker breaker(options);
+
+  ASSERT_TRUE(breaker.Report(false, 10, 0));
+  ASSERT_TRUE(breaker.Acquire(1000));
+  ASSERT_EQ(BreakerState::kOpen, breaker.GetState(1500));
+  // The result of the probe was never reported, another one is let through after a sleep window
+  ASSERT_EQ(BreakerState::kHalfOpen, breaker.GetState(2000));
+  ASSERT_TRUE(breaker.Acquire(2000));
+}
+
+TEST(CircuitBreakerGroupsTest, HalfOpenProbesInFlight) {
+  CircuitBreakerOptions options;
+  options.min_requests = 1;
+  options.sleep_window_ms = 1000;
+  options.success_to_close = 1;
+  CircuitBreakerGroups groups;
+  groups.SetOptions(options);
+
+  groups.Report("svc", "a", false, 10, 0);
+  ASSERT_NE(nullptr, groups.GetOpenBreakers("svc", 0));
+  ASSERT_EQ(nullptr, groups.GetOpenBreakers("svc", 1000));
+
+  groups.Acquire("svc", "a", 1000);
+  auto open = groups.GetOpenBreakers("svc", 1000);
+  ASSERT_NE(nullptr, open);
+  ASSERT_EQ(1, open->members.count("a"));
+
+  groups.Report("svc", "a", true, 10, 1100);
+  ASSERT_EQ(nullptr, groups.GetOpenBreakers("svc", 1100));
+  ASSERT_EQ(BreakerState::kClosed, groups.GetState("svc", "a", 1100));
+}
+
+}  // namespace trpc::naming::polarismesh::testing
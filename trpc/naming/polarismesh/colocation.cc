@@ -0,0 +1,76 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#include "trpc/naming/polarismesh/colocation.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace trpc::naming::polarismesh {
+
+ColocationTable::ColocationTable(RoutedSnapshotPtr snapshot, const ColocationOptions& options)
+    : snapshot_(std::move(snapshot)) {
+  auto local = std::make_shared<RoutedSnapshot>();
+  for (size_t i = 0; i < snapshot_->endpoints.size(); i++) {
+    const auto& endpoint = snapshot_->endpoints[i];
+    if (!endpoint.status || !IsColocated(endpoint, options)) {
+      continue;
+    }
+
+    local->endpoints.push_back(endpoint);
+    if (snapshot_->locations.size() == snapshot_->endpoints.size()) {
+      local->locations.push_back(snapshot_->locations[i]);
+    }
+    auto iter = endpoint.meta.find(kColocationUdsPathKey);
+    if (options.use_uds && iter != endpoint.meta.end() && !iter->second.empty()) {
+      auto& uds_endpoint = local->endpoints.back();
+      uds_endpoint.host = iter->second;
+      uds_endpoint.port = 0;
+      uds_endpoint.is_ipv6 = false;
+    }
+  }
+  if (local->endpoints.empty()) {
+    return;
+  }
+
+  local->revision = CalculateEndpointsRevision(local->endpoints);
+  local->update_time_ms = snapshot_->update_time_ms;
+  local->source_version = snapshot_->source_version;
+  local_ = std::move(local);
+  local_threshold_ = (static_cast<uint64_t>(std::min<uint32_t>(options.max_local_percent, 100)) << 32) / 100;
+}
+
+bool ColocationTable::IsColocated(const TrpcEndpointInfo& endpoint, const ColocationOptions& options) {
+  if (!options.local_host_id.empty()) {
+    auto iter = endpoint.meta.find(kColocationHostIdKey);
+    if (iter != endpoint.meta.end()) {
+      return iter->second == options.local_host_id;
+    }
+  }
+  return !options.local_host.empty() && endpoint.host == options.local_host;
+}
+
+RoutedSnapshotPtr ColocationTable::Pick(uint64_t random) const {
+  if (!local_ || (random & 0xFFFFFFFFULL) >= local_threshold_) {
+    return nullptr;
+  }
+  return local_;
+}
+
+ColocationTablePtr ColocationCache::Get(const std::string& key, const RoutedSnapshotPtr& snapshot) {
+  return tables_.Get(key, snapshot, [this](const RoutedSnapshotPtr& snapshot) {
+    return std::make_shared<const ColocationTable>(snapshot, options_);
+  });
+}
+
+}  // namespace trpc::naming::polarismesh
@@ -0,0 +1,86 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "trpc/naming/polarismesh/snapshot_cache.h"
+
+namespace trpc::naming::polarismesh {
+
+/// Instance metadata published by the registry: identity of the host of the instance
+constexpr char kColocationHostIdKey[] = "trpc_host_id";
+/// Instance metadata published by the registry: path of the unix domain socket the instance listens on
+constexpr char kColocationUdsPathKey[] = "trpc_uds_path";
+
+struct ColocationOptions {
+  /// Address of the local host, the endpoints listening on it are co-located
+  std::string local_host;
+  /// Identity of the local host, the endpoints published with it are co-located. Empty means only the address counts
+  std::string local_host_id;
+  /// Maximum percentage of the calls kept on the co-located endpoints, the others are balanced as usual
+  uint32_t max_local_percent{100};
+  /// Whether a co-located endpoint publishing a unix domain socket is returned as that socket: the path as the host
+  /// and 0 as the port
+  bool use_uds{false};
+};
+
+/// @brief The co-located endpoints of a snapshot, the healthy endpoints on the local host, built once per snapshot
+///        revision
+class ColocationTable {
+ public:
+  ColocationTable(RoutedSnapshotPtr snapshot, const ColocationOptions& options);
+
+  /// @brief Whether the endpoint runs on the local host
+  static bool IsColocated(const TrpcEndpointInfo& endpoint, const ColocationOptions& options);
+
+  /// @brief Pick the co-located endpoints for a call
+  /// @param random Uniformly distributed random number, which decides whether the call is kept local
+  /// @return RoutedSnapshotPtr The co-located endpoints, nullptr if there are none or the call is not kept local
+  RoutedSnapshotPtr Pick(uint64_t random) const;
+
+  /// @brief The co-located endpoints, nullptr if none
+  const RoutedSnapshotPtr& GetLocal() const { return local_; }
+
+  /// @brief The snapshot the table is built from
+  const RoutedSnapshotPtr& GetSnapshot() const { return snapshot_; }
+
+ private:
+  RoutedSnapshotPtr snapshot_;
+  RoutedSnapshotPtr local_;
+  // Probability to keep a call local, scaled to 2^32
+  uint64_t local_threshold_{0};
+};
+
+using ColocationTablePtr = std::shared_ptr<const ColocationTable>;
+
+/// @brief Keeps the co-location table of every selection key, it is rebuilt only when the snapshot revision changes
+class ColocationCache {
+ public:
+  void SetOptions(const ColocationOptions& options) { options_ = options; }
+
+  const ColocationOptions& GetOptions() const { return options_; }
+
+  /// @brief Get the table of the snapshot of key, build it if absent or built from another revision
+  ColocationTablePtr Get(const std::string& key, const RoutedSnapshotPtr& snapshot);
+
+  void Clear() { tables_.Clear(); }
+
+ private:
+  ColocationOptions options_;
+  SnapshotTableCache<ColocationTable> tables_;
+};
+
+}  // namespace trpc::naming::polarismesh
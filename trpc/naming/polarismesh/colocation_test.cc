@@ -0,0 +1,93 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#include "trpc/naming/polarismesh/colocation.h"
+
+#include <map>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace trpc::naming::polarismesh::testing {
+
+namespace {
+
+TrpcEndpointInfo MakeEndpoint(const std::string& host, int port, bool healthy,
+                              const std::map<std::string, std::string>& meta = {}) {
+  TrpcEndpointInfo endpoint;
+  endpoint.host = host;
+  endpoint.port = port;
+  endpoint.weight = 100;
+  endpoint.status = healthy ? 1 : 0;
+  endpoint.meta = meta;
+  return endpoint;
+}
+
+RoutedSnapshotPtr MakeSnapshot(std::vector<TrpcEndpointInfo> endpoints) {
+  auto snapshot = std::make_shared<RoutedSnapshot>();
+  snapshot->endpoints = std::move(endpoints);
+  snapshot->revision = CalculateEndpointsRevision(snapshot->endpoints);
+  return snapshot;
+}
+
+}  // namespace
+
+TEST(ColocationTableTest, ColocatedEndpoints) {
+  ColocationOptions options;
+  options.local_host = "10.0.0.1";
+  options.local_host_id = "host-1";
+  options.use_uds = true;
+  auto snapshot = MakeSnapshot({
+      MakeEndpoint("10.0.0.1", 8000, true, {{kColocationUdsPathKey, "/tmp/callee.sock"}}),
+      // Unhealthy
+      MakeEndpoint("10.0.0.1", 8001, false),
+      // Another address of the same host, as published by the registry
+      MakeEndpoint("192.168.0.1", 8000, true, {{kColocationHostIdKey, "host-1"}}),
+      // The host identity wins over the address
+      MakeEndpoint("10.0.0.1", 8002, true, {{kColocationHostIdKey, "host-2"}}),
+      MakeEndpoint("10.0.0.2", 8000, true),
+  });
+
+  ColocationTable table(snapshot, options);
+  const auto& local = table.GetLocal();
+  ASSERT_EQ(2, local->endpoints.size());
+  // Returned as the unix domain socket
+  ASSERT_EQ("/tmp/callee.sock", local->endpoints[0].host);
+  ASSERT_EQ(0, local->endpoints[0].port);
+  ASSERT_EQ("192.168.0.1", local->endpoints[1].host);
+  ASSERT_EQ(local, table.Pick(0xFFFFFFFFULL));
+
+  options.use_uds = false;
+  ColocationTable tcp_table(snapshot, options);
+  ASSERT_EQ("10.0.0.1", tcp_table.GetLocal()->endpoints[0].host);
+  ASSERT_EQ(8000, tcp_table.GetLocal()->endpoints[0].port);
+}
+
+TEST(ColocationTableTest, MaxLocalPercent) {
+  ColocationOptions options;
+  options.local_host = "10.0.0.1";
+  options.max_local_percent = 25;
+  ColocationTable table(MakeSnapshot({MakeEndpoint("10.0.0.1", 8000, true), MakeEndpoint("10.0.0.2", 8000, true)}),
+                        options);
+
+  ASSERT_NE(nullptr, table.Pick(0));
+  ASSERT_NE(nullptr, table.Pick((1ULL << 32) / 4 - 1));
+  ASSERT_EQ(nullptr, table.Pick((1ULL << 32) / 4));
+
+  // Nothing co-located
+  ColocationTable remote(MakeSnapshot({MakeEndpoint("10.0.0.2", 8000, true)}), options);
+  ASSERT_EQ(nullptr, remote.GetLocal());
+  ASSERT_EQ(nullptr, remote.Pick(0));
+}
+
+}  // namespace trpc::naming::polarismesh::testing
@@ -23,6 +23,7 @@
 #include "trpc/codec/trpc/trpc.pb.h"
 #include "trpc/common/config/trpc_config.h"
 #include "trpc/util/log/logging.h"
+#include "trpc/util/time.h"
 
 namespace {
 
@@ -39,6 +40,20 @@ bool InCircuitBreakWhiteList(trpc::ReadersWriterData<std::set<int>>& whitelist,
 
 namespace trpc {
 
+int64_t GetRemainingTimeoutMs(const ClientContextPtr& context) {
+  int64_t elapsed_ms =
+      static_cast<int64_t>(trpc::time::GetMicroSeconds() - context->GetBeginTimestampUs()) / 1000;
+  return static_cast<int64_t>(context->GetTimeout()) - elapsed_ms;
+}
+
+uint64_t GetDeadlineAwareTimeout(const ClientContextPtr& context, uint64_t configured_timeout, uint64_t reserve) {
+  if (!context) {
+    return configured_timeout;
+  }
+
+  return CalculateDeadlineTimeout(configured_timeout, GetRemainingTimeoutMs(context), reserve);
+}
+
 void SetPolarisMeshSelectorConf(trpc::naming::PolarisMeshNamingConfig& config) {
   if (!trpc::TrpcConfig::GetInstance()->GetPluginConfig<trpc::naming::SelectorConfig>("selector", "polarismesh",
                                                                                       config.selector_config)) {
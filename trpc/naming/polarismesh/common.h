@@ -254,6 +254,32 @@ inline bool ServiceKeyEqual(const polaris::ServiceKey& service_key1, const polar
   return false;
 }
 
+/// @brief Calculate the timeout of a blocking call to the SDK made on behalf of a call, so that it can not wait longer
+///        than the call itself is allowed to
+/// @param configured_timeout Timeout in the plugin configuration, in ms
+/// @param remaining_ms Remaining time before the deadline of the call in ms, negative if it has expired
+/// @param reserve Time reserved for the call itself after the SDK call, in ms
+/// @return uint64_t min(configured_timeout, remaining_ms - reserve), at least 1ms
+inline uint64_t CalculateDeadlineTimeout(uint64_t configured_timeout, int64_t remaining_ms, uint64_t reserve) {
+  if (remaining_ms <= static_cast<int64_t>(reserve)) {
+    return 1;
+  }
+
+  uint64_t timeout = static_cast<uint64_t>(remaining_ms) - reserve;
+  return timeout < configured_timeout ? timeout : configured_timeout;
+}
+
+/// @brief Get the remaining time before the deadline of the call
+/// @param context Client context of the call
+/// @return int64_t Remaining time in ms, negative if the deadline has passed
+int64_t GetRemainingTimeoutMs(const ClientContextPtr& context);
+
+/// @brief Get the timeout of a blocking call to the SDK bounded by the remaining deadline of the call
+/// @param context Client context of the call, configured_timeout is returned if it is nullptr
+/// @param configured_timeout Timeout in the plugin configuration, in ms
+/// @param reserve Time reserved for the call itself after the SDK call, in ms
+uint64_t GetDeadlineAwareTimeout(const ClientContextPtr& context, uint64_t configured_timeout, uint64_t reserve);
+
 /// @brief Integrate all information in config into config.orig_selector_config
 ///        Follow -up can construct the Context of the Arctic SDK through Orig_selector_config
 /// @param config polarismesh plug -in configuration
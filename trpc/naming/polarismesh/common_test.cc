@@ -107,6 +107,16 @@ TEST(SetPolarisMeshSelectorConfTest, Run) {
   ASSERT_NE(0, config.orig_selector_config.size());
 }
 
+TEST(CalculateDeadlineTimeoutTest, Calculate) {
+  // Bounded by the configured timeout
+  ASSERT_EQ(1000, CalculateDeadlineTimeout(1000, 5000, 10));
+  // Bounded by the remaining deadline
+  ASSERT_EQ(40, CalculateDeadlineTimeout(1000, 50, 10));
+  // No time left for the SDK call
+  ASSERT_EQ(1, CalculateDeadlineTimeout(1000, 10, 10));
+  ASSERT_EQ(1, CalculateDeadlineTimeout(1000, -5, 10));
+}
+
 TEST(FrameworkRetToPolarisRet, Convert) {
   ReadersWriterData<std::set<int>> whitelist;
   whitelist.Writer().insert(TrpcRetCode::TRPC_SERVER_OVERLOAD_ERR);
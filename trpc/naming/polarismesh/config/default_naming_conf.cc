@@ -24,6 +24,7 @@ void ServiceConfig::Display() const {
   TRPC_LOG_DEBUG("token:" << token);
   TRPC_LOG_DEBUG("instance_id:" << instance_id);
   TRPC_LOG_DEBUG("metadata_size:" << metadata.size());
+  TRPC_LOG_DEBUG("uds_path:" << uds_path);
 
   TRPC_LOG_DEBUG("--------------------------------");
 }
@@ -33,6 +34,7 @@ void RegistryConfig::Display() const {
 
   TRPC_LOG_DEBUG("heartbeat_interval:" << heartbeat_interval);
   TRPC_LOG_DEBUG("heartbeat_timeout:" << heartbeat_timeout);
+  TRPC_LOG_DEBUG("host_id:" << host_id);
   for (auto& item : services_config) {
     item.Display();
   }
@@ -26,6 +26,8 @@ struct ServiceConfig {
   std::string token;
   std::string instance_id;
   std::map<std::string, std::string> metadata;
+  // Path of the unix domain socket the service also listens on, published to the co-located callers. Optional
+  std::string uds_path;
 
   void Display() const;
 };
@@ -34,6 +36,9 @@ struct RegistryConfig {
   uint64_t heartbeat_interval{3000};
   uint64_t heartbeat_timeout{2000};
   std::vector<ServiceConfig> services_config;
+  // Identity of the host published with the instances, which tells the callers on the same host. Optional, the callers
+  // compare the addresses without it
+  std::string host_id;
 
   void Display() const;
 };
@@ -57,6 +62,8 @@ struct convert<trpc::naming::ServiceConfig> {
 
     node["metadata"] = config.metadata;
 
+    node["uds_path"] = config.uds_path;
+
     return node;
   }
 
@@ -81,6 +88,10 @@ struct convert<trpc::naming::ServiceConfig> {
       config.metadata = node["metadata"].as<std::map<std::string, std::string>>();
     }
 
+    if (node["uds_path"]) {
+      config.uds_path = node["uds_path"].as<std::string>();
+    }
+
     return true;
   }
 };
@@ -96,6 +107,8 @@ struct convert<trpc::naming::RegistryConfig> {
 
     node["service"] = config.services_config;
 
+    node["host_id"] = config.host_id;
+
     return node;
   }
 
@@ -112,6 +125,10 @@ struct convert<trpc::naming::RegistryConfig> {
       config.services_config = node["service"].as<std::vector<trpc::naming::ServiceConfig>>();
     }
 
+    if (node["host_id"]) {
+      config.host_id = node["host_id"].as<std::string>();
+    }
+
     return true;
   }
 };
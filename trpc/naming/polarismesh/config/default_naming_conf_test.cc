@@ -27,12 +27,14 @@ TEST(DefaultNamingConfTest, default_naming_conf_test) {
   service_config.token = "token";
   service_config.instance_id = "id";
   service_config.metadata = {{"key", "value"}, {"test", "metadata"}};
+  service_config.uds_path = "/tmp/test.sock";
   service_config.Display();
 
   naming::RegistryConfig registry_config;
   registry_config.heartbeat_interval = 3333;
   registry_config.heartbeat_timeout = 2222;
   registry_config.services_config.push_back(service_config);
+  registry_config.host_id = "host-1";
   registry_config.Display();
 
   YAML::convert<trpc::naming::RegistryConfig> c;
@@ -44,12 +46,14 @@ TEST(DefaultNamingConfTest, default_naming_conf_test) {
   tmp.Display();
   ASSERT_EQ(registry_config.heartbeat_interval, tmp.heartbeat_interval);
   ASSERT_EQ(registry_config.heartbeat_timeout, tmp.heartbeat_timeout);
+  ASSERT_EQ(registry_config.host_id, tmp.host_id);
   ASSERT_EQ(1, tmp.services_config.size());
   ASSERT_EQ(service_config.name, tmp.services_config[0].name);
   ASSERT_EQ(service_config.namespace_, tmp.services_config[0].namespace_);
   ASSERT_EQ(service_config.token, tmp.services_config[0].token);
   ASSERT_EQ(service_config.instance_id, tmp.services_config[0].instance_id);
   ASSERT_EQ(service_config.metadata, tmp.services_config[0].metadata);
+  ASSERT_EQ(service_config.uds_path, tmp.services_config[0].uds_path);
 }
 
 }  // namespace trpc
\ No newline at end of file
@@ -136,6 +136,13 @@ void CircuitBreakerPluginConfig::Display() const {
 void SetCircuitBreakerConfig::Display() const {
   TRPC_LOG_DEBUG("--------------------------------");
   TRPC_LOG_DEBUG("enable: " << enable);
+  TRPC_LOG_DEBUG("window: " << window);
+  TRPC_LOG_DEBUG("min_requests: " << min_requests);
+  TRPC_LOG_DEBUG("error_rate_percent: " << error_rate_percent);
+  TRPC_LOG_DEBUG("slow_call: " << slow_call);
+  TRPC_LOG_DEBUG("slow_rate_percent: " << slow_rate_percent);
+  TRPC_LOG_DEBUG("sleep_window: " << sleep_window);
+  TRPC_LOG_DEBUG("success_to_close: " << success_to_close);
 }
 
 void CircuitBreakerConfig::Display() const {
@@ -151,10 +158,18 @@ void CircuitBreakerConfig::Display() const {
   set_circuitbreaker_config.Display();
 }
 
+void TrpcOutlierDetectionConfig::Display() const {
+  TRPC_LOG_DEBUG("---------------TrpcOutlierDetectionConfig begin-----------------");
+  TRPC_LOG_DEBUG("func_name:" << func_name);
+  TRPC_LOG_DEBUG("timeout:" << timeout);
+  TRPC_LOG_DEBUG("protocol:" << protocol);
+}
+
 void OutlierDetectionConfig::Display() const {
   TRPC_LOG_DEBUG("---------------OutlierDetectionConfig begin-----------------");
   TRPC_LOG_DEBUG("enable:" << enable);
   TRPC_LOG_DEBUG("check_period:" << check_period);
+  trpc_config.Display();
 }
 
 void LoadBalancerConfig::Display() const {
@@ -233,12 +248,219 @@ void DynamicWeightConfig::Display() const {
   TRPC_LOG_DEBUG("open_dynamic_weight:" << open_dynamic_weight);
 }
 
+void FailStaticConfig::Display() const {
+  TRPC_LOG_DEBUG("---------------FailStaticConfig begin-----------------");
+  TRPC_LOG_DEBUG("enable:" << enable);
+  TRPC_LOG_DEBUG("max_staleness:" << max_staleness);
+  TRPC_LOG_DEBUG("snapshot_interval:" << snapshot_interval);
+  TRPC_LOG_DEBUG("min_backoff:" << min_backoff);
+  TRPC_LOG_DEBUG("max_backoff:" << max_backoff);
+}
+
+void NegativeCacheConfig::Display() const {
+  TRPC_LOG_DEBUG("---------------NegativeCacheConfig begin-----------------");
+  TRPC_LOG_DEBUG("enable:" << enable);
+  TRPC_LOG_DEBUG("ttl:" << ttl);
+}
+
+void DeadlineConfig::Display() const {
+  TRPC_LOG_DEBUG("---------------DeadlineConfig begin-----------------");
+  TRPC_LOG_DEBUG("enable:" << enable);
+  TRPC_LOG_DEBUG("reserve:" << reserve);
+}
+
+void LocalHashConfig::Display() const {
+  TRPC_LOG_DEBUG("---------------LocalHashConfig begin-----------------");
+  TRPC_LOG_DEBUG("enable:" << enable);
+  TRPC_LOG_DEBUG("type:" << type);
+  TRPC_LOG_DEBUG("maglev_table_size:" << maglev_table_size);
+  TRPC_LOG_DEBUG("refresh_interval:" << refresh_interval);
+  TRPC_LOG_DEBUG("bounded_load_factor:" << bounded_load_factor);
+}
+
+void LocalRandomConfig::Display() const {
+  TRPC_LOG_DEBUG("---------------LocalRandomConfig begin-----------------");
+  TRPC_LOG_DEBUG("enable:" << enable);
+  TRPC_LOG_DEBUG("min_instances:" << min_instances);
+  TRPC_LOG_DEBUG("refresh_interval:" << refresh_interval);
+}
+
+void RouteCacheConfig::Display() const {
+  TRPC_LOG_DEBUG("---------------RouteCacheConfig begin-----------------");
+  TRPC_LOG_DEBUG("enable:" << enable);
+  TRPC_LOG_DEBUG("max_entries:" << max_entries);
+  TRPC_LOG_DEBUG("refresh_interval:" << refresh_interval);
+  TRPC_LOG_DEBUG("rule_check_interval:" << rule_check_interval);
+  TRPC_LOG_DEBUG("max_thread_rules:" << max_thread_rules);
+}
+
+void MetadataIndexConfig::Display() const {
+  TRPC_LOG_DEBUG("---------------MetadataIndexConfig begin-----------------");
+  TRPC_LOG_DEBUG("enable:" << enable);
+  TRPC_LOG_DEBUG("max_filters:" << max_filters);
+}
+
+void LocalNearbyConfig::Display() const {
+  TRPC_LOG_DEBUG("---------------LocalNearbyConfig begin-----------------");
+  TRPC_LOG_DEBUG("enable:" << enable);
+}
+
+void ZoneAwareConfig::Display() const {
+  TRPC_LOG_DEBUG("---------------ZoneAwareConfig begin-----------------");
+  TRPC_LOG_DEBUG("enable:" << enable);
+  TRPC_LOG_DEBUG("min_cluster_size:" << min_cluster_size);
+  TRPC_LOG_DEBUG("refresh_interval:" << refresh_interval);
+}
+
+void LatencyLocalityConfig::Display() const {
+  TRPC_LOG_DEBUG("---------------LatencyLocalityConfig begin-----------------");
+  TRPC_LOG_DEBUG("enable:" << enable);
+  TRPC_LOG_DEBUG("decay:" << decay);
+  TRPC_LOG_DEBUG("min_samples:" << min_samples);
+  TRPC_LOG_DEBUG("expire_time:" << expire_time);
+  TRPC_LOG_DEBUG("rank_interval:" << rank_interval);
+}
+
+void ColocationConfig::Display() const {
+  TRPC_LOG_DEBUG("---------------ColocationConfig begin-----------------");
+  TRPC_LOG_DEBUG("enable:" << enable);
+  TRPC_LOG_DEBUG("host_id:" << host_id);
+  TRPC_LOG_DEBUG("max_local_percent:" << max_local_percent);
+  TRPC_LOG_DEBUG("use_uds:" << use_uds);
+}
+
+void FederationClusterConfig::Display() const {
+  TRPC_LOG_DEBUG("name:" << name);
+  for (const auto& address : addresses) {
+    TRPC_LOG_DEBUG("address:" << address);
+  }
+  TRPC_LOG_DEBUG("join_point:" << join_point);
+}
+
+void FederationConfig::Display() const {
+  TRPC_LOG_DEBUG("---------------FederationConfig begin-----------------");
+  TRPC_LOG_DEBUG("enable:" << enable);
+  for (const auto& cluster : clusters) {
+    cluster.Display();
+  }
+  TRPC_LOG_DEBUG("overprovisioning_factor:" << overprovisioning_factor);
+  TRPC_LOG_DEBUG("refresh_interval:" << refresh_interval);
+}
+
+void SlowStartConfig::Display() const {
+  TRPC_LOG_DEBUG("---------------SlowStartConfig begin-----------------");
+  TRPC_LOG_DEBUG("enable:" << enable);
+  TRPC_LOG_DEBUG("window:" << window);
+  TRPC_LOG_DEBUG("curve:" << curve);
+  TRPC_LOG_DEBUG("aggression:" << aggression);
+  TRPC_LOG_DEBUG("min_weight_percent:" << min_weight_percent);
+}
+
+void LatencyOutlierConfig::Display() const {
+  TRPC_LOG_DEBUG("---------------LatencyOutlierConfig begin-----------------");
+  TRPC_LOG_DEBUG("enable:" << enable);
+  TRPC_LOG_DEBUG("window:" << window);
+  TRPC_LOG_DEBUG("quantile:" << quantile);
+  TRPC_LOG_DEBUG("ratio:" << ratio);
+  TRPC_LOG_DEBUG("min_latency:" << min_latency);
+  TRPC_LOG_DEBUG("min_samples:" << min_samples);
+  TRPC_LOG_DEBUG("min_hosts:" << min_hosts);
+  TRPC_LOG_DEBUG("base_ejection_time:" << base_ejection_time);
+  TRPC_LOG_DEBUG("max_ejection_time:" << max_ejection_time);
+  TRPC_LOG_DEBUG("max_ejection_percent:" << max_ejection_percent);
+  TRPC_LOG_DEBUG("interval:" << interval);
+}
+
+void MethodCircuitBreakerConfig::Display() const {
+  TRPC_LOG_DEBUG("---------------MethodCircuitBreakerConfig begin-----------------");
+  TRPC_LOG_DEBUG("enable:" << enable);
+  TRPC_LOG_DEBUG("window:" << window);
+  TRPC_LOG_DEBUG("bucket_num:" << bucket_num);
+  TRPC_LOG_DEBUG("min_requests:" << min_requests);
+  TRPC_LOG_DEBUG("error_rate_percent:" << error_rate_percent);
+  TRPC_LOG_DEBUG("sleep_window:" << sleep_window);
+  TRPC_LOG_DEBUG("success_to_close:" << success_to_close);
+}
+
+void ServiceFailFastConfig::Display() const {
+  TRPC_LOG_DEBUG("---------------ServiceFailFastConfig begin-----------------");
+  TRPC_LOG_DEBUG("enable:" << enable);
+  TRPC_LOG_DEBUG("broken_percent:" << broken_percent);
+  TRPC_LOG_DEBUG("reject_percent:" << reject_percent);
+  TRPC_LOG_DEBUG("window:" << window);
+  TRPC_LOG_DEBUG("min_requests:" << min_requests);
+  TRPC_LOG_DEBUG("error_rate_percent:" << error_rate_percent);
+  TRPC_LOG_DEBUG("sleep_window:" << sleep_window);
+}
+
+void RetryAwareConfig::Display() const {
+  TRPC_LOG_DEBUG("---------------RetryAwareConfig begin-----------------");
+  TRPC_LOG_DEBUG("enable:" << enable);
+  TRPC_LOG_DEBUG("max_tried:" << max_tried);
+}
+
+void HedgingConfig::Display() const {
+  TRPC_LOG_DEBUG("---------------HedgingConfig begin-----------------");
+  TRPC_LOG_DEBUG("enable:" << enable);
+  TRPC_LOG_DEBUG("quantile:" << quantile);
+  TRPC_LOG_DEBUG("window:" << window);
+  TRPC_LOG_DEBUG("min_samples:" << min_samples);
+  TRPC_LOG_DEBUG("min_delay:" << min_delay);
+  TRPC_LOG_DEBUG("budget_percent:" << budget_percent);
+  TRPC_LOG_DEBUG("interval:" << interval);
+}
+
+void RetryBudgetConfig::Display() const {
+  TRPC_LOG_DEBUG("---------------RetryBudgetConfig begin-----------------");
+  TRPC_LOG_DEBUG("enable:" << enable);
+  TRPC_LOG_DEBUG("ratio_percent:" << ratio_percent);
+  TRPC_LOG_DEBUG("max_tokens:" << max_tokens);
+  TRPC_LOG_DEBUG("min_healthy_percent:" << min_healthy_percent);
+  TRPC_LOG_DEBUG("window:" << window);
+  TRPC_LOG_DEBUG("min_requests:" << min_requests);
+  TRPC_LOG_DEBUG("error_rate_percent:" << error_rate_percent);
+  TRPC_LOG_DEBUG("sleep_window:" << sleep_window);
+}
+
+void AdaptiveTimeoutConfig::Display() const {
+  TRPC_LOG_DEBUG("---------------AdaptiveTimeoutConfig begin-----------------");
+  TRPC_LOG_DEBUG("enable:" << enable);
+  TRPC_LOG_DEBUG("apply:" << apply);
+  TRPC_LOG_DEBUG("quantile:" << quantile);
+  TRPC_LOG_DEBUG("multiplier:" << multiplier);
+  TRPC_LOG_DEBUG("min_timeout:" << min_timeout);
+  TRPC_LOG_DEBUG("max_timeout:" << max_timeout);
+  TRPC_LOG_DEBUG("window:" << window);
+  TRPC_LOG_DEBUG("min_samples:" << min_samples);
+  TRPC_LOG_DEBUG("interval:" << interval);
+}
+
 void SelectorConfig::Display() const {
   TRPC_LOG_DEBUG("--------------------------------");
 
   global_config.Display();
   consumer_config.Display();
   dynamic_weight_config.Display();
+  fail_static_config.Display();
+  negative_cache_config.Display();
+  deadline_config.Display();
+  local_hash_config.Display();
+  local_random_config.Display();
+  route_cache_config.Display();
+  metadata_index_config.Display();
+  local_nearby_config.Display();
+  zone_aware_config.Display();
+  latency_locality_config.Display();
+  colocation_config.Display();
+  federation_config.Display();
+  slow_start_config.Display();
+  latency_outlier_config.Display();
+  method_circuit_breaker_config.Display();
+  service_fail_fast_config.Display();
+  retry_aware_config.Display();
+  hedging_config.Display();
+  retry_budget_config.Display();
+  adaptive_timeout_config.Display();
 
   TRPC_LOG_DEBUG("--------------------------------");
 }
@@ -248,6 +470,8 @@ void RateLimiterConfig::Display() const {
 
   TRPC_LOG_DEBUG("timeout:" << timeout);
   TRPC_LOG_DEBUG("updateCallResult:" << update_call_result);
+  TRPC_LOG_DEBUG("enableDeadline:" << enable_deadline);
+  TRPC_LOG_DEBUG("deadlineReserve:" << deadline_reserve);
   TRPC_LOG_DEBUG("mode:" << mode);
   cluster_config.Display();
 
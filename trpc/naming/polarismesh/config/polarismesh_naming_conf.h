@@ -133,6 +133,20 @@ struct CircuitBreakerPluginConfig {
 // polarismesh Set Set Slim Freachment Configuration
 struct SetCircuitBreakerConfig {
   bool enable{false};  // Whether to open the function
+  // Window of the results of the calls of a set, in ms
+  uint64_t window{10000};
+  // Number of calls of a set in the window needed to open its breaker
+  uint32_t min_requests{20};
+  // Error rate opening the breaker of a set, in percent
+  uint32_t error_rate_percent{50};
+  // Latency above which a call is slow, in ms. 0 means the latency is not checked
+  uint64_t slow_call{0};
+  // Rate of slow calls opening the breaker of a set, in percent
+  uint32_t slow_rate_percent{50};
+  // Time the breaker of a set stays open before the calls are let through again, in ms
+  uint64_t sleep_window{30000};
+  // Number of successes closing a half-open breaker
+  uint32_t success_to_close{3};
 
   void Display() const;
 };
@@ -148,10 +162,23 @@ struct CircuitBreakerConfig {
 };
 
 // Detective configuration
+// Probe of the instances through the transport of the framework
+struct TrpcOutlierDetectionConfig {
+  std::string func_name{"/trpc.polarismesh.probe.Probe/Ping"};  // Function called by the probes
+  std::string timeout{"1s"};                                    // Timeout of a probe
+  std::string protocol{"trpc"};                                 // Protocol of the probes
+
+  // Print information
+  void Display() const;
+};
+
 struct OutlierDetectionConfig {
   bool enable{false};
   std::string check_period{"10s"};
+  // Probes of the instances, "tcp" or "trpc" which sends a lightweight call through the transport of the framework
   std::vector<std::string> chain{"tcp"};
+  // Options of the "trpc" probe, passed to the SDK under plugin.trpc
+  TrpcOutlierDetectionConfig trpc_config;
   void Display() const;
 };
 
@@ -259,11 +286,405 @@ struct DynamicWeightConfig {
   void Display() const;
 };
 
+// Fail-static module configuration, which only takes effect inside the plugin
+struct FailStaticConfig {
+  // Whether to serve the last good routed snapshot when the polarismesh server is unreachable or slow
+  bool enable{false};
+  // Maximum age of a snapshot that can still be served, in ms
+  uint64_t max_staleness{300000};
+  // Interval of refreshing the routed snapshot while the polarismesh server is healthy, in ms
+  uint64_t snapshot_interval{10000};
+  // Initial backoff of the asynchronous refresh after a failed lookup, in ms
+  uint64_t min_backoff{1000};
+  // Maximum backoff of the asynchronous refresh after continuous failed lookups, in ms
+  uint64_t max_backoff{30000};
+
+  // Print information
+  void Display() const;
+};
+
+// Negative cache module configuration of the services not found, which only takes effect inside the plugin
+struct NegativeCacheConfig {
+  // Whether to cache the "service not found" result, so repeated lookups of a missing service fail fast, and to
+  // let a single lookup of a service go to the SDK while it is cold. The lookups go straight to the SDK when disabled
+  bool enable{false};
+  // How long the "service not found" result is cached, in ms
+  uint64_t ttl{5000};
+
+  // Print information
+  void Display() const;
+};
+
+// Deadline module configuration, which only takes effect inside the plugin
+struct DeadlineConfig {
+  // Whether to bound the timeout of the lookups by the remaining deadline of the call
+  bool enable{true};
+  // Time reserved for the call itself after the lookup, in ms
+  uint64_t reserve{10};
+
+  // Print information
+  void Display() const;
+};
+
+// Local consistent hashing module configuration, which only takes effect inside the plugin
+struct LocalHashConfig {
+  // Whether the calls with a hash key are balanced by the plugin instead of the SDK
+  bool enable{false};
+  // Default algorithm, "ringHash", "maglev" or "jumpHash". The load balance name of the call takes precedence when it
+  // is one of them. The number of virtual nodes of "ringHash" is the vnodeCount of the consumer load balancer
+  std::string type{"ringHash"};
+  // Size of the maglev lookup table, a prime much larger than the number of instances
+  uint32_t maglev_table_size{65537};
+  // Interval of refreshing the routed instances the tables are built from, in ms
+  uint64_t refresh_interval{1000};
+  // Load factor of the consistent hashing with bounded loads, an instance takes at most this factor times the average
+  // in-flight calls and the others spill over to the next instances. 0 means the loads are not bounded
+  double bounded_load_factor{0};
+
+  // Print information
+  void Display() const;
+};
+
+// Local weighted random module configuration, which only takes effect inside the plugin
+struct LocalRandomConfig {
+  // Whether the weighted random calls without a hash key are balanced by the plugin with alias tables
+  bool enable{false};
+  // Minimum number of routed instances for the plugin to take over, the SDK is cheap enough for the small services
+  uint32_t min_instances{64};
+  // Interval of refreshing the routed instances the tables are built from, in ms
+  uint64_t refresh_interval{1000};
+
+  // Print information
+  void Display() const;
+};
+
+// Routed subset cache configuration, which only takes effect inside the plugin
+struct RouteCacheConfig {
+  // Whether the routed subsets are memoized per distinct routing inputs until the instances, the route rules or the
+  // circuit breaker data of the SDK change. The plugin balancers (local_hash, local_random) and the batch selections
+  // are then served from them, set minInstances of local_random to 0 to serve every weighted random call
+  bool enable{false};
+  // Maximum number of memoized subsets, the least recently refreshed one is evicted for a new one
+  uint32_t max_entries{10000};
+  // Interval of refreshing a subset whose revisions did not change, which catches the changes not signed by a revision,
+  // in ms
+  uint64_t refresh_interval{30000};
+  // Interval of checking the revision of a route rule cached by a thread against the SDK, in ms
+  uint64_t rule_check_interval{1000};
+  // Maximum number of route rules cached by a thread
+  uint32_t max_thread_rules{1024};
+
+  // Print information
+  void Display() const;
+};
+
+// Local nearby routing configuration, which only takes effect inside the plugin
+struct LocalNearbyConfig {
+  // Whether the nearby routing is made by the plugin over locality tiers precomputed per routed subset, relative to the
+  // location of the global api configuration. The settings are those of the nearbyBasedRouter, which should be removed
+  // from the service router chain of the SDK
+  bool enable{false};
+
+  // Print information
+  void Display() const;
+};
+
+// Metadata index configuration, which only takes effect inside the plugin
+struct MetadataIndexConfig {
+  // Whether the destination metadata of the calls served from the routed subsets (route_cache, local_hash,
+  // local_random) is matched with an inverted index of the subset routed without it
+  bool enable{false};
+  // Maximum number of matched subsets kept per index
+  uint32_t max_filters{256};
+
+  // Print information
+  void Display() const;
+};
+
+// Zone-aware routing configuration, which only takes effect inside the plugin
+struct ZoneAwareConfig {
+  // Whether the calls of every zone are spread over the zones of the routed subset in proportion to the capacity of the
+  // zones against the number of callers in them, instead of staying in the local zone
+  bool enable{false};
+  // Minimum number of endpoints in the routed subset to route by zone, all the endpoints are used below it
+  uint32_t min_cluster_size{6};
+  // Interval of refreshing the distribution of the callers over the zones, in ms
+  uint64_t refresh_interval{10000};
+
+  // Print information
+  void Display() const;
+};
+
+// Latency-ranked locality configuration, which only takes effect with local_nearby
+struct LatencyLocalityConfig {
+  // Whether a degraded nearby match level falls back to the locality groups ranked by the latency measured from the
+  // cost of the calls, instead of the region/zone/campus hierarchy
+  bool enable{false};
+  // Weight of a new sample in the moving average of the latency of a group
+  double decay{0.2};
+  // Number of samples needed before the latency of a group is used
+  uint32_t min_samples{20};
+  // Age after which the latency of a group without new samples is unknown again, in ms
+  uint64_t expire_time{60000};
+  // Interval of ranking the groups again, in ms
+  uint64_t rank_interval{1000};
+
+  // Print information
+  void Display() const;
+};
+
+// Co-location configuration, which only takes effect inside the plugin
+struct ColocationConfig {
+  // Whether the callees on the local host are preferred. A callee is local when its host is the bindIP of the api
+  // configuration, or when it is published with the host identity below
+  bool enable{false};
+  // Identity of the local host, the same as the host_id of the registry configuration. Optional
+  std::string host_id;
+  // Maximum percentage of the calls kept on the local callees
+  uint32_t max_local_percent{100};
+  // Whether a local callee publishing a unix domain socket is returned as that socket (the path as the host and 0 as
+  // the port), for the clients whose transport routes such endpoints over unix domain sockets
+  bool use_uds{false};
+
+  // Print information
+  void Display() const;
+};
+
+// A secondary polarismesh cluster of the federation
+struct FederationClusterConfig {
+  // Name of the cluster, unique in the federation
+  std::string name;
+  // Addresses of the polarismesh server of the cluster
+  std::vector<std::string> addresses;
+  // The polarismesh access point of the cluster, the one of the primary cluster if empty
+  std::string join_point;
+
+  // Print information
+  void Display() const;
+};
+
+// Federation configuration, which only takes effect inside the plugin
+struct FederationConfig {
+  // Whether the callees are also discovered in the secondary clusters, which take the calls the primary cluster (the
+  // one of the global configuration) can not take with its healthy instances
+  bool enable{false};
+  // The secondary clusters, ranked by their measured latency
+  std::vector<FederationClusterConfig> clusters;
+  // Overprovisioning factor of the healthy capacity of a cluster, in percent: a cluster keeps all of its calls as long
+  // as its healthy percentage times the factor is at least 100%
+  uint32_t overprovisioning_factor{140};
+  // Interval of refreshing the instances discovered in the secondary clusters, in ms
+  uint64_t refresh_interval{10000};
+
+  // Print information
+  void Display() const;
+};
+
+// Slow start configuration, which only takes effect on the endpoints balanced inside the plugin
+struct SlowStartConfig {
+  // Whether the weight of a newly discovered endpoint ramps up over the window instead of being its full weight at
+  // once, the endpoints known when a callee is first selected are not ramped
+  bool enable{false};
+  // Time for a new endpoint to ramp up to its full weight, in ms
+  uint64_t window{60000};
+  // Shape of the ramp, "linear" or "aggressive"
+  std::string curve{"linear"};
+  // Root of the aggressive curve, the larger the faster the weight grows at first
+  double aggression{2.0};
+  // Weight of an endpoint which just joined, in percent of its full weight
+  uint32_t min_weight_percent{10};
+
+  // Print information
+  void Display() const;
+};
+
+// Latency outlier ejection configuration, which only takes effect inside the plugin
+struct LatencyOutlierConfig {
+  // Whether the instances whose latency quantile is far above the median of their peers are ejected. The latencies
+  // are measured from the cost of the calls, an ejected instance is left out of the routed subsets and the calls the
+  // SDK balances on it are picked again
+  bool enable{false};
+  // Window of the latency samples, in ms
+  uint64_t window{10000};
+  // Quantile of the latencies compared, in [0, 1]
+  double quantile{0.99};
+  // An instance is an outlier when its quantile is more than ratio times the median quantile
+  double ratio{5.0};
+  // Quantile below which an instance is never an outlier, in ms
+  uint64_t min_latency{10};
+  // Number of samples in the window needed to judge an instance
+  uint32_t min_samples{50};
+  // Number of instances judged needed to compute the median
+  uint32_t min_hosts{3};
+  // Ejection time of the first ejection, it grows linearly with the repeated ejections, in ms
+  uint64_t base_ejection_time{30000};
+  // Maximum ejection time, in ms
+  uint64_t max_ejection_time{300000};
+  // Maximum percentage of the instances of a service ejected at the same time, at least one can be ejected
+  uint32_t max_ejection_percent{10};
+  // Interval of the detection of a service, in ms
+  uint64_t interval{1000};
+
+  // Print information
+  void Display() const;
+};
+
+// Method-level circuit breaking configuration, which only takes effect inside the plugin
+struct MethodCircuitBreakerConfig {
+  // Whether the results of the calls are also counted per instance and method, an instance whose breaker of a
+  // method is open is skipped only by the calls of that method. The instance-level breaking of the SDK is unchanged
+  bool enable{false};
+  // Window of the results, in ms
+  uint64_t window{10000};
+  // Number of buckets of the window
+  uint32_t bucket_num{10};
+  // Number of calls in the window needed to open a breaker
+  uint32_t min_requests{10};
+  // Error rate opening a breaker, in percent
+  uint32_t error_rate_percent{50};
+  // Time a breaker stays open before the calls are let through again, in ms
+  uint64_t sleep_window{30000};
+  // Number of successes closing a half-open breaker
+  uint32_t success_to_close{3};
+
+  // Print information
+  void Display() const;
+};
+
+// Service-level fail-fast configuration, which only takes effect inside the plugin
+struct ServiceFailFastConfig {
+  // Whether the calls of a callee whose instances are mostly broken or unhealthy are rejected at once, except
+  // for the calls let through to probe it
+  bool enable{false};
+  // Percentage of the instances broken or unhealthy above which the callee fails fast
+  uint32_t broken_percent{80};
+  // Percentage of the calls rejected while the callee fails fast
+  uint32_t reject_percent{90};
+  // Window of the results of an instance, in ms
+  uint64_t window{10000};
+  // Number of calls of an instance in the window needed to break it
+  uint32_t min_requests{10};
+  // Error rate breaking an instance, in percent
+  uint32_t error_rate_percent{50};
+  // Time an instance stays broken before it is probed, in ms
+  uint64_t sleep_window{30000};
+
+  // Print information
+  void Display() const;
+};
+
+// Retry-aware selection configuration
+struct RetryAwareConfig {
+  // Whether the endpoints selected for a call are recorded in its context, so that its retries avoid them. The
+  // endpoints listed in the "excluded_endpoints" selector extend info of the call are also avoided
+  bool enable{false};
+  // Maximum number of endpoints remembered per call, the latest ones are kept
+  uint32_t max_tried{5};
+
+  // Print information
+  void Display() const;
+};
+
+// Hedging configuration
+struct HedgingConfig {
+  // Whether the calls through the selector filter without a backup request of their own are hedged: a backup
+  // endpoint is selected with the call, and it is called when the call is still pending after the latency quantile
+  // of the callee
+  bool enable{false};
+  // Quantile of the latencies of the callee after which a call is hedged, in [0, 1]
+  double quantile{0.95};
+  // Window of the latency samples and of the hedge budget, in ms
+  uint64_t window{10000};
+  // Number of samples in the window needed for the calls of a callee to be hedged
+  uint32_t min_samples{100};
+  // Minimum hedge delay, in ms
+  uint64_t min_delay{1};
+  // Maximum percentage of the calls of a callee that send a hedge, which is the extra load allowed
+  uint32_t budget_percent{10};
+  // Interval of updating the hedge delay of a callee, in ms
+  uint64_t interval{1000};
+
+  // Print information
+  void Display() const;
+};
+
+// Retry budget configuration, which only takes effect inside the plugin
+struct RetryBudgetConfig {
+  // Whether the retries of the calls of a callee, the selections after the first one in the same context, spend
+  // a budget filled by its successful calls. A retry is refused once the budget is used up
+  bool enable{false};
+  // Maximum ratio of the retries to the successful calls, in percent
+  uint32_t ratio_percent{10};
+  // Capacity of the budget in retries, the budget of a new callee starts full
+  uint32_t max_tokens{100};
+  // Percentage of the instances not broken below which the retries are refused, a retry costs more as the
+  // percentage falls
+  uint32_t min_healthy_percent{50};
+  // Window of the results of an instance, in ms
+  uint64_t window{10000};
+  // Number of calls of an instance in the window needed to break it
+  uint32_t min_requests{10};
+  // Error rate breaking an instance, in percent
+  uint32_t error_rate_percent{50};
+  // Time an instance stays broken, in ms
+  uint64_t sleep_window{30000};
+
+  // Print information
+  void Display() const;
+};
+
+// Adaptive timeout configuration
+struct AdaptiveTimeoutConfig {
+  // Whether a timeout is recommended for every method of a callee from the latency of its calls, and the
+  // outcomes of the calls under the static and the recommended timeouts are reported to the metrics
+  bool enable{false};
+  // Whether the selector filter replaces the timeout of the calls with the recommended one, otherwise the
+  // recommended timeout is only compared with the static one
+  bool apply{false};
+  // Quantile of the latencies the timeout is based on, in [0, 1]
+  double quantile{0.99};
+  // Ratio of the timeout to the quantile
+  double multiplier{2.0};
+  // Minimum recommended timeout, in ms
+  uint64_t min_timeout{10};
+  // Maximum recommended timeout, in ms
+  uint64_t max_timeout{10000};
+  // Window of the latency samples, in ms
+  uint64_t window{60000};
+  // Number of samples in the window needed to recommend a timeout
+  uint32_t min_samples{100};
+  // Interval of updating the timeout of a method, in ms
+  uint64_t interval{1000};
+
+  // Print information
+  void Display() const;
+};
+
 // Route Select Configuration
 struct SelectorConfig {
   GlobalConfig global_config;
   ConsumerConfig consumer_config;
   DynamicWeightConfig dynamic_weight_config;
+  FailStaticConfig fail_static_config;
+  NegativeCacheConfig negative_cache_config;
+  DeadlineConfig deadline_config;
+  LocalHashConfig local_hash_config;
+  LocalRandomConfig local_random_config;
+  RouteCacheConfig route_cache_config;
+  MetadataIndexConfig metadata_index_config;
+  LocalNearbyConfig local_nearby_config;
+  ZoneAwareConfig zone_aware_config;
+  LatencyLocalityConfig latency_locality_config;
+  ColocationConfig colocation_config;
+  FederationConfig federation_config;
+  SlowStartConfig slow_start_config;
+  LatencyOutlierConfig latency_outlier_config;
+  MethodCircuitBreakerConfig method_circuit_breaker_config;
+  ServiceFailFastConfig service_fail_fast_config;
+  RetryAwareConfig retry_aware_config;
+  HedgingConfig hedging_config;
+  RetryBudgetConfig retry_budget_config;
+  AdaptiveTimeoutConfig adaptive_timeout_config;
 
   // Print information
   void Display() const;
@@ -276,6 +697,10 @@ struct RateLimiterConfig {
   // Report the results of the request to deal with the dynamic threshold adjustment of the polarismesh for the current
   // -limiting rules, and close it by default
   bool update_call_result = false;
+  // Whether to bound the quota query timeout by the remaining deadline of the call, open by default
+  bool enable_deadline = true;
+  // Time reserved for the call itself after the quota query, in ms
+  uint32_t deadline_reserve = 10;
   // Flow limit mode, default is the global mode
   std::string mode = "global";
   // polarismesh Limited Flowing Cluster Configuration
@@ -731,37 +1156,38 @@ struct convert<trpc::naming::DynamicWeightConfig> {
 };
 
 template <>
-struct convert<trpc::naming::SelectorConfig> {
-  static YAML::Node encode(const trpc::naming::SelectorConfig& config) {
+struct convert<trpc::naming::FailStaticConfig> {
+  static YAML::Node encode(const trpc::naming::FailStaticConfig& config) {
     YAML::Node node;
 
-    node["global"] = config.global_config;
-
-    node["consumer"] = config.consumer_config;
-
-    node["dynamic_weight"] = config.dynamic_weight_config;
+    node["enable"] = config.enable;
+    node["maxStaleness"] = config.max_staleness;
+    node["snapshotInterval"] = config.snapshot_interval;
+    node["minBackoff"] = config.min_backoff;
+    node["maxBackoff"] = config.max_backoff;
 
     return node;
   }
 
-  static bool decode(const YAML::Node& node, trpc::naming::SelectorConfig& config) {
-    if (node["global"]) {
-      config.global_config = node["global"].as<trpc::naming::GlobalConfig>();
+  static bool decode(const YAML::Node& node, trpc::naming::FailStaticConfig& config) {
+    if (node["enable"]) {
+      config.enable = node["enable"].as<bool>();
     }
 
-    if (node["consumer"]) {
-      config.consumer_config = node["consumer"].as<trpc::naming::ConsumerConfig>();
+    if (node["maxStaleness"]) {
+      config.max_staleness = node["maxStaleness"].as<uint64_t>();
+    }
 
-      // Compatible with the old configuration, set the service regular refresh cycle
-      if (config.consumer_config.local_cache_config.service_refresh_interval == trpc::naming::kServiceRefreshInterval &&
-          config.global_config.server_connector_config.refresh_interval != trpc::naming::kServiceRefreshInterval) {
-        config.consumer_config.local_cache_config.service_refresh_interval =
-            config.global_config.server_connector_config.refresh_interval;
-      }
+    if (node["snapshotInterval"]) {
+      config.snapshot_interval = node["snapshotInterval"].as<uint64_t>();
     }
 
-    if (node["dynamic_weight"]) {
-      config.dynamic_weight_config = node["dynamic_weight"].as<trpc::naming::DynamicWeightConfig>();
+    if (node["minBackoff"]) {
+      config.min_backoff = node["minBackoff"].as<uint64_t>();
+    }
+
+    if (node["maxBackoff"]) {
+      config.max_backoff = node["maxBackoff"].as<uint64_t>();
     }
 
     return true;
@@ -769,31 +1195,23 @@ struct convert<trpc::naming::SelectorConfig> {
 };
 
 template <>
-struct convert<trpc::naming::RateLimiterConfig> {
-  static YAML::Node encode(const trpc::naming::RateLimiterConfig& config) {
+struct convert<trpc::naming::NegativeCacheConfig> {
+  static YAML::Node encode(const trpc::naming::NegativeCacheConfig& config) {
     YAML::Node node;
-    node["timeout"] = config.timeout;
-    node["updateCallResult"] = config.update_call_result;
-    node["mode"] = config.mode;
-    node["rateLimitCluster"] = config.cluster_config;
-    return node;
-  }
 
-  static bool decode(const YAML::Node& node, trpc::naming::RateLimiterConfig& config) {
-    if (node["timeout"]) {
-      config.timeout = node["timeout"].as<uint32_t>();
-    }
+    node["enable"] = config.enable;
+    node["ttl"] = config.ttl;
 
-    if (node["updateCallResult"]) {
-      config.update_call_result = node["updateCallResult"].as<bool>();
-    }
+    return node;
+  }
 
-    if (node["mode"]) {
-      config.mode = node["mode"].as<std::string>();
+  static bool decode(const YAML::Node& node, trpc::naming::NegativeCacheConfig& config) {
+    if (node["enable"]) {
+      config.enable = node["enable"].as<bool>();
     }
 
-    if (node["rateLimitCluster"]) {
-      config.cluster_config = node["rateLimitCluster"].as<trpc::naming::ServiceClusterConfig>();
+    if (node["ttl"]) {
+      config.ttl = node["ttl"].as<uint64_t>();
     }
 
     return true;
@@ -801,34 +1219,23 @@ struct convert<trpc::naming::RateLimiterConfig> {
 };
 
 template <>
-struct convert<trpc::naming::PolarisMeshNamingConfig> {
-  static YAML::Node encode(const trpc::naming::PolarisMeshNamingConfig& config) {
+struct convert<trpc::naming::DeadlineConfig> {
+  static YAML::Node encode(const trpc::naming::DeadlineConfig& config) {
     YAML::Node node;
 
-    node["registry"][config.name] = config.registry_config;
-
-    node["selector"][config.name] = config.selector_config;
-
-    node["limiter"][config.name] = config.ratelimiter_config;
+    node["enable"] = config.enable;
+    node["reserve"] = config.reserve;
 
     return node;
   }
 
-  static bool decode(const YAML::Node& node, trpc::naming::PolarisMeshNamingConfig& config) {
-    if (node["registry"] && node["registry"][config.name]) {
-      config.registry_config = node["registry"][config.name].as<trpc::naming::RegistryConfig>();
-    }
-
-    if (node["selector"] && node["selector"][config.name]) {
-      config.selector_config = node["selector"][config.name].as<trpc::naming::SelectorConfig>();
-      std::stringstream strstream;
-      strstream << node["selector"][config.name];
-      std::string orig_selector_config = strstream.str();
-      config.orig_selector_config = orig_selector_config;
+  static bool decode(const YAML::Node& node, trpc::naming::DeadlineConfig& config) {
+    if (node["enable"]) {
+      config.enable = node["enable"].as<bool>();
     }
 
-    if (node["limiter"] && node["limiter"][config.name]) {
-      config.ratelimiter_config = node["limiter"][config.name].as<trpc::naming::RateLimiterConfig>();
+    if (node["reserve"]) {
+      config.reserve = node["reserve"].as<uint64_t>();
     }
 
     return true;
@@ -836,39 +1243,38 @@ struct convert<trpc::naming::PolarisMeshNamingConfig> {
 };
 
 template <>
-struct convert<trpc::naming::LoadBalancerConfig> {
-  static YAML::Node encode(const trpc::naming::LoadBalancerConfig& config) {
+struct convert<trpc::naming::LocalHashConfig> {
+  static YAML::Node encode(const trpc::naming::LocalHashConfig& config) {
     YAML::Node node;
-    node["type"] = config.type;
-
-    node["enableDynamicWeight"] = config.enable_dynamic_weight;
-
-    if (config.vnode_count > 0) {
-      node["vnodeCount"] = config.vnode_count;
-    }
 
-    if (config.compatible_golang) {
-      node["compatibleGo"] = config.compatible_golang;
-    }
+    node["enable"] = config.enable;
+    node["type"] = config.type;
+    node["maglevTableSize"] = config.maglev_table_size;
+    node["refreshInterval"] = config.refresh_interval;
+    node["boundedLoadFactor"] = config.bounded_load_factor;
 
     return node;
   }
 
-  static bool decode(const YAML::Node& node, trpc::naming::LoadBalancerConfig& config) {
+  static bool decode(const YAML::Node& node, trpc::naming::LocalHashConfig& config) {
+    if (node["enable"]) {
+      config.enable = node["enable"].as<bool>();
+    }
+
     if (node["type"]) {
       config.type = node["type"].as<std::string>();
     }
 
-    if (node["enableDynamicWeight"]) {
-      config.enable_dynamic_weight = node["enableDynamicWeight"].as<bool>();
+    if (node["maglevTableSize"]) {
+      config.maglev_table_size = node["maglevTableSize"].as<uint32_t>();
     }
 
-    if (node["vnodeCount"]) {
-      config.vnode_count = node["vnodeCount"].as<uint32_t>();
+    if (node["refreshInterval"]) {
+      config.refresh_interval = node["refreshInterval"].as<uint64_t>();
     }
 
-    if (node["compatibleGo"]) {
-      config.compatible_golang = node["compatibleGo"].as<bool>();
+    if (node["boundedLoadFactor"]) {
+      config.bounded_load_factor = node["boundedLoadFactor"].as<double>();
     }
 
     return true;
@@ -876,46 +1282,1020 @@ struct convert<trpc::naming::LoadBalancerConfig> {
 };
 
 template <>
-struct convert<trpc::naming::OutlierDetectionConfig> {
-  static YAML::Node encode(const trpc::naming::OutlierDetectionConfig& config) {
+struct convert<trpc::naming::LocalRandomConfig> {
+  static YAML::Node encode(const trpc::naming::LocalRandomConfig& config) {
     YAML::Node node;
+
     node["enable"] = config.enable;
-    node["checkPeriod"] = config.check_period;
-    node["chain"] = config.chain;
+    node["minInstances"] = config.min_instances;
+    node["refreshInterval"] = config.refresh_interval;
 
     return node;
   }
 
-  static bool decode(const YAML::Node& node, trpc::naming::OutlierDetectionConfig& config) {
+  static bool decode(const YAML::Node& node, trpc::naming::LocalRandomConfig& config) {
     if (node["enable"]) {
       config.enable = node["enable"].as<bool>();
     }
-    if (node["checkPeriod"]) {
-      config.check_period = node["checkPeriod"].as<std::string>();
+
+    if (node["minInstances"]) {
+      config.min_instances = node["minInstances"].as<uint32_t>();
     }
-    if (node["chain"]) {
-      config.chain = node["chain"].as<std::vector<std::string>>();
+
+    if (node["refreshInterval"]) {
+      config.refresh_interval = node["refreshInterval"].as<uint64_t>();
     }
+
     return true;
   }
 };
 
 template <>
-struct convert<trpc::naming::NearbyBasedRouterConfig> {
-  static YAML::Node encode(const trpc::naming::NearbyBasedRouterConfig& config) {
+struct convert<trpc::naming::RouteCacheConfig> {
+  static YAML::Node encode(const trpc::naming::RouteCacheConfig& config) {
     YAML::Node node;
-    node["matchLevel"] = config.match_level;
-    node["maxMatchLevel"] = config.max_match_level;
-    node["strictNearby"] = config.strict_nearby;
-    node["enableDegradeByUnhealthyPercent"] = config.enable_degrade_by_unhealthy_percent;
-    node["unhealthyPercentToDegrade"] = config.unhealthy_percent_to_degrade;
-    node["enableRecoverAll"] = config.enable_recover_all;
+
+    node["enable"] = config.enable;
+    node["maxEntries"] = config.max_entries;
+    node["refreshInterval"] = config.refresh_interval;
+    node["ruleCheckInterval"] = config.rule_check_interval;
+    node["maxThreadRules"] = config.max_thread_rules;
+
     return node;
   }
 
-  static bool decode(const YAML::Node& node, trpc::naming::NearbyBasedRouterConfig& config) {
-    if (node["matchLevel"]) {
-      config.match_level = node["matchLevel"].as<std::string>();
+  static bool decode(const YAML::Node& node, trpc::naming::RouteCacheConfig& config) {
+    if (node["enable"]) {
+      config.enable = node["enable"].as<bool>();
+    }
+
+    if (node["maxEntries"]) {
+      config.max_entries = node["maxEntries"].as<uint32_t>();
+    }
+
+    if (node["refreshInterval"]) {
+      config.refresh_interval = node["refreshInterval"].as<uint64_t>();
+    }
+
+    if (node["ruleCheckInterval"]) {
+      config.rule_check_interval = node["ruleCheckInterval"].as<uint64_t>();
+    }
+
+    if (node["maxThreadRules"]) {
+      config.max_thread_rules = node["maxThreadRules"].as<uint32_t>();
+    }
+
+    return true;
+  }
+};
+
+template <>
+struct convert<trpc::naming::MetadataIndexConfig> {
+  static YAML::Node encode(const trpc::naming::MetadataIndexConfig& config) {
+    YAML::Node node;
+
+    node["enable"] = config.enable;
+    node["maxFilters"] = config.max_filters;
+
+    return node;
+  }
+
+  static bool decode(const YAML::Node& node, trpc::naming::MetadataIndexConfig& config) {
+    if (node["enable"]) {
+      config.enable = node["enable"].as<bool>();
+    }
+
+    if (node["maxFilters"]) {
+      config.max_filters = node["maxFilters"].as<uint32_t>();
+    }
+
+    return true;
+  }
+};
+
+template <>
+struct convert<trpc::naming::LocalNearbyConfig> {
+  static YAML::Node encode(const trpc::naming::LocalNearbyConfig& config) {
+    YAML::Node node;
+
+    node["enable"] = config.enable;
+
+    return node;
+  }
+
+  static bool decode(const YAML::Node& node, trpc::naming::LocalNearbyConfig& config) {
+    if (node["enable"]) {
+      config.enable = node["enable"].as<bool>();
+    }
+
+    return true;
+  }
+};
+
+template <>
+struct convert<trpc::naming::ZoneAwareConfig> {
+  static YAML::Node encode(const trpc::naming::ZoneAwareConfig& config) {
+    YAML::Node node;
+
+    node["enable"] = config.enable;
+    node["minClusterSize"] = config.min_cluster_size;
+    node["refreshInterval"] = config.refresh_interval;
+
+    return node;
+  }
+
+  static bool decode(const YAML::Node& node, trpc::naming::ZoneAwareConfig& config) {
+    if (node["enable"]) {
+      config.enable = node["enable"].as<bool>();
+    }
+
+    if (node["minClusterSize"]) {
+      config.min_cluster_size = node["minClusterSize"].as<uint32_t>();
+    }
+
+    if (node["refreshInterval"]) {
+      config.refresh_interval = node["refreshInterval"].as<uint64_t>();
+    }
+
+    return true;
+  }
+};
+
+template <>
+struct convert<trpc::naming::LatencyLocalityConfig> {
+  static YAML::Node encode(const trpc::naming::LatencyLocalityConfig& config) {
+    YAML::Node node;
+
+    node["enable"] = config.enable;
+    node["decay"] = config.decay;
+    node["minSamples"] = config.min_samples;
+    node["expireTime"] = config.expire_time;
+    node["rankInterval"] = config.rank_interval;
+
+    return node;
+  }
+
+  static bool decode(const YAML::Node& node, trpc::naming::LatencyLocalityConfig& config) {
+    if (node["enable"]) {
+      config.enable = node["enable"].as<bool>();
+    }
+
+    if (node["decay"]) {
+      config.decay = node["decay"].as<double>();
+    }
+
+    if (node["minSamples"]) {
+      config.min_samples = node["minSamples"].as<uint32_t>();
+    }
+
+    if (node["expireTime"]) {
+      config.expire_time = node["expireTime"].as<uint64_t>();
+    }
+
+    if (node["rankInterval"]) {
+      config.rank_interval = node["rankInterval"].as<uint64_t>();
+    }
+
+    return true;
+  }
+};
+
+template <>
+struct convert<trpc::naming::ColocationConfig> {
+  static YAML::Node encode(const trpc::naming::ColocationConfig& config) {
+    YAML::Node node;
+
+    node["enable"] = config.enable;
+    node["hostId"] = config.host_id;
+    node["maxLocalPercent"] = config.max_local_percent;
+    node["useUds"] = config.use_uds;
+
+    return node;
+  }
+
+  static bool decode(const YAML::Node& node, trpc::naming::ColocationConfig& config) {
+    if (node["enable"]) {
+      config.enable = node["enable"].as<bool>();
+    }
+
+    if (node["hostId"]) {
+      config.host_id = node["hostId"].as<std::string>();
+    }
+
+    if (node["maxLocalPercent"]) {
+      config.max_local_percent = node["maxLocalPercent"].as<uint32_t>();
+    }
+
+    if (node["useUds"]) {
+      config.use_uds = node["useUds"].as<bool>();
+    }
+
+    return true;
+  }
+};
+
+template <>
+struct convert<trpc::naming::FederationClusterConfig> {
+  static YAML::Node encode(const trpc::naming::FederationClusterConfig& config) {
+    YAML::Node node;
+
+    node["name"] = config.name;
+    node["addresses"] = config.addresses;
+    if (!config.join_point.empty()) {
+      node["joinPoint"] = config.join_point;
+    }
+
+    return node;
+  }
+
+  static bool decode(const YAML::Node& node, trpc::naming::FederationClusterConfig& config) {
+    if (node["name"]) {
+      config.name = node["name"].as<std::string>();
+    }
+
+    if (node["addresses"]) {
+      config.addresses = node["addresses"].as<std::vector<std::string>>();
+    }
+
+    if (node["joinPoint"]) {
+      config.join_point = node["joinPoint"].as<std::string>();
+    }
+
+    return true;
+  }
+};
+
+template <>
+struct convert<trpc::naming::FederationConfig> {
+  static YAML::Node encode(const trpc::naming::FederationConfig& config) {
+    YAML::Node node;
+
+    node["enable"] = config.enable;
+    node["clusters"] = config.clusters;
+    node["overprovisioningFactor"] = config.overprovisioning_factor;
+    node["refreshInterval"] = config.refresh_interval;
+
+    return node;
+  }
+
+  static bool decode(const YAML::Node& node, trpc::naming::FederationConfig& config) {
+    if (node["enable"]) {
+      config.enable = node["enable"].as<bool>();
+    }
+
+    if (node["clusters"]) {
+      config.clusters = node["clusters"].as<std::vector<trpc::naming::FederationClusterConfig>>();
+    }
+
+    if (node["overprovisioningFactor"]) {
+      config.overprovisioning_factor = node["overprovisioningFactor"].as<uint32_t>();
+    }
+
+    if (node["refreshInterval"]) {
+      config.refresh_interval = node["refreshInterval"].as<uint64_t>();
+    }
+
+    return true;
+  }
+};
+
+template <>
+struct convert<trpc::naming::SlowStartConfig> {
+  static YAML::Node encode(const trpc::naming::SlowStartConfig& config) {
+    YAML::Node node;
+
+    node["enable"] = config.enable;
+    node["window"] = config.window;
+    node["curve"] = config.curve;
+    node["aggression"] = config.aggression;
+    node["minWeightPercent"] = config.min_weight_percent;
+
+    return node;
+  }
+
+  static bool decode(const YAML::Node& node, trpc::naming::SlowStartConfig& config) {
+    if (node["enable"]) {
+      config.enable = node["enable"].as<bool>();
+    }
+
+    if (node["window"]) {
+      config.window = node["window"].as<uint64_t>();
+    }
+
+    if (node["curve"]) {
+      config.curve = node["curve"].as<std::string>();
+    }
+
+    if (node["aggression"]) {
+      config.aggression = node["aggression"].as<double>();
+    }
+
+    if (node["minWeightPercent"]) {
+      config.min_weight_percent = node["minWeightPercent"].as<uint32_t>();
+    }
+
+    return true;
+  }
+};
+
+template <>
+struct convert<trpc::naming::LatencyOutlierConfig> {
+  static YAML::Node encode(const trpc::naming::LatencyOutlierConfig& config) {
+    YAML::Node node;
+
+    node["enable"] = config.enable;
+    node["window"] = config.window;
+    node["quantile"] = config.quantile;
+    node["ratio"] = config.ratio;
+    node["minLatency"] = config.min_latency;
+    node["minSamples"] = config.min_samples;
+    node["minHosts"] = config.min_hosts;
+    node["baseEjectionTime"] = config.base_ejection_time;
+    node["maxEjectionTime"] = config.max_ejection_time;
+    node["maxEjectionPercent"] = config.max_ejection_percent;
+    node["interval"] = config.interval;
+
+    return node;
+  }
+
+  static bool decode(const YAML::Node& node, trpc::naming::LatencyOutlierConfig& config) {
+    if (node["enable"]) {
+      config.enable = node["enable"].as<bool>();
+    }
+
+    if (node["window"]) {
+      config.window = node["window"].as<uint64_t>();
+    }
+
+    if (node["quantile"]) {
+      config.quantile = node["quantile"].as<double>();
+    }
+
+    if (node["ratio"]) {
+      config.ratio = node["ratio"].as<double>();
+    }
+
+    if (node["minLatency"]) {
+      config.min_latency = node["minLatency"].as<uint64_t>();
+    }
+
+    if (node["minSamples"]) {
+      config.min_samples = node["minSamples"].as<uint32_t>();
+    }
+
+    if (node["minHosts"]) {
+      config.min_hosts = node["minHosts"].as<uint32_t>();
+    }
+
+    if (node["baseEjectionTime"]) {
+      config.base_ejection_time = node["baseEjectionTime"].as<uint64_t>();
+    }
+
+    if (node["maxEjectionTime"]) {
+      config.max_ejection_time = node["maxEjectionTime"].as<uint64_t>();
+    }
+
+    if (node["maxEjectionPercent"]) {
+      config.max_ejection_percent = node["maxEjectionPercent"].as<uint32_t>();
+    }
+
+    if (node["interval"]) {
+      config.interval = node["interval"].as<uint64_t>();
+    }
+
+    return true;
+  }
+};
+
+template <>
+struct convert<trpc::naming::MethodCircuitBreakerConfig> {
+  static YAML::Node encode(const trpc::naming::MethodCircuitBreakerConfig& config) {
+    YAML::Node node;
+
+    node["enable"] = config.enable;
+    node["window"] = config.window;
+    node["bucketNum"] = config.bucket_num;
+    node["minRequests"] = config.min_requests;
+    node["errorRatePercent"] = config.error_rate_percent;
+    node["sleepWindow"] = config.sleep_window;
+    node["successToClose"] = config.success_to_close;
+
+    return node;
+  }
+
+  static bool decode(const YAML::Node& node, trpc::naming::MethodCircuitBreakerConfig& config) {
+    if (node["enable"]) {
+      config.enable = node["enable"].as<bool>();
+    }
+
+    if (node["window"]) {
+      config.window = node["window"].as<uint64_t>();
+    }
+
+    if (node["bucketNum"]) {
+      config.bucket_num = node["bucketNum"].as<uint32_t>();
+    }
+
+    if (node["minRequests"]) {
+      config.min_requests = node["minRequests"].as<uint32_t>();
+    }
+
+    if (node["errorRatePercent"]) {
+      config.error_rate_percent = node["errorRatePercent"].as<uint32_t>();
+    }
+
+    if (node["sleepWindow"]) {
+      config.sleep_window = node["sleepWindow"].as<uint64_t>();
+    }
+
+    if (node["successToClose"]) {
+      config.success_to_close = node["successToClose"].as<uint32_t>();
+    }
+
+    return true;
+  }
+};
+
+template <>
+struct convert<trpc::naming::ServiceFailFastConfig> {
+  static YAML::Node encode(const trpc::naming::ServiceFailFastConfig& config) {
+    YAML::Node node;
+
+    node["enable"] = config.enable;
+    node["brokenPercent"] = config.broken_percent;
+    node["rejectPercent"] = config.reject_percent;
+    node["window"] = config.window;
+    node["minRequests"] = config.min_requests;
+    node["errorRatePercent"] = config.error_rate_percent;
+    node["sleepWindow"] = config.sleep_window;
+
+    return node;
+  }
+
+  static bool decode(const YAML::Node& node, trpc::naming::ServiceFailFastConfig& config) {
+    if (node["enable"]) {
+      config.enable = node["enable"].as<bool>();
+    }
+
+    if (node["brokenPercent"]) {
+      config.broken_percent = node["brokenPercent"].as<uint32_t>();
+    }
+
+    if (node["rejectPercent"]) {
+      config.reject_percent = node["rejectPercent"].as<uint32_t>();
+    }
+
+    if (node["window"]) {
+      config.window = node["window"].as<uint64_t>();
+    }
+
+    if (node["minRequests"]) {
+      config.min_requests = node["minRequests"].as<uint32_t>();
+    }
+
+    if (node["errorRatePercent"]) {
+      config.error_rate_percent = node["errorRatePercent"].as<uint32_t>();
+    }
+
+    if (node["sleepWindow"]) {
+      config.sleep_window = node["sleepWindow"].as<uint64_t>();
+    }
+
+    return true;
+  }
+};
+
+template <>
+struct convert<trpc::naming::RetryAwareConfig> {
+  static YAML::Node encode(const trpc::naming::RetryAwareConfig& config) {
+    YAML::Node node;
+
+    node["enable"] = config.enable;
+    node["maxTried"] = config.max_tried;
+
+    return node;
+  }
+
+  static bool decode(const YAML::Node& node, trpc::naming::RetryAwareConfig& config) {
+    if (node["enable"]) {
+      config.enable = node["enable"].as<bool>();
+    }
+
+    if (node["maxTried"]) {
+      config.max_tried = node["maxTried"].as<uint32_t>();
+    }
+
+    return true;
+  }
+};
+
+template <>
+struct convert<trpc::naming::HedgingConfig> {
+  static YAML::Node encode(const trpc::naming::HedgingConfig& config) {
+    YAML::Node node;
+
+    node["enable"] = config.enable;
+    node["quantile"] = config.quantile;
+    node["window"] = config.window;
+    node["minSamples"] = config.min_samples;
+    node["minDelay"] = config.min_delay;
+    node["budgetPercent"] = config.budget_percent;
+    node["interval"] = config.interval;
+
+    return node;
+  }
+
+  static bool decode(const YAML::Node& node, trpc::naming::HedgingConfig& config) {
+    if (node["enable"]) {
+      config.enable = node["enable"].as<bool>();
+    }
+
+    if (node["quantile"]) {
+      config.quantile = node["quantile"].as<double>();
+    }
+
+    if (node["window"]) {
+      config.window = node["window"].as<uint64_t>();
+    }
+
+    if (node["minSamples"]) {
+      config.min_samples = node["minSamples"].as<uint32_t>();
+    }
+
+    if (node["minDelay"]) {
+      config.min_delay = node["minDelay"].as<uint64_t>();
+    }
+
+    if (node["budgetPercent"]) {
+      config.budget_percent = node["budgetPercent"].as<uint32_t>();
+    }
+
+    if (node["interval"]) {
+      config.interval = node["interval"].as<uint64_t>();
+    }
+
+    return true;
+  }
+};
+
+template <>
+struct convert<trpc::naming::RetryBudgetConfig> {
+  static YAML::Node encode(const trpc::naming::RetryBudgetConfig& config) {
+    YAML::Node node;
+
+    node["enable"] = config.enable;
+    node["ratioPercent"] = config.ratio_percent;
+    node["maxTokens"] = config.max_tokens;
+    node["minHealthyPercent"] = config.min_healthy_percent;
+    node["window"] = config.window;
+    node["minRequests"] = config.min_requests;
+    node["errorRatePercent"] = config.error_rate_percent;
+    node["sleepWindow"] = config.sleep_window;
+
+    return node;
+  }
+
+  static bool decode(const YAML::Node& node, trpc::naming::RetryBudgetConfig& config) {
+    if (node["enable"]) {
+      config.enable = node["enable"].as<bool>();
+    }
+
+    if (node["ratioPercent"]) {
+      config.ratio_percent = node["ratioPercent"].as<uint32_t>();
+    }
+
+    if (node["maxTokens"]) {
+      config.max_tokens = node["maxTokens"].as<uint32_t>();
+    }
+
+    if (node["minHealthyPercent"]) {
+      config.min_healthy_percent = node["minHealthyPercent"].as<uint32_t>();
+    }
+
+    if (node["window"]) {
+      config.window = node["window"].as<uint64_t>();
+    }
+
+    if (node["minRequests"]) {
+      config.min_requests = node["minRequests"].as<uint32_t>();
+    }
+
+    if (node["errorRatePercent"]) {
+      config.error_rate_percent = node["errorRatePercent"].as<uint32_t>();
+    }
+
+    if (node["sleepWindow"]) {
+      config.sleep_window = node["sleepWindow"].as<uint64_t>();
+    }
+
+    return true;
+  }
+};
+
+template <>
+struct convert<trpc::naming::AdaptiveTimeoutConfig> {
+  static YAML::Node encode(const trpc::naming::AdaptiveTimeoutConfig& config) {
+    YAML::Node node;
+
+    node["enable"] = config.enable;
+    node["apply"] = config.apply;
+    node["quantile"] = config.quantile;
+    node["multiplier"] = config.multiplier;
+    node["minTimeout"] = config.min_timeout;
+    node["maxTimeout"] = config.max_timeout;
+    node["window"] = config.window;
+    node["minSamples"] = config.min_samples;
+    node["interval"] = config.interval;
+
+    return node;
+  }
+
+  static bool decode(const YAML::Node& node, trpc::naming::AdaptiveTimeoutConfig& config) {
+    if (node["enable"]) {
+      config.enable = node["enable"].as<bool>();
+    }
+
+    if (node["apply"]) {
+      config.apply = node["apply"].as<bool>();
+    }
+
+    if (node["quantile"]) {
+      config.quantile = node["quantile"].as<double>();
+    }
+
+    if (node["multiplier"]) {
+      config.multiplier = node["multiplier"].as<double>();
+    }
+
+    if (node["minTimeout"]) {
+      config.min_timeout = node["minTimeout"].as<uint64_t>();
+    }
+
+    if (node["maxTimeout"]) {
+      config.max_timeout = node["maxTimeout"].as<uint64_t>();
+    }
+
+    if (node["window"]) {
+      config.window = node["window"].as<uint64_t>();
+    }
+
+    if (node["minSamples"]) {
+      config.min_samples = node["minSamples"].as<uint32_t>();
+    }
+
+    if (node["interval"]) {
+      config.interval = node["interval"].as<uint64_t>();
+    }
+
+    return true;
+  }
+};
+
+template <>
+struct convert<trpc::naming::SelectorConfig> {
+  static YAML::Node encode(const trpc::naming::SelectorConfig& config) {
+    YAML::Node node;
+
+    node["global"] = config.global_config;
+
+    node["consumer"] = config.consumer_config;
+
+    node["dynamic_weight"] = config.dynamic_weight_config;
+
+    node["fail_static"] = config.fail_static_config;
+
+    node["negative_cache"] = config.negative_cache_config;
+
+    node["deadline"] = config.deadline_config;
+
+    node["local_hash"] = config.local_hash_config;
+
+    node["local_random"] = config.local_random_config;
+
+    node["route_cache"] = config.route_cache_config;
+
+    node["metadata_index"] = config.metadata_index_config;
+
+    node["local_nearby"] = config.local_nearby_config;
+
+    node["zone_aware"] = config.zone_aware_config;
+
+    node["latency_locality"] = config.latency_locality_config;
+
+    node["colocation"] = config.colocation_config;
+
+    node["federation"] = config.federation_config;
+
+    node["slow_start"] = config.slow_start_config;
+
+    node["latency_outlier"] = config.latency_outlier_config;
+
+    node["method_circuit_breaker"] = config.method_circuit_breaker_config;
+
+    node["service_fail_fast"] = config.service_fail_fast_config;
+
+    node["retry_aware"] = config.retry_aware_config;
+
+    node["hedging"] = config.hedging_config;
+
+    node["retry_budget"] = config.retry_budget_config;
+
+    node["adaptive_timeout"] = config.adaptive_timeout_config;
+
+    return node;
+  }
+
+  static bool decode(const YAML::Node& node, trpc::naming::SelectorConfig& config) {
+    if (node["global"]) {
+      config.global_config = node["global"].as<trpc::naming::GlobalConfig>();
+    }
+
+    if (node["consumer"]) {
+      config.consumer_config = node["consumer"].as<trpc::naming::ConsumerConfig>();
+
+      // Compatible with the old configuration, set the service regular refresh cycle
+      if (config.consumer_config.local_cache_config.service_refresh_interval == trpc::naming::kServiceRefreshInterval &&
+          config.global_config.server_connector_config.refresh_interval != trpc::naming::kServiceRefreshInterval) {
+        config.consumer_config.local_cache_config.service_refresh_interval =
+            config.global_config.server_connector_config.refresh_interval;
+      }
+    }
+
+    if (node["dynamic_weight"]) {
+      config.dynamic_weight_config = node["dynamic_weight"].as<trpc::naming::DynamicWeightConfig>();
+    }
+
+    if (node["fail_static"]) {
+      config.fail_static_config = node["fail_static"].as<trpc::naming::FailStaticConfig>();
+    }
+
+    if (node["negative_cache"]) {
+      config.negative_cache_config = node["negative_cache"].as<trpc::naming::NegativeCacheConfig>();
+    }
+
+    if (node["deadline"]) {
+      config.deadline_config = node["deadline"].as<trpc::naming::DeadlineConfig>();
+    }
+
+    if (node["local_hash"]) {
+      config.local_hash_config = node["local_hash"].as<trpc::naming::LocalHashConfig>();
+    }
+
+    if (node["local_random"]) {
+      config.local_random_config = node["local_random"].as<trpc::naming::LocalRandomConfig>();
+    }
+
+    if (node["route_cache"]) {
+      config.route_cache_config = node["route_cache"].as<trpc::naming::RouteCacheConfig>();
+    }
+
+    if (node["metadata_index"]) {
+      config.metadata_index_config = node["metadata_index"].as<trpc::naming::MetadataIndexConfig>();
+    }
+
+    if (node["local_nearby"]) {
+      config.local_nearby_config = node["local_nearby"].as<trpc::naming::LocalNearbyConfig>();
+    }
+
+    if (node["zone_aware"]) {
+      config.zone_aware_config = node["zone_aware"].as<trpc::naming::ZoneAwareConfig>();
+    }
+
+    if (node["latency_locality"]) {
+      config.latency_locality_config = node["latency_locality"].as<trpc::naming::LatencyLocalityConfig>();
+    }
+
+    if (node["colocation"]) {
+      config.colocation_config = node["colocation"].as<trpc::naming::ColocationConfig>();
+    }
+
+    if (node["federation"]) {
+      config.federation_config = node["federation"].as<trpc::naming::FederationConfig>();
+    }
+
+    if (node["slow_start"]) {
+      config.slow_start_config = node["slow_start"].as<trpc::naming::SlowStartConfig>();
+    }
+
+    if (node["latency_outlier"]) {
+      config.latency_outlier_config = node["latency_outlier"].as<trpc::naming::LatencyOutlierConfig>();
+    }
+
+    if (node["method_circuit_breaker"]) {
+      config.method_circuit_breaker_config =
+          node["method_circuit_breaker"].as<trpc::naming::MethodCircuitBreakerConfig>();
+    }
+
+    if (node["service_fail_fast"]) {
+      config.service_fail_fast_config = node["service_fail_fast"].as<trpc::naming::ServiceFailFastConfig>();
+    }
+
+    if (node["retry_aware"]) {
+      config.retry_aware_config = node["retry_aware"].as<trpc::naming::RetryAwareConfig>();
+    }
+
+    if (node["hedging"]) {
+      config.hedging_config = node["hedging"].as<trpc::naming::HedgingConfig>();
+    }
+
+    if (node["retry_budget"]) {
+      config.retry_budget_config = node["retry_budget"].as<trpc::naming::RetryBudgetConfig>();
+    }
+
+    if (node["adaptive_timeout"]) {
+      config.adaptive_timeout_config = node["adaptive_timeout"].as<trpc::naming::AdaptiveTimeoutConfig>();
+    }
+
+    return true;
+  }
+};
+
+template <>
+struct convert<trpc::naming::RateLimiterConfig> {
+  static YAML::Node encode(const trpc::naming::RateLimiterConfig& config) {
+    YAML::Node node;
+    node["timeout"] = config.timeout;
+    node["updateCallResult"] = config.update_call_result;
+    node["enableDeadline"] = config.enable_deadline;
+    node["deadlineReserve"] = config.deadline_reserve;
+    node["mode"] = config.mode;
+    node["rateLimitCluster"] = config.cluster_config;
+    return node;
+  }
+
+  static bool decode(const YAML::Node& node, trpc::naming::RateLimiterConfig& config) {
+    if (node["timeout"]) {
+      config.timeout = node["timeout"].as<uint32_t>();
+    }
+
+    if (node["updateCallResult"]) {
+      config.update_call_result = node["updateCallResult"].as<bool>();
+    }
+
+    if (node["enableDeadline"]) {
+      config.enable_deadline = node["enableDeadline"].as<bool>();
+    }
+
+    if (node["deadlineReserve"]) {
+      config.deadline_reserve = node["deadlineReserve"].as<uint32_t>();
+    }
+
+    if (node["mode"]) {
+      config.mode = node["mode"].as<std::string>();
+    }
+
+    if (node["rateLimitCluster"]) {
+      config.cluster_config = node["rateLimitCluster"].as<trpc::naming::ServiceClusterConfig>();
+    }
+
+    return true;
+  }
+};
+
+template <>
+struct convert<trpc::naming::PolarisMeshNamingConfig> {
+  static YAML::Node encode(const trpc::naming::PolarisMeshNamingConfig& config) {
+    YAML::Node node;
+
+    node["registry"][config.name] = config.registry_config;
+
+    node["selector"][config.name] = config.selector_config;
+
+    node["limiter"][config.name] = config.ratelimiter_config;
+
+    return node;
+  }
+
+  static bool decode(const YAML::Node& node, trpc::naming::PolarisMeshNamingConfig& config) {
+    if (node["registry"] && node["registry"][config.name]) {
+      config.registry_config = node["registry"][config.name].as<trpc::naming::RegistryConfig>();
+    }
+
+    if (node["selector"] && node["selector"][config.name]) {
+      config.selector_config = node["selector"][config.name].as<trpc::naming::SelectorConfig>();
+      std::stringstream strstream;
+      strstream << node["selector"][config.name];
+      std::string orig_selector_config = strstream.str();
+      config.orig_selector_config = orig_selector_config;
+    }
+
+    if (node["limiter"] && node["limiter"][config.name]) {
+      config.ratelimiter_config = node["limiter"][config.name].as<trpc::naming::RateLimiterConfig>();
+    }
+
+    return true;
+  }
+};
+
+template <>
+struct convert<trpc::naming::LoadBalancerConfig> {
+  static YAML::Node encode(const trpc::naming::LoadBalancerConfig& config) {
+    YAML::Node node;
+    node["type"] = config.type;
+
+    node["enableDynamicWeight"] = config.enable_dynamic_weight;
+
+    if (config.vnode_count > 0) {
+      node["vnodeCount"] = config.vnode_count;
+    }
+
+    if (config.compatible_golang) {
+      node["compatibleGo"] = config.compatible_golang;
+    }
+
+    return node;
+  }
+
+  static bool decode(const YAML::Node& node, trpc::naming::LoadBalancerConfig& config) {
+    if (node["type"]) {
+      config.type = node["type"].as<std::string>();
+    }
+
+    if (node["enableDynamicWeight"]) {
+      config.enable_dynamic_weight = node["enableDynamicWeight"].as<bool>();
+    }
+
+    if (node["vnodeCount"]) {
+      config.vnode_count = node["vnodeCount"].as<uint32_t>();
+    }
+
+    if (node["compatibleGo"]) {
+      config.compatible_golang = node["compatibleGo"].as<bool>();
+    }
+
+    return true;
+  }
+};
+
+template <>
+struct convert<trpc::naming::TrpcOutlierDetectionConfig> {
+  static YAML::Node encode(const trpc::naming::TrpcOutlierDetectionConfig& config) {
+    YAML::Node node;
+    node["func_name"] = config.func_name;
+    node["timeout"] = config.timeout;
+    node["protocol"] = config.protocol;
+    return node;
+  }
+
+  static bool decode(const YAML::Node& node, trpc::naming::TrpcOutlierDetectionConfig& config) {
+    if (node["func_name"]) {
+      config.func_name = node["func_name"].as<std::string>();
+    }
+    if (node["timeout"]) {
+      config.timeout = node["timeout"].as<std::string>();
+    }
+    if (node["protocol"]) {
+      config.protocol = node["protocol"].as<std::string>();
+    }
+    return true;
+  }
+};
+
+template <>
+struct convert<trpc::naming::OutlierDetectionConfig> {
+  static YAML::Node encode(const trpc::naming::OutlierDetectionConfig& config) {
+    YAML::Node node;
+    node["enable"] = config.enable;
+    node["checkPeriod"] = config.check_period;
+    node["chain"] = config.chain;
+    node["plugin"]["trpc"] = config.trpc_config;
+
+    return node;
+  }
+
+  static bool decode(const YAML::Node& node, trpc::naming::OutlierDetectionConfig& config) {
+    if (node["enable"]) {
+      config.enable = node["enable"].as<bool>();
+    }
+    if (node["checkPeriod"]) {
+      config.check_period = node["checkPeriod"].as<std::string>();
+    }
+    if (node["chain"]) {
+      config.chain = node["chain"].as<std::vector<std::string>>();
+    }
+    if (node["plugin"] && node["plugin"]["trpc"]) {
+      config.trpc_config = node["plugin"]["trpc"].as<trpc::naming::TrpcOutlierDetectionConfig>();
+    }
+    return true;
+  }
+};
+
+template <>
+struct convert<trpc::naming::NearbyBasedRouterConfig> {
+  static YAML::Node encode(const trpc::naming::NearbyBasedRouterConfig& config) {
+    YAML::Node node;
+    node["matchLevel"] = config.match_level;
+    node["maxMatchLevel"] = config.max_match_level;
+    node["strictNearby"] = config.strict_nearby;
+    node["enableDegradeByUnhealthyPercent"] = config.enable_degrade_by_unhealthy_percent;
+    node["unhealthyPercentToDegrade"] = config.unhealthy_percent_to_degrade;
+    node["enableRecoverAll"] = config.enable_recover_all;
+    return node;
+  }
+
+  static bool decode(const YAML::Node& node, trpc::naming::NearbyBasedRouterConfig& config) {
+    if (node["matchLevel"]) {
+      config.match_level = node["matchLevel"].as<std::string>();
     }
     if (node["maxMatchLevel"]) {
       config.max_match_level = node["maxMatchLevel"].as<std::string>();
@@ -1081,6 +2461,13 @@ struct convert<trpc::naming::SetCircuitBreakerConfig> {
   static YAML::Node encode(const trpc::naming::SetCircuitBreakerConfig& config) {
     YAML::Node node;
     node["enable"] = config.enable;
+    node["window"] = config.window;
+    node["minRequests"] = config.min_requests;
+    node["errorRatePercent"] = config.error_rate_percent;
+    node["slowCall"] = config.slow_call;
+    node["slowRatePercent"] = config.slow_rate_percent;
+    node["sleepWindow"] = config.sleep_window;
+    node["successToClose"] = config.success_to_close;
     return node;
   }
 
@@ -1089,6 +2476,34 @@ struct convert<trpc::naming::SetCircuitBreakerConfig> {
       config.enable = node["enable"].as<bool>();
     }
 
+    if (node["window"]) {
+      config.window = node["window"].as<uint64_t>();
+    }
+
+    if (node["minRequests"]) {
+      config.min_requests = node["minRequests"].as<uint32_t>();
+    }
+
+    if (node["errorRatePercent"]) {
+      config.error_rate_percent = node["errorRatePercent"].as<uint32_t>();
+    }
+
+    if (node["slowCall"]) {
+      config.slow_call = node["slowCall"].as<uint64_t>();
+    }
+
+    if (node["slowRatePercent"]) {
+      config.slow_rate_percent = node["slowRatePercent"].as<uint32_t>();
+    }
+
+    if (node["sleepWindow"]) {
+      config.sleep_window = node["sleepWindow"].as<uint64_t>();
+    }
+
+    if (node["successToClose"]) {
+      config.success_to_close = node["successToClose"].as<uint32_t>();
+    }
+
     return true;
   }
 };
@@ -174,4 +174,497 @@ TEST(ConsumerConfig, service_consumer_config_test) {
   ASSERT_EQ(default_service_consumer_config.set_service_router, false);
 }
 
+TEST(FailStaticConfig, fail_static_config_test) {
+  trpc::naming::FailStaticConfig fail_static_config;
+  fail_static_config.enable = true;
+  fail_static_config.max_staleness = 60000;
+  fail_static_config.snapshot_interval = 5000;
+  fail_static_config.min_backoff = 500;
+  fail_static_config.max_backoff = 8000;
+
+  YAML::convert<trpc::naming::FailStaticConfig> c;
+  YAML::Node config_node = c.encode(fail_static_config);
+
+  trpc::naming::FailStaticConfig tmp;
+  ASSERT_TRUE(c.decode(config_node, tmp));
+
+  tmp.Display();
+  ASSERT_EQ(fail_static_config.enable, tmp.enable);
+  ASSERT_EQ(fail_static_config.max_staleness, tmp.max_staleness);
+  ASSERT_EQ(fail_static_config.snapshot_interval, tmp.snapshot_interval);
+  ASSERT_EQ(fail_static_config.min_backoff, tmp.min_backoff);
+  ASSERT_EQ(fail_static_config.max_backoff, tmp.max_backoff);
+}
+
+TEST(NegativeCacheConfig, negative_cache_config_test) {
+  trpc::naming::NegativeCacheConfig negative_cache_config;
+  negative_cache_config.enable = true;
+  negative_cache_config.ttl = 2000;
+
+  YAML::convert<trpc::naming::SelectorConfig> c;
+  trpc::naming::SelectorConfig selector_config;
+  selector_config.negative_cache_config = negative_cache_config;
+  YAML::Node config_node = c.encode(selector_config);
+
+  trpc::naming::SelectorConfig tmp;
+  ASSERT_TRUE(c.decode(config_node, tmp));
+
+  tmp.negative_cache_config.Display();
+  ASSERT_EQ(negative_cache_config.enable, tmp.negative_cache_config.enable);
+  ASSERT_EQ(negative_cache_config.ttl, tmp.negative_cache_config.ttl);
+}
+
+TEST(LocalHashConfig, local_hash_config_test) {
+  trpc::naming::LocalHashConfig local_hash_config;
+  local_hash_config.enable = true;
+  local_hash_config.type = "maglev";
+  local_hash_config.maglev_table_size = 1031;
+  local_hash_config.refresh_interval = 500;
+  local_hash_config.bounded_load_factor = 1.25;
+
+  YAML::convert<trpc::naming::LocalHashConfig> c;
+  YAML::Node config_node = c.encode(local_hash_config);
+
+  trpc::naming::LocalHashConfig tmp;
+  ASSERT_TRUE(c.decode(config_node, tmp));
+
+  tmp.Display();
+  ASSERT_EQ(local_hash_config.enable, tmp.enable);
+  ASSERT_EQ(local_hash_config.type, tmp.type);
+  ASSERT_EQ(local_hash_config.maglev_table_size, tmp.maglev_table_size);
+  ASSERT_EQ(local_hash_config.refresh_interval, tmp.refresh_interval);
+  ASSERT_DOUBLE_EQ(local_hash_config.bounded_load_factor, tmp.bounded_load_factor);
+}
+
+TEST(LocalRandomConfig, local_random_config_test) {
+  trpc::naming::SelectorConfig selector_config;
+  selector_config.local_random_config.enable = true;
+  selector_config.local_random_config.min_instances = 16;
+  selector_config.local_random_config.refresh_interval = 200;
+
+  YAML::convert<trpc::naming::SelectorConfig> c;
+  YAML::Node config_node = c.encode(selector_config);
+
+  trpc::naming::SelectorConfig tmp;
+  ASSERT_TRUE(c.decode(config_node, tmp));
+
+  tmp.local_random_config.Display();
+  ASSERT_EQ(selector_config.local_random_config.enable, tmp.local_random_config.enable);
+  ASSERT_EQ(selector_config.local_random_config.min_instances, tmp.local_random_config.min_instances);
+  ASSERT_EQ(selector_config.local_random_config.refresh_interval, tmp.local_random_config.refresh_interval);
+}
+
+TEST(RouteCacheConfig, route_cache_config_test) {
+  trpc::naming::RouteCacheConfig route_cache_config;
+  route_cache_config.enable = true;
+  route_cache_config.max_entries = 100;
+  route_cache_config.refresh_interval = 5000;
+  route_cache_config.rule_check_interval = 200;
+  route_cache_config.max_thread_rules = 16;
+
+  YAML::convert<trpc::naming::RouteCacheConfig> c;
+  YAML::Node config_node = c.encode(route_cache_config);
+
+  trpc::naming::RouteCacheConfig tmp;
+  ASSERT_TRUE(c.decode(config_node, tmp));
+
+  tmp.Display();
+  ASSERT_EQ(route_cache_config.enable, tmp.enable);
+  ASSERT_EQ(route_cache_config.max_entries, tmp.max_entries);
+  ASSERT_EQ(route_cache_config.refresh_interval, tmp.refresh_interval);
+  ASSERT_EQ(route_cache_config.rule_check_interval, tmp.rule_check_interval);
+  ASSERT_EQ(route_cache_config.max_thread_rules, tmp.max_thread_rules);
+}
+
+TEST(MetadataIndexConfig, metadata_index_config_test) {
+  trpc::naming::MetadataIndexConfig metadata_index_config;
+  metadata_index_config.enable = true;
+  metadata_index_config.max_filters = 32;
+
+  YAML::convert<trpc::naming::MetadataIndexConfig> c;
+  YAML::Node config_node = c.encode(metadata_index_config);
+
+  trpc::naming::MetadataIndexConfig tmp;
+  ASSERT_TRUE(c.decode(config_node, tmp));
+
+  tmp.Display();
+  ASSERT_EQ(metadata_index_config.enable, tmp.enable);
+  ASSERT_EQ(metadata_index_config.max_filters, tmp.max_filters);
+}
+
+TEST(LocalNearbyConfig, local_nearby_config_test) {
+  trpc::naming::SelectorConfig selector_config;
+  selector_config.local_nearby_config.enable = true;
+
+  YAML::convert<trpc::naming::SelectorConfig> c;
+  YAML::Node config_node = c.encode(selector_config);
+
+  trpc::naming::SelectorConfig tmp;
+  ASSERT_TRUE(c.decode(config_node, tmp));
+
+  tmp.local_nearby_config.Display();
+  ASSERT_TRUE(tmp.local_nearby_config.enable);
+}
+
+TEST(ZoneAwareConfig, zone_aware_config_test) {
+  trpc::naming::SelectorConfig selector_config;
+  selector_config.zone_aware_config.enable = true;
+  selector_config.zone_aware_config.min_cluster_size = 3;
+  selector_config.zone_aware_config.refresh_interval = 5000;
+
+  YAML::convert<trpc::naming::SelectorConfig> c;
+  YAML::Node config_node = c.encode(selector_config);
+
+  trpc::naming::SelectorConfig tmp;
+  ASSERT_TRUE(c.decode(config_node, tmp));
+
+  tmp.zone_aware_config.Display();
+  ASSERT_TRUE(tmp.zone_aware_config.enable);
+  ASSERT_EQ(3, tmp.zone_aware_config.min_cluster_size);
+  ASSERT_EQ(5000, tmp.zone_aware_config.refresh_interval);
+}
+
+TEST(LatencyLocalityConfig, latency_locality_config_test) {
+  trpc::naming::SelectorConfig selector_config;
+  auto& latency_locality_config = selector_config.latency_locality_config;
+  latency_locality_config.enable = true;
+  latency_locality_config.decay = 0.5;
+  latency_locality_config.min_samples = 5;
+  latency_locality_config.expire_time = 30000;
+  latency_locality_config.rank_interval = 500;
+
+  YAML::convert<trpc::naming::SelectorConfig> c;
+  YAML::Node config_node = c.encode(selector_config);
+
+  trpc::naming::SelectorConfig tmp;
+  ASSERT_TRUE(c.decode(config_node, tmp));
+
+  tmp.latency_locality_config.Display();
+  ASSERT_TRUE(tmp.latency_locality_config.enable);
+  ASSERT_DOUBLE_EQ(0.5, tmp.latency_locality_config.decay);
+  ASSERT_EQ(5, tmp.latency_locality_config.min_samples);
+  ASSERT_EQ(30000, tmp.latency_locality_config.expire_time);
+  ASSERT_EQ(500, tmp.latency_locality_config.rank_interval);
+}
+
+TEST(ColocationConfig, colocation_config_test) {
+  trpc::naming::SelectorConfig selector_config;
+  selector_config.colocation_config.enable = true;
+  selector_config.colocation_config.host_id = "host-1";
+  selector_config.colocation_config.max_local_percent = 80;
+  selector_config.colocation_config.use_uds = true;
+
+  YAML::convert<trpc::naming::SelectorConfig> c;
+  YAML::Node config_node = c.encode(selector_config);
+
+  trpc::naming::SelectorConfig tmp;
+  ASSERT_TRUE(c.decode(config_node, tmp));
+
+  tmp.colocation_config.Display();
+  ASSERT_TRUE(tmp.colocation_config.enable);
+  ASSERT_EQ("host-1", tmp.colocation_config.host_id);
+  ASSERT_EQ(80, tmp.colocation_config.max_local_percent);
+  ASSERT_TRUE(tmp.colocation_config.use_uds);
+}
+
+TEST(FederationConfig, federation_config_test) {
+  trpc::naming::SelectorConfig selector_config;
+  auto& federation_config = selector_config.federation_config;
+  federation_config.enable = true;
+  trpc::naming::FederationClusterConfig cluster;
+  cluster.name = "backup";
+  cluster.addresses = {"127.0.0.1:8091", "127.0.0.2:8091"};
+  cluster.join_point = "backup";
+  federation_config.clusters.push_back(cluster);
+  federation_config.overprovisioning_factor = 120;
+  federation_config.refresh_interval = 5000;
+
+  YAML::convert<trpc::naming::SelectorConfig> c;
+  YAML::Node config_node = c.encode(selector_config);
+
+  trpc::naming::SelectorConfig tmp;
+  ASSERT_TRUE(c.decode(config_node, tmp));
+
+  tmp.federation_config.Display();
+  ASSERT_TRUE(tmp.federation_config.enable);
+  ASSERT_EQ(1, tmp.federation_config.clusters.size());
+  ASSERT_EQ("backup", tmp.federation_config.clusters[0].name);
+  ASSERT_EQ(cluster.addresses, tmp.federation_config.clusters[0].addresses);
+  ASSERT_EQ("backup", tmp.federation_config.clusters[0].join_point);
+  ASSERT_EQ(120, tmp.federation_config.overprovisioning_factor);
+  ASSERT_EQ(5000, tmp.federation_config.refresh_interval);
+}
+
+TEST(SlowStartConfig, slow_start_config_test) {
+  trpc::naming::SelectorConfig selector_config;
+  auto& slow_start_config = selector_config.slow_start_config;
+  slow_start_config.enable = true;
+  slow_start_config.window = 30000;
+  slow_start_config.curve = "aggressive";
+  slow_start_config.aggression = 3.0;
+  slow_start_config.min_weight_percent = 5;
+
+  YAML::convert<trpc::naming::SelectorConfig> c;
+  YAML::Node config_node = c.encode(selector_config);
+
+  trpc::naming::SelectorConfig tmp;
+  ASSERT_TRUE(c.decode(config_node, tmp));
+
+  tmp.slow_start_config.Display();
+  ASSERT_TRUE(tmp.slow_start_config.enable);
+  ASSERT_EQ(30000, tmp.slow_start_config.window);
+  ASSERT_EQ("aggressive", tmp.slow_start_config.curve);
+  ASSERT_DOUBLE_EQ(3.0, tmp.slow_start_config.aggression);
+  ASSERT_EQ(5, tmp.slow_start_config.min_weight_percent);
+}
+
+TEST(LatencyOutlierConfig, latency_outlier_config_test) {
+  trpc::naming::SelectorConfig selector_config;
+  auto& latency_outlier_config = selector_config.latency_outlier_config;
+  latency_outlier_config.enable = true;
+  latency_outlier_config.window = 5000;
+  latency_outlier_config.quantile = 0.9;
+  latency_outlier_config.ratio = 3.0;
+  latency_outlier_config.min_latency = 20;
+  latency_outlier_config.min_samples = 100;
+  latency_outlier_config.min_hosts = 5;
+  latency_outlier_config.base_ejection_time = 10000;
+  latency_outlier_config.max_ejection_time = 60000;
+  latency_outlier_config.max_ejection_percent = 20;
+  latency_outlier_config.interval = 500;
+
+  YAML::convert<trpc::naming::SelectorConfig> c;
+  YAML::Node config_node = c.encode(selector_config);
+
+  trpc::naming::SelectorConfig tmp;
+  ASSERT_TRUE(c.decode(config_node, tmp));
+
+  tmp.latency_outlier_config.Display();
+  ASSERT_TRUE(tmp.latency_outlier_config.enable);
+  ASSERT_EQ(5000, tmp.latency_outlier_config.window);
+  ASSERT_DOUBLE_EQ(0.9, tmp.latency_outlier_config.quantile);
+  ASSERT_DOUBLE_EQ(3.0, tmp.latency_outlier_config.ratio);
+  ASSERT_EQ(20, tmp.latency_outlier_config.min_latency);
+  ASSERT_EQ(100, tmp.latency_outlier_config.min_samples);
+  ASSERT_EQ(5, tmp.latency_outlier_config.min_hosts);
+  ASSERT_EQ(10000, tmp.latency_outlier_config.base_ejection_time);
+  ASSERT_EQ(60000, tmp.latency_outlier_config.max_ejection_time);
+  ASSERT_EQ(20, tmp.latency_outlier_config.max_ejection_percent);
+  ASSERT_EQ(500, tmp.latency_outlier_config.interval);
+}
+
+TEST(MethodCircuitBreakerConfig, method_circuit_breaker_config_test) {
+  trpc::naming::SelectorConfig selector_config;
+  auto& method_circuit_breaker_config = selector_config.method_circuit_breaker_config;
+  method_circuit_breaker_config.enable = true;
+  method_circuit_breaker_config.window = 5000;
+  method_circuit_breaker_config.bucket_num = 5;
+  method_circuit_breaker_config.min_requests = 20;
+  method_circuit_breaker_config.error_rate_percent = 30;
+  method_circuit_breaker_config.sleep_window = 10000;
+  method_circuit_breaker_config.success_to_close = 5;
+
+  YAML::convert<trpc::naming::SelectorConfig> c;
+  YAML::Node config_node = c.encode(selector_config);
+
+  trpc::naming::SelectorConfig tmp;
+  ASSERT_TRUE(c.decode(config_node, tmp));
+
+  tmp.method_circuit_breaker_config.Display();
+  ASSERT_TRUE(tmp.method_circuit_breaker_config.enable);
+  ASSERT_EQ(5000, tmp.method_circuit_breaker_config.window);
+  ASSERT_EQ(5, tmp.method_circuit_breaker_config.bucket_num);
+  ASSERT_EQ(20, tmp.method_circuit_breaker_config.min_requests);
+  ASSERT_EQ(30, tmp.method_circuit_breaker_config.error_rate_percent);
+  ASSERT_EQ(10000, tmp.method_circuit_breaker_config.sleep_window);
+  ASSERT_EQ(5, tmp.method_circuit_breaker_config.success_to_close);
+}
+
+TEST(SetCircuitBreakerConfig, set_circuit_breaker_config_test) {
+  trpc::naming::SetCircuitBreakerConfig set_circuit_breaker_config;
+  set_circuit_breaker_config.enable = true;
+  set_circuit_breaker_config.window = 5000;
+  set_circuit_breaker_config.min_requests = 50;
+  set_circuit_breaker_config.error_rate_percent = 30;
+  set_circuit_breaker_config.slow_call = 200;
+  set_circuit_breaker_config.slow_rate_percent = 40;
+  set_circuit_breaker_config.sleep_window = 10000;
+  set_circuit_breaker_config.success_to_close = 5;
+
+  YAML::convert<trpc::naming::SetCircuitBreakerConfig> c;
+  YAML::Node config_node = c.encode(set_circuit_breaker_config);
+
+  trpc::naming::SetCircuitBreakerConfig tmp;
+  ASSERT_TRUE(c.decode(config_node, tmp));
+
+  tmp.Display();
+  ASSERT_TRUE(tmp.enable);
+  ASSERT_EQ(5000, tmp.window);
+  ASSERT_EQ(50, tmp.min_requests);
+  ASSERT_EQ(30, tmp.error_rate_percent);
+  ASSERT_EQ(200, tmp.slow_call);
+  ASSERT_EQ(40, tmp.slow_rate_percent);
+  ASSERT_EQ(10000, tmp.sleep_window);
+  ASSERT_EQ(5, tmp.success_to_close);
+}
+
+TEST(ServiceFailFastConfig, service_fail_fast_config_test) {
+  trpc::naming::SelectorConfig selector_config;
+  auto& service_fail_fast_config = selector_config.service_fail_fast_config;
+  service_fail_fast_config.enable = true;
+  service_fail_fast_config.broken_percent = 60;
+  service_fail_fast_config.reject_percent = 80;
+  service_fail_fast_config.window = 5000;
+  service_fail_fast_config.min_requests = 20;
+  service_fail_fast_config.error_rate_percent = 30;
+  service_fail_fast_config.sleep_window = 10000;
+
+  YAML::convert<trpc::naming::SelectorConfig> c;
+  YAML::Node config_node = c.encode(selector_config);
+
+  trpc::naming::SelectorConfig tmp;
+  ASSERT_TRUE(c.decode(config_node, tmp));
+
+  tmp.service_fail_fast_config.Display();
+  ASSERT_TRUE(tmp.service_fail_fast_config.enable);
+  ASSERT_EQ(60, tmp.service_fail_fast_config.broken_percent);
+  ASSERT_EQ(80, tmp.service_fail_fast_config.reject_percent);
+  ASSERT_EQ(5000, tmp.service_fail_fast_config.window);
+  ASSERT_EQ(20, tmp.service_fail_fast_config.min_requests);
+  ASSERT_EQ(30, tmp.service_fail_fast_config.error_rate_percent);
+  ASSERT_EQ(10000, tmp.service_fail_fast_config.sleep_window);
+}
+
+TEST(RetryAwareConfig, retry_aware_config_test) {
+  trpc::naming::SelectorConfig selector_config;
+  auto& retry_aware_config = selector_config.retry_aware_config;
+  retry_aware_config.enable = true;
+  retry_aware_config.max_tried = 3;
+
+  YAML::convert<trpc::naming::SelectorConfig> c;
+  YAML::Node config_node = c.encode(selector_config);
+
+  trpc::naming::SelectorConfig tmp;
+  ASSERT_TRUE(c.decode(config_node, tmp));
+
+  tmp.retry_aware_config.Display();
+  ASSERT_TRUE(tmp.retry_aware_config.enable);
+  ASSERT_EQ(3, tmp.retry_aware_config.max_tried);
+}
+
+TEST(HedgingConfig, hedging_config_test) {
+  trpc::naming::SelectorConfig selector_config;
+  auto& hedging_config = selector_config.hedging_config;
+  hedging_config.enable = true;
+  hedging_config.quantile = 0.9;
+  hedging_config.window = 5000;
+  hedging_config.min_samples = 50;
+  hedging_config.min_delay = 3;
+  hedging_config.budget_percent = 5;
+  hedging_config.interval = 500;
+
+  YAML::convert<trpc::naming::SelectorConfig> c;
+  YAML::Node config_node = c.encode(selector_config);
+
+  trpc::naming::SelectorConfig tmp;
+  ASSERT_TRUE(c.decode(config_node, tmp));
+
+  tmp.hedging_config.Display();
+  ASSERT_TRUE(tmp.hedging_config.enable);
+  ASSERT_DOUBLE_EQ(0.9, tmp.hedging_config.quantile);
+  ASSERT_EQ(5000, tmp.hedging_config.window);
+  ASSERT_EQ(50, tmp.hedging_config.min_samples);
+  ASSERT_EQ(3, tmp.hedging_config.min_delay);
+  ASSERT_EQ(5, tmp.hedging_config.budget_percent);
+  ASSERT_EQ(500, tmp.hedging_config.interval);
+}
+
+TEST(RetryBudgetConfig, retry_budget_config_test) {
+  trpc::naming::SelectorConfig selector_config;
+  auto& retry_budget_config = selector_config.retry_budget_config;
+  retry_budget_config.enable = true;
+  retry_budget_config.ratio_percent = 20;
+  retry_budget_config.max_tokens = 50;
+  retry_budget_config.min_healthy_percent = 40;
+  retry_budget_config.window = 5000;
+  retry_budget_config.min_requests = 20;
+  retry_budget_config.error_rate_percent = 30;
+  retry_budget_config.sleep_window = 10000;
+
+  YAML::convert<trpc::naming::SelectorConfig> c;
+  YAML::Node config_node = c.encode(selector_config);
+
+  trpc::naming::SelectorConfig tmp;
+  ASSERT_TRUE(c.decode(config_node, tmp));
+
+  tmp.retry_budget_config.Display();
+  ASSERT_TRUE(tmp.retry_budget_config.enable);
+  ASSERT_EQ(20, tmp.retry_budget_config.ratio_percent);
+  ASSERT_EQ(50, tmp.retry_budget_config.max_tokens);
+  ASSERT_EQ(40, tmp.retry_budget_config.min_healthy_percent);
+  ASSERT_EQ(5000, tmp.retry_budget_config.window);
+  ASSERT_EQ(20, tmp.retry_budget_config.min_requests);
+  ASSERT_EQ(30, tmp.retry_budget_config.error_rate_percent);
+  ASSERT_EQ(10000, tmp.retry_budget_config.sleep_window);
+}
+
+TEST(AdaptiveTimeoutConfig, adaptive_timeout_config_test) {
+  trpc::naming::SelectorConfig selector_config;
+  auto& adaptive_timeout_config = selector_config.adaptive_timeout_config;
+  adaptive_timeout_config.enable = true;
+  adaptive_timeout_config.apply = true;
+  adaptive_timeout_config.quantile = 0.95;
+  adaptive_timeout_config.multiplier = 3.0;
+  adaptive_timeout_config.min_timeout = 20;
+  adaptive_timeout_config.max_timeout = 5000;
+  adaptive_timeout_config.window = 30000;
+  adaptive_timeout_config.min_samples = 50;
+  adaptive_timeout_config.interval = 500;
+
+  YAML::convert<trpc::naming::SelectorConfig> c;
+  YAML::Node config_node = c.encode(selector_config);
+
+  trpc::naming::SelectorConfig tmp;
+  ASSERT_TRUE(c.decode(config_node, tmp));
+
+  tmp.adaptive_timeout_config.Display();
+  ASSERT_TRUE(tmp.adaptive_timeout_config.enable);
+  ASSERT_TRUE(tmp.adaptive_timeout_config.apply);
+  ASSERT_DOUBLE_EQ(0.95, tmp.adaptive_timeout_config.quantile);
+  ASSERT_DOUBLE_EQ(3.0, tmp.adaptive_timeout_config.multiplier);
+  ASSERT_EQ(20, tmp.adaptive_timeout_config.min_timeout);
+  ASSERT_EQ(5000, tmp.adaptive_timeout_config.max_timeout);
+  ASSERT_EQ(30000, tmp.adaptive_timeout_config.window);
+  ASSERT_EQ(50, tmp.adaptive_timeout_config.min_samples);
+  ASSERT_EQ(500, tmp.adaptive_timeout_config.interval);
+}
+
+TEST(OutlierDetectionConfig, outlier_detection_config_test) {
+  trpc::naming::OutlierDetectionConfig outlier_detection_config;
+  outlier_detection_config.enable = true;
+  outlier_detection_config.check_period = "5s";
+  outlier_detection_config.chain = {"trpc"};
+  outlier_detection_config.trpc_config.func_name = "/trpc.test.Probe/Check";
+  outlier_detection_config.trpc_config.timeout = "200ms";
+  outlier_detection_config.trpc_config.protocol = "http";
+
+  YAML::convert<trpc::naming::OutlierDetectionConfig> c;
+  YAML::Node config_node = c.encode(outlier_detection_config);
+  // The options of the probe are passed to the SDK under plugin.trpc
+  ASSERT_EQ("/trpc.test.Probe/Check", config_node["plugin"]["trpc"]["func_name"].as<std::string>());
+  ASSERT_EQ("200ms", config_node["plugin"]["trpc"]["timeout"].as<std::string>());
+  ASSERT_EQ("http", config_node["plugin"]["trpc"]["protocol"].as<std::string>());
+
+  trpc::naming::OutlierDetectionConfig tmp;
+  ASSERT_TRUE(c.decode(config_node, tmp));
+
+  tmp.Display();
+  ASSERT_TRUE(tmp.enable);
+  ASSERT_EQ("5s", tmp.check_period);
+  ASSERT_EQ(std::vector<std::string>{"trpc"}, tmp.chain);
+  ASSERT_EQ("/trpc.test.Probe/Check", tmp.trpc_config.func_name);
+  ASSERT_EQ("200ms", tmp.trpc_config.timeout);
+  ASSERT_EQ("http", tmp.trpc_config.protocol);
+}
+
 #endif
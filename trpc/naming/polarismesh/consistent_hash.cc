@@ -0,0 +1,427 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#include "trpc/naming/polarismesh/consistent_hash.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+#include "MurmurHash3.h"
+
+namespace trpc::naming::polarismesh {
+
+namespace {
+
+constexpr uint32_t kMaglevOffsetSeed = 0x4d61676c;
+constexpr uint32_t kMaglevSkipSeed = 0x65764c42;
+
+// Indexes of the endpoints which take part in the hashing
+std::vector<uint32_t> GetHashableEndpoints(const std::vector<TrpcEndpointInfo>& endpoints) {
+  std::vector<uint32_t> indexes;
+  indexes.reserve(endpoints.size());
+  for (uint32_t i = 0; i < endpoints.size(); ++i) {
+    if (endpoints[i].weight > 0) {
+      indexes.push_back(i);
+    }
+  }
+  if (indexes.empty()) {
+    for (uint32_t i = 0; i < endpoints.size(); ++i) {
+      indexes.push_back(i);
+    }
+  }
+  return indexes;
+}
+
+// Weight used by the hashing, all endpoints count equally if none of them has a weight
+uint32_t GetHashWeight(const TrpcEndpointInfo& endpoint) { return endpoint.weight > 0 ? endpoint.weight : 1; }
+
+uint32_t NextPrime(uint32_t value) {
+  auto is_prime = [](uint32_t n) {
+    if (n < 2) {
+      return false;
+    }
+    for (uint32_t i = 2; static_cast<uint64_t>(i) * i <= n; ++i) {
+      if (n % i == 0) {
+        return false;
+      }
+    }
+    return true;
+  };
+  while (!is_prime(value)) {
+    ++value;
+  }
+  return value;
+}
+
+// Endpoints visited by a walk. Most walks stop after a few endpoints, which are probed in a small array, the longer
+// ones mark the endpoints in a buffer of the thread reused by its next walks, so that no walk allocates per endpoint
+class VisitedSet {
+ public:
+  explicit VisitedSet(size_t endpoint_num) : endpoint_num_(endpoint_num) {}
+
+  ~VisitedSet() {
+    if (marks_ == &thread_marks_) {
+      thread_marks_in_use_ = false;
+    }
+  }
+
+  VisitedSet(const VisitedSet&) = delete;
+  VisitedSet& operator=(const VisitedSet&) = delete;
+
+  /// @brief Mark an endpoint as visited
+  /// @return bool Whether it was not visited yet
+  bool Insert(uint32_t index) {
+    if (size_ < kInlineNum) {
+      for (size_t i = 0; i < size_; ++i) {
+        if (inline_[i] == index) {
+          return false;
+        }
+      }
+      inline_[size_++] = index;
+      return true;
+    }
+
+    if (marks_ == nullptr) {
+      AcquireMarks();
+    }
+    if (marks_->stamps[index] == marks_->generation) {
+      return false;
+    }
+    marks_->stamps[index] = marks_->generation;
+    ++size_;
+    return true;
+  }
+
+ private:
+  // An endpoint is visited when its stamp is the generation of the current walk, so the buffer is not cleared
+  struct Marks {
+    std::vector<uint32_t> stamps;
+    uint32_t generation{0};
+  };
+
+  void AcquireMarks() {
+    // A walk nested in the visitor of another one does not share the buffer of the thread
+    marks_ = thread_marks_in_use_ ? &own_marks_ : &thread_marks_;
+    if (marks_ == &thread_marks_) {
+      thread_marks_in_use_ = true;
+    }
+    if (marks_->stamps.size() < endpoint_num_) {
+      marks_->stamps.resize(endpoint_num_, 0);
+    }
+    if (++marks_->generation == 0) {
+      std::fill(marks_->stamps.begin(), marks_->stamps.end(), 0);
+      marks_->generation = 1;
+    }
+    for (auto index : inline_) {
+      marks_->stamps[index] = marks_->generation;
+    }
+  }
+
+ private:
+  static constexpr size_t kInlineNum = 8;
+
+  static thread_local Marks thread_marks_;
+  static thread_local bool thread_marks_in_use_;
+
+  size_t endpoint_num_;
+  size_t size_{0};
+  std::array<uint32_t, kInlineNum> inline_;
+  Marks* marks_{nullptr};
+  Marks own_marks_;
+};
+
+thread_local VisitedSet::Marks VisitedSet::thread_marks_;
+thread_local bool VisitedSet::thread_marks_in_use_{false};
+
+class RingHashTable : public ConsistentHashTable {
+ public:
+  RingHashTable(RoutedSnapshotPtr snapshot, uint32_t vnode_count) : ConsistentHashTable(std::move(snapshot)) {
+    const auto& endpoints = snapshot_->endpoints;
+    auto indexes = GetHashableEndpoints(endpoints);
+    endpoint_num_ = indexes.size();
+
+    uint64_t total_weight = 0;
+    for (auto index : indexes) {
+      total_weight += GetHashWeight(endpoints[index]);
+    }
+    uint64_t total_vnodes = static_cast<uint64_t>(std::max<uint32_t>(vnode_count, 1)) * indexes.size();
+
+    for (auto index : indexes) {
+      uint64_t vnodes = std::max<uint64_t>(1, total_vnodes * GetHashWeight(endpoints[index]) / total_weight);
+      std::string address = GetEndpointAddress(endpoints[index]);
+      for (uint64_t i = 0; i < vnodes; ++i) {
+        ring_.emplace_back(HashString(address, static_cast<uint32_t>(i)), index);
+      }
+    }
+    std::sort(ring_.begin(), ring_.end());
+  }
+
+  uint32_t Lookup(uint64_t hash) const override { return ring_[FindPosition(hash)].second; }
+
+  void Walk(uint64_t hash, const std::function<bool(uint32_t)>& visitor) const override {
+    VisitedSet visited(snapshot_->endpoints.size());
+    size_t visited_num = 0;
+    size_t position = FindPosition(hash);
+    for (size_t i = 0; i < ring_.size() && visited_num < endpoint_num_; ++i) {
+      uint32_t index = ring_[(position + i) % ring_.size()].second;
+      if (!visited.Insert(index)) {
+        continue;
+      }
+      ++visited_num;
+      if (!visitor(index)) {
+        return;
+      }
+    }
+  }
+
+ private:
+  size_t FindPosition(uint64_t hash) const {
+    auto iter = std::lower_bound(ring_.begin(), ring_.end(), std::make_pair(hash, static_cast<uint32_t>(0)));
+    return iter == ring_.end() ? 0 : iter - ring_.begin();
+  }
+
+ private:
+  std::vector<std::pair<uint64_t, uint32_t>> ring_;
+};
+
+class MaglevTable : public ConsistentHashTable {
+ public:
+  MaglevTable(RoutedSnapshotPtr snapshot, uint32_t table_size) : ConsistentHashTable(std::move(snapshot)) {
+    const auto& endpoints = snapshot_->endpoints;
+    auto indexes = GetHashableEndpoints(endpoints);
+    endpoint_num_ = indexes.size();
+    uint32_t size = NextPrime(std::max<uint64_t>(table_size, indexes.size() * 100));
+
+    struct BuildEntry {
+      uint32_t index;
+      uint64_t offset;
+      uint64_t skip;
+      uint64_t next;
+      double weight;
+      double target;
+    };
+    uint32_t max_weight = 0;
+    for (auto index : indexes) {
+      max_weight = std::max(max_weight, GetHashWeight(endpoints[index]));
+    }
+    std::vector<BuildEntry> entries;
+    entries.reserve(indexes.size());
+    for (auto index : indexes) {
+      std::string address = GetEndpointAddress(endpoints[index]);
+      entries.push_back(BuildEntry{index, HashString(address, kMaglevOffsetSeed) % size,
+                                   HashString(address, kMaglevSkipSeed) % (size - 1) + 1, 0,
+                                   static_cast<double>(GetHashWeight(endpoints[index])) / max_weight, 0});
+    }
+
+    // Every endpoint takes its turns in proportion to its weight, the heaviest one takes a turn every round
+    table_.assign(size, UINT32_MAX);
+    uint32_t filled = 0;
+    for (uint64_t round = 1; filled < size; ++round) {
+      for (auto& entry : entries) {
+        if (filled >= size) {
+          break;
+        }
+        if (round * entry.weight < entry.target) {
+          continue;
+        }
+        entry.target += 1.0;
+        uint64_t slot = (entry.offset + entry.next * entry.skip) % size;
+        while (table_[slot] != UINT32_MAX) {
+          ++entry.next;
+          slot = (entry.offset + entry.next * entry.skip) % size;
+        }
+        table_[slot] = entry.index;
+        ++entry.next;
+        ++filled;
+      }
+    }
+  }
+
+  uint32_t Lookup(uint64_t hash) const override { return table_[hash % table_.size()]; }
+
+  void Walk(uint64_t hash, const std::function<bool(uint32_t)>& visitor) const override {
+    VisitedSet visited(snapshot_->endpoints.size());
+    size_t visited_num = 0;
+    size_t slot = hash % table_.size();
+    for (size_t i = 0; i < table_.size() && visited_num < endpoint_num_; ++i) {
+      uint32_t index = table_[(slot + i) % table_.size()];
+      if (!visited.Insert(index)) {
+        continue;
+      }
+      ++visited_num;
+      if (!visitor(index)) {
+        return;
+      }
+    }
+  }
+
+ private:
+  std::vector<uint32_t> table_;
+};
+
+class JumpHashTable : public ConsistentHashTable {
+ public:
+  explicit JumpHashTable(RoutedSnapshotPtr snapshot) : ConsistentHashTable(std::move(snapshot)) {
+    const auto& endpoints = snapshot_->endpoints;
+    buckets_ = GetHashableEndpoints(endpoints);
+    endpoint_num_ = buckets_.size();
+    // The buckets are ordered by address, so the result does not depend on the order returned by the SDK
+    std::sort(buckets_.begin(), buckets_.end(), [&endpoints](uint32_t a, uint32_t b) {
+      if (endpoints[a].host != endpoints[b].host) {
+        return endpoints[a].host < endpoints[b].host;
+      }
+      return endpoints[a].port < endpoints[b].port;
+    });
+  }
+
+  uint32_t Lookup(uint64_t hash) const override { return buckets_[JumpConsistentHash(hash, buckets_.size())]; }
+
+  void Walk(uint64_t hash, const std::function<bool(uint32_t)>& visitor) const override {
+    VisitedSet visited(snapshot_->endpoints.size());
+    size_t visited_num = 0;
+    auto visit = [&](uint32_t index) {
+      if (!visited.Insert(index)) {
+        return true;
+      }
+      ++visited_num;
+      return visitor(index);
+    };
+
+    // Rehash for the next choices, and fall back to the bucket order for the remaining ones
+    uint64_t key = hash;
+    for (size_t i = 0; i < buckets_.size() * 2 && visited_num < buckets_.size(); ++i) {
+      if (!visit(buckets_[JumpConsistentHash(key, buckets_.size())])) {
+        return;
+      }
+      key = key * 6364136223846793005ULL + 1442695040888963407ULL;
+    }
+    for (size_t i = 0; i < buckets_.size() && visited_num < buckets_.size(); ++i) {
+      if (!visit(buckets_[i])) {
+        return;
+      }
+    }
+  }
+
+ private:
+  // A Fast, Minimal Memory, Consistent Hash Algorithm, John Lamping and Eric Veach
+  static size_t JumpConsistentHash(uint64_t key, size_t num_buckets) {
+    int64_t b = -1;
+    int64_t j = 0;
+    while (j < static_cast<int64_t>(num_buckets)) {
+      b = j;
+      key = key * 2862933555777941757ULL + 1;
+      j = static_cast<int64_t>((b + 1) * (static_cast<double>(1LL << 31) / static_cast<double>((key >> 33) + 1)));
+    }
+    return static_cast<size_t>(b);
+  }
+
+ private:
+  std::vector<uint32_t> buckets_;
+};
+
+}  // namespace
+
+bool ParseConsistentHashType(const std::string& name, ConsistentHashType& type) {
+  if (name == "ringHash") {
+    type = ConsistentHashType::kRingHash;
+  } else if (name == "maglev") {
+    type = ConsistentHashType::kMaglev;
+  } else if (name == "jumpHash") {
+    type = ConsistentHashType::kJumpHash;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+uint64_t HashString(const std::string& key, uint32_t seed) {
+  uint64_t out[2];
+  MurmurHash3_x64_128(key.data(), static_cast<int>(key.size()), seed, out);
+  return out[0];
+}
+
+ConsistentHashTablePtr BuildConsistentHashTable(ConsistentHashType type, const RoutedSnapshotPtr& snapshot,
+                                                const ConsistentHashOptions& options) {
+  if (!snapshot || snapshot->endpoints.empty()) {
+    return nullptr;
+  }
+
+  switch (type) {
+    case ConsistentHashType::kMaglev:
+      return std::make_shared<MaglevTable>(snapshot, options.maglev_table_size);
+    case ConsistentHashType::kJumpHash:
+      return std::make_shared<JumpHashTable>(snapshot);
+    default:
+      return std::make_shared<RingHashTable>(snapshot, options.vnode_count);
+  }
+}
+
+uint32_t LookupWithBoundedLoad(const ConsistentHashTable& table, uint64_t hash, double load_factor, int64_t total_load,
+                               const std::function<int64_t(uint32_t)>& get_load) {
+  // Capacity counts the call being selected, so it is at least 1
+  double average = static_cast<double>(std::max<int64_t>(total_load, 0) + 1) / table.GetEndpointNum();
+  auto capacity = static_cast<int64_t>(std::ceil(std::max(load_factor, 1.0) * average));
+
+  bool found = false;
+  uint32_t selected = 0;
+  table.Walk(hash, [&](uint32_t index) {
+    if (get_load(index) < capacity) {
+      selected = index;
+      found = true;
+      return false;
+    }
+    return true;
+  });
+
+  // The loads changed concurrently and no endpoint is below the capacity, keep the affinity
+  return found ? selected : table.Lookup(hash);
+}
+
+void SelectReplicas(const ConsistentHashTable& table, uint64_t hash, uint32_t offset, uint32_t num,
+                    std::vector<uint32_t>& indexes) {
+  if (num == 0 || table.GetEndpointNum() == 0) {
+    return;
+  }
+
+  // The replicate index wraps around like the positions of the ring
+  offset %= table.GetEndpointNum();
+  num = std::min<uint32_t>(num, table.GetEndpointNum());
+  std::vector<uint32_t> skipped;
+  skipped.reserve(offset);
+  size_t begin = indexes.size();
+  table.Walk(hash, [&](uint32_t index) {
+    if (skipped.size() < offset) {
+      skipped.push_back(index);
+      return true;
+    }
+    indexes.push_back(index);
+    return indexes.size() - begin < num;
+  });
+
+  // Wrap around to the skipped ones
+  for (size_t i = 0; i < skipped.size() && indexes.size() - begin < num; ++i) {
+    indexes.push_back(skipped[i]);
+  }
+}
+
+ConsistentHashTablePtr ConsistentHashTableCache::Get(const std::string& key, ConsistentHashType type,
+                                                     const RoutedSnapshotPtr& snapshot) {
+  return tables_.Get(key + "#" + std::to_string(static_cast<int>(type)), snapshot,
+                     [this, type](const RoutedSnapshotPtr& snapshot) {
+                       return BuildConsistentHashTable(type, snapshot, options_);
+                     });
+}
+
+}  // namespace trpc::naming::polarismesh
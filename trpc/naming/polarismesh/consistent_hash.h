@@ -0,0 +1,129 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "trpc/naming/polarismesh/snapshot_cache.h"
+
+namespace trpc::naming::polarismesh {
+
+/// @brief Consistent hashing algorithms of the plugin
+enum class ConsistentHashType {
+  /// Hash ring with virtual nodes, the number of virtual nodes of an endpoint is proportional to its weight
+  kRingHash,
+  /// Maglev lookup table, weighted
+  kMaglev,
+  /// Jump consistent hash, which ignores the weights
+  kJumpHash,
+};
+
+/// @brief Parse the algorithm name used in the configuration and the load balance name of the call
+/// @param name "ringHash", "maglev" or "jumpHash"
+/// @param[out] type The algorithm
+/// @return bool Whether the name is a known algorithm
+bool ParseConsistentHashType(const std::string& name, ConsistentHashType& type);
+
+/// @brief Hash a string key with murmur3, the same key always hashes to the same value
+uint64_t HashString(const std::string& key, uint32_t seed = 0);
+
+struct ConsistentHashOptions {
+  /// Number of virtual nodes per endpoint of the hash ring, on average
+  uint32_t vnode_count{1024};
+  /// Size of the maglev lookup table, it should be a prime much larger than the number of endpoints
+  uint32_t maglev_table_size{65537};
+};
+
+/// @brief Lookup table of a consistent hashing algorithm, built once per snapshot revision and read concurrently
+class ConsistentHashTable {
+ public:
+  explicit ConsistentHashTable(RoutedSnapshotPtr snapshot) : snapshot_(std::move(snapshot)) {}
+
+  virtual ~ConsistentHashTable() = default;
+
+  /// @brief Index of the endpoint in the snapshot which owns hash
+  virtual uint32_t Lookup(uint64_t hash) const = 0;
+
+  /// @brief Visit the distinct endpoints in the preference order of hash, the first one is the result of Lookup
+  /// @param visitor Called with the index of the endpoint in the snapshot, returns false to stop the walk
+  virtual void Walk(uint64_t hash, const std::function<bool(uint32_t)>& visitor) const = 0;
+
+  /// @brief The snapshot the table is built from
+  const RoutedSnapshotPtr& GetSnapshot() const { return snapshot_; }
+
+  /// @brief Number of endpoints in the table
+  size_t GetEndpointNum() const { return endpoint_num_; }
+
+ protected:
+  RoutedSnapshotPtr snapshot_;
+  size_t endpoint_num_{0};
+};
+
+using ConsistentHashTablePtr = std::shared_ptr<const ConsistentHashTable>;
+
+/// @brief Build the lookup table of a snapshot, the endpoints with zero weight are left out unless all of them are
+/// @return ConsistentHashTablePtr nullptr if the snapshot is empty
+ConsistentHashTablePtr BuildConsistentHashTable(ConsistentHashType type, const RoutedSnapshotPtr& snapshot,
+                                                const ConsistentHashOptions& options);
+
+/// @brief Consistent hashing with bounded loads: the owner of hash is taken unless its load reaches the capacity, which
+///        is load_factor times the average load, then the next endpoints in the preference order are tried. Most keys
+///        keep their endpoint while a hot key spills over to the neighbors.
+/// @param table The lookup table
+/// @param hash Hash of the key
+/// @param load_factor Capacity of an endpoint relative to the average load, not less than 1
+/// @param total_load Total load of the endpoints, usually the number of in-flight calls
+/// @param get_load Get the load of an endpoint by its index in the snapshot
+/// @return uint32_t Index of the selected endpoint in the snapshot
+uint32_t LookupWithBoundedLoad(const ConsistentHashTable& table, uint64_t hash, double load_factor, int64_t total_load,
+                               const std::function<int64_t(uint32_t)>& get_load);
+
+/// @brief Select the distinct replicas of a key in the preference order in one pass, which is the ring order for the
+///        hash ring. The i-th replica is the one selected alone with the replicate index offset + i.
+/// @param table The lookup table
+/// @param hash Hash of the key
+/// @param offset Number of replicas skipped, which is the replicate index of the first one
+/// @param num Number of replicas needed, less are returned if there are not enough endpoints
+/// @param[out] indexes Indexes of the replicas in the snapshot
+void SelectReplicas(const ConsistentHashTable& table, uint64_t hash, uint32_t offset, uint32_t num,
+                    std::vector<uint32_t>& indexes);
+
+/// @brief Keeps the lookup table of every selection key, it is rebuilt only when the snapshot revision changes. The
+///        ring and maglev tables hold many slots per endpoint, so only the tables of the current and the previous
+///        revisions of a key are kept.
+class ConsistentHashTableCache {
+ public:
+  ConsistentHashTableCache() : tables_(kMaxRevisionsPerKey) {}
+
+  void SetOptions(const ConsistentHashOptions& options) { options_ = options; }
+
+  const ConsistentHashOptions& GetOptions() const { return options_; }
+
+  /// @brief Get the table of the snapshot of key, build it if absent or built from another revision
+  ConsistentHashTablePtr Get(const std::string& key, ConsistentHashType type, const RoutedSnapshotPtr& snapshot);
+
+  void Clear() { tables_.Clear(); }
+
+ private:
+  static constexpr size_t kMaxRevisionsPerKey = 2;
+
+  ConsistentHashOptions options_;
+  SnapshotTableCache<ConsistentHashTable> tables_;
+};
+
+}  // namespace trpc::naming::polarismesh
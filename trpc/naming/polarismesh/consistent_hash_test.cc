@@ -0,0 +1,234 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#include "trpc/naming/polarismesh/consistent_hash.h"
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace trpc::naming::polarismesh::testing {
+
+RoutedSnapshotPtr MakeSnapshot(int num, uint32_t weight = 100) {
+  auto snapshot = std::make_shared<RoutedSnapshot>();
+  for (int i = 1; i <= num; i++) {
+    TrpcEndpointInfo endpoint;
+    endpoint.host = "127.0.0." + std::to_string(i);
+    endpoint.port = 8080;
+    endpoint.weight = weight;
+    endpoint.status = 1;
+    snapshot->endpoints.push_back(endpoint);
+  }
+  snapshot->revision = CalculateEndpointsRevision(snapshot->endpoints);
+  return snapshot;
+}
+
+ConsistentHashOptions MakeOptions() {
+  ConsistentHashOptions options;
+  options.vnode_count = 128;
+  options.maglev_table_size = 1031;
+  return options;
+}
+
+class ConsistentHashTest : public ::testing::TestWithParam<ConsistentHashType> {};
+
+TEST_P(ConsistentHashTest, StableAndBalanced) {
+  auto snapshot = MakeSnapshot(4);
+  auto table = BuildConsistentHashTable(GetParam(), snapshot, MakeOptions());
+  ASSERT_NE(nullptr, table);
+
+  std::map<uint32_t, int> counts;
+  for (int i = 0; i < 4000; i++) {
+    uint64_t hash = HashString("key" + std::to_string(i));
+    uint32_t index = table->Lookup(hash);
+    ASSERT_LT(index, 4);
+    ASSERT_EQ(index, table->Lookup(hash));
+    counts[index]++;
+  }
+  ASSERT_EQ(4, counts.size());
+  for (const auto& item : counts) {
+    ASSERT_GT(item.second, 500);
+  }
+}
+
+TEST_P(ConsistentHashTest, MinimalDisruption) {
+  auto table = BuildConsistentHashTable(GetParam(), MakeSnapshot(5), MakeOptions());
+  auto bigger_table = BuildConsistentHashTable(GetParam(), MakeSnapshot(6), MakeOptions());
+
+  int moved = 0;
+  for (int i = 0; i < 3000; i++) {
+    uint64_t hash = HashString("key" + std::to_string(i));
+    uint32_t index = table->Lookup(hash);
+    uint32_t new_index = bigger_table->Lookup(hash);
+    // Keys either stay or move to the new endpoint
+    if (index != new_index) {
+      ++moved;
+      if (GetParam() != ConsistentHashType::kMaglev) {
+        ASSERT_EQ(5, new_index);
+      }
+    }
+  }
+  ASSERT_LT(moved, 1000);
+}
+
+TEST_P(ConsistentHashTest, Walk) {
+  auto snapshot = MakeSnapshot(5);
+  auto table = BuildConsistentHashTable(GetParam(), snapshot, MakeOptions());
+  uint64_t hash = HashString("abc");
+
+  std::vector<uint32_t> indexes;
+  table->Walk(hash, [&indexes](uint32_t index) {
+    indexes.push_back(index);
+    return true;
+  });
+  ASSERT_EQ(5, indexes.size());
+  ASSERT_EQ(table->Lookup(hash), indexes[0]);
+  ASSERT_EQ(5, std::set<uint32_t>(indexes.begin(), indexes.end()).size());
+
+  indexes.clear();
+  table->Walk(hash, [&indexes](uint32_t index) {
+    indexes.push_back(index);
+    return indexes.size() < 2;
+  });
+  ASSERT_EQ(2, indexes.size());
+}
+
+TEST_P(ConsistentHashTest, WalkManyEndpoints) {
+  // More endpoints than the walks track without the buffer of the thread, walked again and nested in a walk
+  auto table = BuildConsistentHashTable(GetParam(), MakeSnapshot(40), MakeOptions());
+  auto small_table = BuildConsistentHashTable(GetParam(), MakeSnapshot(20), MakeOptions());
+  for (int i = 0; i < 3; i++) {
+    uint64_t hash = HashString("key" + std::to_string(i));
+    std::vector<uint32_t> indexes;
+    table->Walk(hash, [&](uint32_t index) {
+      if (indexes.size() == 10) {
+        std::set<uint32_t> nested;
+        small_table->Walk(hash, [&nested](uint32_t index) { return nested.insert(index).second; });
+        EXPECT_EQ(20, nested.size());
+      }
+      indexes.push_back(index);
+      return true;
+    });
+    ASSERT_EQ(40, indexes.size());
+    ASSERT_EQ(40, std::set<uint32_t>(indexes.begin(), indexes.end()).size());
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(Types, ConsistentHashTest,
+                         ::testing::Values(ConsistentHashType::kRingHash, ConsistentHashType::kMaglev,
+                                           ConsistentHashType::kJumpHash));
+
+TEST(ConsistentHashWeightTest, Weighted) {
+  auto snapshot = std::const_pointer_cast<RoutedSnapshot>(MakeSnapshot(2));
+  snapshot->endpoints[0].weight = 300;
+  for (auto type : {ConsistentHashType::kRingHash, ConsistentHashType::kMaglev}) {
+    auto table = BuildConsistentHashTable(type, snapshot, MakeOptions());
+    int first = 0;
+    for (int i = 0; i < 4000; i++) {
+      if (table->Lookup(HashString("key" + std::to_string(i))) == 0) {
+        ++first;
+      }
+    }
+    ASSERT_GT(first, 2600);
+    ASSERT_LT(first, 3400);
+  }
+
+  // Zero weight endpoints are left out
+  snapshot->endpoints[1].weight = 0;
+  auto table = BuildConsistentHashTable(ConsistentHashType::kJumpHash, snapshot, MakeOptions());
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(0, table->Lookup(HashString("key" + std::to_string(i))));
+  }
+}
+
+TEST(LookupWithBoundedLoadTest, SpillOver) {
+  auto snapshot = MakeSnapshot(4);
+  auto table = BuildConsistentHashTable(ConsistentHashType::kRingHash, snapshot, MakeOptions());
+  uint64_t hash = HashString("hot");
+  uint32_t owner = table->Lookup(hash);
+
+  // Balanced, keep the affinity
+  std::vector<int64_t> loads = {2, 2, 2, 2};
+  auto get_load = [&loads](uint32_t index) { return loads[index]; };
+  ASSERT_EQ(owner, LookupWithBoundedLoad(*table, hash, 1.25, 8, get_load));
+
+  // The owner is overloaded, spill over to the next one in the preference order
+  loads = {0, 0, 0, 0};
+  loads[owner] = 8;
+  std::vector<uint32_t> order;
+  table->Walk(hash, [&order](uint32_t index) {
+    order.push_back(index);
+    return true;
+  });
+  ASSERT_EQ(order[1], LookupWithBoundedLoad(*table, hash, 1.25, 8, get_load));
+
+  // No load at all
+  loads = {0, 0, 0, 0};
+  ASSERT_EQ(owner, LookupWithBoundedLoad(*table, hash, 1.0, 0, get_load));
+}
+
+TEST(SelectReplicasTest, RingOrder) {
+  auto snapshot = MakeSnapshot(5);
+  auto table = BuildConsistentHashTable(ConsistentHashType::kRingHash, snapshot, MakeOptions());
+  uint64_t hash = HashString("replica");
+  std::vector<uint32_t> order;
+  table->Walk(hash, [&order](uint32_t index) {
+    order.push_back(index);
+    return true;
+  });
+
+  std::vector<uint32_t> indexes;
+  SelectReplicas(*table, hash, 0, 3, indexes);
+  ASSERT_EQ(std::vector<uint32_t>(order.begin(), order.begin() + 3), indexes);
+
+  // Starts from the replicate index and wraps around
+  indexes.clear();
+  SelectReplicas(*table, hash, 3, 3, indexes);
+  ASSERT_EQ((std::vector<uint32_t>{order[3], order[4], order[0]}), indexes);
+
+  // No more than the endpoints
+  indexes.clear();
+  SelectReplicas(*table, hash, 0, 10, indexes);
+  ASSERT_EQ(order, indexes);
+}
+
+TEST(ConsistentHashTableCacheTest, RebuildOnRevision) {
+  ConsistentHashTableCache cache;
+  cache.SetOptions(MakeOptions());
+  ASSERT_EQ(nullptr, cache.Get("key", ConsistentHashType::kRingHash, nullptr));
+
+  auto snapshot = MakeSnapshot(3);
+  auto table = cache.Get("key", ConsistentHashType::kRingHash, snapshot);
+  ASSERT_NE(nullptr, table);
+  ASSERT_EQ(table, cache.Get("key", ConsistentHashType::kRingHash, MakeSnapshot(3)));
+  ASSERT_NE(table, cache.Get("key", ConsistentHashType::kMaglev, snapshot));
+  ASSERT_NE(table, cache.Get("key", ConsistentHashType::kRingHash, MakeSnapshot(4)));
+}
+
+TEST(ParseConsistentHashTypeTest, Parse) {
+  ConsistentHashType type;
+  ASSERT_TRUE(ParseConsistentHashType("ringHash", type));
+  ASSERT_EQ(ConsistentHashType::kRingHash, type);
+  ASSERT_TRUE(ParseConsistentHashType("maglev", type));
+  ASSERT_EQ(ConsistentHashType::kMaglev, type);
+  ASSERT_TRUE(ParseConsistentHashType("jumpHash", type));
+  ASSERT_EQ(ConsistentHashType::kJumpHash, type);
+  ASSERT_FALSE(ParseConsistentHashType("weightedRandom", type));
+  ASSERT_NE(HashString("a"), HashString("b"));
+}
+
+}  // namespace trpc::naming::polarismesh::testing
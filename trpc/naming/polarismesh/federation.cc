@@ -0,0 +1,115 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#include "trpc/naming/polarismesh/federation.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace trpc::naming::polarismesh {
+
+namespace {
+
+constexpr uint64_t kOne = 1ULL << 32;
+
+}  // namespace
+
+FederationPlan::FederationPlan(std::vector<RoutedSnapshotPtr> clusters, const FederationOptions& options)
+    : clusters_(std::move(clusters)) {
+  // Overprovisioned healthy percentage of every cluster
+  std::vector<double> health(clusters_.size(), 0);
+  double total_health = 0;
+  for (size_t i = 0; i < clusters_.size(); i++) {
+    if (!clusters_[i] || clusters_[i]->endpoints.empty()) {
+      continue;
+    }
+    size_t healthy = std::count_if(clusters_[i]->endpoints.begin(), clusters_[i]->endpoints.end(),
+                                   [](const TrpcEndpointInfo& endpoint) { return endpoint.status != 0; });
+    double healthy_percent = 100.0 * healthy / clusters_[i]->endpoints.size();
+    health[i] = std::min(100.0, healthy_percent * options.overprovisioning_factor / 100);
+    total_health += health[i];
+  }
+
+  cumulative_.resize(clusters_.size(), 0);
+  if (total_health <= 0) {
+    // Nothing is healthy, the calls stay in the preferred cluster
+    std::fill(cumulative_.begin(), cumulative_.end(), kOne);
+    return;
+  }
+
+  double remaining = 100;
+  double cumulative = 0;
+  for (size_t i = 0; i < clusters_.size(); i++) {
+    double load = total_health < 100 ? health[i] * 100 / total_health : std::min(remaining, health[i]);
+    remaining -= load;
+    cumulative += load;
+    cumulative_[i] = static_cast<uint64_t>(std::min(100.0, cumulative) / 100 * kOne);
+  }
+  // Rounding leftovers go to the last cluster with a share
+  for (size_t i = clusters_.size(); i > 0; i--) {
+    if (health[i - 1] > 0) {
+      for (size_t j = i - 1; j < clusters_.size(); j++) {
+        cumulative_[j] = kOne;
+      }
+      break;
+    }
+  }
+}
+
+size_t FederationPlan::Pick(uint64_t random) const {
+  uint64_t point = random & 0xFFFFFFFFULL;
+  auto iter = std::upper_bound(cumulative_.begin(), cumulative_.end(), point);
+  return iter == cumulative_.end() ? 0 : iter - cumulative_.begin();
+}
+
+double FederationPlan::GetLoadPercent(size_t index) const {
+  uint64_t previous = index == 0 ? 0 : cumulative_[index - 1];
+  return static_cast<double>(cumulative_[index] - previous) * 100 / kOne;
+}
+
+std::vector<size_t> RankClustersByLatency(const std::vector<std::string>& names, LocalityLatencyTracker& tracker,
+                                          uint64_t now_ms) {
+  std::vector<size_t> order(names.size());
+  std::vector<double> latencies(names.size(), 0);
+  std::vector<bool> measured(names.size(), false);
+  for (size_t i = 0; i < names.size(); i++) {
+    order[i] = i;
+    measured[i] = tracker.GetLatency(names[i], now_ms, latencies[i]);
+  }
+  std::stable_sort(order.begin(), order.end(), [&latencies, &measured](size_t a, size_t b) {
+    if (measured[a] != measured[b]) {
+      return static_cast<bool>(measured[a]);
+    }
+    return measured[a] && latencies[a] < latencies[b];
+  });
+  return order;
+}
+
+FederationPlanPtr FederationPlanCache::Get(const std::string& key, const std::vector<RoutedSnapshotPtr>& clusters) {
+  static const RoutedSnapshotPtr kEmpty = std::make_shared<RoutedSnapshot>();
+  if (clusters.empty()) {
+    return nullptr;
+  }
+
+  SignatureHasher hasher;
+  for (const auto& cluster : clusters) {
+    // The order of the clusters is signed by the order of their revisions
+    hasher.Add(cluster ? cluster->revision : 0);
+  }
+  const auto& first = clusters[0] ? clusters[0] : kEmpty;
+  return plans_.Get(key, hasher.Get(), first, [this, &clusters](const RoutedSnapshotPtr&) {
+    return std::make_shared<const FederationPlan>(clusters, options_);
+  });
+}
+
+}  // namespace trpc::naming::polarismesh
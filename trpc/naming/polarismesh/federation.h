@@ -0,0 +1,82 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "trpc/naming/polarismesh/locality_latency.h"
+#include "trpc/naming/polarismesh/snapshot_cache.h"
+
+namespace trpc::naming::polarismesh {
+
+struct FederationOptions {
+  /// Overprovisioning factor of the healthy capacity of a cluster, in percent. A cluster keeps all of its calls as long
+  /// as its healthy percentage times the factor is at least 100%
+  uint32_t overprovisioning_factor{140};
+};
+
+/// @brief Share of the calls of every cluster of a federation, in the manner of the priority levels of envoy: a cluster
+///        takes the calls up to its overprovisioned healthy percentage, the rest spills over to the next clusters in
+///        preference order. When the clusters can not take all the calls together, the shares are normalized to their
+///        healthy capacity.
+class FederationPlan {
+ public:
+  /// @param clusters Routed snapshots of the clusters in preference order, nullptr if a cluster is unavailable
+  FederationPlan(std::vector<RoutedSnapshotPtr> clusters, const FederationOptions& options);
+
+  /// @brief Pick the cluster of a call
+  /// @param random Uniformly distributed random number
+  /// @return size_t Index of the cluster, the first one if no cluster is healthy
+  size_t Pick(uint64_t random) const;
+
+  /// @brief Share of the calls of a cluster, in percent
+  double GetLoadPercent(size_t index) const;
+
+  /// @brief The snapshot of a cluster, nullptr if unavailable
+  const RoutedSnapshotPtr& GetCluster(size_t index) const { return clusters_[index]; }
+
+ private:
+  std::vector<RoutedSnapshotPtr> clusters_;
+  // Cumulative shares of the clusters, scaled to 2^32
+  std::vector<uint64_t> cumulative_;
+};
+
+using FederationPlanPtr = std::shared_ptr<const FederationPlan>;
+
+/// @brief Rank the secondary clusters by their measured latency, the clusters without estimate keep their configured
+///        order after the measured ones
+/// @param names Names of the clusters, which are their groups in the tracker
+/// @return std::vector<size_t> Indexes of the clusters, nearest first
+std::vector<size_t> RankClustersByLatency(const std::vector<std::string>& names, LocalityLatencyTracker& tracker,
+                                          uint64_t now_ms);
+
+/// @brief Keeps the federation plan of every selection key, it is rebuilt only when the revision of a cluster snapshot
+///        or the preference order changes
+class FederationPlanCache {
+ public:
+  void SetOptions(const FederationOptions& options) { options_ = options; }
+
+  /// @brief Get the plan of the clusters of key, in preference order
+  FederationPlanPtr Get(const std::string& key, const std::vector<RoutedSnapshotPtr>& clusters);
+
+  void Clear() { plans_.Clear(); }
+
+ private:
+  FederationOptions options_;
+  SnapshotTableCache<FederationPlan> plans_;
+};
+
+}  // namespace trpc::naming::polarismesh
@@ -0,0 +1,102 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#include "trpc/naming/polarismesh/federation.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace trpc::naming::polarismesh::testing {
+
+namespace {
+
+// A cluster with healthy and unhealthy endpoints, ports start from base_port
+RoutedSnapshotPtr MakeCluster(int healthy, int unhealthy, int base_port) {
+  auto snapshot = std::make_shared<RoutedSnapshot>();
+  for (int i = 0; i < healthy + unhealthy; i++) {
+    TrpcEndpointInfo endpoint;
+    endpoint.host = "127.0.0.1";
+    endpoint.port = base_port + i;
+    endpoint.weight = 100;
+    endpoint.status = i < healthy ? 1 : 0;
+    snapshot->endpoints.push_back(endpoint);
+  }
+  snapshot->revision = CalculateEndpointsRevision(snapshot->endpoints);
+  return snapshot;
+}
+
+}  // namespace
+
+TEST(FederationPlanTest, Spillover) {
+  FederationOptions options;
+  // Healthy enough with the overprovisioning
+  FederationPlan healthy({MakeCluster(8, 2, 1000), MakeCluster(10, 0, 2000)}, options);
+  ASSERT_DOUBLE_EQ(100, healthy.GetLoadPercent(0));
+  ASSERT_EQ(0, healthy.Pick(0xFFFFFFFFULL));
+
+  // 50% healthy is 70% of the calls, the rest spills over
+  FederationPlan degraded({MakeCluster(5, 5, 1000), MakeCluster(10, 0, 2000)}, options);
+  ASSERT_NEAR(70, degraded.GetLoadPercent(0), 1e-6);
+  ASSERT_NEAR(30, degraded.GetLoadPercent(1), 1e-6);
+  ASSERT_EQ(0, degraded.Pick(0));
+  ASSERT_EQ(1, degraded.Pick(0xFFFFFFFFULL));
+
+  // An unavailable primary cluster
+  FederationPlan unavailable({nullptr, MakeCluster(10, 0, 2000)}, options);
+  ASSERT_DOUBLE_EQ(0, unavailable.GetLoadPercent(0));
+  ASSERT_EQ(1, unavailable.Pick(0));
+}
+
+TEST(FederationPlanTest, Normalized) {
+  FederationOptions options;
+  options.overprovisioning_factor = 100;
+  // 20% + 30% healthy, the shares are normalized to 40% and 60%
+  FederationPlan plan({MakeCluster(2, 8, 1000), MakeCluster(3, 7, 2000)}, options);
+  ASSERT_NEAR(40, plan.GetLoadPercent(0), 1e-6);
+  ASSERT_NEAR(60, plan.GetLoadPercent(1), 1e-6);
+
+  // Nothing healthy, the calls stay in the preferred cluster
+  FederationPlan down({MakeCluster(0, 10, 1000), MakeCluster(0, 10, 2000)}, options);
+  ASSERT_EQ(0, down.Pick(0xFFFFFFFFULL));
+}
+
+TEST(FederationPlanTest, RankClustersByLatency) {
+  LocalityLatencyTracker tracker;
+  LocalityLatencyTracker::Options tracker_options;
+  tracker_options.min_samples = 1;
+  tracker.SetOptions(tracker_options);
+  tracker.AddAddresses(*MakeCluster(1, 0, 1000), "a");
+  tracker.AddAddresses(*MakeCluster(1, 0, 2000), "b");
+  tracker.AddAddresses(*MakeCluster(1, 0, 3000), "c");
+
+  // Nothing measured, the configured order
+  ASSERT_EQ((std::vector<size_t>{0, 1, 2}), RankClustersByLatency({"a", "b", "c"}, tracker, 0));
+
+  tracker.Record("127.0.0.1:1000", 30, 0);
+  tracker.Record("127.0.0.1:3000", 10, 0);
+  ASSERT_EQ((std::vector<size_t>{2, 0, 1}), RankClustersByLatency({"a", "b", "c"}, tracker, 0));
+}
+
+TEST(FederationPlanCacheTest, RebuildOnChange) {
+  FederationPlanCache cache;
+  auto primary = MakeCluster(5, 5, 1000);
+  auto secondary = MakeCluster(10, 0, 2000);
+  auto plan = cache.Get("key", {primary, secondary});
+  ASSERT_EQ(plan, cache.Get("key", {primary, secondary}));
+  ASSERT_NE(plan, cache.Get("key", {primary, MakeCluster(9, 1, 2000)}));
+  ASSERT_NE(nullptr, cache.Get("key", {nullptr, secondary}));
+}
+
+}  // namespace trpc::naming::polarismesh::testing
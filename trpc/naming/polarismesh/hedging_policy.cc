@@ -0,0 +1,83 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#include "trpc/naming/polarismesh/hedging_policy.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace trpc::naming::polarismesh {
+
+std::shared_ptr<HedgingPolicy::Callee> HedgingPolicy::GetCallee(const std::string& service, bool create) {
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto iter = callees_.find(service);
+    if (iter != callees_.end() || !create) {
+      return iter != callees_.end() ? iter->second : nullptr;
+    }
+  }
+
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  auto& entry = callees_[service];
+  if (!entry) {
+    entry = std::make_shared<Callee>(options_.window_ms);
+  }
+  return entry;
+}
+
+void HedgingPolicy::Record(const std::string& service, uint64_t cost_ms, uint64_t hedge_delay_ms, uint64_t now_ms) {
+  auto entry = GetCallee(service, true);
+  entry->latencies.Add(cost_ms, now_ms);
+  entry->hedges.Add(hedge_delay_ms == 0 || cost_ms < hedge_delay_ms, now_ms);
+}
+
+uint64_t HedgingPolicy::GetHedgeDelay(const std::string& service, uint64_t now_ms) {
+  auto entry = GetCallee(service, false);
+  if (!entry) {
+    return 0;
+  }
+
+  // Only the caller which moves the update time forward updates the delay, the others keep the current one
+  uint64_t next_update_ms = entry->next_update_ms.load(std::memory_order_relaxed);
+  if (now_ms >= next_update_ms &&
+      entry->next_update_ms.compare_exchange_strong(next_update_ms, now_ms + options_.interval_ms,
+                                                    std::memory_order_relaxed)) {
+    double latency_ms = 0;
+    uint64_t delay_ms = 0;
+    if (entry->latencies.GetQuantile(options_.quantile, now_ms, options_.min_samples, latency_ms)) {
+      delay_ms = std::max<uint64_t>({1, options_.min_delay_ms, static_cast<uint64_t>(std::ceil(latency_ms))});
+    }
+    entry->delay_ms.store(delay_ms, std::memory_order_relaxed);
+  }
+
+  uint64_t delay_ms = entry->delay_ms.load(std::memory_order_relaxed);
+  if (delay_ms == 0) {
+    return 0;
+  }
+  // An empty window has spent no budget, the calls are hedged until the first of them are recorded
+  auto counts = entry->hedges.Get(now_ms);
+  if (options_.budget_percent == 0 ||
+      (counts.Total() > 0 && counts.failure * 100 >= counts.Total() * options_.budget_percent)) {
+    return 0;
+  }
+  return delay_ms;
+}
+
+void HedgingPolicy::Clear() {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  callees_.clear();
+}
+
+}  // namespace trpc::naming::polarismesh
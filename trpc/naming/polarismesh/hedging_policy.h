@@ -0,0 +1,84 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include "trpc/naming/polarismesh/latency_sketch.h"
+#include "trpc/naming/polarismesh/sliding_window.h"
+
+namespace trpc::naming::polarismesh {
+
+/// @brief Hedging of the calls by the latency of their callee. The latency quantile of every callee is measured over a
+///        sliding window from the cost of its calls, and a call still pending after the quantile sends a hedge to a
+///        backup endpoint. The hedges are capped by a budget, a percentage of the calls of the callee in the window.
+class HedgingPolicy {
+ public:
+  struct Options {
+    /// Quantile of the latencies after which a call is hedged, in [0, 1]
+    double quantile{0.95};
+    /// Window of the latency samples and of the hedge budget, in ms
+    uint64_t window_ms{10000};
+    /// Number of samples in the window needed for the calls to be hedged
+    uint32_t min_samples{100};
+    /// Minimum hedge delay, in ms
+    uint64_t min_delay_ms{1};
+    /// Maximum percentage of the calls of a callee that send a hedge, which is the extra load allowed
+    uint32_t budget_percent{10};
+    /// Interval of updating the hedge delay of a callee, in ms
+    uint64_t interval_ms{1000};
+  };
+
+  void SetOptions(const Options& options) { options_ = options; }
+
+  const Options& GetOptions() const { return options_; }
+
+  /// @brief Record the cost of a call
+  /// @param service Callee of the call
+  /// @param hedge_delay_ms Hedge delay of the call, 0 if it was not hedged. The hedge counts against the budget when
+  ///                       the call lasted longer
+  void Record(const std::string& service, uint64_t cost_ms, uint64_t hedge_delay_ms, uint64_t now_ms);
+
+  /// @brief Get the hedge delay of a call to service, the delay is updated first if it is due
+  /// @return uint64_t The delay in ms, 0 if the call is not hedged: too few samples or the budget is used up
+  uint64_t GetHedgeDelay(const std::string& service, uint64_t now_ms);
+
+  void Clear();
+
+ private:
+  struct Callee {
+    explicit Callee(uint64_t window_ms) : latencies(window_ms), hedges(window_ms) {}
+
+    WindowedLatencySketch latencies;
+    // A success is a call which did not send its hedge, a failure one which did
+    SlidingWindow hedges;
+    std::atomic<uint64_t> delay_ms{0};
+    std::atomic<uint64_t> next_update_ms{0};
+  };
+
+  std::shared_ptr<Callee> GetCallee(const std::string& service, bool create);
+
+ private:
+  Options options_;
+  std::shared_mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<Callee>> callees_;
+};
+
+}  // namespace trpc::naming::polarismesh
@@ -0,0 +1,122 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#include "trpc/naming/polarismesh/hedging_policy.h"
+
+#include "gtest/gtest.h"
+
+namespace trpc::naming::polarismesh::testing {
+
+HedgingPolicy::Options MakeOptions() {
+  HedgingPolicy::Options options;
+  options.quantile = 0.9;
+  options.window_ms = 10000;
+  options.min_samples = 10;
+  options.min_delay_ms = 5;
+  options.budget_percent = 10;
+  options.interval_ms = 1000;
+  return options;
+}
+
+TEST(HedgingPolicyTest, DelayIsLatencyQuantile) {
+  HedgingPolicy policy;
+  policy.SetOptions(MakeOptions());
+  ASSERT_EQ(0, policy.GetHedgeDelay("service", 1000));
+
+  // Too few samples
+  for (int i = 0; i < 5; ++i) {
+    policy.Record("service", 20, 0, 1000);
+  }
+  ASSERT_EQ(0, policy.GetHedgeDelay("service", 1000));
+
+  // Updated after the interval, 95% of the calls answer in 20ms and the others in 200ms
+  for (int i = 0; i < 90; ++i) {
+    policy.Record("service", 20, 0, 1000);
+  }
+  for (int i = 0; i < 5; ++i) {
+    policy.Record("service", 200, 0, 1000);
+  }
+  ASSERT_EQ(0, policy.GetHedgeDelay("service", 1500));
+  uint64_t delay_ms = policy.GetHedgeDelay("service", 2000);
+  ASSERT_GE(delay_ms, 19);
+  ASSERT_LE(delay_ms, 22);
+  ASSERT_EQ(0, policy.GetHedgeDelay("other", 2000));
+
+  // The minimum delay
+  HedgingPolicy fast_policy;
+  fast_policy.SetOptions(MakeOptions());
+  for (int i = 0; i < 20; ++i) {
+    fast_policy.Record("service", 1, 0, 1000);
+  }
+  ASSERT_EQ(5, fast_policy.GetHedgeDelay("service", 1000));
+
+  // The samples leave the window
+  ASSERT_EQ(0, policy.GetHedgeDelay("service", 30000));
+}
+
+TEST(HedgingPolicyTest, HedgeBudget) {
+  HedgingPolicy policy;
+  policy.SetOptions(MakeOptions());
+  for (int i = 0; i < 100; ++i) {
+    policy.Record("service", 20, 0, 1000);
+  }
+  uint64_t delay_ms = policy.GetHedgeDelay("service", 1000);
+  ASSERT_GT(delay_ms, 0);
+
+  // The calls answered before the delay do not send their hedge
+  for (int i = 0; i < 100; ++i) {
+    policy.Record("service", delay_ms - 1, delay_ms, 1000);
+  }
+  ASSERT_EQ(delay_ms, policy.GetHedgeDelay("service", 1000));
+
+  // 19 hedges out of 219 calls are within the 10% budget, 20 more are not
+  for (int i = 0; i < 19; ++i) {
+    policy.Record("service", delay_ms, delay_ms, 1000);
+  }
+  ASSERT_EQ(delay_ms, policy.GetHedgeDelay("service", 1000));
+  for (int i = 0; i < 20; ++i) {
+    policy.Record("service", delay_ms + 100, delay_ms, 1000);
+  }
+  ASSERT_EQ(0, policy.GetHedgeDelay("service", 1000));
+
+  // The hedges leave the window with the calls, the budget is regained
+  for (int i = 0; i < 100; ++i) {
+    policy.Record("service", 20, 0, 12000);
+  }
+  ASSERT_GT(policy.GetHedgeDelay("service", 12000), 0);
+
+  policy.Clear();
+  ASSERT_EQ(0, policy.GetHedgeDelay("service", 12000));
+}
+
+TEST(HedgingPolicyTest, EmptyHedgeWindow) {
+  auto options = MakeOptions();
+  options.interval_ms = 20000;
+  HedgingPolicy policy;
+  policy.SetOptions(options);
+  for (int i = 0; i < 100; ++i) {
+    policy.Record("service", 20, 0, 1000);
+  }
+  uint64_t delay_ms = policy.GetHedgeDelay("service", 1000);
+  ASSERT_GT(delay_ms, 0);
+
+  // No call left in the window, none of the budget is spent
+  ASSERT_EQ(delay_ms, policy.GetHedgeDelay("service", 15000));
+
+  options.budget_percent = 0;
+  policy.SetOptions(options);
+  ASSERT_EQ(0, policy.GetHedgeDelay("service", 15000));
+}
+
+}  // namespace trpc::naming::polarismesh::testing
@@ -0,0 +1,157 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#include "trpc/naming/polarismesh/inflight_tracker.h"
+
+#include <mutex>
+
+namespace trpc::naming::polarismesh {
+
+uint64_t InflightTracker::Begin(const std::string& service, const std::string& address, uint64_t now_ms) {
+  if (now_ms >= generation_end_ms_.load(std::memory_order_relaxed)) {
+    Rotate(now_ms);
+  }
+
+  // The generation can not change while the lock is held, the counters are only rotated with the exclusive lock
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto counters = FindCounters(service, address);
+    if (counters.second != nullptr) {
+      counters.first->total.fetch_add(1, std::memory_order_relaxed);
+      counters.second->current.fetch_add(1, std::memory_order_relaxed);
+      return generation_.load(std::memory_order_relaxed);
+    }
+  }
+
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  auto& service_load = services_[service];
+  if (!service_load) {
+    service_load = std::make_unique<ServiceLoad>();
+  }
+  auto& endpoint_load = service_load->endpoints[address];
+  if (!endpoint_load) {
+    endpoint_load = std::make_unique<EndpointLoad>();
+  }
+  service_load->total.fetch_add(1, std::memory_order_relaxed);
+  endpoint_load->current.fetch_add(1, std::memory_order_relaxed);
+  return generation_.load(std::memory_order_relaxed);
+}
+
+void InflightTracker::End(const std::string& service, const std::string& address, uint64_t generation) {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto counters = FindCounters(service, address);
+  if (counters.second == nullptr) {
+    return;
+  }
+
+  uint64_t current = generation_.load(std::memory_order_relaxed);
+  std::atomic<int64_t>* counter = nullptr;
+  if (generation == current) {
+    counter = &counters.second->current;
+  } else if (generation + 1 == current) {
+    counter = &counters.second->previous;
+  } else {
+    return;
+  }
+  if (Decrease(*counter)) {
+    Decrease(counters.first->total);
+  }
+}
+
+int64_t InflightTracker::Get(const std::string& service, const std::string& address) {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto counters = FindCounters(service, address);
+  if (counters.second == nullptr) {
+    return 0;
+  }
+  return counters.second->current.load(std::memory_order_relaxed) +
+         counters.second->previous.load(std::memory_order_relaxed);
+}
+
+int64_t InflightTracker::GetTotal(const std::string& service) {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto iter = services_.find(service);
+  return iter == services_.end() ? 0 : iter->second->total.load(std::memory_order_relaxed);
+}
+
+size_t InflightTracker::Size() {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  size_t size = 0;
+  for (const auto& item : services_) {
+    size += item.second->endpoints.size();
+  }
+  return size;
+}
+
+void InflightTracker::Clear() {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  services_.clear();
+}
+
+std::pair<InflightTracker::ServiceLoad*, InflightTracker::EndpointLoad*> InflightTracker::FindCounters(
+    const std::string& service, const std::string& address) const {
+  auto iter = services_.find(service);
+  if (iter == services_.end()) {
+    return {nullptr, nullptr};
+  }
+  auto endpoint_iter = iter->second->endpoints.find(address);
+  if (endpoint_iter == iter->second->endpoints.end()) {
+    return {nullptr, nullptr};
+  }
+  return {iter->second.get(), endpoint_iter->second.get()};
+}
+
+void InflightTracker::Rotate(uint64_t now_ms) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  if (now_ms < generation_end_ms_.load(std::memory_order_relaxed)) {
+    // Rotated by another caller
+    return;
+  }
+
+  for (auto iter = services_.begin(); iter != services_.end();) {
+    auto& service_load = *iter->second;
+    auto& endpoints = service_load.endpoints;
+    for (auto endpoint_iter = endpoints.begin(); endpoint_iter != endpoints.end();) {
+      auto& endpoint_load = *endpoint_iter->second;
+      // Not ended within a whole generation, the results of these calls were never reported
+      service_load.total.fetch_sub(endpoint_load.previous.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      endpoint_load.previous.store(endpoint_load.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      endpoint_load.current.store(0, std::memory_order_relaxed);
+      if (endpoint_load.previous.load(std::memory_order_relaxed) == 0) {
+        endpoint_iter = endpoints.erase(endpoint_iter);
+      } else {
+        ++endpoint_iter;
+      }
+    }
+    if (endpoints.empty()) {
+      iter = services_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+
+  generation_.fetch_add(1, std::memory_order_relaxed);
+  generation_end_ms_.store(now_ms + max_call_ms_, std::memory_order_relaxed);
+}
+
+bool InflightTracker::Decrease(std::atomic<int64_t>& counter) {
+  int64_t value = counter.load(std::memory_order_relaxed);
+  while (value > 0) {
+    if (counter.compare_exchange_weak(value, value - 1, std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace trpc::naming::polarismesh
@@ -0,0 +1,87 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace trpc::naming::polarismesh {
+
+/// @brief Counts the in-flight calls of every endpoint and their total per service. The counters are created on first
+///        use and updated under a shared lock afterwards.
+///        The calls are counted in generations of max_call_ms, a call which is not ended by the end of the next
+///        generation is considered leaked (its result was never reported) and is no longer counted. The endpoints
+///        without in-flight calls are dropped with the generations.
+class InflightTracker {
+ public:
+  /// Default length of a generation, in ms
+  static constexpr uint64_t kMaxCallMs = 60000;
+
+  /// @param max_call_ms Minimum time a call is counted for without being ended, in ms
+  explicit InflightTracker(uint64_t max_call_ms = kMaxCallMs) : max_call_ms_(max_call_ms > 0 ? max_call_ms : 1) {}
+
+  /// @brief A call to address of service begins
+  /// @return uint64_t Generation the call is counted in, passed back to End
+  uint64_t Begin(const std::string& service, const std::string& address, uint64_t now_ms);
+
+  /// @brief A call to address of service ends, the counters never drop below 0. A call of an expired generation is
+  ///        not counted any more and is ignored
+  void End(const std::string& service, const std::string& address, uint64_t generation);
+
+  /// @brief In-flight calls of address of service
+  int64_t Get(const std::string& service, const std::string& address);
+
+  /// @brief In-flight calls of all the endpoints of service
+  int64_t GetTotal(const std::string& service);
+
+  /// @brief Number of endpoints tracked
+  size_t Size();
+
+  void Clear();
+
+ private:
+  // Calls of the current generation and of the previous one
+  struct EndpointLoad {
+    std::atomic<int64_t> current{0};
+    std::atomic<int64_t> previous{0};
+  };
+
+  struct ServiceLoad {
+    std::atomic<int64_t> total{0};
+    std::unordered_map<std::string, std::unique_ptr<EndpointLoad>> endpoints;
+  };
+
+  // Find the counters of address of service, nullptr if absent. Called with the lock held
+  std::pair<ServiceLoad*, EndpointLoad*> FindCounters(const std::string& service, const std::string& address) const;
+
+  // Start a new generation if the current one is over, the calls of the previous one are dropped
+  void Rotate(uint64_t now_ms);
+
+  // Decrease counter if it is positive, returns whether it is decreased
+  static bool Decrease(std::atomic<int64_t>& counter);
+
+ private:
+  uint64_t max_call_ms_;
+  std::atomic<uint64_t> generation_{0};
+  std::atomic<uint64_t> generation_end_ms_{0};
+  std::shared_mutex mutex_;
+  std::unordered_map<std::string, std::unique_ptr<ServiceLoad>> services_;
+};
+
+}  // namespace trpc::naming::polarismesh
@@ -0,0 +1,91 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#include "trpc/naming/polarismesh/inflight_tracker.h"
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace trpc::naming::polarismesh::testing {
+
+TEST(InflightTrackerTest, BeginAndEnd) {
+  InflightTracker tracker;
+  uint64_t generation = tracker.Begin("Test|svc", "127.0.0.1:80", 0);
+  tracker.Begin("Test|svc", "127.0.0.1:80", 0);
+  tracker.Begin("Test|svc", "127.0.0.2:80", 0);
+  ASSERT_EQ(2, tracker.Get("Test|svc", "127.0.0.1:80"));
+  ASSERT_EQ(3, tracker.GetTotal("Test|svc"));
+  ASSERT_EQ(0, tracker.GetTotal("Test|other"));
+
+  tracker.End("Test|svc", "127.0.0.1:80", generation);
+  ASSERT_EQ(1, tracker.Get("Test|svc", "127.0.0.1:80"));
+  ASSERT_EQ(2, tracker.GetTotal("Test|svc"));
+
+  // Unknown or extra ends are ignored
+  tracker.End("Test|svc", "127.0.0.3:80", generation);
+  tracker.End("Test|svc", "127.0.0.2:80", generation);
+  tracker.End("Test|svc", "127.0.0.2:80", generation);
+  ASSERT_EQ(0, tracker.Get("Test|svc", "127.0.0.2:80"));
+  ASSERT_EQ(1, tracker.GetTotal("Test|svc"));
+}
+
+TEST(InflightTrackerTest, LeakedCallsExpire) {
+  InflightTracker tracker(1000);
+  uint64_t first = tracker.Begin("Test|svc", "127.0.0.1:80", 0);
+  tracker.Begin("Test|svc", "127.0.0.1:80", 0);
+  tracker.Begin("Test|svc", "127.0.0.2:80", 0);
+
+  // Still counted in the next generation, and ended from it
+  uint64_t second = tracker.Begin("Test|svc", "127.0.0.1:80", 1000);
+  ASSERT_NE(first, second);
+  ASSERT_EQ(4, tracker.GetTotal("Test|svc"));
+  tracker.End("Test|svc", "127.0.0.1:80", first);
+  ASSERT_EQ(2, tracker.Get("Test|svc", "127.0.0.1:80"));
+  ASSERT_EQ(3, tracker.GetTotal("Test|svc"));
+
+  // The calls of the first generation never ended, they are dropped with the endpoints left without calls
+  tracker.Begin("Test|other", "127.0.0.3:80", 2000);
+  ASSERT_EQ(1, tracker.Get("Test|svc", "127.0.0.1:80"));
+  ASSERT_EQ(0, tracker.Get("Test|svc", "127.0.0.2:80"));
+  ASSERT_EQ(1, tracker.GetTotal("Test|svc"));
+  ASSERT_EQ(2, tracker.Size());
+
+  // The end of an expired call is ignored
+  tracker.End("Test|svc", "127.0.0.1:80", first);
+  ASSERT_EQ(1, tracker.GetTotal("Test|svc"));
+  tracker.End("Test|svc", "127.0.0.1:80", second);
+  ASSERT_EQ(0, tracker.GetTotal("Test|svc"));
+}
+
+TEST(InflightTrackerTest, Concurrent) {
+  InflightTracker tracker;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&tracker, i]() {
+      std::string address = "127.0.0." + std::to_string(i % 2) + ":80";
+      for (int j = 0; j < 1000; j++) {
+        tracker.End("Test|svc", address, tracker.Begin("Test|svc", address, 0));
+      }
+      tracker.Begin("Test|svc", address, 0);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(4, tracker.GetTotal("Test|svc"));
+  ASSERT_EQ(2, tracker.Get("Test|svc", "127.0.0.0:80"));
+}
+
+}  // namespace trpc::naming::polarismesh::testing
@@ -0,0 +1,197 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#include "trpc/naming/polarismesh/latency_outlier.h"
+
+#include <algorithm>
+
+namespace trpc::naming::polarismesh {
+
+std::shared_ptr<LatencyOutlierDetector::Service> LatencyOutlierDetector::GetService(const std::string& service,
+                                                                                     bool create) {
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto iter = services_.find(service);
+    if (iter != services_.end() || !create) {
+      return iter != services_.end() ? iter->second : nullptr;
+    }
+  }
+
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  auto& entry = services_[service];
+  if (!entry) {
+    entry = std::make_shared<Service>();
+  }
+  return entry;
+}
+
+void LatencyOutlierDetector::Record(const std::string& service, const std::string& address, uint64_t cost_ms,
+                                    uint64_t now_ms) {
+  auto entry = GetService(service, true);
+  {
+    std::shared_lock<std::shared_mutex> lock(entry->hosts_mutex);
+    auto iter = entry->hosts.find(address);
+    if (iter != entry->hosts.end()) {
+      iter->second->sketch.Add(cost_ms, now_ms);
+      return;
+    }
+  }
+
+  std::unique_lock<std::shared_mutex> lock(entry->hosts_mutex);
+  auto& host = entry->hosts[address];
+  if (!host) {
+    host = std::make_unique<Host>(options_.window_ms);
+  }
+  host->sketch.Add(cost_ms, now_ms);
+}
+
+LatencyEjectionsPtr LatencyOutlierDetector::GetEjections(const std::string& service, uint64_t now_ms) {
+  auto entry = GetService(service, false);
+  if (!entry) {
+    return nullptr;
+  }
+
+  // Only one caller runs the detection of a callee, the others keep the current ejections
+  if (now_ms >= entry->next_detect_ms.load(std::memory_order_relaxed) && entry->detect_mutex.try_lock()) {
+    std::lock_guard<std::mutex> lock(entry->detect_mutex, std::adopt_lock);
+    if (now_ms >= entry->next_detect_ms.load(std::memory_order_relaxed)) {
+      Detect(*entry, now_ms);
+      entry->next_detect_ms.store(now_ms + options_.interval_ms, std::memory_order_relaxed);
+    }
+  }
+  return std::atomic_load(&entry->ejections);
+}
+
+void LatencyOutlierDetector::Detect(Service& service, uint64_t now_ms) {
+  struct Judged {
+    const std::string* address;
+    Host* host;
+    double latency_ms;
+  };
+
+  // The hosts are only erased below, by the detection itself, so the pointers stay valid out of the lock
+  std::vector<Judged> judged;
+  std::vector<std::string> idle;
+  std::vector<std::string> ejected;
+  size_t host_num = 0;
+  {
+    std::shared_lock<std::shared_mutex> lock(service.hosts_mutex);
+    host_num = service.hosts.size();
+    for (auto& [address, host] : service.hosts) {
+      if (host->ejected_until_ms > now_ms) {
+        ejected.push_back(address);
+        continue;
+      }
+      host->ejected_until_ms = 0;
+      double latency_ms = 0;
+      if (host->sketch.GetQuantile(options_.quantile, now_ms, options_.min_samples, latency_ms)) {
+        judged.push_back(Judged{&address, host.get(), latency_ms});
+      } else if (host->ejection_count == 0 && host->sketch.GetCount(now_ms) == 0) {
+        idle.push_back(address);
+      }
+    }
+  }
+
+  if (judged.size() >= std::max<uint32_t>(1, options_.min_hosts)) {
+    std::vector<double> latencies;
+    latencies.reserve(judged.size());
+    for (const auto& item : judged) {
+      latencies.push_back(item.latency_ms);
+    }
+    auto middle = latencies.begin() + latencies.size() / 2;
+    std::nth_element(latencies.begin(), middle, latencies.end());
+    double threshold = std::max(*middle * options_.ratio, static_cast<double>(options_.min_latency_ms));
+
+    size_t max_ejected = 0;
+    if (options_.max_ejection_percent > 0) {
+      max_ejected = std::max<size_t>(1, host_num * std::min<uint32_t>(options_.max_ejection_percent, 100) / 100);
+    }
+
+    // The slowest outliers are ejected first
+    std::sort(judged.begin(), judged.end(),
+              [](const Judged& a, const Judged& b) { return a.latency_ms > b.latency_ms; });
+    for (auto& item : judged) {
+      Host& host = *item.host;
+      if (item.latency_ms > threshold) {
+        if (ejected.size() < max_ejected) {
+          ++host.ejection_count;
+          uint64_t ejection_ms = std::min(options_.base_ejection_ms * host.ejection_count, options_.max_ejection_ms);
+          host.ejected_until_ms = now_ms + ejection_ms;
+          host.last_ejection_ms = now_ms;
+          ejected.push_back(*item.address);
+        }
+      } else if (host.ejection_count > 0 && now_ms >= host.last_ejection_ms + options_.max_ejection_ms) {
+        // An endpoint staying healthy is forgiven one ejection per maximum ejection time
+        --host.ejection_count;
+        host.last_ejection_ms = now_ms;
+      }
+    }
+  }
+
+  if (!idle.empty()) {
+    std::unique_lock<std::shared_mutex> lock(service.hosts_mutex);
+    for (const auto& address : idle) {
+      auto iter = service.hosts.find(address);
+      if (iter != service.hosts.end() && iter->second->sketch.GetCount(now_ms) == 0) {
+        service.hosts.erase(iter);
+      }
+    }
+  }
+
+  std::sort(ejected.begin(), ejected.end());
+  SignatureHasher hasher;
+  for (const auto& address : ejected) {
+    hasher.Add(address);
+  }
+  auto current = std::atomic_load(&service.ejections);
+  uint64_t revision = ejected.empty() ? 0 : hasher.Get();
+  if ((current ? current->revision : 0) == revision) {
+    return;
+  }
+
+  std::shared_ptr<LatencyEjections> ejections;
+  if (!ejected.empty()) {
+    ejections = std::make_shared<LatencyEjections>();
+    ejections->addresses.insert(ejected.begin(), ejected.end());
+    ejections->revision = revision;
+  }
+  std::atomic_store(&service.ejections, LatencyEjectionsPtr(std::move(ejections)));
+}
+
+RoutedSnapshotPtr LatencyOutlierDetector::Apply(const std::string& service, const std::string& key,
+                                                const RoutedSnapshotPtr& snapshot, uint64_t now_ms) {
+  if (!snapshot) {
+    return nullptr;
+  }
+  auto ejections = GetEjections(service, now_ms);
+  if (!ejections) {
+    return snapshot;
+  }
+
+  uint64_t revision = SignatureHasher().Add(snapshot->revision).Add(ejections->revision).Get();
+  auto result = snapshots_.Get(key, revision, snapshot, [&ejections](const RoutedSnapshotPtr& origin) {
+    return RemoveEndpoints(origin, ejections->addresses);
+  });
+  return result ? result : snapshot;
+}
+
+void LatencyOutlierDetector::Clear() {
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    services_.clear();
+  }
+  snapshots_.Clear();
+}
+
+}  // namespace trpc::naming::polarismesh
@@ -0,0 +1,124 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "trpc/naming/polarismesh/latency_sketch.h"
+#include "trpc/naming/polarismesh/snapshot_cache.h"
+
+namespace trpc::naming::polarismesh {
+
+/// @brief Endpoints of a callee ejected for their latency
+struct LatencyEjections {
+  /// Addresses of the ejected endpoints, "host:port"
+  std::unordered_set<std::string> addresses;
+  /// Signature of the addresses, the same set has the same revision
+  uint64_t revision{0};
+};
+
+using LatencyEjectionsPtr = std::shared_ptr<const LatencyEjections>;
+
+/// @brief Passive outlier detection by latency. The latency quantile of every endpoint of a callee is measured over a
+///        sliding window from the cost of its calls, and an endpoint whose quantile is more than ratio times the
+///        median of its peers is ejected for a backoff growing with its repeated ejections. At most a percentage of
+///        the endpoints is ejected at the same time, the slowest first.
+class LatencyOutlierDetector {
+ public:
+  struct Options {
+    /// Window of the latency samples, in ms
+    uint64_t window_ms{10000};
+    /// Quantile of the latencies compared, in [0, 1]
+    double quantile{0.99};
+    /// An endpoint is an outlier when its quantile is more than ratio times the median quantile of the endpoints
+    double ratio{5.0};
+    /// Quantile below which an endpoint is never an outlier, in ms
+    uint64_t min_latency_ms{10};
+    /// Number of samples in the window needed to judge an endpoint
+    uint32_t min_samples{50};
+    /// Number of endpoints judged needed to compute the median
+    uint32_t min_hosts{3};
+    /// Ejection time of the first ejection, it grows linearly with the repeated ejections, in ms
+    uint64_t base_ejection_ms{30000};
+    /// Maximum ejection time, in ms
+    uint64_t max_ejection_ms{300000};
+    /// Maximum percentage of the endpoints of a callee ejected at the same time, at least one can be ejected
+    uint32_t max_ejection_percent{10};
+    /// Interval of the detection of a callee, in ms
+    uint64_t interval_ms{1000};
+  };
+
+  void SetOptions(const Options& options) { options_ = options; }
+
+  const Options& GetOptions() const { return options_; }
+
+  /// @brief Record the cost of a call
+  /// @param service Callee of the call
+  /// @param address Address of the endpoint called, "host:port"
+  void Record(const std::string& service, const std::string& address, uint64_t cost_ms, uint64_t now_ms);
+
+  /// @brief Get the endpoints of service ejected at now_ms, the detection runs first if it is due
+  /// @return LatencyEjectionsPtr nullptr if none is ejected
+  LatencyEjectionsPtr GetEjections(const std::string& service, uint64_t now_ms);
+
+  /// @brief Get the snapshot of key of service without the ejected endpoints, the filtered snapshot is kept until the
+  ///        ejections or the snapshot change
+  /// @return RoutedSnapshotPtr snapshot itself when none of its endpoints is ejected, or all of them are
+  RoutedSnapshotPtr Apply(const std::string& service, const std::string& key, const RoutedSnapshotPtr& snapshot,
+                          uint64_t now_ms);
+
+  void Clear();
+
+ private:
+  struct Host {
+    explicit Host(uint64_t window_ms) : sketch(window_ms) {}
+
+    WindowedLatencySketch sketch;
+    // Guarded by the detection mutex of the service
+    uint32_t ejection_count{0};
+    uint64_t ejected_until_ms{0};
+    // Time of the last ejection or of the last decrease of the ejection count
+    uint64_t last_ejection_ms{0};
+  };
+
+  struct Service {
+    std::shared_mutex hosts_mutex;
+    std::unordered_map<std::string, std::unique_ptr<Host>> hosts;
+    std::atomic<uint64_t> next_detect_ms{0};
+    std::mutex detect_mutex;
+    // Written under the detection mutex, read with atomic_load
+    LatencyEjectionsPtr ejections;
+  };
+
+  std::shared_ptr<Service> GetService(const std::string& service, bool create);
+
+  // Eject the outliers and bring back the endpoints whose ejection expired
+  void Detect(Service& service, uint64_t now_ms);
+
+ private:
+  Options options_;
+  std::shared_mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<Service>> services_;
+  SnapshotTableCache<RoutedSnapshot> snapshots_;
+};
+
+}  // namespace trpc::naming::polarismesh
@@ -0,0 +1,115 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#include "trpc/naming/polarismesh/latency_outlier.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace trpc::naming::polarismesh::testing {
+
+LatencyOutlierDetector::Options MakeOptions() {
+  LatencyOutlierDetector::Options options;
+  options.window_ms = 10000;
+  options.quantile = 0.99;
+  options.ratio = 5.0;
+  options.min_latency_ms = 10;
+  options.min_samples = 10;
+  options.min_hosts = 3;
+  options.base_ejection_ms = 30000;
+  options.max_ejection_ms = 100000;
+  options.max_ejection_percent = 20;
+  options.interval_ms = 1000;
+  return options;
+}
+
+// Ten hosts answering in 10ms, except the slow ones
+void RecordCalls(LatencyOutlierDetector& detector, const std::vector<int>& slow, uint64_t now_ms) {
+  for (int i = 0; i < 10; ++i) {
+    bool is_slow = std::find(slow.begin(), slow.end(), i) != slow.end();
+    for (int n = 0; n < 20; ++n) {
+      detector.Record("service", "host" + std::to_string(i) + ":80", is_slow ? 200 : 10, now_ms);
+    }
+  }
+}
+
+TEST(LatencyOutlierDetectorTest, EjectAndReturn) {
+  LatencyOutlierDetector detector;
+  detector.SetOptions(MakeOptions());
+  ASSERT_EQ(nullptr, detector.GetEjections("service", 1000));
+
+  RecordCalls(detector, {3}, 1000);
+  auto ejections = detector.GetEjections("service", 1000);
+  ASSERT_NE(nullptr, ejections);
+  ASSERT_EQ(1, ejections->addresses.size());
+  ASSERT_EQ(1, ejections->addresses.count("host3:80"));
+
+  // Still ejected before the ejection time ends, back after it
+  ASSERT_EQ(ejections, detector.GetEjections("service", 20000));
+  ASSERT_EQ(nullptr, detector.GetEjections("service", 31000));
+
+  // Ejected again for longer
+  RecordCalls(detector, {3}, 32000);
+  ASSERT_NE(nullptr, detector.GetEjections("service", 32000));
+  ASSERT_NE(nullptr, detector.GetEjections("service", 91000));
+  ASSERT_EQ(nullptr, detector.GetEjections("service", 92000));
+}
+
+TEST(LatencyOutlierDetectorTest, MaxEjectionPercent) {
+  LatencyOutlierDetector detector;
+  detector.SetOptions(MakeOptions());
+
+  // At most 2 of the 10 hosts are ejected
+  RecordCalls(detector, {1, 2, 3}, 1000);
+  auto ejections = detector.GetEjections("service", 1000);
+  ASSERT_NE(nullptr, ejections);
+  ASSERT_EQ(2, ejections->addresses.size());
+
+  // Slow hosts below the minimum latency are not outliers
+  LatencyOutlierDetector fast;
+  auto options = MakeOptions();
+  options.min_latency_ms = 500;
+  fast.SetOptions(options);
+  RecordCalls(fast, {1}, 1000);
+  ASSERT_EQ(nullptr, fast.GetEjections("service", 1000));
+}
+
+TEST(LatencyOutlierDetectorTest, Apply) {
+  LatencyOutlierDetector detector;
+  detector.SetOptions(MakeOptions());
+
+  auto snapshot = std::make_shared<RoutedSnapshot>();
+  for (int i = 0; i < 10; ++i) {
+    TrpcEndpointInfo endpoint;
+    endpoint.host = "host" + std::to_string(i);
+    endpoint.port = 80;
+    endpoint.weight = 100;
+    snapshot->endpoints.push_back(endpoint);
+  }
+  snapshot->revision = CalculateEndpointsRevision(snapshot->endpoints);
+  ASSERT_EQ(snapshot, detector.Apply("service", "key", snapshot, 1000));
+
+  RecordCalls(detector, {3}, 2000);
+  auto result = detector.Apply("service", "key", snapshot, 2000);
+  ASSERT_EQ(9, result->endpoints.size());
+  for (const auto& endpoint : result->endpoints) {
+    ASSERT_NE("host3", endpoint.host);
+  }
+  ASSERT_EQ(result, detector.Apply("service", "key", snapshot, 2500));
+}
+
+}  // namespace trpc::naming::polarismesh::testing
@@ -0,0 +1,134 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#include "trpc/naming/polarismesh/latency_sketch.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace trpc::naming::polarismesh {
+
+namespace {
+
+// Ratio of the bounds of a bucket
+const double kGamma = (1 + LatencySketch::kRelativeError) / (1 - LatencySketch::kRelativeError);
+const double kLogGamma = std::log(kGamma);
+
+}  // namespace
+
+uint32_t LatencySketch::GetBucket(uint64_t latency_ms) {
+  if (latency_ms <= 1) {
+    return 0;
+  }
+  // Bucket i holds (gamma^(i-1), gamma^i]
+  auto bucket = static_cast<uint32_t>(std::ceil(std::log(static_cast<double>(latency_ms)) / kLogGamma));
+  return std::min(bucket, kBucketNum - 1);
+}
+
+double LatencySketch::GetBucketValue(uint32_t bucket) {
+  if (bucket == 0) {
+    return 1.0;
+  }
+  return 2 * std::pow(kGamma, bucket) / (kGamma + 1);
+}
+
+double LatencySketch::GetQuantile(const Counts& counts, double quantile) {
+  uint64_t total = 0;
+  for (auto count : counts) {
+    total += count;
+  }
+  if (total == 0) {
+    return 0;
+  }
+
+  auto rank = static_cast<uint64_t>(std::clamp(quantile, 0.0, 1.0) * (total - 1));
+  uint64_t seen = 0;
+  for (uint32_t i = 0; i < kBucketNum; ++i) {
+    seen += counts[i];
+    if (seen > rank) {
+      return GetBucketValue(i);
+    }
+  }
+  return GetBucketValue(kBucketNum - 1);
+}
+
+uint64_t LatencySketch::AddTo(Counts& counts) const {
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < kBucketNum; ++i) {
+    uint64_t count = buckets_[i].load(std::memory_order_relaxed);
+    counts[i] += count;
+    total += count;
+  }
+  return total;
+}
+
+void LatencySketch::Reset() {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+}
+
+WindowedLatencySketch::WindowedLatencySketch(uint64_t window_ms, uint32_t slice_num)
+    : slice_num_(std::max<uint32_t>(1, slice_num)) {
+  slice_ms_ = std::max<uint64_t>(1, window_ms / slice_num_);
+  slices_ = std::make_unique<Slice[]>(slice_num_);
+}
+
+void WindowedLatencySketch::Add(uint64_t latency_ms, uint64_t now_ms) {
+  // Periods start from 1, 0 marks a slice never used
+  uint64_t period = now_ms / slice_ms_ + 1;
+  auto& slice = slices_[period % slice_num_];
+  uint64_t current = slice.period.load(std::memory_order_acquire);
+  if (current != period) {
+    if (current > period) {
+      // A late sample of a slice already recycled
+      return;
+    }
+    if (slice.period.compare_exchange_strong(current, period, std::memory_order_acq_rel)) {
+      slice.sketch.Reset();
+    }
+  }
+  slice.sketch.Add(latency_ms);
+}
+
+uint64_t WindowedLatencySketch::GetCounts(uint64_t now_ms, LatencySketch::Counts& counts) const {
+  counts.fill(0);
+  uint64_t period = now_ms / slice_ms_ + 1;
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < slice_num_; ++i) {
+    uint64_t slice_period = slices_[i].period.load(std::memory_order_acquire);
+    if (slice_period != 0 && slice_period <= period && slice_period + slice_num_ > period) {
+      total += slices_[i].sketch.AddTo(counts);
+    }
+  }
+  return total;
+}
+
+bool WindowedLatencySketch::GetQuantile(double quantile, uint64_t now_ms, uint64_t min_samples,
+                                        double& latency_ms) const {
+  LatencySketch::Counts counts;
+  uint64_t total = GetCounts(now_ms, counts);
+  if (total == 0 || total < min_samples) {
+    return false;
+  }
+  latency_ms = LatencySketch::GetQuantile(counts, quantile);
+  return true;
+}
+
+uint64_t WindowedLatencySketch::GetCount(uint64_t now_ms) const {
+  LatencySketch::Counts counts;
+  return GetCounts(now_ms, counts);
+}
+
+}  // namespace trpc::naming::polarismesh
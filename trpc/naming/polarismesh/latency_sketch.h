@@ -0,0 +1,94 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace trpc::naming::polarismesh {
+
+/// @brief Histogram of latencies in logarithmic buckets, the quantiles read from it are within kRelativeError of the
+///        exact ones whatever the distribution. Adding a sample is a single relaxed atomic increment.
+class LatencySketch {
+ public:
+  /// Relative error of the quantiles
+  static constexpr double kRelativeError = 0.05;
+  /// Number of buckets, the last one takes the latencies of more than about two hours
+  static constexpr uint32_t kBucketNum = 160;
+
+  using Counts = std::array<uint64_t, kBucketNum>;
+
+  /// @brief Bucket of a latency in ms, latencies below 1 ms share the first bucket
+  static uint32_t GetBucket(uint64_t latency_ms);
+
+  /// @brief Representative latency of a bucket in ms, the one with the least relative error to the bucket bounds
+  static double GetBucketValue(uint32_t bucket);
+
+  /// @brief Quantile of the counts of the buckets
+  /// @param quantile In [0, 1]
+  /// @return double The latency in ms, 0 if the counts are empty
+  static double GetQuantile(const Counts& counts, double quantile);
+
+  void Add(uint64_t latency_ms) { buckets_[GetBucket(latency_ms)].fetch_add(1, std::memory_order_relaxed); }
+
+  /// @brief Add the counts of the buckets to counts
+  /// @return uint64_t Number of samples added
+  uint64_t AddTo(Counts& counts) const;
+
+  void Reset();
+
+ private:
+  std::array<std::atomic<uint32_t>, kBucketNum> buckets_{};
+};
+
+/// @brief Latency sketch over a sliding time window, made of slices which are recycled as the window moves. A slice
+///        is cleared by the first sample of its new period, the samples racing with the clearing may be lost, which
+///        the quantiles tolerate.
+class WindowedLatencySketch {
+ public:
+  /// @param window_ms Length of the window, in ms
+  /// @param slice_num Number of slices of the window, the window moves by one slice at a time
+  explicit WindowedLatencySketch(uint64_t window_ms, uint32_t slice_num = 4);
+
+  void Add(uint64_t latency_ms, uint64_t now_ms);
+
+  /// @brief Merge the counts of the slices in the window of now_ms
+  /// @return uint64_t Number of samples in the window
+  uint64_t GetCounts(uint64_t now_ms, LatencySketch::Counts& counts) const;
+
+  /// @brief Quantile of the latencies in the window
+  /// @param min_samples Minimum number of samples for the quantile to be known
+  /// @param[out] latency_ms The quantile
+  /// @return bool Whether the quantile is known
+  bool GetQuantile(double quantile, uint64_t now_ms, uint64_t min_samples, double& latency_ms) const;
+
+  /// @brief Number of samples in the window of now_ms
+  uint64_t GetCount(uint64_t now_ms) const;
+
+ private:
+  struct Slice {
+    // Period of the slice, the time divided by the slice length
+    std::atomic<uint64_t> period{0};
+    LatencySketch sketch;
+  };
+
+  uint64_t slice_ms_;
+  std::unique_ptr<Slice[]> slices_;
+  uint32_t slice_num_;
+};
+
+}  // namespace trpc::naming::polarismesh
@@ -0,0 +1,75 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#include "trpc/naming/polarismesh/latency_sketch.h"
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+namespace trpc::naming::polarismesh::testing {
+
+TEST(LatencySketchTest, Quantile) {
+  LatencySketch sketch;
+  for (uint64_t latency = 1; latency <= 1000; ++latency) {
+    sketch.Add(latency);
+  }
+
+  LatencySketch::Counts counts{};
+  ASSERT_EQ(1000, sketch.AddTo(counts));
+  for (double quantile : {0.5, 0.9, 0.99}) {
+    double exact = quantile * 1000;
+    ASSERT_NEAR(exact, LatencySketch::GetQuantile(counts, quantile), exact * LatencySketch::kRelativeError + 1);
+  }
+
+  // Every latency is within the relative error of the value of its bucket
+  for (uint64_t latency : {2, 17, 250, 4000, 60000}) {
+    double value = LatencySketch::GetBucketValue(LatencySketch::GetBucket(latency));
+    ASSERT_LE(std::abs(value - latency), latency * LatencySketch::kRelativeError + 1e-9);
+  }
+  ASSERT_EQ(LatencySketch::kBucketNum - 1, LatencySketch::GetBucket(UINT64_MAX));
+
+  sketch.Reset();
+  counts.fill(0);
+  ASSERT_EQ(0, sketch.AddTo(counts));
+  ASSERT_EQ(0, LatencySketch::GetQuantile(counts, 0.5));
+}
+
+TEST(WindowedLatencySketchTest, Window) {
+  WindowedLatencySketch sketch(4000, 4);
+  for (int i = 0; i < 100; ++i) {
+    sketch.Add(10, 500);
+  }
+  for (int i = 0; i < 100; ++i) {
+    sketch.Add(100, 2500);
+  }
+  ASSERT_EQ(200, sketch.GetCount(3000));
+
+  double latency = 0;
+  ASSERT_FALSE(sketch.GetQuantile(0.5, 3000, 500, latency));
+  ASSERT_TRUE(sketch.GetQuantile(0.99, 3000, 100, latency));
+  ASSERT_NEAR(100, latency, 100 * LatencySketch::kRelativeError);
+
+  // The first slice leaves the window, then the whole window moves past the samples
+  ASSERT_EQ(100, sketch.GetCount(4500));
+  ASSERT_TRUE(sketch.GetQuantile(0.01, 4500, 1, latency));
+  ASSERT_NEAR(100, latency, 100 * LatencySketch::kRelativeError);
+  ASSERT_EQ(0, sketch.GetCount(7000));
+
+  // A recycled slice starts over
+  sketch.Add(10, 8500);
+  ASSERT_EQ(1, sketch.GetCount(8500));
+}
+
+}  // namespace trpc::naming::polarismesh::testing
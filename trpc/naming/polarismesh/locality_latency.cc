@@ -0,0 +1,100 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#include "trpc/naming/polarismesh/locality_latency.h"
+
+#include <algorithm>
+
+namespace trpc::naming::polarismesh {
+
+std::string GetLocalityGroupKey(const EndpointLocation& location) {
+  return location.region + "/" + location.zone + "/" + location.campus;
+}
+
+void LocalityLatencyTracker::AddLocations(const RoutedSnapshot& snapshot) {
+  if (snapshot.locations.size() != snapshot.endpoints.size()) {
+    return;
+  }
+
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  if (addresses_.size() + snapshot.endpoints.size() > options_.max_addresses) {
+    addresses_.clear();
+  }
+  for (size_t i = 0; i < snapshot.endpoints.size(); i++) {
+    AddAddress(snapshot.endpoints[i], GetLocalityGroupKey(snapshot.locations[i]));
+  }
+}
+
+void LocalityLatencyTracker::AddAddresses(const RoutedSnapshot& snapshot, const std::string& group_key) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  if (addresses_.size() + snapshot.endpoints.size() > options_.max_addresses) {
+    addresses_.clear();
+  }
+  for (const auto& endpoint : snapshot.endpoints) {
+    AddAddress(endpoint, group_key);
+  }
+}
+
+void LocalityLatencyTracker::AddAddress(const TrpcEndpointInfo& endpoint, const std::string& group_key) {
+  auto& estimate = groups_[group_key];
+  if (!estimate) {
+    estimate = std::make_unique<Estimate>();
+  }
+  // A moved endpoint is attributed to its new group
+  addresses_[endpoint.host + ":" + std::to_string(endpoint.port)] = estimate.get();
+}
+
+void LocalityLatencyTracker::Record(const std::string& address, uint64_t cost_ms, uint64_t now_ms) {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto iter = addresses_.find(address);
+  if (iter == addresses_.end()) {
+    return;
+  }
+
+  auto& estimate = *iter->second;
+  std::lock_guard<std::mutex> estimate_lock(estimate.mutex);
+  // An expired estimate starts over, the old samples no longer describe the network
+  if (estimate.samples == 0 || now_ms > estimate.update_time_ms + options_.expire_ms) {
+    estimate.latency_ms = static_cast<double>(cost_ms);
+    estimate.samples = 1;
+  } else {
+    estimate.latency_ms += options_.decay * (static_cast<double>(cost_ms) - estimate.latency_ms);
+    // Capped, only whether the estimate is usable matters
+    estimate.samples = std::min(estimate.samples + 1, std::max<uint32_t>(1, options_.min_samples));
+  }
+  estimate.update_time_ms = now_ms;
+}
+
+bool LocalityLatencyTracker::GetLatency(const std::string& group_key, uint64_t now_ms, double& latency_ms) {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto iter = groups_.find(group_key);
+  if (iter == groups_.end()) {
+    return false;
+  }
+
+  auto& estimate = *iter->second;
+  std::lock_guard<std::mutex> estimate_lock(estimate.mutex);
+  if (estimate.samples < options_.min_samples || now_ms > estimate.update_time_ms + options_.expire_ms) {
+    return false;
+  }
+  latency_ms = estimate.latency_ms;
+  return true;
+}
+
+void LocalityLatencyTracker::Clear() {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  addresses_.clear();
+  groups_.clear();
+}
+
+}  // namespace trpc::naming::polarismesh
@@ -0,0 +1,85 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include "trpc/naming/polarismesh/snapshot_cache.h"
+
+namespace trpc::naming::polarismesh {
+
+/// @brief Key of the locality group of a location, the endpoints of a campus form a group
+std::string GetLocalityGroupKey(const EndpointLocation& location);
+
+/// @brief Passive latency estimates of the locality groups of the callees, an exponential moving average of the cost
+///        of the calls made to their endpoints. The estimates measure the network distance that the region, zone and
+///        campus labels only approximate.
+class LocalityLatencyTracker {
+ public:
+  struct Options {
+    /// Weight of a new sample in the moving average, in (0, 1]
+    double decay{0.2};
+    /// Number of samples needed before the estimate of a group is used
+    uint32_t min_samples{20};
+    /// Age after which an estimate without new samples is unknown again, in ms
+    uint64_t expire_ms{60000};
+    /// Maximum number of endpoint addresses kept, the addresses are registered again when the map is reset
+    size_t max_addresses{100000};
+  };
+
+  void SetOptions(const Options& options) { options_ = options; }
+
+  const Options& GetOptions() const { return options_; }
+
+  /// @brief Register the locations of the endpoints of snapshot, the calls to them are then attributed to their groups
+  void AddLocations(const RoutedSnapshot& snapshot);
+
+  /// @brief Register the endpoints of snapshot in one group, whatever their locations
+  void AddAddresses(const RoutedSnapshot& snapshot, const std::string& group_key);
+
+  /// @brief Record the cost of a call to address, ignored if address is not registered
+  /// @param address "host:port" of the endpoint
+  void Record(const std::string& address, uint64_t cost_ms, uint64_t now_ms);
+
+  /// @brief Get the estimate of a group
+  /// @param[out] latency_ms The estimate
+  /// @return bool Whether the group has a usable estimate
+  bool GetLatency(const std::string& group_key, uint64_t now_ms, double& latency_ms);
+
+  void Clear();
+
+ private:
+  struct Estimate {
+    std::mutex mutex;
+    double latency_ms{0};
+    uint32_t samples{0};
+    uint64_t update_time_ms{0};
+  };
+
+  // Register an endpoint in a group, called with the lock held
+  void AddAddress(const TrpcEndpointInfo& endpoint, const std::string& group_key);
+
+ private:
+  Options options_;
+  std::shared_mutex mutex_;
+  std::unordered_map<std::string, std::unique_ptr<Estimate>> groups_;
+  // Estimate of the group of every endpoint address, owned by groups_
+  std::unordered_map<std::string, Estimate*> addresses_;
+};
+
+}  // namespace trpc::naming::polarismesh
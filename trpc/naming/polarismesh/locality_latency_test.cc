@@ -0,0 +1,96 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#include "trpc/naming/polarismesh/locality_latency.h"
+
+#include "gtest/gtest.h"
+
+namespace trpc::naming::polarismesh::testing {
+
+namespace {
+
+RoutedSnapshot MakeSnapshot(const std::vector<EndpointLocation>& locations) {
+  RoutedSnapshot snapshot;
+  for (size_t i = 0; i < locations.size(); i++) {
+    TrpcEndpointInfo endpoint;
+    endpoint.host = "127.0.0.1";
+    endpoint.port = 10000 + i;
+    snapshot.endpoints.push_back(endpoint);
+  }
+  snapshot.locations = locations;
+  return snapshot;
+}
+
+}  // namespace
+
+TEST(LocalityLatencyTrackerTest, MovingAverage) {
+  LocalityLatencyTracker tracker;
+  LocalityLatencyTracker::Options options;
+  options.decay = 0.5;
+  options.min_samples = 2;
+  options.expire_ms = 1000;
+  tracker.SetOptions(options);
+  tracker.AddLocations(MakeSnapshot({{"south", "sz", "sz1"}, {"south", "sz", "sz1"}, {"south", "gz", "gz1"}}));
+
+  std::string group = GetLocalityGroupKey({"south", "sz", "sz1"});
+  double latency = 0;
+  tracker.Record("127.0.0.1:10000", 10, 100);
+  // Not enough samples
+  ASSERT_FALSE(tracker.GetLatency(group, 100, latency));
+
+  // The samples of the endpoints of a group are averaged together
+  tracker.Record("127.0.0.1:10001", 20, 200);
+  ASSERT_TRUE(tracker.GetLatency(group, 200, latency));
+  ASSERT_DOUBLE_EQ(15, latency);
+  ASSERT_FALSE(tracker.GetLatency(GetLocalityGroupKey({"south", "gz", "gz1"}), 200, latency));
+
+  // Unknown addresses are ignored
+  tracker.Record("127.0.0.2:10000", 1000, 300);
+  ASSERT_TRUE(tracker.GetLatency(group, 300, latency));
+  ASSERT_DOUBLE_EQ(15, latency);
+
+  // Expired, then started over
+  ASSERT_FALSE(tracker.GetLatency(group, 1300, latency));
+  tracker.Record("127.0.0.1:10000", 50, 1300);
+  ASSERT_FALSE(tracker.GetLatency(group, 1300, latency));
+}
+
+TEST(LocalityLatencyTrackerTest, MovedEndpoint) {
+  LocalityLatencyTracker tracker;
+  LocalityLatencyTracker::Options options;
+  options.min_samples = 1;
+  tracker.SetOptions(options);
+  tracker.AddLocations(MakeSnapshot({{"south", "sz", "sz1"}}));
+  tracker.AddLocations(MakeSnapshot({{"south", "gz", "gz1"}}));
+
+  tracker.Record("127.0.0.1:10000", 10, 100);
+  double latency = 0;
+  ASSERT_FALSE(tracker.GetLatency(GetLocalityGroupKey({"south", "sz", "sz1"}), 100, latency));
+  ASSERT_TRUE(tracker.GetLatency(GetLocalityGroupKey({"south", "gz", "gz1"}), 100, latency));
+  ASSERT_DOUBLE_EQ(10, latency);
+}
+
+TEST(LocalityLatencyTrackerTest, AddAddresses) {
+  LocalityLatencyTracker tracker;
+  LocalityLatencyTracker::Options options;
+  options.min_samples = 1;
+  tracker.SetOptions(options);
+  tracker.AddAddresses(MakeSnapshot({{"south", "sz", "sz1"}, {"north", "bj", "bj1"}}), "secondary");
+
+  tracker.Record("127.0.0.1:10001", 10, 100);
+  double latency = 0;
+  ASSERT_TRUE(tracker.GetLatency("secondary", 100, latency));
+  ASSERT_DOUBLE_EQ(10, latency);
+}
+
+}  // namespace trpc::naming::polarismesh::testing
@@ -0,0 +1,290 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#include "trpc/naming/polarismesh/locality_tiers.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace trpc::naming::polarismesh {
+
+namespace {
+
+// Whether the endpoint is within level of the local location
+bool WithinLevel(const EndpointLocation& endpoint, const EndpointLocation& local, LocalityLevel level) {
+  switch (level) {
+    case LocalityLevel::kCampus:
+      return endpoint.campus == local.campus && endpoint.zone == local.zone && endpoint.region == local.region;
+    case LocalityLevel::kZone:
+      return endpoint.zone == local.zone && endpoint.region == local.region;
+    case LocalityLevel::kRegion:
+      return endpoint.region == local.region;
+    default:
+      return true;
+  }
+}
+
+// Whether too many endpoints of a set are unhealthy for the set to be used
+bool IsDegraded(const NearbyOptions& options, size_t total, size_t healthy) {
+  return options.enable_degrade_by_unhealthy_percent &&
+         (total - healthy) * 100 >= static_cast<size_t>(options.unhealthy_percent_to_degrade) * total;
+}
+
+// Maximum number of group combinations whose subsets are kept
+constexpr size_t kMaxGroupSubsets = 64;
+
+bool LocalKnown(const EndpointLocation& local, LocalityLevel level) {
+  switch (level) {
+    case LocalityLevel::kCampus:
+      return !local.campus.empty() && !local.zone.empty() && !local.region.empty();
+    case LocalityLevel::kZone:
+      return !local.zone.empty() && !local.region.empty();
+    case LocalityLevel::kRegion:
+      return !local.region.empty();
+    default:
+      return true;
+  }
+}
+
+}  // namespace
+
+bool ParseLocalityLevel(const std::string& name, LocalityLevel& level) {
+  if (name == "campus") {
+    level = LocalityLevel::kCampus;
+  } else if (name == "zone") {
+    level = LocalityLevel::kZone;
+  } else if (name == "region") {
+    level = LocalityLevel::kRegion;
+  } else if (name == "none" || name.empty()) {
+    level = LocalityLevel::kAll;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+LocalityTiers::LocalityTiers(RoutedSnapshotPtr snapshot, const EndpointLocation& local)
+    : snapshot_(std::move(snapshot)) {
+  const auto& endpoints = snapshot_->endpoints;
+  const auto& locations = snapshot_->locations;
+  for (size_t i = 0; i < kLocalityLevelNum; i++) {
+    auto level = static_cast<LocalityLevel>(i);
+    auto& tier = tiers_[i];
+    tier.local_known = LocalKnown(local, level);
+    if (level == LocalityLevel::kAll) {
+      tier.snapshot = snapshot_;
+    } else if (tier.local_known && locations.size() == endpoints.size()) {
+      auto subset = std::make_shared<RoutedSnapshot>();
+      for (size_t j = 0; j < endpoints.size(); j++) {
+        if (WithinLevel(locations[j], local, level)) {
+          subset->endpoints.push_back(endpoints[j]);
+          subset->locations.push_back(locations[j]);
+        }
+      }
+      subset->revision = CalculateEndpointsRevision(subset->endpoints);
+      subset->update_time_ms = snapshot_->update_time_ms;
+      subset->source_version = snapshot_->source_version;
+      tier.snapshot = std::move(subset);
+    }
+
+    if (tier.snapshot) {
+      for (const auto& endpoint : tier.snapshot->endpoints) {
+        tier.healthy_num += endpoint.status ? 1 : 0;
+      }
+      if (tier.snapshot->endpoints.empty()) {
+        tier.snapshot = nullptr;
+      }
+    }
+  }
+
+  if (locations.size() != endpoints.size()) {
+    return;
+  }
+  std::unordered_map<std::string, uint32_t> group_indexes;
+  endpoint_groups_.reserve(endpoints.size());
+  for (size_t i = 0; i < endpoints.size(); i++) {
+    std::string key = GetLocalityGroupKey(locations[i]);
+    auto result = group_indexes.emplace(key, groups_.size());
+    if (result.second) {
+      Group group;
+      group.key = std::move(key);
+      for (size_t j = 0; j < kLocalityLevelNum - 1; j++) {
+        auto level = static_cast<LocalityLevel>(j);
+        if (tiers_[j].local_known && WithinLevel(locations[i], local, level)) {
+          group.level = level;
+          break;
+        }
+      }
+      groups_.push_back(std::move(group));
+    }
+    auto& group = groups_[result.first->second];
+    group.endpoint_num++;
+    group.healthy_num += endpoints[i].status ? 1 : 0;
+    endpoint_groups_.push_back(result.first->second);
+  }
+}
+
+RoutedSnapshotPtr LocalityTiers::Select(const NearbyOptions& options, LocalityLevel* level) const {
+  size_t first = static_cast<size_t>(options.match_level);
+  size_t last = std::max(first, static_cast<size_t>(options.max_match_level));
+  if (options.strict_nearby && !tiers_[first].local_known) {
+    return nullptr;
+  }
+
+  // The widest non-empty level seen, returned when every level is degraded and recovering all is allowed
+  size_t widest = kLocalityLevelNum;
+  for (size_t i = first; i <= last; i++) {
+    const auto& tier = tiers_[i];
+    if (!tier.snapshot) {
+      continue;
+    }
+    widest = i;
+    if (!IsDegraded(options, tier.snapshot->endpoints.size(), tier.healthy_num)) {
+      if (level != nullptr) {
+        *level = static_cast<LocalityLevel>(i);
+      }
+      return tier.snapshot;
+    }
+  }
+
+  if (widest == kLocalityLevelNum || !options.enable_recover_all) {
+    return nullptr;
+  }
+  if (level != nullptr) {
+    *level = static_cast<LocalityLevel>(widest);
+  }
+  return tiers_[widest].snapshot;
+}
+
+RoutedSnapshotPtr LocalityTiers::SelectByLatency(const NearbyOptions& options, LocalityLatencyTracker& tracker,
+                                                 uint64_t now_ms, uint64_t rank_interval_ms) const {
+  size_t first = static_cast<size_t>(options.match_level);
+  if (options.strict_nearby && !tiers_[first].local_known) {
+    return nullptr;
+  }
+  // The match level is used as long as it is healthy, and the locations are needed to rank the groups
+  const auto& tier = tiers_[first];
+  if ((tier.snapshot && !IsDegraded(options, tier.snapshot->endpoints.size(), tier.healthy_num)) || groups_.empty()) {
+    return Select(options);
+  }
+
+  std::lock_guard<std::mutex> lock(rank_mutex_);
+  if (!ranked_ || now_ms >= rank_time_ms_ + rank_interval_ms) {
+    ranked_snapshot_ = RankByLatency(options, tracker, now_ms);
+    ranked_ = true;
+    rank_time_ms_ = now_ms;
+  }
+  return ranked_snapshot_;
+}
+
+RoutedSnapshotPtr LocalityTiers::RankByLatency(const NearbyOptions& options, LocalityLatencyTracker& tracker,
+                                               uint64_t now_ms) const {
+  size_t first = static_cast<size_t>(options.match_level);
+  size_t last = std::max(first, static_cast<size_t>(options.max_match_level));
+
+  // The groups of the match level are kept, the others within the widest level are the candidates
+  std::vector<bool> chosen(groups_.size(), false);
+  size_t total = 0;
+  size_t healthy = 0;
+  std::vector<uint32_t> candidates;
+  std::vector<double> latencies(groups_.size(), 0);
+  std::vector<bool> measured(groups_.size(), false);
+  std::array<double, kLocalityLevelNum> slowest_within{};
+  for (uint32_t i = 0; i < groups_.size(); i++) {
+    const auto& group = groups_[i];
+    size_t level = static_cast<size_t>(group.level);
+    if (level <= first) {
+      chosen[i] = true;
+      total += group.endpoint_num;
+      healthy += group.healthy_num;
+    } else if (level <= last) {
+      candidates.push_back(i);
+    }
+    measured[i] = tracker.GetLatency(group.key, now_ms, latencies[i]);
+    if (measured[i]) {
+      slowest_within[level] = std::max(slowest_within[level], latencies[i]);
+    }
+  }
+  for (size_t i = 1; i < kLocalityLevelNum; i++) {
+    slowest_within[i] = std::max(slowest_within[i], slowest_within[i - 1]);
+  }
+  for (uint32_t index : candidates) {
+    if (!measured[index]) {
+      latencies[index] = slowest_within[static_cast<size_t>(groups_[index].level)];
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(), [this, &latencies](uint32_t a, uint32_t b) {
+    if (latencies[a] != latencies[b]) {
+      return latencies[a] < latencies[b];
+    }
+    return groups_[a].level < groups_[b].level;
+  });
+
+  bool degraded = total == 0 || IsDegraded(options, total, healthy);
+  for (size_t i = 0; i < candidates.size() && degraded; i++) {
+    const auto& group = groups_[candidates[i]];
+    chosen[candidates[i]] = true;
+    total += group.endpoint_num;
+    healthy += group.healthy_num;
+    degraded = IsDegraded(options, total, healthy);
+  }
+  if (total == 0 || (degraded && !options.enable_recover_all)) {
+    return nullptr;
+  }
+  return GetGroupsSubset(chosen);
+}
+
+RoutedSnapshotPtr LocalityTiers::GetGroupsSubset(const std::vector<bool>& chosen) const {
+  if (std::all_of(chosen.begin(), chosen.end(), [](bool value) { return value; })) {
+    return snapshot_;
+  }
+
+  SignatureHasher hasher;
+  for (uint32_t i = 0; i < chosen.size(); i++) {
+    if (chosen[i]) {
+      hasher.Add(static_cast<uint64_t>(i));
+    }
+  }
+  auto iter = group_subsets_.find(hasher.Get());
+  if (iter != group_subsets_.end()) {
+    return iter->second;
+  }
+
+  auto subset = std::make_shared<RoutedSnapshot>();
+  for (size_t i = 0; i < snapshot_->endpoints.size(); i++) {
+    if (chosen[endpoint_groups_[i]]) {
+      subset->endpoints.push_back(snapshot_->endpoints[i]);
+      subset->locations.push_back(snapshot_->locations[i]);
+    }
+  }
+  subset->revision = CalculateEndpointsRevision(subset->endpoints);
+  subset->update_time_ms = snapshot_->update_time_ms;
+  subset->source_version = snapshot_->source_version;
+  if (group_subsets_.size() >= kMaxGroupSubsets) {
+    group_subsets_.clear();
+  }
+  group_subsets_.emplace(hasher.Get(), subset);
+  return subset;
+}
+
+LocalityTiersPtr LocalityTiersCache::Get(const std::string& key, const RoutedSnapshotPtr& snapshot) {
+  return tiers_.Get(key, snapshot, [this](const RoutedSnapshotPtr& snapshot) {
+    if (tracker_ != nullptr) {
+      tracker_->AddLocations(*snapshot);
+    }
+    return std::make_shared<const LocalityTiers>(snapshot, local_);
+  });
+}
+
+}  // namespace trpc::naming::polarismesh
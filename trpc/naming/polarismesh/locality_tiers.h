@@ -0,0 +1,153 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "trpc/naming/polarismesh/locality_latency.h"
+#include "trpc/naming/polarismesh/snapshot_cache.h"
+
+namespace trpc::naming::polarismesh {
+
+/// @brief Locality levels of the nearby routing, from the nearest to the widest
+enum class LocalityLevel {
+  kCampus = 0,
+  kZone = 1,
+  kRegion = 2,
+  /// No locality constraint, "none" in the nearby router configuration
+  kAll = 3,
+};
+
+constexpr size_t kLocalityLevelNum = 4;
+
+/// @brief Parse the level name of the nearby router configuration
+/// @param name "campus", "zone", "region" or "none"
+/// @param[out] level The level
+/// @return bool Whether the name is a known level
+bool ParseLocalityLevel(const std::string& name, LocalityLevel& level);
+
+/// @brief Settings of the nearby routing, the same as the nearbyBasedRouter of the SDK
+struct NearbyOptions {
+  /// The nearest level tried first
+  LocalityLevel match_level{LocalityLevel::kZone};
+  /// The widest level the routing may degrade to
+  LocalityLevel max_match_level{LocalityLevel::kAll};
+  /// Whether the routing fails when the local location lacks the match level
+  bool strict_nearby{false};
+  /// Whether to degrade to the next level when too many endpoints of a level are unhealthy
+  bool enable_degrade_by_unhealthy_percent{true};
+  /// Percentage of unhealthy endpoints of a level which makes it degrade
+  uint32_t unhealthy_percent_to_degrade{100};
+  /// Whether the widest level is returned when all of the levels are degraded
+  bool enable_recover_all{true};
+};
+
+/// @brief The endpoints of a snapshot partitioned by their locality relative to the local location, built once per
+///        snapshot revision. Every level keeps its subset as a snapshot and its healthy count, so a nearby routing is a
+///        walk over the four levels instead of a partition of the endpoints.
+class LocalityTiers {
+ public:
+  LocalityTiers(RoutedSnapshotPtr snapshot, const EndpointLocation& local);
+
+  /// @brief The endpoints within level of the local location, nullptr if none
+  const RoutedSnapshotPtr& GetTier(LocalityLevel level) const { return tiers_[static_cast<size_t>(level)].snapshot; }
+
+  /// @brief Number of the healthy endpoints within level of the local location
+  size_t GetHealthyNum(LocalityLevel level) const { return tiers_[static_cast<size_t>(level)].healthy_num; }
+
+  /// @brief Route by the nearby rules
+  /// @param options The nearby settings
+  /// @param[out] level The level selected, can be nullptr
+  /// @return RoutedSnapshotPtr The endpoints of the level selected, nullptr if none can be selected
+  RoutedSnapshotPtr Select(const NearbyOptions& options, LocalityLevel* level = nullptr) const;
+
+  /// @brief Route by the nearby rules, but degrade by measured latency instead of the label hierarchy: when the match
+  ///        level is degraded, the locality groups (campuses) within the widest level are added nearest first, as
+  ///        ranked by their latency estimates. A group without estimate is ranked with the slowest measured group of
+  ///        the same or a nearer level, so the labels are only a prior.
+  /// @param tracker Latency estimates of the groups
+  /// @param rank_interval_ms The ranking is reused within the interval
+  /// @return RoutedSnapshotPtr The endpoints selected, nullptr if none can be selected
+  RoutedSnapshotPtr SelectByLatency(const NearbyOptions& options, LocalityLatencyTracker& tracker, uint64_t now_ms,
+                                    uint64_t rank_interval_ms) const;
+
+  /// @brief The snapshot the tiers are built from
+  const RoutedSnapshotPtr& GetSnapshot() const { return snapshot_; }
+
+ private:
+  struct Tier {
+    RoutedSnapshotPtr snapshot;
+    size_t healthy_num{0};
+    // Whether the local location has the fields of the level
+    bool local_known{false};
+  };
+
+  struct Group {
+    std::string key;
+    // The nearest level the group is within
+    LocalityLevel level{LocalityLevel::kAll};
+    size_t endpoint_num{0};
+    size_t healthy_num{0};
+  };
+
+  // Rank the groups by latency and select the nearest ones which are not degraded
+  RoutedSnapshotPtr RankByLatency(const NearbyOptions& options, LocalityLatencyTracker& tracker,
+                                  uint64_t now_ms) const;
+
+  // Subset of the snapshot made of the groups chosen, kept per combination
+  RoutedSnapshotPtr GetGroupsSubset(const std::vector<bool>& chosen) const;
+
+ private:
+  RoutedSnapshotPtr snapshot_;
+  std::array<Tier, kLocalityLevelNum> tiers_;
+  // Locality groups, empty if the locations are unknown
+  std::vector<Group> groups_;
+  // Group of every endpoint of the snapshot
+  std::vector<uint32_t> endpoint_groups_;
+
+  // Last latency ranking and the subsets of the group combinations it selected
+  mutable std::mutex rank_mutex_;
+  mutable bool ranked_{false};
+  mutable uint64_t rank_time_ms_{0};
+  mutable RoutedSnapshotPtr ranked_snapshot_;
+  mutable std::unordered_map<uint64_t, RoutedSnapshotPtr> group_subsets_;
+};
+
+using LocalityTiersPtr = std::shared_ptr<const LocalityTiers>;
+
+/// @brief Keeps the locality tiers of every selection key, they are rebuilt only when the snapshot revision changes
+class LocalityTiersCache {
+ public:
+  void SetLocalLocation(const EndpointLocation& local) { local_ = local; }
+
+  /// @brief Set the tracker to register the locations of the snapshots in, nullptr if the latency is not measured
+  void SetLatencyTracker(LocalityLatencyTracker* tracker) { tracker_ = tracker; }
+
+  /// @brief Get the tiers of the snapshot of key, build them if absent or built from another revision
+  LocalityTiersPtr Get(const std::string& key, const RoutedSnapshotPtr& snapshot);
+
+  void Clear() { tiers_.Clear(); }
+
+ private:
+  EndpointLocation local_;
+  LocalityLatencyTracker* tracker_{nullptr};
+  SnapshotTableCache<LocalityTiers> tiers_;
+};
+
+}  // namespace trpc::naming::polarismesh
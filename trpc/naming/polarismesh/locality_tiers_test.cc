@@ -0,0 +1,148 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#include "trpc/naming/polarismesh/locality_tiers.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace trpc::naming::polarismesh::testing {
+
+namespace {
+
+struct TestEndpoint {
+  EndpointLocation location;
+  bool healthy;
+};
+
+RoutedSnapshotPtr MakeSnapshot(const std::vector<TestEndpoint>& test_endpoints) {
+  auto snapshot = std::make_shared<RoutedSnapshot>();
+  for (size_t i = 0; i < test_endpoints.size(); i++) {
+    TrpcEndpointInfo endpoint;
+    endpoint.host = "127.0.0.1";
+    endpoint.port = 10000 + i;
+    endpoint.weight = 100;
+    endpoint.status = test_endpoints[i].healthy ? 1 : 0;
+    snapshot->endpoints.push_back(endpoint);
+    snapshot->locations.push_back(test_endpoints[i].location);
+  }
+  snapshot->revision = CalculateEndpointsRevision(snapshot->endpoints);
+  return snapshot;
+}
+
+const EndpointLocation kLocal{"south", "sz", "sz1"};
+
+}  // namespace
+
+TEST(LocalityTiersTest, Tiers) {
+  LocalityTiers tiers(MakeSnapshot({{{"south", "sz", "sz1"}, true},
+                                    {{"south", "sz", "sz2"}, false},
+                                    {{"south", "gz", "gz1"}, true},
+                                    {{"north", "bj", "bj1"}, true}}),
+                      kLocal);
+
+  ASSERT_EQ(1, tiers.GetTier(LocalityLevel::kCampus)->endpoints.size());
+  ASSERT_EQ(2, tiers.GetTier(LocalityLevel::kZone)->endpoints.size());
+  ASSERT_EQ(1, tiers.GetHealthyNum(LocalityLevel::kZone));
+  ASSERT_EQ(3, tiers.GetTier(LocalityLevel::kRegion)->endpoints.size());
+  ASSERT_EQ(4, tiers.GetTier(LocalityLevel::kAll)->endpoints.size());
+  ASSERT_EQ(tiers.GetSnapshot(), tiers.GetTier(LocalityLevel::kAll));
+
+  NearbyOptions options;
+  LocalityLevel level;
+  ASSERT_EQ(tiers.GetTier(LocalityLevel::kZone), tiers.Select(options, &level));
+  ASSERT_EQ(LocalityLevel::kZone, level);
+
+  // Half of the zone is unhealthy
+  options.unhealthy_percent_to_degrade = 50;
+  ASSERT_EQ(tiers.GetTier(LocalityLevel::kRegion), tiers.Select(options, &level));
+  ASSERT_EQ(LocalityLevel::kRegion, level);
+}
+
+TEST(LocalityTiersTest, DegradeAndRecoverAll) {
+  LocalityTiers tiers(MakeSnapshot({{{"south", "sz", "sz1"}, false}, {{"north", "bj", "bj1"}, false}}), kLocal);
+
+  NearbyOptions options;
+  options.max_match_level = LocalityLevel::kZone;
+  LocalityLevel level;
+  // Every level is unhealthy, the widest one allowed is recovered
+  ASSERT_EQ(tiers.GetTier(LocalityLevel::kZone), tiers.Select(options, &level));
+  ASSERT_EQ(LocalityLevel::kZone, level);
+
+  options.enable_recover_all = false;
+  ASSERT_EQ(nullptr, tiers.Select(options));
+}
+
+TEST(LocalityTiersTest, UnknownLocation) {
+  auto snapshot = MakeSnapshot({{{"north", "bj", "bj1"}, true}});
+  LocalityTiers tiers(snapshot, EndpointLocation{});
+
+  NearbyOptions options;
+  // Not strict, the levels unknown locally are skipped
+  ASSERT_EQ(snapshot, tiers.Select(options));
+
+  options.strict_nearby = true;
+  ASSERT_EQ(nullptr, tiers.Select(options));
+
+  // The nearest levels have nothing, the region is taken
+  LocalityTiers far_tiers(snapshot, EndpointLocation{"north", "tj", "tj1"});
+  LocalityLevel level;
+  ASSERT_NE(nullptr, far_tiers.Select(NearbyOptions{}, &level));
+  ASSERT_EQ(LocalityLevel::kRegion, level);
+}
+
+TEST(LocalityTiersTest, SelectByLatency) {
+  // The local zone is down, its region has another zone which is slower than a zone of another region
+  auto snapshot = MakeSnapshot({{{"south", "sz", "sz1"}, false},
+                                {{"south", "gz", "gz1"}, true},
+                                {{"north", "bj", "bj1"}, true},
+                                {{"north", "tj", "tj1"}, true}});
+  LocalityTiers tiers(snapshot, kLocal);
+  LocalityLatencyTracker tracker;
+  LocalityLatencyTracker::Options tracker_options;
+  tracker_options.min_samples = 1;
+  tracker.SetOptions(tracker_options);
+  tracker.AddLocations(*snapshot);
+
+  // Nothing measured yet, the labels decide
+  NearbyOptions options;
+  auto selected = tiers.SelectByLatency(options, tracker, 0, 1000);
+  ASSERT_EQ(2, selected->endpoints.size());
+  ASSERT_EQ("gz", selected->locations[1].zone);
+
+  // bj is measured nearer than gz, tj is unknown and ranked after the slowest group of its level
+  tracker.Record("127.0.0.1:10001", 30, 0);
+  tracker.Record("127.0.0.1:10002", 5, 0);
+  // The ranking is reused within the interval
+  ASSERT_EQ(selected, tiers.SelectByLatency(options, tracker, 999, 1000));
+  selected = tiers.SelectByLatency(options, tracker, 1000, 1000);
+  ASSERT_EQ(2, selected->endpoints.size());
+  ASSERT_EQ("bj", selected->locations[1].zone);
+
+  // A healthy match level is used as is
+  options.match_level = LocalityLevel::kRegion;
+  ASSERT_EQ(tiers.GetTier(LocalityLevel::kRegion), tiers.SelectByLatency(options, tracker, 1000, 1000));
+}
+
+TEST(LocalityTiersTest, ParseLocalityLevel) {
+  LocalityLevel level;
+  ASSERT_TRUE(ParseLocalityLevel("campus", level));
+  ASSERT_EQ(LocalityLevel::kCampus, level);
+  ASSERT_TRUE(ParseLocalityLevel("none", level));
+  ASSERT_EQ(LocalityLevel::kAll, level);
+  ASSERT_FALSE(ParseLocalityLevel("planet", level));
+}
+
+}  // namespace trpc::naming::polarismesh::testing
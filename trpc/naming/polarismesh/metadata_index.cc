@@ -0,0 +1,157 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#include "trpc/naming/polarismesh/metadata_index.h"
+
+#include <algorithm>
+
+namespace trpc::naming::polarismesh {
+
+namespace {
+
+std::string MakePairKey(const std::string& key, const std::string& value) {
+  std::string pair_key;
+  pair_key.reserve(key.size() + value.size() + 1);
+  pair_key.append(key).push_back('\0');
+  pair_key.append(value);
+  return pair_key;
+}
+
+}  // namespace
+
+bool MetadataIndex::Posting::Contains(uint32_t slot) const {
+  if (!bits.empty()) {
+    return (bits[slot >> 6] >> (slot & 63)) & 1;
+  }
+  return std::binary_search(slots.begin(), slots.end(), slot);
+}
+
+MetadataIndex::MetadataIndex(RoutedSnapshotPtr snapshot, size_t max_cached_filters)
+    : snapshot_(std::move(snapshot)), max_cached_filters_(max_cached_filters) {
+  const auto& endpoints = snapshot_->endpoints;
+  for (uint32_t slot = 0; slot < endpoints.size(); slot++) {
+    for (const auto& item : endpoints[slot].meta) {
+      postings_[MakePairKey(item.first, item.second)].slots.push_back(slot);
+    }
+  }
+
+  // A bitmap takes less memory than the array once a quarter of a word per slot is exceeded
+  size_t words = (endpoints.size() + 63) / 64;
+  for (auto& item : postings_) {
+    auto& posting = item.second;
+    posting.cardinality = posting.slots.size();
+    if (posting.cardinality * sizeof(uint32_t) > words * sizeof(uint64_t)) {
+      posting.bits.assign(words, 0);
+      for (uint32_t slot : posting.slots) {
+        posting.bits[slot >> 6] |= 1ULL << (slot & 63);
+      }
+      std::vector<uint32_t>().swap(posting.slots);
+    }
+  }
+}
+
+void MetadataIndex::MatchIndexes(const std::map<std::string, std::string>& filter,
+                                 std::vector<uint32_t>& indexes) const {
+  std::vector<const Posting*> postings;
+  postings.reserve(filter.size());
+  for (const auto& item : filter) {
+    auto iter = postings_.find(MakePairKey(item.first, item.second));
+    if (iter == postings_.end()) {
+      return;
+    }
+    postings.push_back(&iter->second);
+  }
+  if (postings.empty()) {
+    return;
+  }
+
+  // The smallest set drives the intersection
+  std::sort(postings.begin(), postings.end(),
+            [](const Posting* a, const Posting* b) { return a->cardinality < b->cardinality; });
+  const Posting& smallest = *postings.front();
+  if (smallest.bits.empty()) {
+    for (uint32_t slot : smallest.slots) {
+      bool matched = std::all_of(postings.begin() + 1, postings.end(),
+                                 [slot](const Posting* posting) { return posting->Contains(slot); });
+      if (matched) {
+        indexes.push_back(slot);
+      }
+    }
+    return;
+  }
+
+  // All of them are dense, intersect the bitmaps word by word
+  for (size_t word = 0; word < smallest.bits.size(); word++) {
+    uint64_t bits = smallest.bits[word];
+    for (size_t i = 1; i < postings.size() && bits != 0; i++) {
+      bits &= postings[i]->bits[word];
+    }
+    while (bits != 0) {
+      indexes.push_back(static_cast<uint32_t>(word * 64 + __builtin_ctzll(bits)));
+      bits &= bits - 1;
+    }
+  }
+}
+
+RoutedSnapshotPtr MetadataIndex::Match(const std::map<std::string, std::string>& filter) const {
+  if (filter.empty()) {
+    return snapshot_;
+  }
+
+  std::string filter_key;
+  for (const auto& item : filter) {
+    filter_key.append(MakePairKey(item.first, item.second)).push_back('\0');
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = matched_.find(filter_key);
+    if (iter != matched_.end()) {
+      return iter->second;
+    }
+  }
+
+  std::vector<uint32_t> indexes;
+  MatchIndexes(filter, indexes);
+  RoutedSnapshotPtr subset;
+  if (!indexes.empty()) {
+    auto matched = std::make_shared<RoutedSnapshot>();
+    matched->endpoints.reserve(indexes.size());
+    bool has_locations = !snapshot_->locations.empty();
+    for (uint32_t index : indexes) {
+      matched->endpoints.push_back(snapshot_->endpoints[index]);
+      if (has_locations) {
+        matched->locations.push_back(snapshot_->locations[index]);
+      }
+    }
+    matched->revision = CalculateEndpointsRevision(matched->endpoints);
+    matched->update_time_ms = snapshot_->update_time_ms;
+    matched->source_version = snapshot_->source_version;
+    subset = std::move(matched);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (matched_.size() >= max_cached_filters_) {
+    matched_.clear();
+  }
+  matched_[filter_key] = subset;
+  return subset;
+}
+
+MetadataIndexPtr MetadataIndexCache::Get(const std::string& key, const RoutedSnapshotPtr& snapshot) {
+  return indexes_.Get(key, snapshot, [this](const RoutedSnapshotPtr& snapshot) {
+    return std::make_shared<const MetadataIndex>(snapshot, max_cached_filters_);
+  });
+}
+
+}  // namespace trpc::naming::polarismesh
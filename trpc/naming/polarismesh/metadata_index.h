@@ -0,0 +1,84 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "trpc/naming/polarismesh/snapshot_cache.h"
+
+namespace trpc::naming::polarismesh {
+
+/// @brief Inverted index of the metadata of the endpoints of a snapshot, built once per snapshot revision. Every
+///        key=value pair maps to the slots of the endpoints having it, stored as a sorted array when it is sparse and
+///        as a bitmap when it is dense, so a filter of several keys is the intersection of a few sets.
+class MetadataIndex {
+ public:
+  /// @param snapshot The snapshot to index
+  /// @param max_cached_filters Maximum number of matched subsets kept, all of them are dropped when it is reached
+  explicit MetadataIndex(RoutedSnapshotPtr snapshot, size_t max_cached_filters = 256);
+
+  /// @brief Get the endpoints having all the pairs of filter, as a snapshot that is cached per filter
+  /// @return RoutedSnapshotPtr The subset, the snapshot itself if filter is empty, nullptr if no endpoint matches
+  RoutedSnapshotPtr Match(const std::map<std::string, std::string>& filter) const;
+
+  /// @brief Get the slots in the snapshot of the endpoints having all the pairs of filter, in ascending order
+  void MatchIndexes(const std::map<std::string, std::string>& filter, std::vector<uint32_t>& indexes) const;
+
+  /// @brief The snapshot the index is built from
+  const RoutedSnapshotPtr& GetSnapshot() const { return snapshot_; }
+
+ private:
+  struct Posting {
+    // Slots of the endpoints, used while the posting is sparse
+    std::vector<uint32_t> slots;
+    // One bit per slot, used once the posting is dense
+    std::vector<uint64_t> bits;
+    size_t cardinality{0};
+
+    bool Contains(uint32_t slot) const;
+  };
+
+ private:
+  RoutedSnapshotPtr snapshot_;
+  size_t max_cached_filters_;
+  // Keyed by the pair joined with a NUL character
+  std::unordered_map<std::string, Posting> postings_;
+
+  mutable std::mutex mutex_;
+  mutable std::unordered_map<std::string, RoutedSnapshotPtr> matched_;
+};
+
+using MetadataIndexPtr = std::shared_ptr<const MetadataIndex>;
+
+/// @brief Keeps the metadata index of every selection key, it is rebuilt only when the snapshot revision changes
+class MetadataIndexCache {
+ public:
+  void SetMaxCachedFilters(size_t max_cached_filters) { max_cached_filters_ = max_cached_filters; }
+
+  /// @brief Get the index of the snapshot of key, build it if absent or built from another revision
+  MetadataIndexPtr Get(const std::string& key, const RoutedSnapshotPtr& snapshot);
+
+  void Clear() { indexes_.Clear(); }
+
+ private:
+  size_t max_cached_filters_{256};
+  SnapshotTableCache<MetadataIndex> indexes_;
+};
+
+}  // namespace trpc::naming::polarismesh
@@ -0,0 +1,102 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#include "trpc/naming/polarismesh/metadata_index.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace trpc::naming::polarismesh::testing {
+
+namespace {
+
+// Endpoint i has env=test on the even slots, zone=zone(i % 3) and a unique id
+RoutedSnapshotPtr MakeSnapshot(int num) {
+  auto snapshot = std::make_shared<RoutedSnapshot>();
+  for (int i = 0; i < num; i++) {
+    TrpcEndpointInfo endpoint;
+    endpoint.host = "127.0.0.1";
+    endpoint.port = 10000 + i;
+    endpoint.weight = 100;
+    endpoint.status = 1;
+    endpoint.meta["env"] = i % 2 == 0 ? "test" : "prod";
+    endpoint.meta["zone"] = "zone" + std::to_string(i % 3);
+    endpoint.meta["id"] = std::to_string(i);
+    snapshot->endpoints.push_back(endpoint);
+  }
+  snapshot->revision = CalculateEndpointsRevision(snapshot->endpoints);
+  return snapshot;
+}
+
+std::vector<uint32_t> ScanMatch(const RoutedSnapshot& snapshot, const std::map<std::string, std::string>& filter) {
+  std::vector<uint32_t> indexes;
+  for (uint32_t i = 0; i < snapshot.endpoints.size(); i++) {
+    const auto& meta = snapshot.endpoints[i].meta;
+    bool matched = true;
+    for (const auto& item : filter) {
+      auto iter = meta.find(item.first);
+      matched = matched && iter != meta.end() && iter->second == item.second;
+    }
+    if (matched) {
+      indexes.push_back(i);
+    }
+  }
+  return indexes;
+}
+
+}  // namespace
+
+TEST(MetadataIndexTest, MatchesLikeScan) {
+  auto snapshot = MakeSnapshot(1000);
+  MetadataIndex index(snapshot);
+
+  std::vector<std::map<std::string, std::string>> filters = {
+      {{"env", "test"}},
+      {{"env", "test"}, {"zone", "zone1"}},
+      {{"zone", "zone2"}, {"id", "5"}},
+      {{"zone", "zone2"}, {"id", "6"}},
+      {{"env", "none"}},
+      {{"region", "sz"}},
+  };
+  for (const auto& filter : filters) {
+    std::vector<uint32_t> indexes;
+    index.MatchIndexes(filter, indexes);
+    ASSERT_EQ(ScanMatch(*snapshot, filter), indexes);
+  }
+}
+
+TEST(MetadataIndexTest, MatchedSubsetIsCached) {
+  auto snapshot = MakeSnapshot(100);
+  MetadataIndex index(snapshot, 2);
+
+  ASSERT_EQ(snapshot, index.Match({}));
+  ASSERT_EQ(nullptr, index.Match({{"env", "none"}}));
+
+  auto subset = index.Match({{"env", "test"}, {"zone", "zone0"}});
+  ASSERT_NE(nullptr, subset);
+  ASSERT_EQ(17, subset->endpoints.size());
+  ASSERT_EQ(subset, index.Match({{"env", "test"}, {"zone", "zone0"}}));
+  ASSERT_EQ(CalculateEndpointsRevision(subset->endpoints), subset->revision);
+}
+
+TEST(MetadataIndexTest, Cache) {
+  MetadataIndexCache cache;
+  auto index = cache.Get("key", MakeSnapshot(10));
+  ASSERT_EQ(index, cache.Get("key", MakeSnapshot(10)));
+  ASSERT_NE(index, cache.Get("key", MakeSnapshot(11)));
+}
+
+}  // namespace trpc::naming::polarismesh::testing
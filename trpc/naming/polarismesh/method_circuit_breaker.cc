@@ -0,0 +1,37 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#include "trpc/naming/polarismesh/method_circuit_breaker.h"
+
+namespace trpc::naming::polarismesh {
+
+RoutedSnapshotPtr MethodCircuitBreaker::Apply(const std::string& service, const std::string& method,
+                                              const std::string& key, const RoutedSnapshotPtr& snapshot,
+                                              uint64_t now_ms) {
+  if (!snapshot) {
+    return nullptr;
+  }
+  auto open = GetOpenBreakers(service, method, now_ms);
+  if (!open) {
+    return snapshot;
+  }
+
+  uint64_t revision = SignatureHasher().Add(snapshot->revision).Add(open->revision).Get();
+  auto result = snapshots_.Get(key + "|" + method, revision, snapshot, [&open](const RoutedSnapshotPtr& origin) {
+    return RemoveEndpoints(origin, open->members);
+  });
+  return result ? result : snapshot;
+}
+
+}  // namespace trpc::naming::polarismesh
@@ -0,0 +1,77 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#pragma once
+
+#include <string>
+
+#include "trpc/naming/polarismesh/circuit_breaker.h"
+#include "trpc/naming/polarismesh/snapshot_cache.h"
+
+namespace trpc::naming::polarismesh {
+
+/// @brief Circuit breakers per endpoint and method. The results of the calls of a method on an endpoint are counted in
+///        a sliding window, and its breaker opens when the error rate reaches the threshold, so a method failing on
+///        an endpoint only cuts off that method there while its other methods keep being called.
+class MethodCircuitBreaker {
+ public:
+  using Options = CircuitBreakerOptions;
+
+  void SetOptions(const Options& options) { breakers_.SetOptions(options); }
+
+  const Options& GetOptions() const { return breakers_.GetOptions(); }
+
+  /// @brief Record the result of a call
+  /// @param service Callee of the call
+  /// @param method Method called
+  /// @param address Address of the endpoint called, "host:port"
+  void Report(const std::string& service, const std::string& method, const std::string& address, bool success,
+              uint64_t now_ms) {
+    breakers_.Report(service + "|" + method, address, success, 0, now_ms);
+  }
+
+  /// @brief State of the breaker of method on an endpoint at now_ms
+  BreakerState GetState(const std::string& service, const std::string& method, const std::string& address,
+                        uint64_t now_ms) {
+    return breakers_.GetState(service + "|" + method, address, now_ms);
+  }
+
+  /// @brief A call of method was selected on an endpoint, it takes a probe of the breaker if half-open
+  void Acquire(const std::string& service, const std::string& method, const std::string& address, uint64_t now_ms) {
+    breakers_.Acquire(service + "|" + method, address, now_ms);
+  }
+
+  /// @brief Get the addresses of the endpoints whose breaker of method is open at now_ms
+  /// @return OpenBreakersPtr nullptr if none is open
+  OpenBreakersPtr GetOpenBreakers(const std::string& service, const std::string& method, uint64_t now_ms) {
+    return breakers_.GetOpenBreakers(service + "|" + method, now_ms);
+  }
+
+  /// @brief Get the snapshot of key without the endpoints whose breaker of method is open, the filtered snapshot is
+  ///        kept until the open breakers or the snapshot change
+  /// @return RoutedSnapshotPtr snapshot itself when none of its endpoints is cut off, or all of them are
+  RoutedSnapshotPtr Apply(const std::string& service, const std::string& method, const std::string& key,
+                          const RoutedSnapshotPtr& snapshot, uint64_t now_ms);
+
+  void Clear() {
+    breakers_.Clear();
+    snapshots_.Clear();
+  }
+
+ private:
+  CircuitBreakerGroups breakers_;
+  SnapshotTableCache<RoutedSnapshot> snapshots_;
+};
+
+}  // namespace trpc::naming::polarismesh
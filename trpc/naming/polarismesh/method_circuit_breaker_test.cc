@@ -0,0 +1,102 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#include "trpc/naming/polarismesh/method_circuit_breaker.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace trpc::naming::polarismesh::testing {
+
+MethodCircuitBreaker::Options MakeOptions() {
+  MethodCircuitBreaker::Options options;
+  options.window_ms = 10000;
+  options.bucket_num = 10;
+  options.min_requests = 10;
+  options.error_rate_percent = 50;
+  options.sleep_window_ms = 5000;
+  options.success_to_close = 2;
+  return options;
+}
+
+void ReportCalls(MethodCircuitBreaker& breaker, const std::string& method, const std::string& address, int success,
+                 int failure, uint64_t now_ms) {
+  for (int i = 0; i < success; ++i) {
+    breaker.Report("service", method, address, true, now_ms);
+  }
+  for (int i = 0; i < failure; ++i) {
+    breaker.Report("service", method, address, false, now_ms);
+  }
+}
+
+TEST(MethodCircuitBreakerTest, StateMachine) {
+  MethodCircuitBreaker breaker;
+  breaker.SetOptions(MakeOptions());
+
+  // Not enough calls, then an error rate below the threshold
+  ReportCalls(breaker, "/Heavy", "host1:80", 0, 5, 1000);
+  ASSERT_EQ(BreakerState::kClosed, breaker.GetState("service", "/Heavy", "host1:80", 1000));
+  ReportCalls(breaker, "/Heavy", "host1:80", 6, 0, 1000);
+  ASSERT_EQ(BreakerState::kClosed, breaker.GetState("service", "/Heavy", "host1:80", 1000));
+
+  ReportCalls(breaker, "/Heavy", "host1:80", 0, 2, 1000);
+  ASSERT_EQ(BreakerState::kOpen, breaker.GetState("service", "/Heavy", "host1:80", 1000));
+  // Only the failing method is cut off on the endpoint
+  ASSERT_EQ(BreakerState::kClosed, breaker.GetState("service", "/Light", "host1:80", 1000));
+
+  // Half-open after the sleep window, a failure opens it again
+  ASSERT_EQ(BreakerState::kHalfOpen, breaker.GetState("service", "/Heavy", "host1:80", 6000));
+  breaker.Report("service", "/Heavy", "host1:80", false, 6000);
+  ASSERT_EQ(BreakerState::kOpen, breaker.GetState("service", "/Heavy", "host1:80", 6000));
+
+  // Enough successes close it
+  ASSERT_EQ(BreakerState::kHalfOpen, breaker.GetState("service", "/Heavy", "host1:80", 11000));
+  ReportCalls(breaker, "/Heavy", "host1:80", 2, 0, 11000);
+  ASSERT_EQ(BreakerState::kClosed, breaker.GetState("service", "/Heavy", "host1:80", 11000));
+}
+
+TEST(MethodCircuitBreakerTest, Apply) {
+  MethodCircuitBreaker breaker;
+  breaker.SetOptions(MakeOptions());
+
+  auto snapshot = std::make_shared<RoutedSnapshot>();
+  for (int i = 1; i <= 3; ++i) {
+    TrpcEndpointInfo endpoint;
+    endpoint.host = "host" + std::to_string(i);
+    endpoint.port = 80;
+    endpoint.weight = 100;
+    snapshot->endpoints.push_back(endpoint);
+  }
+  snapshot->revision = CalculateEndpointsRevision(snapshot->endpoints);
+  ASSERT_EQ(nullptr, breaker.GetOpenBreakers("service", "/Heavy", 1000));
+  ASSERT_EQ(snapshot, breaker.Apply("service", "/Heavy", "key", snapshot, 1000));
+
+  ReportCalls(breaker, "/Light", "host2:80", 10, 0, 1000);
+  ReportCalls(breaker, "/Heavy", "host2:80", 0, 10, 1000);
+  auto open = breaker.GetOpenBreakers("service", "/Heavy", 1000);
+  ASSERT_NE(nullptr, open);
+  ASSERT_EQ(1, open->members.count("host2:80"));
+  ASSERT_EQ(6000, open->expire_ms);
+
+  auto result = breaker.Apply("service", "/Heavy", "key", snapshot, 1000);
+  ASSERT_EQ(2, result->endpoints.size());
+  ASSERT_EQ(result, breaker.Apply("service", "/Heavy", "key", snapshot, 2000));
+  ASSERT_EQ(snapshot, breaker.Apply("service", "/Light", "key", snapshot, 2000));
+
+  // The half-open endpoint takes calls again
+  ASSERT_EQ(snapshot, breaker.Apply("service", "/Heavy", "key", snapshot, 6000));
+}
+
+}  // namespace trpc::naming::polarismesh::testing
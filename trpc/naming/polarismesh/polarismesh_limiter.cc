@@ -67,6 +67,10 @@ void PolarisMeshLimiter::Destroy() noexcept {
 
 // Simultaneously obtain a current -limiting state interface
 LimitRetCode PolarisMeshLimiter::ShouldLimit(const LimitInfo* info) {
+  return ShouldLimitWithTimeout(info, plugin_config_.ratelimiter_config.timeout);
+}
+
+LimitRetCode PolarisMeshLimiter::ShouldLimitWithTimeout(const LimitInfo* info, uint32_t timeout) {
   if (!init_) {
     TRPC_FMT_ERROR("No init yet");
     return LimitRetCode::kLimitError;
@@ -83,7 +87,7 @@ LimitRetCode PolarisMeshLimiter::ShouldLimit(const LimitInfo* info) {
   if (!info->labels.empty()) {
     quota_request.SetLabels(info->labels);
   }
-  quota_request.SetTimeout(plugin_config_.ratelimiter_config.timeout);
+  quota_request.SetTimeout(timeout);
 
   polaris::QuotaResponse* quota_response = nullptr;
   polaris::ReturnCode ret = limit_api_->GetQuota(quota_request, quota_response);
@@ -51,6 +51,11 @@ class PolarisMeshLimiter : public Limiter {
   /// @brief Get access to the current -limiting state interface simultaneously
   LimitRetCode ShouldLimit(const LimitInfo* info) override;
 
+  /// @brief Same as ShouldLimit, but the quota query waits no longer than timeout
+  /// @param info Limit information of the call
+  /// @param timeout Timeout of the quota query in ms, usually bounded by the remaining deadline of the call
+  LimitRetCode ShouldLimitWithTimeout(const LimitInfo* info, uint32_t timeout);
+
   /// @brief End when the current limit processing is called to report some current limit data, etc.
   int FinishLimit(const LimitResult* result) override;
 
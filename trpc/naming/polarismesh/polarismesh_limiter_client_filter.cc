@@ -17,6 +17,7 @@
 
 #include "trpc/codec/trpc/trpc.pb.h"
 #include "trpc/common/status.h"
+#include "trpc/naming/polarismesh/common.h"
 #include "trpc/util/log/logging.h"
 #include "trpc/util/time.h"
 
@@ -31,6 +32,12 @@ LimitRetCode PolarisMeshLimiterClientFilter::ShouldLimit(const ClientContextPtr&
   limit_info.labels.insert(std::make_pair("method", context->GetFuncName()));    // Method name
   limit_info.labels.insert(std::make_pair("caller", context->GetCallerName()));  // Main service name
 
+  if (polarismesh_limiter_ != nullptr && enable_deadline_) {
+    // The quota query should not wait longer than the call itself is allowed to
+    uint32_t timeout = GetDeadlineAwareTimeout(context, timeout_, deadline_reserve_);
+    return polarismesh_limiter_->ShouldLimitWithTimeout(&limit_info, timeout);
+  }
+
   return limiter_->ShouldLimit(&limit_info);
 }
 
@@ -23,6 +23,7 @@
 #include "trpc/naming/limiter.h"
 #include "trpc/naming/limiter_factory.h"
 #include "trpc/naming/polarismesh/config/polarismesh_naming_conf.h"
+#include "trpc/naming/polarismesh/polarismesh_limiter.h"
 
 namespace trpc {
 
@@ -37,11 +38,15 @@ class PolarisMeshLimiterClientFilter : public MessageClientFilter {
 
   int Init() override {
     limiter_ = LimiterFactory::GetInstance()->Get("polarismesh");
+    polarismesh_limiter_ = dynamic_cast<PolarisMeshLimiter*>(limiter_.get());
 
     trpc::naming::RateLimiterConfig config;
     if (TrpcConfig::GetInstance()->GetPluginConfig<trpc::naming::RateLimiterConfig>("limiter", "polarismesh", config)) {
       update_call_result_ = config.update_call_result;
     }
+    timeout_ = config.timeout;
+    enable_deadline_ = config.enable_deadline;
+    deadline_reserve_ = config.deadline_reserve;
 
     return 0;
   }
@@ -63,8 +68,20 @@ class PolarisMeshLimiterClientFilter : public MessageClientFilter {
   // Streaming plug -in object
   LimiterPtr limiter_;
 
+  // The limiter object when it is the polarismesh limiter, used to bound the quota query by the deadline of the call
+  PolarisMeshLimiter* polarismesh_limiter_ = nullptr;
+
   // Do you need to report the call
   bool update_call_result_ = false;
+
+  // Configured timeout of the quota query, in ms
+  uint32_t timeout_ = 1000;
+
+  // Whether to bound the quota query timeout by the remaining deadline of the call
+  bool enable_deadline_ = true;
+
+  // Time reserved for the call itself after the quota query, in ms
+  uint32_t deadline_reserve_ = 10;
 };
 
 using PolarisMeshLimiterClientFilterPtr = RefPtr<PolarisMeshLimiterClientFilter>;
@@ -18,6 +18,7 @@
 #include "yaml-cpp/yaml.h"
 
 #include "trpc/common/config/trpc_config.h"
+#include "trpc/naming/polarismesh/colocation.h"
 #include "trpc/naming/polarismesh/common.h"
 #include "trpc/naming/polarismesh/trpc_share_context.h"
 #include "trpc/naming/registry_factory.h"
@@ -305,6 +306,14 @@ void PolarisMeshRegistry::GetMetadataFromRegistryConfig(PolarisMeshRegistryInfo&
   auto it = services_config_.find(service_key);
   if (it != services_config_.end()) {
     polarismesh_registry_info.metadata = it->second.metadata;
+    // Published for the co-located callers
+    if (!it->second.uds_path.empty()) {
+      polarismesh_registry_info.metadata[naming::polarismesh::kColocationUdsPathKey] = it->second.uds_path;
+    }
+  }
+  if (!plugin_config_.registry_config.host_id.empty()) {
+    polarismesh_registry_info.metadata[naming::polarismesh::kColocationHostIdKey] =
+        plugin_config_.registry_config.host_id;
   }
 }
 
@@ -13,28 +13,41 @@
 
 #include "trpc/naming/polarismesh/polarismesh_selector.h"
 
+#include <algorithm>
+#include <chrono>
+#include <limits>
 #include <map>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "google/protobuf/util/json_util.h"
 #include "polaris/api/consumer_api.h"
+#include "polaris/model.h"
 #include "polaris/model/constants.h"
+#include "polaris/plugin.h"
 #include "polaris/plugin/service_router/set_division_router.h"
 
 #include "trpc/codec/trpc/trpc.pb.h"
 #include "trpc/naming/polarismesh/common.h"
 #include "trpc/naming/polarismesh/config/polarismesh_naming_conf.h"
+#include "trpc/naming/polarismesh/trpc_server_metric.h"
 #include "trpc/naming/polarismesh/trpc_share_context.h"
 #include "trpc/naming/selector_factory.h"
 #include "trpc/util/log/logging.h"
 #include "trpc/util/string_helper.h"
 #include "trpc/util/string_util.h"
+#include "trpc/util/time.h"
 
 namespace trpc {
 
+thread_local std::unordered_map<std::string, PolarisMeshSelector::PolarisRuleRouteRaw>
+    PolarisMeshSelector::source_route_rule_map_;
+
+std::atomic<uint64_t> PolarisMeshSelector::route_rule_epoch_{0};
+
 namespace naming::polarismesh {
 
 uint32_t g_polarismesh_selector_plugin_id;
@@ -43,6 +56,158 @@ uint32_t GetPolarisMeshSelectorPluginID() { return g_polarismesh_selector_plugin
 
 }  // namespace naming::polarismesh
 
+namespace {
+
+// Keys of the filter data which record the in-flight call of the bounded-load selection
+constexpr char kInflightServiceKey[] = "inflight_service";
+constexpr char kInflightAddressKey[] = "inflight_address";
+constexpr char kInflightGenerationKey[] = "inflight_generation";
+
+// Key of the filter data which records the set of the endpoint selected for the call
+constexpr char kSelectedSetKey[] = "selected_set";
+
+// Key of the filter data which records the endpoints selected for the call, "host:port" separated by ","
+constexpr char kTriedEndpointsKey[] = "tried_endpoints";
+
+// Key of the filter data which records that an endpoint was selected for the call, the next selections are retries
+constexpr char kAttemptedKey[] = "attempted";
+
+// Keys of the filter data which record the static timeout of the call and the recommended one, in ms
+constexpr char kStaticTimeoutKey[] = "static_timeout";
+constexpr char kAdaptiveTimeoutKey[] = "adaptive_timeout";
+
+// Key of the filter data which records the hedge delay of the call, in ms
+constexpr char kHedgeDelayKey[] = "hedge_delay";
+
+// Key of the selector extend info naming the endpoints the call avoids, "host:port" separated by ","
+constexpr char kExcludedEndpointsKey[] = "excluded_endpoints";
+
+// Load balance name of the weighted random of the SDK
+constexpr char kLoadBalanceTypeWeightedRandom[] = "weightedRandom";
+
+void ConvertInstanceLocations(const std::vector<polaris::Instance>& instances,
+                              std::vector<naming::polarismesh::EndpointLocation>& locations) {
+  locations.reserve(instances.size());
+  for (const auto& instance : instances) {
+    locations.push_back({instance.GetRegion(), instance.GetZone(), instance.GetCampus()});
+  }
+}
+
+// Key of a callee in the caches and the statistics of the plugin, "namespace|name"
+std::string GetServiceId(const polaris::ServiceKey& service_key) {
+  return service_key.namespace_ + "|" + service_key.name_;
+}
+
+// Record the in-flight call in the context, the mark of the previous try must be taken out first
+void MarkInflight(const ClientContextPtr& context, const std::string& service, const std::string& address,
+                  uint64_t generation) {
+  auto* data_map = context->GetFilterData<std::unordered_map<std::string, std::string>>(
+      naming::polarismesh::GetPolarisMeshSelectorPluginID());
+  if (!data_map) {
+    std::unordered_map<std::string, std::string> new_data_map;
+    new_data_map[kInflightServiceKey] = service;
+    new_data_map[kInflightAddressKey] = address;
+    new_data_map[kInflightGenerationKey] = std::to_string(generation);
+    context->SetFilterData(naming::polarismesh::GetPolarisMeshSelectorPluginID(), std::move(new_data_map));
+  } else {
+    (*data_map)[kInflightServiceKey] = service;
+    (*data_map)[kInflightAddressKey] = address;
+    (*data_map)[kInflightGenerationKey] = std::to_string(generation);
+  }
+}
+
+// Take the in-flight call out of the context, so it ends only once
+bool TakeInflightMark(const ClientContextPtr& context, std::string& service, std::string& address,
+                      uint64_t& generation) {
+  auto* data_map = context->GetFilterData<std::unordered_map<std::string, std::string>>(
+      naming::polarismesh::GetPolarisMeshSelectorPluginID());
+  if (!data_map) {
+    return false;
+  }
+
+  auto service_iter = data_map->find(kInflightServiceKey);
+  auto address_iter = data_map->find(kInflightAddressKey);
+  auto generation_iter = data_map->find(kInflightGenerationKey);
+  if (service_iter == data_map->end() || address_iter == data_map->end() || generation_iter == data_map->end()) {
+    return false;
+  }
+  service = std::move(service_iter->second);
+  address = std::move(address_iter->second);
+  generation = trpc::util::Convert<uint64_t, std::string>(generation_iter->second);
+  data_map->erase(kInflightServiceKey);
+  data_map->erase(kInflightAddressKey);
+  data_map->erase(kInflightGenerationKey);
+  return true;
+}
+
+// Record a value of the call in the context, a retry overwrites the record of the previous try
+void MarkCallData(const ClientContextPtr& context, const char* key, const std::string& value) {
+  auto* data_map = context->GetFilterData<std::unordered_map<std::string, std::string>>(
+      naming::polarismesh::GetPolarisMeshSelectorPluginID());
+  if (!data_map) {
+    std::unordered_map<std::string, std::string> new_data_map;
+    new_data_map[key] = value;
+    context->SetFilterData(naming::polarismesh::GetPolarisMeshSelectorPluginID(), std::move(new_data_map));
+  } else {
+    (*data_map)[key] = value;
+  }
+}
+
+// Record an endpoint selected for the call, its retries avoid it. The latest max_tried endpoints are kept
+void MarkTriedEndpoint(const ClientContextPtr& context, const std::string& address, uint32_t max_tried) {
+  auto* data_map = context->GetFilterData<std::unordered_map<std::string, std::string>>(
+      naming::polarismesh::GetPolarisMeshSelectorPluginID());
+  if (!data_map) {
+    std::unordered_map<std::string, std::string> new_data_map;
+    new_data_map[kTriedEndpointsKey] = address;
+    context->SetFilterData(naming::polarismesh::GetPolarisMeshSelectorPluginID(), std::move(new_data_map));
+    return;
+  }
+
+  auto& tried = (*data_map)[kTriedEndpointsKey];
+  if (!tried.empty()) {
+    tried.append(",");
+  }
+  tried.append(address);
+  while (static_cast<uint32_t>(std::count(tried.begin(), tried.end(), ',')) >= std::max<uint32_t>(1, max_tried)) {
+    tried.erase(0, tried.find(',') + 1);
+  }
+}
+
+// Add the endpoints of a list separated by "," to addresses
+void SplitAddresses(const std::string& list, std::unordered_set<std::string>& addresses) {
+  size_t begin = 0;
+  while (begin < list.size()) {
+    size_t end = list.find(',', begin);
+    if (end == std::string::npos) {
+      end = list.size();
+    }
+    if (end > begin) {
+      addresses.emplace(list, begin, end - begin);
+    }
+    begin = end + 1;
+  }
+}
+
+// Take a value of the call out of the context, so the result is counted only once
+bool TakeCallData(const ClientContextPtr& context, const char* key, std::string& value) {
+  auto* data_map = context->GetFilterData<std::unordered_map<std::string, std::string>>(
+      naming::polarismesh::GetPolarisMeshSelectorPluginID());
+  if (!data_map) {
+    return false;
+  }
+
+  auto iter = data_map->find(key);
+  if (iter == data_map->end()) {
+    return false;
+  }
+  value = std::move(iter->second);
+  data_map->erase(iter);
+  return true;
+}
+
+}  // namespace
+
 // Set the transparent information of the Selector-META-prefix to the polaris Routing rule
 void SetTransSelectorMeta(const ClientContextPtr& context, std::map<std::string, std::string>* metadata) {
   static constexpr char meta_prefix[] = "selector-meta-";
@@ -70,11 +235,282 @@ int PolarisMeshSelector::Init() noexcept {
     plugin_config_ = config;
   }
 
-  enable_set_circuitbreaker_ =
-      plugin_config_.selector_config.consumer_config.circuit_breaker_config.set_circuitbreaker_config.enable;
+  const auto& set_breaker_config =
+      plugin_config_.selector_config.consumer_config.circuit_breaker_config.set_circuitbreaker_config;
+  enable_set_circuitbreaker_ = set_breaker_config.enable;
+  if (enable_set_circuitbreaker_) {
+    naming::polarismesh::SetCircuitBreaker::Options set_breaker_options;
+    set_breaker_options.window_ms = set_breaker_config.window;
+    set_breaker_options.min_requests = set_breaker_config.min_requests;
+    set_breaker_options.error_rate_percent = std::min<uint32_t>(100, set_breaker_config.error_rate_percent);
+    set_breaker_options.slow_call_ms = set_breaker_config.slow_call;
+    set_breaker_options.slow_rate_percent = std::min<uint32_t>(100, set_breaker_config.slow_rate_percent);
+    set_breaker_options.sleep_window_ms = set_breaker_config.sleep_window;
+    set_breaker_options.success_to_close = std::max<uint32_t>(1, set_breaker_config.success_to_close);
+    set_breaker_.SetOptions(set_breaker_options);
+  }
   timeout_ = plugin_config_.selector_config.global_config.server_connector_config.timeout;
+  enable_deadline_ = plugin_config_.selector_config.deadline_config.enable;
+  deadline_reserve_ = plugin_config_.selector_config.deadline_config.reserve;
   enable_polarismesh_trans_meta_ = plugin_config_.selector_config.consumer_config.enable_trans_meta;
 
+  const auto& fail_static_config = plugin_config_.selector_config.fail_static_config;
+  enable_fail_static_ = fail_static_config.enable;
+  naming::polarismesh::RoutedSnapshotCache::Options snapshot_options;
+  snapshot_options.max_staleness_ms = fail_static_config.max_staleness;
+  snapshot_options.snapshot_interval_ms = fail_static_config.snapshot_interval;
+  snapshot_options.min_backoff_ms = fail_static_config.min_backoff;
+  snapshot_options.max_backoff_ms = fail_static_config.max_backoff;
+
+  const auto& local_hash_config = plugin_config_.selector_config.local_hash_config;
+  enable_local_hash_ = local_hash_config.enable;
+  if (!naming::polarismesh::ParseConsistentHashType(local_hash_config.type, local_hash_type_)) {
+    TRPC_FMT_WARN("Unknown local hash type:{}, use ringHash", local_hash_config.type);
+    local_hash_type_ = naming::polarismesh::ConsistentHashType::kRingHash;
+  }
+  naming::polarismesh::ConsistentHashOptions hash_options;
+  uint32_t vnode_count = plugin_config_.selector_config.consumer_config.load_balancer_config.vnode_count;
+  if (vnode_count > 0) {
+    hash_options.vnode_count = vnode_count;
+  }
+  hash_options.maglev_table_size = local_hash_config.maglev_table_size;
+  hash_table_cache_.SetOptions(hash_options);
+  bounded_load_factor_ = local_hash_config.bounded_load_factor;
+
+  const auto& local_random_config = plugin_config_.selector_config.local_random_config;
+  const auto& load_balancer_config = plugin_config_.selector_config.consumer_config.load_balancer_config;
+  // The dynamic weights are only known to the SDK
+  enable_local_random_ = local_random_config.enable && load_balancer_config.type == kLoadBalanceTypeWeightedRandom &&
+                         !load_balancer_config.enable_dynamic_weight;
+  local_random_min_instances_ = local_random_config.min_instances;
+
+  // The tables follow the routed snapshots, which have to be refreshed often enough
+  std::vector<uint64_t> snapshot_intervals;
+  if (enable_fail_static_) {
+    snapshot_intervals.push_back(fail_static_config.snapshot_interval);
+  }
+  if (enable_local_hash_) {
+    snapshot_intervals.push_back(local_hash_config.refresh_interval);
+  }
+  if (enable_local_random_) {
+    snapshot_intervals.push_back(local_random_config.refresh_interval);
+  }
+  const auto& location_config = plugin_config_.selector_config.global_config.api_config.location_config;
+  naming::polarismesh::EndpointLocation local_location{location_config.region, location_config.zone,
+                                                       location_config.campus};
+  const auto& service_router_config = plugin_config_.selector_config.consumer_config.service_router_config;
+  enable_local_nearby_ = plugin_config_.selector_config.local_nearby_config.enable;
+  if (enable_local_nearby_) {
+    const auto& nearby_config = service_router_config.router_plugin_config.nearby_based_router_config;
+    if (!naming::polarismesh::ParseLocalityLevel(nearby_config.match_level, nearby_options_.match_level) ||
+        !naming::polarismesh::ParseLocalityLevel(nearby_config.max_match_level, nearby_options_.max_match_level)) {
+      TRPC_FMT_WARN("Unknown nearby match level:{} or max match level:{}, use zone and none", nearby_config.match_level,
+                    nearby_config.max_match_level);
+      nearby_options_.match_level = naming::polarismesh::LocalityLevel::kZone;
+      nearby_options_.max_match_level = naming::polarismesh::LocalityLevel::kAll;
+    }
+    nearby_options_.strict_nearby = nearby_config.strict_nearby;
+    nearby_options_.enable_degrade_by_unhealthy_percent = nearby_config.enable_degrade_by_unhealthy_percent;
+    nearby_options_.unhealthy_percent_to_degrade = std::max(0, nearby_config.unhealthy_percent_to_degrade);
+    nearby_options_.enable_recover_all = nearby_config.enable_recover_all;
+
+    locality_tiers_cache_.SetLocalLocation(local_location);
+
+    const auto& chain = service_router_config.chain;
+    if (std::find(chain.begin(), chain.end(), "nearbyRouter") != chain.end()) {
+      TRPC_FMT_WARN("The nearbyRouter is still in the service router chain, the locality is routed twice");
+    }
+  }
+
+  const auto& latency_locality_config = plugin_config_.selector_config.latency_locality_config;
+  // The fallback levels are only known to the plugin when it makes the nearby routing
+  enable_latency_locality_ = latency_locality_config.enable && enable_local_nearby_;
+  if (latency_locality_config.enable && !enable_local_nearby_) {
+    TRPC_FMT_WARN("The latency locality needs local_nearby, it is disabled");
+  }
+  if (enable_latency_locality_) {
+    naming::polarismesh::LocalityLatencyTracker::Options latency_options;
+    latency_options.decay = std::clamp(latency_locality_config.decay, 0.01, 1.0);
+    latency_options.min_samples = latency_locality_config.min_samples;
+    latency_options.expire_ms = latency_locality_config.expire_time;
+    locality_latency_tracker_.SetOptions(latency_options);
+    latency_rank_interval_ = latency_locality_config.rank_interval;
+    locality_tiers_cache_.SetLatencyTracker(&locality_latency_tracker_);
+  }
+
+  const auto& zone_aware_config = plugin_config_.selector_config.zone_aware_config;
+  enable_zone_aware_ = zone_aware_config.enable;
+  if (enable_zone_aware_) {
+    snapshot_intervals.push_back(zone_aware_config.refresh_interval);
+    zone_aware_cache_.SetLocalLocation(local_location);
+    zone_aware_cache_.SetMinClusterSize(zone_aware_config.min_cluster_size);
+    naming::polarismesh::RoutedSnapshotCache::Options caller_options;
+    caller_options.snapshot_interval_ms = zone_aware_config.refresh_interval;
+    caller_snapshot_cache_.SetOptions(caller_options);
+    if (location_config.zone.empty()) {
+      TRPC_FMT_WARN("The local zone is unknown, the calls are not routed by zone");
+    }
+  }
+
+  const auto& federation_config = plugin_config_.selector_config.federation_config;
+  enable_federation_ = federation_config.enable && !federation_config.clusters.empty();
+  naming::polarismesh::FederationOptions federation_options;
+  federation_options.overprovisioning_factor = std::max<uint32_t>(100, federation_config.overprovisioning_factor);
+  federation_plan_cache_.SetOptions(federation_options);
+
+  const auto& colocation_config = plugin_config_.selector_config.colocation_config;
+  enable_colocation_ = colocation_config.enable;
+  if (enable_colocation_) {
+    naming::polarismesh::ColocationOptions colocation_options;
+    colocation_options.local_host = plugin_config_.selector_config.global_config.api_config.bind_ip;
+    colocation_options.local_host_id = colocation_config.host_id;
+    colocation_options.max_local_percent = colocation_config.max_local_percent;
+    colocation_options.use_uds = colocation_config.use_uds;
+    colocation_cache_.SetOptions(colocation_options);
+    if (colocation_options.local_host.empty() && colocation_options.local_host_id.empty()) {
+      TRPC_FMT_WARN("Neither the bindIP nor the host id is known, the co-location is disabled");
+      enable_colocation_ = false;
+    }
+  }
+
+  const auto& slow_start_config = plugin_config_.selector_config.slow_start_config;
+  enable_slow_start_ = slow_start_config.enable && slow_start_config.window > 0;
+  if (enable_slow_start_) {
+    naming::polarismesh::SlowStartOptions slow_start_options;
+    slow_start_options.window_ms = slow_start_config.window;
+    if (!naming::polarismesh::ParseSlowStartCurve(slow_start_config.curve, slow_start_options.curve)) {
+      TRPC_FMT_WARN("Unknown slow start curve:{}, use linear", slow_start_config.curve);
+      slow_start_options.curve = naming::polarismesh::SlowStartCurve::kLinear;
+    }
+    slow_start_options.aggression = std::max(1.0, slow_start_config.aggression);
+    slow_start_options.min_weight_percent = std::min<uint32_t>(100, slow_start_config.min_weight_percent);
+    slow_start_cache_.SetOptions(slow_start_options);
+    snapshot_options.track_first_seen = true;
+    if (!enable_local_random_ && !enable_local_hash_ && !enable_local_nearby_ && !enable_zone_aware_) {
+      TRPC_FMT_WARN("The slow start only ramps the endpoints balanced by the plugin, none of them is enabled");
+    }
+  }
+
+  const auto& latency_outlier_config = plugin_config_.selector_config.latency_outlier_config;
+  enable_latency_outlier_ = latency_outlier_config.enable;
+  if (enable_latency_outlier_) {
+    naming::polarismesh::LatencyOutlierDetector::Options outlier_options;
+    outlier_options.window_ms = latency_outlier_config.window;
+    outlier_options.quantile = std::clamp(latency_outlier_config.quantile, 0.0, 1.0);
+    outlier_options.ratio = std::max(1.0, latency_outlier_config.ratio);
+    outlier_options.min_latency_ms = latency_outlier_config.min_latency;
+    outlier_options.min_samples = latency_outlier_config.min_samples;
+    outlier_options.min_hosts = latency_outlier_config.min_hosts;
+    outlier_options.base_ejection_ms = latency_outlier_config.base_ejection_time;
+    outlier_options.max_ejection_ms = latency_outlier_config.max_ejection_time;
+    outlier_options.max_ejection_percent = latency_outlier_config.max_ejection_percent;
+    outlier_options.interval_ms = latency_outlier_config.interval;
+    latency_outlier_detector_.SetOptions(outlier_options);
+  }
+
+  const auto& method_breaker_config = plugin_config_.selector_config.method_circuit_breaker_config;
+  enable_method_breaker_ = method_breaker_config.enable;
+  if (enable_method_breaker_) {
+    naming::polarismesh::MethodCircuitBreaker::Options breaker_options;
+    breaker_options.window_ms = method_breaker_config.window;
+    breaker_options.bucket_num = std::max<uint32_t>(1, method_breaker_config.bucket_num);
+    breaker_options.min_requests = method_breaker_config.min_requests;
+    breaker_options.error_rate_percent = std::min<uint32_t>(100, method_breaker_config.error_rate_percent);
+    breaker_options.sleep_window_ms = method_breaker_config.sleep_window;
+    breaker_options.success_to_close = std::max<uint32_t>(1, method_breaker_config.success_to_close);
+    method_breaker_.SetOptions(breaker_options);
+  }
+
+  const auto& retry_aware_config = plugin_config_.selector_config.retry_aware_config;
+  enable_retry_aware_ = retry_aware_config.enable;
+  max_tried_endpoints_ = std::max<uint32_t>(1, retry_aware_config.max_tried);
+
+  const auto& hedging_config = plugin_config_.selector_config.hedging_config;
+  enable_hedging_ = hedging_config.enable;
+  if (enable_hedging_) {
+    naming::polarismesh::HedgingPolicy::Options hedging_options;
+    hedging_options.quantile = std::clamp(hedging_config.quantile, 0.0, 1.0);
+    hedging_options.window_ms = std::max<uint64_t>(1, hedging_config.window);
+    hedging_options.min_samples = hedging_config.min_samples;
+    hedging_options.min_delay_ms = hedging_config.min_delay;
+    hedging_options.budget_percent = std::min<uint32_t>(100, hedging_config.budget_percent);
+    hedging_options.interval_ms = hedging_config.interval;
+    hedging_policy_.SetOptions(hedging_options);
+  }
+
+  const auto& adaptive_timeout_config = plugin_config_.selector_config.adaptive_timeout_config;
+  enable_adaptive_timeout_ = adaptive_timeout_config.enable;
+  apply_adaptive_timeout_ = adaptive_timeout_config.apply;
+  if (enable_adaptive_timeout_) {
+    naming::polarismesh::AdaptiveTimeout::Options adaptive_timeout_options;
+    adaptive_timeout_options.quantile = std::clamp(adaptive_timeout_config.quantile, 0.0, 1.0);
+    adaptive_timeout_options.multiplier = std::max(1.0, adaptive_timeout_config.multiplier);
+    adaptive_timeout_options.min_timeout_ms = adaptive_timeout_config.min_timeout;
+    adaptive_timeout_options.max_timeout_ms = adaptive_timeout_config.max_timeout;
+    adaptive_timeout_options.window_ms = std::max<uint64_t>(1, adaptive_timeout_config.window);
+    adaptive_timeout_options.min_samples = adaptive_timeout_config.min_samples;
+    adaptive_timeout_options.interval_ms = adaptive_timeout_config.interval;
+    adaptive_timeout_.SetOptions(adaptive_timeout_options);
+  }
+
+  const auto& retry_budget_config = plugin_config_.selector_config.retry_budget_config;
+  enable_retry_budget_ = retry_budget_config.enable;
+  if (enable_retry_budget_) {
+    naming::polarismesh::RetryBudget::Options retry_budget_options;
+    retry_budget_options.ratio_percent = retry_budget_config.ratio_percent;
+    retry_budget_options.max_tokens = retry_budget_config.max_tokens;
+    retry_budget_options.min_healthy_percent = std::min<uint32_t>(100, retry_budget_config.min_healthy_percent);
+    retry_budget_options.breaker.window_ms = retry_budget_config.window;
+    retry_budget_options.breaker.min_requests = retry_budget_config.min_requests;
+    retry_budget_options.breaker.error_rate_percent = std::min<uint32_t>(100, retry_budget_config.error_rate_percent);
+    retry_budget_options.breaker.sleep_window_ms = retry_budget_config.sleep_window;
+    retry_budget_.SetOptions(retry_budget_options);
+  }
+
+  const auto& fail_fast_config = plugin_config_.selector_config.service_fail_fast_config;
+  enable_fail_fast_ = fail_fast_config.enable;
+  if (enable_fail_fast_) {
+    naming::polarismesh::ServiceFailFast::Options fail_fast_options;
+    fail_fast_options.broken_percent = std::min<uint32_t>(100, fail_fast_config.broken_percent);
+    fail_fast_options.reject_percent = std::min<uint32_t>(100, fail_fast_config.reject_percent);
+    fail_fast_options.breaker.window_ms = fail_fast_config.window;
+    fail_fast_options.breaker.min_requests = fail_fast_config.min_requests;
+    fail_fast_options.breaker.error_rate_percent = std::min<uint32_t>(100, fail_fast_config.error_rate_percent);
+    fail_fast_options.breaker.sleep_window_ms = fail_fast_config.sleep_window;
+    fail_fast_.SetOptions(fail_fast_options);
+  }
+
+  const auto& metadata_index_config = plugin_config_.selector_config.metadata_index_config;
+  enable_metadata_index_ = metadata_index_config.enable;
+  metadata_index_cache_.SetMaxCachedFilters(std::max<uint32_t>(1, metadata_index_config.max_filters));
+
+  const auto& route_cache_config = plugin_config_.selector_config.route_cache_config;
+  enable_route_cache_ = route_cache_config.enable;
+  if (enable_route_cache_) {
+    // The subsets follow the revisions of the SDK data, the timed refresh is only a safety net
+    snapshot_options.snapshot_interval_ms = route_cache_config.refresh_interval;
+    snapshot_options.max_entries = route_cache_config.max_entries;
+  } else if (!snapshot_intervals.empty()) {
+    snapshot_options.snapshot_interval_ms = *std::min_element(snapshot_intervals.begin(), snapshot_intervals.end());
+  }
+  rule_check_interval_ = route_cache_config.rule_check_interval;
+  max_thread_rules_ = std::max<uint32_t>(1, route_cache_config.max_thread_rules);
+  route_rule_epoch_.fetch_add(1, std::memory_order_release);
+  snapshot_cache_.SetOptions(snapshot_options);
+
+  const auto& negative_cache_config = plugin_config_.selector_config.negative_cache_config;
+  enable_lookup_guard_ = negative_cache_config.enable;
+  naming::polarismesh::ServiceLookupGuard::Options lookup_options;
+  lookup_options.enable_negative_cache = negative_cache_config.enable;
+  lookup_options.negative_ttl_ms = negative_cache_config.ttl;
+  lookup_options.wait_timeout_ms = timeout_;
+  lookup_guard_.SetOptions(lookup_options);
+
+  const auto& server_metric_config = plugin_config_.selector_config.global_config.server_metric_config;
+  if (server_metric_config.enable) {
+    metrics_name_ = GetPluginMetricsName(server_metric_config.metrics_name);
+  }
+
   if (trpc::TrpcShareContext::GetInstance()->Init(plugin_config_) != 0) {
     return -1;
   }
@@ -88,6 +524,10 @@ int PolarisMeshSelector::Init() noexcept {
     return -1;
   }
 
+  if (enable_federation_) {
+    InitFederation();
+  }
+
   // Add the default framework and return code white list
   circuitbreak_whitelist_.Writer().clear();
   circuitbreak_whitelist_.Writer().insert(TrpcRetCode::TRPC_SERVER_OVERLOAD_ERR);
@@ -98,27 +538,987 @@ int PolarisMeshSelector::Init() noexcept {
   return 0;
 }
 
+void PolarisMeshSelector::Start() noexcept {
+  if (!enable_fail_static_ || refresh_thread_) {
+    return;
+  }
+
+  refresh_stop_ = false;
+  snapshot_cache_.SetAsyncRefresh(true);
+  refresh_thread_ = std::make_unique<std::thread>([this]() { SnapshotRefreshLoop(); });
+}
+
+void PolarisMeshSelector::Stop() noexcept {
+  if (!refresh_thread_) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(refresh_mutex_);
+    refresh_stop_ = true;
+  }
+  refresh_cond_.notify_all();
+  refresh_thread_->join();
+  refresh_thread_ = nullptr;
+  snapshot_cache_.SetAsyncRefresh(false);
+}
+
 void PolarisMeshSelector::Destroy() noexcept {
   if (!init_) {
     TRPC_FMT_DEBUG("No init yet");
     return;
   }
 
+  Stop();
+  // The SDK objects of a cluster go before its context
+  for (auto& cluster : federated_clusters_) {
+    cluster->consumer_api = nullptr;
+  }
+  federated_clusters_.clear();
+  federation_plan_cache_.Clear();
+  cluster_latency_tracker_.Clear();
+  snapshot_cache_.Clear();
+  hash_table_cache_.Clear();
+  alias_table_cache_.Clear();
+  metadata_index_cache_.Clear();
+  locality_tiers_cache_.Clear();
+  colocation_cache_.Clear();
+  slow_start_cache_.Clear();
+  latency_outlier_detector_.Clear();
+  method_breaker_.Clear();
+  set_breaker_.Clear();
+  fail_fast_.Clear();
+  hedging_policy_.Clear();
+  retry_budget_.Clear();
+  adaptive_timeout_.Clear();
+  locality_latency_tracker_.Clear();
+  zone_aware_cache_.Clear();
+  caller_snapshot_cache_.Clear();
+  inflight_tracker_.Clear();
+  lookup_guard_.Clear();
+  route_rule_epoch_.fetch_add(1, std::memory_order_release);
   consumer_api_ = nullptr;
   polarismesh_context_ = nullptr;
   trpc::TrpcShareContext::GetInstance()->Destroy();
   init_ = false;
 }
 
+void PolarisMeshSelector::SnapshotRefreshLoop() {
+  // Check the due refreshes at the granularity of the minimum backoff
+  uint64_t check_interval = std::clamp<uint64_t>(snapshot_cache_.GetOptions().min_backoff_ms, 10, 1000);
+  std::unique_lock<std::mutex> lock(refresh_mutex_);
+  while (!refresh_stop_) {
+    refresh_cond_.wait_for(lock, std::chrono::milliseconds(check_interval));
+    if (refresh_stop_) {
+      break;
+    }
+
+    lock.unlock();
+    for (auto& refresher : snapshot_cache_.ClaimDueRefreshes(trpc::time::GetMilliSeconds())) {
+      refresher();
+    }
+    lock.lock();
+  }
+}
+
+bool PolarisMeshSelector::AdmitLookup(const std::string& lookup_key, uint64_t timeout_ms,
+                                      naming::polarismesh::ServiceLookupGuard::Admission& admission) {
+  if (!enable_lookup_guard_) {
+    admission = naming::polarismesh::ServiceLookupGuard::Admission::kWarm;
+    return true;
+  }
+
+  admission = lookup_guard_.Admit(lookup_key, trpc::time::GetMilliSeconds(), timeout_ms);
+  if (admission == naming::polarismesh::ServiceLookupGuard::Admission::kNotFound) {
+    TRPC_FMT_DEBUG("Service not found recently, fail fast, service:{}", lookup_key);
+    return false;
+  }
+  return true;
+}
+
+void PolarisMeshSelector::CompleteLookup(const std::string& lookup_key,
+                                         naming::polarismesh::ServiceLookupGuard::Admission admission,
+                                         polaris::ReturnCode ret) {
+  if (!enable_lookup_guard_) {
+    return;
+  }
+
+  using LookupResult = naming::polarismesh::ServiceLookupGuard::Result;
+  LookupResult result = LookupResult::kError;
+  if (ret == polaris::ReturnCode::kReturnOk) {
+    result = LookupResult::kFound;
+  } else if (ret == polaris::ReturnCode::kReturnServiceNotFound) {
+    result = LookupResult::kNotFound;
+  }
+  lookup_guard_.Complete(lookup_key, admission, result, trpc::time::GetMilliSeconds());
+}
+
+void PolarisMeshSelector::BuildRouteInputs(const SelectorInfo* info, const polaris::ServiceKey& service_key,
+                                           RouteInputs& inputs) {
+  inputs.service_key = service_key;
+  inputs.timeout = GetLookupTimeout(info->context);
+  // The main system of service key
+  GetSourceServiceKey(info->context, info->extend_select_info, inputs.source_service_info.service_key_);
+  // Set the main service information
+  FillMetadataOfSourceServiceInfo(info, inputs.source_service_info);
+  // Set Canary Information
+  inputs.canary = GetValueFromContextOrExtend(info->context, info->extend_select_info, "canary_label");
+  // Fill in metadata
+  auto meta =
+      naming::polarismesh::GetFilterMetadataOfNaming(info->context, PolarisMetadataType::kPolarisDstMetaRouteLable);
+  if (meta != nullptr) {
+    inputs.dst_metadata = std::move(*meta);
+  }
+  // Setting whether to include unhealthy or fuse nodes
+  inputs.include_unhealthy =
+      GetValueFromContextOrExtend(info->context, info->extend_select_info, "include_unhealthy") == "true";
+}
+
+std::string PolarisMeshSelector::BuildRouteKey(const RouteInputs& inputs) {
+  // The callee stays readable, the other inputs are signed to keep the key short whatever the size of the metadata
+  naming::polarismesh::SignatureHasher hasher;
+  hasher.Add(inputs.source_service_info.service_key_.namespace_).Add(inputs.source_service_info.service_key_.name_);
+  hasher.Add(inputs.canary).Add(inputs.include_unhealthy ? 1 : 0);
+  hasher.Add(inputs.source_service_info.metadata_.size());
+  for (const auto& item : inputs.source_service_info.metadata_) {
+    hasher.Add(item.first).Add(item.second);
+  }
+  hasher.Add(inputs.dst_metadata.size());
+  for (const auto& item : inputs.dst_metadata) {
+    hasher.Add(item.first).Add(item.second);
+  }
+
+  std::string key;
+  key.reserve(inputs.service_key.namespace_.size() + inputs.service_key.name_.size() + 24);
+  key.append(inputs.service_key.namespace_).append("|").append(inputs.service_key.name_);
+  key.append("|").append(std::to_string(hasher.Get()));
+  return key;
+}
+
+uint64_t PolarisMeshSelector::GetRouteRuleVersion(const polaris::ServiceKey& service_key) {
+  uint64_t now_ms = trpc::time::GetMilliSeconds();
+  uint64_t epoch = route_rule_epoch_.load(std::memory_order_acquire);
+  std::string key = GetServiceId(service_key);
+  auto iter = source_route_rule_map_.find(key);
+  if (iter != source_route_rule_map_.end() && iter->second.epoch == epoch &&
+      now_ms < iter->second.check_time_ms + rule_check_interval_) {
+    return iter->second.version;
+  }
+
+  polaris::ServiceData* service_data = nullptr;
+  if (polarismesh_context_->GetLocalRegistry()->GetServiceDataWithRef(service_key, polaris::kServiceDataRouteRule,
+                                                                      service_data) != polaris::kReturnOk ||
+      service_data == nullptr) {
+    // Not loaded yet, nothing is cached so that the next call checks again
+    if (iter != source_route_rule_map_.end()) {
+      source_route_rule_map_.erase(iter);
+    }
+    return 0;
+  }
+
+  // Only the signature of the revision is cached, the data is released at once
+  uint64_t version = naming::polarismesh::SignatureHasher().Add(service_data->GetRevision()).Get();
+  service_data->DecrementRef();
+  if (iter != source_route_rule_map_.end()) {
+    if (iter->second.epoch == epoch && iter->second.version == version) {
+      // Unchanged, keep the cached data
+      iter->second.check_time_ms = now_ms;
+      return version;
+    }
+    source_route_rule_map_.erase(iter);
+  }
+
+  if (source_route_rule_map_.size() >= max_thread_rules_) {
+    // Drop the rules of the old generations first, then any rule, the cache of a thread is small
+    for (auto it = source_route_rule_map_.begin(); it != source_route_rule_map_.end();) {
+      it = it->second.epoch != epoch ? source_route_rule_map_.erase(it) : std::next(it);
+    }
+    if (source_route_rule_map_.size() >= max_thread_rules_) {
+      source_route_rule_map_.erase(source_route_rule_map_.begin());
+    }
+  }
+  source_route_rule_map_.emplace(std::move(key), PolarisRuleRouteRaw{version, now_ms, epoch});
+  return version;
+}
+
+uint64_t PolarisMeshSelector::GetRouteSourceVersion(const RouteInputs& inputs) {
+  if (!enable_route_cache_) {
+    return 0;
+  }
+
+  polaris::LocalRegistry* local_registry = polarismesh_context_->GetLocalRegistry();
+  naming::polarismesh::SignatureHasher hasher;
+  auto add_revision = [local_registry, &hasher](const polaris::ServiceKey& service_key,
+                                                polaris::ServiceDataType data_type) {
+    polaris::ServiceData* service_data = nullptr;
+    if (local_registry->GetServiceDataWithRef(service_key, data_type, service_data) == polaris::kReturnOk &&
+        service_data != nullptr) {
+      hasher.Add(service_data->GetRevision());
+      service_data->DecrementRef();
+    } else {
+      // Not loaded yet, the version changes once it is
+      hasher.Add(std::string());
+    }
+  };
+
+  add_revision(inputs.service_key, polaris::kServiceDataInstances);
+  hasher.Add(GetRouteRuleVersion(inputs.service_key));
+  if (!inputs.source_service_info.service_key_.name_.empty()) {
+    hasher.Add(GetRouteRuleVersion(inputs.source_service_info.service_key_));
+  }
+  // The circuit breaker and health states of the instances change without a new revision of the instances
+  uint64_t circuit_breaker_version = 0;
+  local_registry->GetCircuitBreakerDataVersion(inputs.service_key, circuit_breaker_version);
+  hasher.Add(circuit_breaker_version);
+  return hasher.Get();
+}
+
+void PolarisMeshSelector::FillInstancesRequest(const RouteInputs& inputs, polaris::GetInstancesRequest& request) {
+  request.SetTimeout(inputs.timeout);
+  if (inputs.include_unhealthy) {
+    request.SetIncludeUnhealthyInstances(true);
+    request.SetIncludeCircuitBreakInstances(true);
+  }
+  if (!inputs.canary.empty()) {
+    request.SetCanary(inputs.canary);
+  }
+  request.SetSourceService(inputs.source_service_info);
+  if (!inputs.dst_metadata.empty()) {
+    request.SetMetadata(inputs.dst_metadata);
+  }
+}
+
+uint64_t PolarisMeshSelector::GetLookupTimeout(const ClientContextPtr& context) {
+  if (!enable_deadline_) {
+    return timeout_;
+  }
+
+  return GetDeadlineAwareTimeout(context, timeout_, deadline_reserve_);
+}
+
+naming::polarismesh::RoutedSnapshotCache::Refresher PolarisMeshSelector::MakeRefresher(const RouteInputs& inputs,
+                                                                                      const std::string& route_key) {
+  // The refresh is not made on behalf of a call any more, so it uses the configured timeout
+  RouteInputs refresh_inputs = inputs;
+  refresh_inputs.timeout = timeout_;
+  refresh_inputs.lookup_failed = false;
+  return [this, refresh_inputs, route_key]() { return RefreshRoutedSnapshot(refresh_inputs, route_key); };
+}
+
+bool PolarisMeshSelector::RefreshRoutedSnapshot(const RouteInputs& inputs, const std::string& route_key) {
+  if (inputs.lookup_failed) {
+    return false;
+  }
+
+  // Taken before the lookup, a change during the lookup makes the snapshot outdated at once
+  uint64_t source_version = GetRouteSourceVersion(inputs);
+  polaris::GetInstancesRequest request(inputs.service_key);
+  FillInstancesRequest(inputs, request);
+
+  std::string service_id = GetServiceId(inputs.service_key);
+  naming::polarismesh::ServiceLookupGuard::Admission admission;
+  if (!AdmitLookup(service_id, inputs.timeout, admission)) {
+    inputs.lookup_failed = true;
+    snapshot_cache_.Erase(route_key);
+    return false;
+  }
+
+  polaris::InstancesResponse* response = nullptr;
+  polaris::ReturnCode ret = consumer_api_->GetInstances(request, response);
+  CompleteLookup(service_id, admission, ret);
+  uint64_t now_ms = trpc::time::GetMilliSeconds();
+  if (ret != polaris::ReturnCode::kReturnOk) {
+    inputs.lookup_failed = true;
+    TRPC_FMT_WARN("Refresh routed snapshot failed, sdk returnCode:{}, service_name:{}, service_namespace:{}",
+                  static_cast<int32_t>(ret), inputs.service_key.name_, inputs.service_key.namespace_);
+    if (response != nullptr) {
+      delete response;
+    }
+    // A service which does not exist is an answer of the control plane, not an outage of it, its snapshot is dropped
+    if (ret == polaris::ReturnCode::kReturnServiceNotFound) {
+      snapshot_cache_.Erase(route_key);
+    } else {
+      snapshot_cache_.OnFailure(route_key, now_ms, MakeRefresher(inputs, route_key));
+    }
+    return false;
+  }
+
+  std::vector<TrpcEndpointInfo> endpoints;
+  ConvertPolarisInstances(response->GetInstances(), endpoints);
+  std::vector<naming::polarismesh::EndpointLocation> locations;
+  ConvertInstanceLocations(response->GetInstances(), locations);
+  delete response;
+  snapshot_cache_.Update(route_key, std::move(endpoints), now_ms, source_version, std::move(locations));
+  return true;
+}
+
+int PolarisMeshSelector::SelectFromSnapshot(const SelectorInfo* info, const RouteInputs& inputs,
+                                            const std::string& route_key,
+                                            const naming::polarismesh::RoutedSnapshotPtr& snapshot,
+                                            std::vector<TrpcEndpointInfo>& endpoints) {
+  uint32_t num = 1;
+  if (info->policy == SelectorPolicy::MULTIPLE && info->select_num > 1) {
+    num = info->select_num;
+  }
+
+  // Keep the hash keys on the same endpoints as the local consistent hashing does
+  naming::polarismesh::ConsistentHashType hash_type;
+  naming::polarismesh::ConsistentHashTablePtr table;
+  if (!info->context->GetHashKey().empty() && GetLocalHashType(info, hash_type)) {
+    table = hash_table_cache_.Get(route_key, hash_type, snapshot);
+  }
+  size_t size = endpoints.size();
+  if (table) {
+    uint32_t offset = trpc::util::Convert<uint32_t, std::string>(
+        GetValueFromContextOrExtend(info->context, info->extend_select_info, "replicate_index"));
+    AppendHashReplicas(info, *table, offset, num, true, endpoints);
+    // The endpoint of the key is left out by the plugin, picked again from the endpoints which are not
+    if (endpoints.size() > size && IsExcludedEndpoint(inputs, endpoints[size])) {
+      endpoints.resize(size);
+      table = nullptr;
+    }
+  }
+  if (!table &&
+      naming::polarismesh::PickFromSnapshot(*ExcludeEndpoints(inputs, snapshot), info->context->GetHashKey(), num,
+                                            endpoints) != 0) {
+    return -1;
+  }
+
+  uint64_t staleness = trpc::time::GetMilliSeconds() - snapshot->update_time_ms;
+  TRPC_FMT_WARN("Serve routed snapshot in fail-static mode, staleness:{}ms, service_name:{}", staleness, info->name);
+  ReportPluginMetric(metrics_name_, "polarismesh_snapshot_staleness_ms", info->name, staleness);
+  return 0;
+}
+
+int PolarisMeshSelector::SelectAfterFailedLookup(const SelectorInfo* info, const RouteInputs& inputs,
+                                                 const std::string& route_key,
+                                                 std::vector<TrpcEndpointInfo>& endpoints) {
+  if (!enable_fail_static_) {
+    return -1;
+  }
+
+  // The failed refresh already backed the key off, it is degraded if a snapshot is left to serve
+  auto snapshot = ApplyLocalNearby(route_key, snapshot_cache_.GetIfDegraded(route_key, trpc::time::GetMilliSeconds()));
+  return snapshot ? SelectFromSnapshot(info, inputs, route_key, snapshot, endpoints) : -1;
+}
+
+bool PolarisMeshSelector::GetLocalHashType(const SelectorInfo* info, naming::polarismesh::ConsistentHashType& type) {
+  if (!enable_local_hash_) {
+    return false;
+  }
+
+  // A load balance name other than the hashing ones means the call does not want a consistent hashing
+  if (info->load_balance_name.empty() || info->load_balance_name == polaris::kLoadBalanceTypeDefaultConfig) {
+    type = local_hash_type_;
+    return true;
+  }
+  return naming::polarismesh::ParseConsistentHashType(info->load_balance_name, type);
+}
+
+naming::polarismesh::RoutedSnapshotPtr PolarisMeshSelector::GetRoutedSnapshot(const RouteInputs& inputs,
+                                                                             const std::string& route_key) {
+  if (enable_metadata_index_ && !inputs.dst_metadata.empty()) {
+    // Routed once without the destination metadata, each filter is then an intersection in the index of that subset
+    RouteInputs base_inputs = inputs;
+    base_inputs.dst_metadata.clear();
+    base_inputs.zone_aware = false;
+    base_inputs.method.clear();
+    std::string base_key = BuildRouteKey(base_inputs);
+    auto index = metadata_index_cache_.Get(base_key, GetRoutedSnapshot(base_inputs, base_key));
+    auto snapshot = ApplyMethodBreaker(inputs, route_key, index ? index->Match(inputs.dst_metadata) : nullptr);
+    return inputs.zone_aware ? ApplyZoneAware(inputs, route_key, snapshot) : snapshot;
+  }
+
+  if (snapshot_cache_.NeedSnapshot(route_key, trpc::time::GetMilliSeconds(), GetRouteSourceVersion(inputs)) &&
+      !RefreshRoutedSnapshot(inputs, route_key)) {
+    return nullptr;
+  }
+  auto snapshot = snapshot_cache_.Get(route_key);
+  if (enable_slow_start_) {
+    // Ramped before the locality and zone subsets are taken, they carry the ramped weights
+    snapshot = slow_start_cache_.Apply(route_key, snapshot, trpc::time::GetMilliSeconds());
+  }
+  if (enable_latency_outlier_) {
+    snapshot = latency_outlier_detector_.Apply(GetServiceId(inputs.service_key), route_key, snapshot,
+                                               trpc::time::GetMilliSeconds());
+  }
+  if (enable_set_circuitbreaker_) {
+    snapshot =
+        set_breaker_.Apply(GetServiceId(inputs.service_key), route_key, snapshot, trpc::time::GetMilliSeconds());
+  }
+  snapshot = ApplyMethodBreaker(inputs, route_key, snapshot);
+  snapshot = ApplyLocalNearby(route_key, snapshot);
+  return inputs.zone_aware ? ApplyZoneAware(inputs, route_key, snapshot) : snapshot;
+}
+
+naming::polarismesh::RoutedSnapshotPtr PolarisMeshSelector::ApplyLocalNearby(
+    const std::string& route_key, const naming::polarismesh::RoutedSnapshotPtr& snapshot) {
+  if (!enable_local_nearby_ || !snapshot) {
+    return snapshot;
+  }
+  auto tiers = locality_tiers_cache_.Get(route_key, snapshot);
+  if (!tiers) {
+    return nullptr;
+  }
+  if (enable_latency_locality_) {
+    return tiers->SelectByLatency(nearby_options_, locality_latency_tracker_, trpc::time::GetMilliSeconds(),
+                                  latency_rank_interval_);
+  }
+  return tiers->Select(nearby_options_);
+}
+
+naming::polarismesh::RoutedSnapshotPtr PolarisMeshSelector::ApplyMethodBreaker(
+    const RouteInputs& inputs, const std::string& route_key, const naming::polarismesh::RoutedSnapshotPtr& snapshot) {
+  if (inputs.method.empty() || !snapshot) {
+    return snapshot;
+  }
+  return method_breaker_.Apply(GetServiceId(inputs.service_key), inputs.method, route_key, snapshot,
+                               trpc::time::GetMilliSeconds());
+}
+
+naming::polarismesh::RoutedSnapshotPtr PolarisMeshSelector::ExcludeTried(
+    const RouteInputs& inputs, const naming::polarismesh::RoutedSnapshotPtr& snapshot) {
+  if (inputs.tried.empty() || !snapshot) {
+    return snapshot;
+  }
+  // Not cached, only the retries pay for it. A retry to a tried endpoint is still better than no endpoint
+  auto left = naming::polarismesh::RemoveEndpoints(snapshot, inputs.tried);
+  return left ? left : snapshot;
+}
+
+naming::polarismesh::RoutedSnapshotPtr PolarisMeshSelector::ExcludeEndpoints(
+    const RouteInputs& inputs, const naming::polarismesh::RoutedSnapshotPtr& snapshot) {
+  if (!enable_latency_outlier_ && !enable_method_breaker_ && !enable_set_circuitbreaker_ && inputs.tried.empty()) {
+    return snapshot;
+  }
+
+  std::unordered_set<std::string> excluded;
+  for (const auto& endpoint : snapshot->endpoints) {
+    if (IsExcludedEndpoint(inputs, endpoint)) {
+      excluded.insert(naming::polarismesh::GetEndpointAddress(endpoint));
+    }
+  }
+  if (excluded.empty()) {
+    return snapshot;
+  }
+  // An excluded endpoint is still better than no endpoint
+  auto left = naming::polarismesh::RemoveEndpoints(snapshot, excluded);
+  return left ? left : snapshot;
+}
+
+bool PolarisMeshSelector::IsExcludedEndpoint(const RouteInputs& inputs, const TrpcEndpointInfo& endpoint) {
+  std::string service = GetServiceId(inputs.service_key);
+  std::string address = naming::polarismesh::GetEndpointAddress(endpoint);
+  if (inputs.tried.count(address) > 0) {
+    return true;
+  }
+  uint64_t now_ms = trpc::time::GetMilliSeconds();
+  if (enable_latency_outlier_) {
+    auto ejections = latency_outlier_detector_.GetEjections(service, now_ms);
+    if (ejections && ejections->addresses.count(address) > 0) {
+      return true;
+    }
+  }
+  if (enable_set_circuitbreaker_) {
+    std::string set_name = naming::polarismesh::GetEndpointSetName(endpoint.meta);
+    if (!set_name.empty() &&
+        set_breaker_.GetState(service, set_name, now_ms) == naming::polarismesh::BreakerState::kOpen) {
+      return true;
+    }
+  }
+  return !inputs.method.empty() &&
+         method_breaker_.GetState(service, inputs.method, address, now_ms) == naming::polarismesh::BreakerState::kOpen;
+}
+
+bool PolarisMeshSelector::IsFailingFast(const RouteInputs& inputs, const std::string& route_key) {
+  // Judged on the routed endpoints before the plugin leaves any of them out
+  uint64_t now_ms = trpc::time::GetMilliSeconds();
+  if (snapshot_cache_.NeedSnapshot(route_key, now_ms, GetRouteSourceVersion(inputs)) &&
+      !RefreshRoutedSnapshot(inputs, route_key)) {
+    return false;
+  }
+  return fail_fast_.ShouldReject(GetServiceId(inputs.service_key), route_key, snapshot_cache_.Get(route_key), now_ms,
+                                 naming::polarismesh::FastRandom());
+}
+
+void PolarisMeshSelector::FallbackFromOpenSet(RouteInputs& inputs) {
+  auto& metadata = inputs.source_service_info.metadata_;
+  auto iter = metadata.find(polaris::constants::kRouterRequestSetNameKey);
+  if (iter == metadata.end() || iter->second.empty()) {
+    return;
+  }
+
+  std::string service = GetServiceId(inputs.service_key);
+  std::string fallback = set_breaker_.GetFallbackSetName(service, iter->second, trpc::time::GetMilliSeconds());
+  if (fallback == iter->second) {
+    return;
+  }
+  TRPC_FMT_DEBUG("Set {} is broken, fall back to set:{}, service_name:{}", iter->second, fallback,
+                 inputs.service_key.name_);
+  if (fallback.empty()) {
+    metadata.erase(iter);
+    metadata[polaris::SetDivisionServiceRouter::enable_set_force] = "false";
+  } else {
+    iter->second = fallback;
+  }
+}
+
+naming::polarismesh::RoutedSnapshotPtr PolarisMeshSelector::ApplyZoneAware(
+    const RouteInputs& inputs, const std::string& route_key, const naming::polarismesh::RoutedSnapshotPtr& snapshot) {
+  if (!snapshot) {
+    return nullptr;
+  }
+  auto callers = GetCallerSnapshot(inputs.source_service_info.service_key_);
+  auto table = zone_aware_cache_.Get(route_key, snapshot, callers);
+  return table ? table->Pick(naming::polarismesh::FastRandom()) : snapshot;
+}
+
+naming::polarismesh::RoutedSnapshotPtr PolarisMeshSelector::GetCallerSnapshot(const polaris::ServiceKey& caller_key) {
+  if (caller_key.name_.empty()) {
+    return nullptr;
+  }
+
+  std::string key = GetServiceId(caller_key);
+  uint64_t now_ms = trpc::time::GetMilliSeconds();
+  if (!caller_snapshot_cache_.NeedSnapshot(key, now_ms)) {
+    return caller_snapshot_cache_.Get(key);
+  }
+
+  std::vector<TrpcEndpointInfo> endpoints;
+  std::vector<naming::polarismesh::EndpointLocation> locations;
+  polaris::GetInstancesRequest request(caller_key);
+  request.SetTimeout(timeout_);
+  polaris::InstancesResponse* response = nullptr;
+  polaris::ReturnCode ret = polaris::ReturnCode::kReturnServiceNotFound;
+  naming::polarismesh::ServiceLookupGuard::Admission admission;
+  if (AdmitLookup(key, timeout_, admission)) {
+    ret = consumer_api_->GetAllInstances(request, response);
+    CompleteLookup(key, admission, ret);
+  }
+  if (ret == polaris::ReturnCode::kReturnOk) {
+    // The isolated callers do not send calls
+    for (const auto& instance : response->GetInstances()) {
+      if (instance.isIsolate() || instance.GetWeight() == 0) {
+        continue;
+      }
+      TrpcEndpointInfo endpoint;
+      ConvertPolarisInstance(instance, endpoint, false);
+      endpoints.emplace_back(std::move(endpoint));
+      locations.push_back({instance.GetRegion(), instance.GetZone(), instance.GetCampus()});
+    }
+  } else {
+    TRPC_FMT_WARN("Get caller instances failed, sdk returnCode:{}, service_name:{}, service_namespace:{}",
+                  static_cast<int32_t>(ret), caller_key.name_, caller_key.namespace_);
+    // Keep the last distribution, the lookup is retried after the refresh interval
+    auto last = caller_snapshot_cache_.Get(key);
+    if (last) {
+      endpoints = last->endpoints;
+      locations = last->locations;
+    }
+  }
+  if (response != nullptr) {
+    delete response;
+  }
+  caller_snapshot_cache_.Update(key, std::move(endpoints), now_ms, 0, std::move(locations));
+  return caller_snapshot_cache_.Get(key);
+}
+
+int PolarisMeshSelector::SelectByLocalHash(const SelectorInfo* info, const RouteInputs& inputs,
+                                           const std::string& route_key, naming::polarismesh::ConsistentHashType type,
+                                           std::vector<TrpcEndpointInfo>& endpoints, bool need_meta) {
+  auto table = hash_table_cache_.Get(route_key, type, GetRoutedSnapshot(inputs, route_key));
+  if (!table) {
+    return -1;
+  }
+
+  // The replicate index skips the first endpoints of the key, the backup endpoints follow the selected one
+  uint32_t skip = trpc::util::Convert<uint32_t, std::string>(
+      GetValueFromContextOrExtend(info->context, info->extend_select_info, "replicate_index"));
+  uint32_t num = 1;
+  if (info->policy == SelectorPolicy::MULTIPLE && info->select_num > 1) {
+    num = info->select_num;
+  }
+
+  const auto& snapshot_endpoints = table->GetSnapshot()->endpoints;
+  uint64_t hash = naming::polarismesh::HashString(info->context->GetHashKey());
+  if (bounded_load_factor_ > 0 && num == 1 && skip == 0) {
+    // The in-flight calls are tracked only for the single selection, the result of which is reported
+    std::string service_id = GetServiceId(inputs.service_key);
+    uint32_t index = naming::polarismesh::LookupWithBoundedLoad(
+        *table, hash, bounded_load_factor_, inflight_tracker_.GetTotal(service_id), [&](uint32_t candidate) {
+          std::string candidate_address = naming::polarismesh::GetEndpointAddress(snapshot_endpoints[candidate]);
+          // A tried endpoint is full, the retry goes to the next one of the key
+          if (inputs.tried.count(candidate_address) > 0) {
+            return std::numeric_limits<int64_t>::max();
+          }
+          return inflight_tracker_.Get(service_id, candidate_address);
+        });
+    const auto& endpoint = snapshot_endpoints[index];
+    std::string address = naming::polarismesh::GetEndpointAddress(endpoint);
+    // A retry or a backup selection ends the call of the previous try, whose result may never be reported
+    std::string previous_service, previous_address;
+    uint64_t previous_generation = 0;
+    if (TakeInflightMark(info->context, previous_service, previous_address, previous_generation)) {
+      inflight_tracker_.End(previous_service, previous_address, previous_generation);
+    }
+    uint64_t generation = inflight_tracker_.Begin(service_id, address, trpc::time::GetMilliSeconds());
+    MarkInflight(info->context, service_id, address, generation);
+
+    endpoints.push_back(endpoint);
+    if (!need_meta) {
+      endpoints.back().meta.clear();
+    }
+    return 0;
+  }
+
+  if (num == 1 && skip == 0 && !inputs.tried.empty()) {
+    // The retry goes to the first endpoint of the key which was not tried
+    uint32_t selected = table->Lookup(hash);
+    table->Walk(hash, [&](uint32_t index) {
+      if (inputs.tried.count(naming::polarismesh::GetEndpointAddress(snapshot_endpoints[index])) > 0) {
+        return true;
+      }
+      selected = index;
+      return false;
+    });
+    endpoints.push_back(snapshot_endpoints[selected]);
+    if (!need_meta) {
+      endpoints.back().meta.clear();
+    }
+    return 0;
+  }
+
+  AppendHashReplicas(info, *table, skip, num, need_meta, endpoints);
+  return 0;
+}
+
+void PolarisMeshSelector::AppendHashReplicas(const SelectorInfo* info,
+                                             const naming::polarismesh::ConsistentHashTable& table, uint32_t offset,
+                                             uint32_t num, bool need_meta, std::vector<TrpcEndpointInfo>& endpoints) {
+  // All the replicas come from one routing pass, in the preference order of the hash key
+  std::vector<uint32_t> indexes;
+  naming::polarismesh::SelectReplicas(table, naming::polarismesh::HashString(info->context->GetHashKey()), offset, num,
+                                      indexes);
+
+  const auto& snapshot_endpoints = table.GetSnapshot()->endpoints;
+  endpoints.reserve(endpoints.size() + indexes.size());
+  for (auto index : indexes) {
+    endpoints.push_back(snapshot_endpoints[index]);
+    if (!need_meta) {
+      endpoints.back().meta.clear();
+    }
+  }
+}
+
+void PolarisMeshSelector::InitFederation() {
+  const auto& federation_config = plugin_config_.selector_config.federation_config;
+  for (const auto& cluster_config : federation_config.clusters) {
+    auto cluster = std::make_unique<FederatedCluster>();
+    cluster->name = cluster_config.name;
+    cluster->context = trpc::TrpcShareContext::GetInstance()->CreateClusterContext(plugin_config_, cluster_config);
+    if (cluster->context) {
+      cluster->consumer_api =
+          std::unique_ptr<polaris::ConsumerApi>(polaris::ConsumerApi::Create(cluster->context.get()));
+    }
+    if (!cluster->consumer_api) {
+      TRPC_FMT_ERROR("Create ConsumerApi of cluster {} failed, it is left out of the federation", cluster_config.name);
+      continue;
+    }
+
+    naming::polarismesh::RoutedSnapshotCache::Options cluster_options;
+    cluster_options.snapshot_interval_ms = federation_config.refresh_interval;
+    cluster->snapshot_cache.SetOptions(cluster_options);
+    federated_clusters_.push_back(std::move(cluster));
+  }
+  enable_federation_ = !federated_clusters_.empty();
+}
+
+naming::polarismesh::RoutedSnapshotPtr PolarisMeshSelector::GetFederatedSnapshot(FederatedCluster& cluster,
+                                                                                const RouteInputs& inputs,
+                                                                                const std::string& route_key) {
+  uint64_t now_ms = trpc::time::GetMilliSeconds();
+  if (!cluster.snapshot_cache.NeedSnapshot(route_key, now_ms)) {
+    return cluster.snapshot_cache.Get(route_key);
+  }
+
+  // The refresh is not made on behalf of the call, it is bounded by the configured timeout
+  polaris::GetInstancesRequest request(inputs.service_key);
+  FillInstancesRequest(inputs, request);
+  request.SetTimeout(timeout_);
+  polaris::InstancesResponse* response = nullptr;
+  polaris::ReturnCode ret = polaris::ReturnCode::kReturnServiceNotFound;
+  // The clusters are looked up apart, a service may be missing from some of them only
+  std::string lookup_key = cluster.name + "|" + GetServiceId(inputs.service_key);
+  naming::polarismesh::ServiceLookupGuard::Admission admission;
+  if (AdmitLookup(lookup_key, timeout_, admission)) {
+    ret = cluster.consumer_api->GetInstances(request, response);
+    CompleteLookup(lookup_key, admission, ret);
+  }
+  std::vector<TrpcEndpointInfo> endpoints;
+  std::vector<naming::polarismesh::EndpointLocation> locations;
+  if (ret == polaris::ReturnCode::kReturnOk) {
+    ConvertPolarisInstances(response->GetInstances(), endpoints);
+    ConvertInstanceLocations(response->GetInstances(), locations);
+  } else if (ret != polaris::ReturnCode::kReturnServiceNotFound) {
+    TRPC_FMT_WARN("Get instances of cluster {} failed, sdk returnCode:{}, service_name:{}, service_namespace:{}",
+                  cluster.name, static_cast<int32_t>(ret), inputs.service_key.name_, inputs.service_key.namespace_);
+    // Keep the last instances, the lookup is retried after the refresh interval
+    auto last = cluster.snapshot_cache.Get(route_key);
+    if (last) {
+      endpoints = last->endpoints;
+      locations = last->locations;
+    }
+  }
+  if (response != nullptr) {
+    delete response;
+  }
+  cluster.snapshot_cache.Update(route_key, std::move(endpoints), now_ms, 0, std::move(locations));
+  auto snapshot = cluster.snapshot_cache.Get(route_key);
+  // The calls to the instances measure the latency of the cluster
+  cluster_latency_tracker_.AddAddresses(*snapshot, cluster.name);
+  return snapshot;
+}
+
+int PolarisMeshSelector::SelectFederated(const SelectorInfo* info, const RouteInputs& inputs,
+                                         const std::string& route_key, std::vector<TrpcEndpointInfo>& endpoints,
+                                         bool need_meta) {
+  uint64_t now_ms = trpc::time::GetMilliSeconds();
+  // The health of the primary cluster is that of the whole routed subset, not of the zone picked for the call
+  RouteInputs primary_inputs = inputs;
+  primary_inputs.zone_aware = false;
+  std::vector<naming::polarismesh::RoutedSnapshotPtr> snapshots;
+  std::vector<std::string> names;
+  snapshots.reserve(federated_clusters_.size() + 1);
+  names.reserve(federated_clusters_.size());
+  for (auto& cluster : federated_clusters_) {
+    snapshots.push_back(GetFederatedSnapshot(*cluster, inputs, route_key));
+    names.push_back(cluster->name);
+  }
+
+  // The secondary clusters are tried nearest first
+  auto order = naming::polarismesh::RankClustersByLatency(names, cluster_latency_tracker_, now_ms);
+  std::vector<naming::polarismesh::RoutedSnapshotPtr> clusters;
+  clusters.reserve(snapshots.size() + 1);
+  clusters.push_back(GetRoutedSnapshot(primary_inputs, route_key));
+  for (size_t index : order) {
+    clusters.push_back(snapshots[index]);
+  }
+
+  auto plan = federation_plan_cache_.Get(route_key, clusters);
+  if (!plan) {
+    return -1;
+  }
+  // The calls with a hash key keep their cluster
+  const auto& hash_key = info->context->GetHashKey();
+  uint64_t random =
+      hash_key.empty() ? naming::polarismesh::FastRandom() : naming::polarismesh::HashString(hash_key);
+  size_t picked = plan->Pick(random);
+  if (picked == 0) {
+    return -1;
+  }
+
+  const auto& snapshot = plan->GetCluster(picked);
+  uint32_t num = 1;
+  if (info->policy == SelectorPolicy::MULTIPLE && info->select_num > 1) {
+    num = info->select_num;
+  }
+  if (naming::polarismesh::PickFromSnapshot(*snapshot, hash_key, num, endpoints) != 0) {
+    return -1;
+  }
+  if (!need_meta) {
+    for (auto& endpoint : endpoints) {
+      endpoint.meta.clear();
+    }
+  }
+  return 0;
+}
+
+int PolarisMeshSelector::SelectColocated(const SelectorInfo* info, const RouteInputs& inputs,
+                                         const std::string& route_key, std::vector<TrpcEndpointInfo>& endpoints,
+                                         bool need_meta) {
+  // The backups are spread over the other hosts as usual
+  if (info->policy == SelectorPolicy::MULTIPLE && info->select_num > 1) {
+    return -1;
+  }
+
+  // Looked up in the whole routed subset, not in the zone picked for the call
+  RouteInputs local_inputs = inputs;
+  local_inputs.zone_aware = false;
+  auto table = colocation_cache_.Get(route_key, GetRoutedSnapshot(local_inputs, route_key));
+  auto local = ExcludeTried(inputs, table ? table->Pick(naming::polarismesh::FastRandom()) : nullptr);
+  if (!local || naming::polarismesh::PickFromSnapshot(*local, "", 1, endpoints) != 0) {
+    return -1;
+  }
+  // All the local callees were tried, the retry goes to the other hosts
+  if (inputs.tried.count(naming::polarismesh::GetEndpointAddress(endpoints.back())) > 0) {
+    endpoints.pop_back();
+    return -1;
+  }
+
+  if (!need_meta) {
+    endpoints.back().meta.clear();
+  }
+  return 0;
+}
+
+bool PolarisMeshSelector::IsLocalRandom(const SelectorInfo* info) {
+  if (!enable_local_random_) {
+    return false;
+  }
+
+  return info->load_balance_name.empty() || info->load_balance_name == polaris::kLoadBalanceTypeDefaultConfig ||
+         info->load_balance_name == kLoadBalanceTypeWeightedRandom;
+}
+
+int PolarisMeshSelector::SelectByLocalRandom(const SelectorInfo* info, const RouteInputs& inputs,
+                                             const std::string& route_key, std::vector<TrpcEndpointInfo>& endpoints,
+                                             bool need_meta) {
+  auto snapshot = GetRoutedSnapshot(inputs, route_key);
+  if (!snapshot || snapshot->endpoints.size() < local_random_min_instances_) {
+    return -1;
+  }
+  auto table = alias_table_cache_.Get(route_key, snapshot);
+  if (!table) {
+    return -1;
+  }
+
+  const auto& snapshot_endpoints = snapshot->endpoints;
+  if (info->policy == SelectorPolicy::MULTIPLE && info->select_num > 1) {
+    std::vector<uint32_t> indexes;
+    naming::polarismesh::PickDistinct(*table, info->select_num, indexes);
+    endpoints.reserve(endpoints.size() + indexes.size());
+    for (auto index : indexes) {
+      endpoints.push_back(snapshot_endpoints[index]);
+      if (!need_meta) {
+        endpoints.back().meta.clear();
+      }
+    }
+    return 0;
+  }
+
+  uint32_t index = table->Pick();
+  if (inputs.tried.count(naming::polarismesh::GetEndpointAddress(snapshot_endpoints[index])) > 0) {
+    // The retry picks again among the endpoints not tried, without the table of the whole subset
+    auto left = ExcludeTried(inputs, snapshot);
+    if (naming::polarismesh::PickFromSnapshot(*left, "", 1, endpoints) == 0) {
+      if (!need_meta) {
+        endpoints.back().meta.clear();
+      }
+      return 0;
+    }
+  }
+  endpoints.push_back(snapshot_endpoints[index]);
+  if (!need_meta) {
+    endpoints.back().meta.clear();
+  }
+  return 0;
+}
+
+uint64_t PolarisMeshSelector::GetSnapshotStalenessMs(const SelectorInfo* info) {
+  polaris::ServiceKey service_key{GetNamespaceFromContextOrExtend(info->context, info->extend_select_info), info->name};
+  RouteInputs inputs;
+  BuildRouteInputs(info, service_key, inputs);
+  return snapshot_cache_.GetStalenessMs(BuildRouteKey(inputs), trpc::time::GetMilliSeconds());
+}
+
 // Obtain the specific implementation of the service node
 // from the SDK API interface to select a single node or backup node
-int PolarisMeshSelector::SelectImpl(const SelectorInfo* info, polaris::InstancesResponse*& polarismesh_response_info) {
-  // The main system of service key
-  polaris::ServiceInfo source_service_info;
-  GetSourceServiceKey(info->context, info->extend_select_info, source_service_info.service_key_);
+int PolarisMeshSelector::SelectImpl(const SelectorInfo* info, std::vector<TrpcEndpointInfo>& endpoints,
+                                    bool need_meta) {
   // The adjusted service key
-  std::string service_namespace = source_service_info.service_key_.namespace_;
   polaris::ServiceKey service_key{GetNamespaceFromContextOrExtend(info->context, info->extend_select_info), info->name};
+  RouteInputs inputs;
+  BuildRouteInputs(info, service_key, inputs);
+  if (enable_set_circuitbreaker_) {
+    FallbackFromOpenSet(inputs);
+  }
+
+  // Calls with a hash key keep their endpoint whatever the zone of the caller
+  auto& hash_key = info->context->GetHashKey();
+  inputs.zone_aware = enable_zone_aware_ && hash_key.empty();
+  if (enable_method_breaker_) {
+    inputs.method = info->context->GetFuncName();
+  }
+  // A single selection avoids the endpoints already tried by the call, the backups are distinct from each other
+  if (enable_retry_aware_ && !(info->policy == SelectorPolicy::MULTIPLE && info->select_num > 1)) {
+    SplitAddresses(naming::polarismesh::GetSelectorExtendInfo(info->context, kTriedEndpointsKey), inputs.tried);
+    SplitAddresses(GetValueFromContextOrExtend(info->context, info->extend_select_info, kExcludedEndpointsKey),
+                   inputs.tried);
+  }
+
+  std::string route_key;
+  if (enable_fail_static_ || enable_local_hash_ || enable_local_random_ || enable_route_cache_ ||
+      enable_local_nearby_ || enable_zone_aware_ || enable_colocation_ || enable_federation_ ||
+      enable_latency_outlier_ || enable_method_breaker_ || enable_set_circuitbreaker_ || enable_fail_fast_ ||
+      enable_retry_aware_) {
+    route_key = BuildRouteKey(inputs);
+  }
+
+  // A callee whose endpoints are mostly broken fails the calls at once instead of stacking their timeouts, the calls
+  // let through probe whether it recovered
+  if (enable_fail_fast_ && IsFailingFast(inputs, route_key)) {
+    TRPC_FMT_DEBUG("Fail fast, most instances are broken, service_name:{}, service_namespace:{}", service_key.name_,
+                   service_key.namespace_);
+    return -1;
+  }
+
+  // In fail-static mode, a degraded key is served from the snapshot without waiting for the SDK
+  if (enable_fail_static_) {
+    auto snapshot =
+        ApplyLocalNearby(route_key, snapshot_cache_.GetIfDegraded(route_key, trpc::time::GetMilliSeconds()));
+    if (snapshot) {
+      return SelectFromSnapshot(info, inputs, route_key, snapshot, endpoints);
+    }
+  }
+
+  // The calls the primary cluster can not take with its healthy instances spill over to the secondary clusters
+  if (enable_federation_ && SelectFederated(info, inputs, route_key, endpoints, need_meta) == 0) {
+    return 0;
+  }
+
+  // The callees on the local host are preferred, except for the calls with a hash key which keep their endpoints
+  if (enable_colocation_ && hash_key.empty() &&
+      SelectColocated(info, inputs, route_key, endpoints, need_meta) == 0) {
+    return 0;
+  }
+
+  // Calls with a hash key are balanced by the plugin, the SDK is used only when it fails
+  naming::polarismesh::ConsistentHashType hash_type;
+  if (!hash_key.empty() && GetLocalHashType(info, hash_type) &&
+      SelectByLocalHash(info, inputs, route_key, hash_type, endpoints, need_meta) == 0) {
+    return 0;
+  }
+
+  // Weighted random calls of the large services are balanced by the plugin in constant time
+  if (hash_key.empty() && IsLocalRandom(info) &&
+      SelectByLocalRandom(info, inputs, route_key, endpoints, need_meta) == 0) {
+    return 0;
+  }
+
+  // The SDK does not route by locality when the plugin does, the other calls are served from the nearby subset or
+  // from the zone picked for the call
+  if (enable_local_nearby_ || inputs.zone_aware) {
+    auto snapshot = ExcludeTried(inputs, GetRoutedSnapshot(inputs, route_key));
+    uint32_t num = 1;
+    if (info->policy == SelectorPolicy::MULTIPLE && info->select_num > 1) {
+      num = info->select_num;
+    }
+    if (snapshot && naming::polarismesh::PickFromSnapshot(*snapshot, hash_key, num, endpoints) == 0) {
+      if (!need_meta) {
+        for (auto& endpoint : endpoints) {
+          endpoint.meta.clear();
+        }
+      }
+      return 0;
+    }
+  }
+
+  // A refresh which failed during the selection already waited for the SDK, the call is served from the degraded
+  // snapshot or fails instead of waiting for the SDK once more
+  if (inputs.lookup_failed) {
+    return SelectAfterFailedLookup(info, inputs, route_key, endpoints);
+  }
+
   polaris::GetOneInstanceRequest request(service_key);
 
   // For the polarismesh, the load balancing plugin name and load balancing strategy are an option
@@ -128,36 +1528,34 @@ int PolarisMeshSelector::SelectImpl(const SelectorInfo* info, polaris::Instances
     request.SetLoadBalanceType(info->load_balance_name);
   }
   // Check HASH
-  auto& hash_key = info->context->GetHashKey();
   if (!hash_key.empty()) {
     request.SetHashString(hash_key);
     // Set up a copy indexy
     uint64_t replicate_index = trpc::util::Convert<uint64_t, std::string>(
         GetValueFromContextOrExtend(info->context, info->extend_select_info, "replicate_index"));
     request.SetReplicateIndex(replicate_index);
-    // polarismesh bug, use SethashKey in the early stages
+    // polarismesh bug, use SethashKey in the early stages. With the local hashing, a key which is not a number is
+    // hashed, otherwise all of them would be converted to 0. It is left as is without it, the SDK keeps the endpoints
+    // the keys were mapped to before
     uint64_t u64_hash_key = trpc::util::Convert<uint64_t, std::string>(hash_key);
+    if (enable_local_hash_ && u64_hash_key == 0 && hash_key != "0") {
+      u64_hash_key = naming::polarismesh::HashString(hash_key);
+    }
     request.SetHashKey(u64_hash_key);
   }
 
-  // Set the main service information
-  FillMetadataOfSourceServiceInfo(info, source_service_info);
-
   // Set Canary Information
-  auto cannary = GetValueFromContextOrExtend(info->context, info->extend_select_info, "canary_label");
-  if (!cannary.empty()) {
-    request.SetCanary(cannary);
+  if (!inputs.canary.empty()) {
+    request.SetCanary(inputs.canary);
   }
 
-  request.SetSourceService(source_service_info);
-  // Set timeout time
-  request.SetTimeout(timeout_);
+  request.SetSourceService(inputs.source_service_info);
+  // Set timeout time, bounded by the remaining deadline of the call
+  request.SetTimeout(inputs.timeout);
 
   // Fill in metadata
-  auto meta =
-      naming::polarismesh::GetFilterMetadataOfNaming(info->context, PolarisMetadataType::kPolarisDstMetaRouteLable);
-  if (meta != nullptr) {
-    request.SetMetadata(*(meta.get()));
+  if (!inputs.dst_metadata.empty()) {
+    request.SetMetadata(inputs.dst_metadata);
   }
 
   // If it is a backup strategy, you need to set the number of Backup nodes
@@ -167,12 +1565,64 @@ int PolarisMeshSelector::SelectImpl(const SelectorInfo* info, polaris::Instances
   }
 
   // When selecting a routing, do not consider whether to include a health or melting node
+  std::string service_id = GetServiceId(service_key);
+  naming::polarismesh::ServiceLookupGuard::Admission admission;
+  if (!AdmitLookup(service_id, inputs.timeout, admission)) {
+    return -1;
+  }
+
+  polaris::InstancesResponse* polarismesh_response_info = nullptr;
   polaris::ReturnCode ret = consumer_api_->GetOneInstance(request, polarismesh_response_info);
+  CompleteLookup(service_id, admission, ret);
   if (ret != polaris::ReturnCode::kReturnOk) {
     TRPC_FMT_ERROR("GetOneInstance failed, sdk returnCode:{}, service_name:{}, service_namespace:{}",
                    static_cast<int32_t>(ret), service_key.name_, service_key.namespace_);
+    if (polarismesh_response_info != nullptr) {
+      delete polarismesh_response_info;
+    }
+    // A service which does not exist is an answer of the control plane, not an outage of it
+    if (enable_fail_static_ && ret != polaris::ReturnCode::kReturnServiceNotFound) {
+      auto snapshot = ApplyLocalNearby(route_key, snapshot_cache_.OnFailure(route_key, trpc::time::GetMilliSeconds(),
+                                                                            MakeRefresher(inputs, route_key)));
+      if (snapshot) {
+        return SelectFromSnapshot(info, inputs, route_key, snapshot, endpoints);
+      }
+    }
     return -1;
   }
+
+  std::vector<polaris::Instance>& instances = polarismesh_response_info->GetInstances();
+  endpoints.reserve(instances.size());
+  for (const auto& instance : instances) {
+    TrpcEndpointInfo endpoint;
+    ConvertPolarisInstance(instance, endpoint, need_meta);
+    endpoints.emplace_back(std::move(endpoint));
+  }
+  delete polarismesh_response_info;
+
+  // The SDK knows neither the endpoints ejected for their latency, the breakers of the plugin nor the endpoints tried
+  // by the call, a call it balanced on an excluded endpoint is picked again from the routed subset without them
+  if ((enable_latency_outlier_ || enable_method_breaker_ || enable_set_circuitbreaker_ || !inputs.tried.empty()) &&
+      !endpoints.empty() && IsExcludedEndpoint(inputs, endpoints[0])) {
+    auto snapshot = ExcludeTried(inputs, GetRoutedSnapshot(inputs, route_key));
+    std::vector<TrpcEndpointInfo> picked;
+    if (snapshot && naming::polarismesh::PickFromSnapshot(*snapshot, hash_key, endpoints.size(), picked) == 0) {
+      if (!need_meta) {
+        for (auto& endpoint : picked) {
+          endpoint.meta.clear();
+        }
+      }
+      endpoints.swap(picked);
+    }
+  }
+
+  // Keep the routed snapshot fresh while the SDK is healthy, it is served when the SDK becomes unavailable. The
+  // refresh is left to the background thread, the call only performs it when there is none
+  uint64_t now_ms = trpc::time::GetMilliSeconds();
+  if (enable_fail_static_ && snapshot_cache_.NeedSnapshot(route_key, now_ms) &&
+      !snapshot_cache_.ScheduleRefresh(route_key, now_ms, MakeRefresher(inputs, route_key))) {
+    RefreshRoutedSnapshot(inputs, route_key);
+  }
   return 0;
 }
 
@@ -183,22 +1633,53 @@ int PolarisMeshSelector::Select(const SelectorInfo* info, TrpcEndpointInfo* endp
     return -1;
   }
 
-  polaris::InstancesResponse* polarismesh_response_info;
-  int ret = SelectImpl(info, polarismesh_response_info);
+  // A retry spends the budget of the callee, which its successful calls fill
+  if (enable_retry_budget_ && !naming::polarismesh::GetSelectorExtendInfo(info->context, kAttemptedKey).empty()) {
+    std::string callee = GetCalleeKey(info->context, info->extend_select_info, info->name);
+    if (!retry_budget_.TryRetry(callee, trpc::time::GetMilliSeconds())) {
+      TRPC_FMT_DEBUG("Retry refused, the retry budget is used up, service:{}", callee);
+      return -1;
+    }
+  }
+
+  // From the workflow of the framework, the entire MetAdata of Instance is not needed
+  std::vector<TrpcEndpointInfo> endpoints;
+  bool need_meta = !info->is_from_workflow;
+  // The set of the selected endpoint is read from its metadata, the result of the call is counted in that set
+  int ret = SelectImpl(info, endpoints, need_meta || enable_set_circuitbreaker_);
   if (ret != 0) {
     return -1;
   }
 
-  std::vector<polaris::Instance>& instances = polarismesh_response_info->GetInstances();
-
-  TRPC_ASSERT(instances.size() == 1 && "select result should return only one instance");
-  if (info->is_from_workflow) {
-    // From the workflow of the framework, the entire MetAdata of Instance
-    ConvertPolarisInstance(instances[0], *endpoint, false);
-    // SetInstanceId(polarismesh_response_info.GetId());
-  } else {
-    ConvertPolarisInstance(instances[0], *endpoint, true);
+  TRPC_ASSERT(endpoints.size() == 1 && "select result should return only one instance");
+  if (enable_retry_budget_) {
+    MarkCallData(info->context, kAttemptedKey, "1");
+  }
+  if (enable_retry_aware_) {
+    MarkTriedEndpoint(info->context, naming::polarismesh::GetEndpointAddress(endpoints[0]), max_tried_endpoints_);
   }
+  // A half-open breaker lets a bounded number of probes through, the selected endpoint takes one of them
+  if (enable_method_breaker_ || enable_set_circuitbreaker_) {
+    std::string callee = GetCalleeKey(info->context, info->extend_select_info, info->name);
+    uint64_t now_ms = trpc::time::GetMilliSeconds();
+    if (enable_method_breaker_) {
+      method_breaker_.Acquire(callee, info->context->GetFuncName(),
+                              naming::polarismesh::GetEndpointAddress(endpoints[0]), now_ms);
+    }
+    if (enable_set_circuitbreaker_) {
+      std::string set_name = naming::polarismesh::GetEndpointSetName(endpoints[0].meta);
+      if (!set_name.empty()) {
+        set_breaker_.Acquire(callee, set_name, now_ms);
+      }
+    }
+  }
+  if (enable_set_circuitbreaker_) {
+    MarkCallData(info->context, kSelectedSetKey, naming::polarismesh::GetEndpointSetName(endpoints[0].meta));
+    if (!need_meta) {
+      endpoints[0].meta.clear();
+    }
+  }
+  *endpoint = std::move(endpoints[0]);
   TRPC_FMT_DEBUG("Select result {}:{}, id:{}, service_name:{}, service_namespace:{}", endpoint->host, endpoint->port,
                  endpoint->id, info->name,
                  GetValueFromContextOrExtend(info->context, info->extend_select_info, "namespace"));
@@ -226,22 +1707,18 @@ int PolarisMeshSelector::SelectBatch(const SelectorInfo* info, std::vector<TrpcE
     return -1;
   }
 
-  polaris::InstancesResponse* discovery_rsp = nullptr;
-
   if (info->policy == SelectorPolicy::MULTIPLE) {
-    polaris::InstancesResponse* polarismesh_response_info;
     // Backup strategy (compatible with old version logic)
-    int ret = SelectImpl(info, polarismesh_response_info);
+    int ret = SelectImpl(info, *endpoints, true);
     if (ret != 0) {
       return -1;
     }
 
-    std::vector<polaris::Instance> instances = polarismesh_response_info->GetInstances();
-    ConvertPolarisInstances(instances, *endpoints);
-
     return 0;
   }
 
+  polaris::InstancesResponse* discovery_rsp = nullptr;
+
   // The main system of service key
   polaris::ServiceKey source_service_key;
   GetSourceServiceKey(info->context, info->extend_select_info, source_service_key);
@@ -250,13 +1727,22 @@ int PolarisMeshSelector::SelectBatch(const SelectorInfo* info, std::vector<TrpcE
   polaris::ServiceKey service_key{service_namespace, info->name};
 
   polaris::GetInstancesRequest discovery_req = polaris::GetInstancesRequest(service_key);
-  discovery_req.SetTimeout(timeout_);
+  uint64_t lookup_timeout = GetLookupTimeout(info->context);
+  discovery_req.SetTimeout(lookup_timeout);
 
+  std::string service_id = GetServiceId(service_key);
+  naming::polarismesh::ServiceLookupGuard::Admission admission;
+  std::string route_key;
   if (info->policy == SelectorPolicy::ALL) {
+    if (!AdmitLookup(service_id, lookup_timeout, admission)) {
+      return -1;
+    }
+
     // All nodes returned from the SDK interface are consistent with the polarismesh Console, including nodes with a
     // weight of 0 or isolation In the following code, it will remove nodes with isolation or 0 weights (compatible with
     // old version logic)
     polaris::ReturnCode ret = consumer_api_->GetAllInstances(discovery_req, discovery_rsp);
+    CompleteLookup(service_id, admission, ret);
     if (ret != polaris::ReturnCode::kReturnOk) {
       TRPC_FMT_ERROR("GetAllInstances failed, sdk returnCode:{}, service_name:{}, service_namespace:{}",
                      static_cast<int32_t>(ret), service_key.name_, service_key.namespace_);
@@ -267,37 +1753,67 @@ int PolarisMeshSelector::SelectBatch(const SelectorInfo* info, std::vector<TrpcE
     }
   } else {
     // Routing selection
-    // Setting whether to include unhealthy or fuse nodes
-    if (GetValueFromContextOrExtend(info->context, info->extend_select_info, "include_unhealthy") == "true") {
-      discovery_req.SetIncludeUnhealthyInstances(true);
-      discovery_req.SetIncludeCircuitBreakInstances(true);
+    RouteInputs inputs;
+    BuildRouteInputs(info, service_key, inputs);
+    if (enable_fail_static_ || enable_route_cache_ || enable_local_nearby_) {
+      route_key = BuildRouteKey(inputs);
     }
-
-    // Set the main service information
-    polaris::ServiceInfo source_service_info;
-    source_service_info.service_key_ = source_service_key;
-    FillMetadataOfSourceServiceInfo(info, source_service_info);
-    // Set Canary Information
-    auto cannary = GetValueFromContextOrExtend(info->context, info->extend_select_info, "canary_label");
-    if (!cannary.empty()) {
-      discovery_req.SetCanary(cannary);
+    if (enable_fail_static_) {
+      auto snapshot =
+          ApplyLocalNearby(route_key, snapshot_cache_.GetIfDegraded(route_key, trpc::time::GetMilliSeconds()));
+      if (snapshot) {
+        *endpoints = snapshot->endpoints;
+        ReportPluginMetric(metrics_name_, "polarismesh_snapshot_staleness_ms", info->name,
+                           trpc::time::GetMilliSeconds() - snapshot->update_time_ms);
+        return 0;
+      }
+    }
+    // The routed subset is memoized until the data of the SDK changes, or routed by locality by the plugin
+    if (enable_route_cache_ || enable_local_nearby_) {
+      auto snapshot = GetRoutedSnapshot(inputs, route_key);
+      if (snapshot) {
+        *endpoints = snapshot->endpoints;
+        return 0;
+      }
     }
-    discovery_req.SetSourceService(source_service_info);
+    // A refresh which failed during the selection already waited for the SDK
+    if (inputs.lookup_failed) {
+      naming::polarismesh::RoutedSnapshotPtr snapshot;
+      if (enable_fail_static_) {
+        snapshot = ApplyLocalNearby(route_key, snapshot_cache_.GetIfDegraded(route_key, trpc::time::GetMilliSeconds()));
+      }
+      if (!snapshot) {
+        return -1;
+      }
+      *endpoints = snapshot->endpoints;
+      ReportPluginMetric(metrics_name_, "polarismesh_snapshot_staleness_ms", info->name,
+                         trpc::time::GetMilliSeconds() - snapshot->update_time_ms);
+      return 0;
+    }
+    FillInstancesRequest(inputs, discovery_req);
 
-    // Fill in metadata
-    auto meta =
-        naming::polarismesh::GetFilterMetadataOfNaming(info->context, PolarisMetadataType::kPolarisDstMetaRouteLable);
-    if (meta) {
-      discovery_req.SetMetadata(*(meta.get()));
+    if (!AdmitLookup(service_id, inputs.timeout, admission)) {
+      return -1;
     }
 
     polaris::ReturnCode ret = consumer_api_->GetInstances(discovery_req, discovery_rsp);
+    CompleteLookup(service_id, admission, ret);
     if (ret != polaris::ReturnCode::kReturnOk) {
       TRPC_FMT_ERROR("GetInstances failed, sdk returnCode:{}, service_name:{}, service_namespace:{}",
                      static_cast<int32_t>(ret), service_key.name_, service_key.namespace_);
       if (discovery_rsp != nullptr) {
         delete discovery_rsp;
       }
+      if (enable_fail_static_ && ret != polaris::ReturnCode::kReturnServiceNotFound) {
+        auto snapshot = ApplyLocalNearby(route_key, snapshot_cache_.OnFailure(route_key, trpc::time::GetMilliSeconds(),
+                                                                              MakeRefresher(inputs, route_key)));
+        if (snapshot) {
+          *endpoints = snapshot->endpoints;
+          ReportPluginMetric(metrics_name_, "polarismesh_snapshot_staleness_ms", info->name,
+                             trpc::time::GetMilliSeconds() - snapshot->update_time_ms);
+          return 0;
+        }
+      }
       return -1;
     }
   }
@@ -311,6 +1827,19 @@ int PolarisMeshSelector::SelectBatch(const SelectorInfo* info, std::vector<TrpcE
     ConvertInstancesNoIsolated(instances, *endpoints);
   } else {
     ConvertPolarisInstances(instances, *endpoints);
+    // The routed result is exactly the snapshot of the key
+    uint64_t now_ms = trpc::time::GetMilliSeconds();
+    if ((enable_fail_static_ || enable_local_nearby_) && snapshot_cache_.NeedSnapshot(route_key, now_ms)) {
+      std::vector<naming::polarismesh::EndpointLocation> locations;
+      ConvertInstanceLocations(instances, locations);
+      snapshot_cache_.Update(route_key, std::vector<TrpcEndpointInfo>(*endpoints), now_ms, 0, std::move(locations));
+    }
+    if (enable_local_nearby_) {
+      auto snapshot = ApplyLocalNearby(route_key, snapshot_cache_.Get(route_key));
+      if (snapshot) {
+        *endpoints = snapshot->endpoints;
+      }
+    }
   }
 
   delete discovery_rsp;
@@ -335,17 +1864,74 @@ int PolarisMeshSelector::ReportInvokeResult(const InvokeResult* result) {
     return -1;
   }
 
+  std::string inflight_service, inflight_address;
+  uint64_t inflight_generation = 0;
+  if (TakeInflightMark(result->context, inflight_service, inflight_address, inflight_generation)) {
+    inflight_tracker_.End(inflight_service, inflight_address, inflight_generation);
+  }
+
+  if (enable_federation_) {
+    cluster_latency_tracker_.Record(result->context->GetIp() + ":" + std::to_string(result->context->GetPort()),
+                                    result->cost_time, trpc::time::GetMilliSeconds());
+  }
+  if (enable_latency_locality_) {
+    locality_latency_tracker_.Record(result->context->GetIp() + ":" + std::to_string(result->context->GetPort()),
+                                     result->cost_time, trpc::time::GetMilliSeconds());
+  }
+
   polaris::ServiceCallResult result_req;
   polaris::ServiceKey source_service_key;
   GetSourceServiceKey(result->context, nullptr, source_service_key);
 
+  // Counted under the namespace of the callee, which the selection reads, not the env namespace of the caller
+  std::string callee = GetCalleeKey(result->context, nullptr, result->name);
+  std::string address = result->context->GetIp() + ":" + std::to_string(result->context->GetPort());
+  polaris::CallRetStatus ret_status = FrameworkRetToPolarisRet(circuitbreak_whitelist_, result->framework_result);
+  bool success = ret_status == polaris::CallRetStatus::kCallRetOk;
+  if (enable_latency_outlier_) {
+    latency_outlier_detector_.Record(callee, address, result->cost_time, trpc::time::GetMilliSeconds());
+  }
+  if (enable_fail_fast_) {
+    fail_fast_.Report(callee, address, success, trpc::time::GetMilliSeconds());
+  }
+  if (enable_retry_budget_) {
+    retry_budget_.Report(callee, address, success, trpc::time::GetMilliSeconds());
+  }
+  if (enable_method_breaker_) {
+    method_breaker_.Report(callee, result->context->GetFuncName(), address, success, trpc::time::GetMilliSeconds());
+  }
+  std::string set_name;
+  if (enable_set_circuitbreaker_ && TakeCallData(result->context, kSelectedSetKey, set_name) && !set_name.empty()) {
+    set_breaker_.Report(callee, set_name, success, result->cost_time, trpc::time::GetMilliSeconds());
+  }
+  if (enable_adaptive_timeout_) {
+    std::string method = callee + "|" + result->context->GetFuncName();
+    bool timed_out = result->framework_result == TrpcRetCode::TRPC_CLIENT_INVOKE_TIMEOUT_ERR;
+    // The calls failed for other reasons than their timeout say nothing about the latency
+    if (success || timed_out) {
+      adaptive_timeout_.Record(method, result->cost_time, trpc::time::GetMilliSeconds());
+    }
+    std::string static_timeout, adaptive_timeout;
+    if (TakeCallData(result->context, kStaticTimeoutKey, static_timeout) &&
+        TakeCallData(result->context, kAdaptiveTimeoutKey, adaptive_timeout)) {
+      ReportTimeoutOutcome(method, trpc::util::Convert<uint64_t, std::string>(static_timeout),
+                           trpc::util::Convert<uint64_t, std::string>(adaptive_timeout), result->cost_time, timed_out);
+    }
+  }
+  std::string hedge_delay;
+  if (enable_hedging_) {
+    TakeCallData(result->context, kHedgeDelayKey, hedge_delay);
+    hedging_policy_.Record(callee, result->cost_time, trpc::util::Convert<uint64_t, std::string>(hedge_delay),
+                           trpc::time::GetMilliSeconds());
+  }
+
   result_req.SetSource(source_service_key);
   result_req.SetServiceName(result->name);
   result_req.SetServiceNamespace(source_service_key.namespace_);
   result_req.SetInstanceHostAndPort(result->context->GetIp(), result->context->GetPort());
 
   // Set RetStatus (frame error code)
-  result_req.SetRetStatus(FrameworkRetToPolarisRet(circuitbreak_whitelist_, result->framework_result));
+  result_req.SetRetStatus(ret_status);
   // Call_ret_code is a customized return value for users, for statistical reporting
   result_req.SetRetCode(result->interface_result);
   result_req.SetDelay(result->cost_time);
@@ -361,6 +1947,14 @@ int PolarisMeshSelector::ReportInvokeResult(const InvokeResult* result) {
   if (circuit_breaker_lables) {
     result_req.SetLabels(*(circuit_breaker_lables.get()));
   }
+  // The subset of the call is reported for the set circuit breaking of the SDK
+  if (enable_set_circuitbreaker_) {
+    auto subset =
+        naming::polarismesh::GetFilterMetadataOfNaming(result->context, PolarisMetadataType::kPolarisSubsetLabel);
+    if (subset) {
+      result_req.SetSubset(*subset);
+    }
+  }
 
   int ret = consumer_api_->UpdateServiceCallResult(result_req);
   if (ret != polaris::ReturnCode::kReturnOk) {
@@ -372,6 +1966,69 @@ int PolarisMeshSelector::ReportInvokeResult(const InvokeResult* result) {
   return 0;
 }
 
+void PolarisMeshSelector::ApplyAdaptiveTimeout(const ClientContextPtr& context) {
+  if (!init_ || !enable_adaptive_timeout_ || context->GetServiceProxyOption() == nullptr) {
+    return;
+  }
+
+  std::string method =
+      GetCalleeKey(context, nullptr, context->GetServiceProxyOption()->target) + "|" + context->GetFuncName();
+  uint64_t timeout_ms = adaptive_timeout_.GetTimeout(method, trpc::time::GetMilliSeconds());
+  timeout_ms = std::min<uint64_t>(timeout_ms, std::numeric_limits<uint32_t>::max());
+  MarkCallData(context, kStaticTimeoutKey, std::to_string(context->GetTimeout()));
+  MarkCallData(context, kAdaptiveTimeoutKey, std::to_string(timeout_ms));
+  if (apply_adaptive_timeout_ && timeout_ms > 0) {
+    // Shortens the timeout set by the caller, never raises it
+    context->SetTimeout(static_cast<uint32_t>(
+        naming::polarismesh::AdaptiveTimeout::LimitTimeout(context->GetTimeout(), timeout_ms,
+                                                           GetRemainingTimeoutMs(context))));
+  }
+}
+
+void PolarisMeshSelector::ReportTimeoutOutcome(const std::string& method, uint64_t static_timeout_ms,
+                                               uint64_t adaptive_timeout_ms, uint64_t cost_ms, bool timed_out) {
+  if (metrics_name_.empty()) {
+    return;
+  }
+
+  // The calls are counted under the timeout they ran with
+  bool applied = apply_adaptive_timeout_ && adaptive_timeout_ms > 0;
+  const char* prefix = applied ? "polarismesh_adaptive_timeout_" : "polarismesh_static_timeout_";
+  ReportPluginCounter(metrics_name_, std::string(prefix) + "calls", method);
+  if (timed_out) {
+    ReportPluginCounter(metrics_name_, std::string(prefix) + "timeouts", method);
+  }
+  if (adaptive_timeout_ms == 0) {
+    return;
+  }
+
+  ReportPluginMetric(metrics_name_, "polarismesh_adaptive_timeout_ms", method, adaptive_timeout_ms);
+  if (!applied) {
+    // A call run with the static timeout which outlasted the recommended one would have timed out under it
+    if (cost_ms >= adaptive_timeout_ms) {
+      ReportPluginCounter(metrics_name_, "polarismesh_adaptive_timeout_shadow_timeouts", method);
+    }
+  } else if (timed_out && static_timeout_ms > adaptive_timeout_ms) {
+    // Time the timed out call would have waited longer under the static timeout
+    ReportPluginCounter(metrics_name_, "polarismesh_adaptive_timeout_saved_ms", method,
+                        static_timeout_ms - adaptive_timeout_ms);
+  }
+}
+
+uint32_t PolarisMeshSelector::GetHedgeDelay(const ClientContextPtr& context) {
+  if (!init_ || !enable_hedging_ || context->GetServiceProxyOption() == nullptr) {
+    return 0;
+  }
+
+  uint64_t delay_ms = hedging_policy_.GetHedgeDelay(
+      GetCalleeKey(context, nullptr, context->GetServiceProxyOption()->target), trpc::time::GetMilliSeconds());
+  delay_ms = std::min<uint64_t>(delay_ms, std::numeric_limits<uint32_t>::max());
+  if (delay_ms > 0) {
+    MarkCallData(context, kHedgeDelayKey, std::to_string(delay_ms));
+  }
+  return static_cast<uint32_t>(delay_ms);
+}
+
 bool PolarisMeshSelector::SetCircuitBreakWhiteList(const std::vector<int>& framework_retcodes) {
   auto& writer = circuitbreak_whitelist_.Writer();
   writer.clear();
@@ -462,6 +2119,11 @@ std::string PolarisMeshSelector::GetValueFromContextOrExtend(const ClientContext
   return value;
 }
 
+std::string PolarisMeshSelector::GetCalleeKey(const ClientContextPtr& context, const std::any* extend_select_info,
+                                              const std::string& name) {
+  return GetServiceId(polaris::ServiceKey{GetNamespaceFromContextOrExtend(context, extend_select_info), name});
+}
+
 std::string PolarisMeshSelector::GetNamespaceFromContextOrExtend(const ClientContextPtr& context,
                                                                  const std::any* extend_select_info) {
   std::string value = naming::polarismesh::GetSelectorExtendInfo(context, "namespace");
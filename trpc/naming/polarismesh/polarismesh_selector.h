@@ -14,9 +14,15 @@
 #pragma once
 
 #include <any>
+#include <atomic>
+#include <condition_variable>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "polaris/api/consumer_api.h"
@@ -27,8 +33,26 @@
 #include "rapidjson/writer.h"
 
 #include "trpc/naming/common/common_defs.h"
+#include "trpc/naming/polarismesh/adaptive_timeout.h"
+#include "trpc/naming/polarismesh/colocation.h"
 #include "trpc/naming/polarismesh/common.h"
+#include "trpc/naming/polarismesh/consistent_hash.h"
+#include "trpc/naming/polarismesh/federation.h"
+#include "trpc/naming/polarismesh/hedging_policy.h"
+#include "trpc/naming/polarismesh/inflight_tracker.h"
+#include "trpc/naming/polarismesh/latency_outlier.h"
+#include "trpc/naming/polarismesh/locality_tiers.h"
+#include "trpc/naming/polarismesh/metadata_index.h"
+#include "trpc/naming/polarismesh/method_circuit_breaker.h"
 #include "trpc/naming/polarismesh/readers_writer_data.h"
+#include "trpc/naming/polarismesh/retry_budget.h"
+#include "trpc/naming/polarismesh/service_fail_fast.h"
+#include "trpc/naming/polarismesh/service_lookup_guard.h"
+#include "trpc/naming/polarismesh/set_circuit_breaker.h"
+#include "trpc/naming/polarismesh/slow_start.h"
+#include "trpc/naming/polarismesh/snapshot_cache.h"
+#include "trpc/naming/polarismesh/weighted_random.h"
+#include "trpc/naming/polarismesh/zone_aware.h"
 #include "trpc/naming/selector.h"
 
 namespace trpc {
@@ -51,6 +75,7 @@ uint32_t GetPolarisMeshSelectorPluginID();
 /// - replicate_index (uint32_t)
 /// - metadata (std::map<std::string, std::string>)
 /// - include_unhealthy (boolean)
+/// - excluded_endpoints (endpoints the call avoids, "host:port" separated by ",")
 /// @param context Client/Server context to store the filter data, can be either serverContext or clientContext.
 /// @param key_value_pairs A variadic list of key-value pairs to set in the context's filter data.
 template <typename T, typename... Args>
@@ -78,6 +103,7 @@ void SetSelectorExtendInfo(T& context, Args&&... key_value_pairs) {
 /// - replicate_index (uint32_t)
 /// - metadata (std::map<std::string, std::string>)
 /// - include_unhealthy (boolean)
+/// - excluded_endpoints (endpoints the call avoids, "host:port" separated by ",")
 /// @param context Client/Server context to retrieve the filter data from, can be either serverContext or clientContext.
 /// @param key The key of the property to retrieve.
 /// @return The value of the specified property if found, or an empty string if not found.
@@ -176,11 +202,12 @@ class PolarisMeshSelector : public Selector {
 
   /// @brief In the internal implementation of the plugin, it needs to be used when the thread needs to be created.
   /// You can use this interface uniformly
-  void Start() noexcept override {}
+  /// @note The snapshot refresh thread of the fail-static mode is created here
+  void Start() noexcept override;
 
   /// @brief When there is a thread in the internal implementation of the plugin, the interface of the stop thread
   /// needs to be implemented
-  void Stop() noexcept override {}
+  void Stop() noexcept override;
 
   /// @brief Various resources to destroy specific plugin
   void Destroy() noexcept override;
@@ -191,7 +218,9 @@ class PolarisMeshSelector : public Selector {
   /// @brief Asynchronous acquisition of a adjustable node interface
   Future<TrpcEndpointInfo> AsyncSelect(const SelectorInfo* info) override;
 
-  /// @brief Obtain the interface of node routing information according to strategy
+  /// @brief Obtain the interface of node routing information according to strategy.
+  ///        With the MULTIPLE policy and a hash key balanced by the local consistent hashing, the result is select_num
+  ///        distinct replicas of the key in ring order from one routing pass, starting from the replicate index
   int SelectBatch(const SelectorInfo* info, std::vector<TrpcEndpointInfo>* endpoints) override;
 
   /// @brief Asynchronously obtain the interface of node routing information according to strategy
@@ -215,9 +244,187 @@ class PolarisMeshSelector : public Selector {
   void GetSourceServiceKey(const ClientContextPtr& client_context_ptr, const std::any* extend_select_info,
                            polaris::ServiceKey& service_key);
 
+  /// @brief Key of the callee of a call in the statistics of the plugin, "namespace|name". The namespace is the one of
+  ///        the callee, the same for the selection and for the report of the result, which can differ from the env
+  ///        namespace of the caller
+  /// @param context Client context of the call
+  /// @param name Name of the callee
+  std::string GetCalleeKey(const ClientContextPtr& context, const std::any* extend_select_info,
+                           const std::string& name);
+
+  /// @brief Get the age of the routed snapshot served in fail-static mode
+  /// @param info Selection information of the call
+  /// @return uint64_t Age of the snapshot in ms, 0 if there is no snapshot
+  uint64_t GetSnapshotStalenessMs(const SelectorInfo* info);
+
+  /// @brief Record the static timeout of a call and the one recommended by the latency of its method in the context,
+  ///        their outcomes are compared when the result is reported. The recommended timeout replaces the static one
+  ///        if so configured
+  /// @param context Client context of the call, with its service proxy option
+  void ApplyAdaptiveTimeout(const ClientContextPtr& context);
+
+  /// @brief Get the hedge delay of a call by the latency quantile of its callee, and record it in the context so the
+  ///        hedges are counted against the budget when the result is reported
+  /// @param context Client context of the call, with its service proxy option
+  /// @return uint32_t The delay in ms, 0 if hedging is disabled or the call is not hedged
+  uint32_t GetHedgeDelay(const ClientContextPtr& context);
+
  private:
+  // Routing inputs of one selection, used to build the SDK requests and the key of the plugin caches
+  struct RouteInputs {
+    polaris::ServiceKey service_key;
+    polaris::ServiceInfo source_service_info;
+    std::string canary;
+    std::map<std::string, std::string> dst_metadata;
+    bool include_unhealthy{false};
+    // Timeout of the lookup in ms
+    uint64_t timeout{0};
+    // Whether the routed subset is narrowed to the zone picked for the call, not part of the route key
+    bool zone_aware{false};
+    // Method of the call when the method breakers are enabled, not part of the route key
+    std::string method;
+    // Endpoints already selected for the call or excluded by it, "host:port", not part of the route key
+    std::unordered_set<std::string> tried;
+    // Whether a refresh of the routed snapshot failed during the selection, the SDK is not waited for again
+    mutable bool lookup_failed{false};
+  };
+
+  // A secondary polarismesh cluster of the federation
+  struct FederatedCluster {
+    std::string name;
+    std::shared_ptr<polaris::Context> context;
+    std::unique_ptr<polaris::ConsumerApi> consumer_api;
+    // Routed instances discovered in the cluster
+    naming::polarismesh::RoutedSnapshotCache snapshot_cache;
+  };
+
   // Get the specific implementation of the service node from the SDK GetoneInstance interface
-  int SelectImpl(const SelectorInfo* info, polaris::InstancesResponse*& polarismesh_response_info);
+  int SelectImpl(const SelectorInfo* info, std::vector<TrpcEndpointInfo>& endpoints, bool need_meta);
+
+  // Collect the routing inputs of a selection
+  void BuildRouteInputs(const SelectorInfo* info, const polaris::ServiceKey& service_key, RouteInputs& inputs);
+
+  // Build the cache key of the routing inputs
+  std::string BuildRouteKey(const RouteInputs& inputs);
+
+  // Signature of the revisions of the SDK data the routing of inputs depends on, 0 if the route cache is disabled
+  uint64_t GetRouteSourceVersion(const RouteInputs& inputs);
+
+  // Signature of the revision of the route rule of service_key, read from the rules cached by the current thread and
+  // checked against the SDK once per rule_check_interval_
+  uint64_t GetRouteRuleVersion(const polaris::ServiceKey& service_key);
+
+  // Fill the routing inputs into the request of the GetInstances interface
+  void FillInstancesRequest(const RouteInputs& inputs, polaris::GetInstancesRequest& request);
+
+  // Timeout of a lookup made on behalf of the call, bounded by its remaining deadline
+  uint64_t GetLookupTimeout(const ClientContextPtr& context);
+
+  // Make the task which refreshes the snapshot of route_key in the background
+  naming::polarismesh::RoutedSnapshotCache::Refresher MakeRefresher(const RouteInputs& inputs,
+                                                                    const std::string& route_key);
+
+  // Fetch the routed instances from the SDK and store them as the snapshot of route_key
+  bool RefreshRoutedSnapshot(const RouteInputs& inputs, const std::string& route_key);
+
+  // Serve the selection from a snapshot when the SDK is unavailable, without the endpoints the plugin excludes
+  int SelectFromSnapshot(const SelectorInfo* info, const RouteInputs& inputs, const std::string& route_key,
+                         const naming::polarismesh::RoutedSnapshotPtr& snapshot,
+                         std::vector<TrpcEndpointInfo>& endpoints);
+
+  // Serve the selection from the degraded snapshot, or fail it, after a refresh failed during the selection
+  int SelectAfterFailedLookup(const SelectorInfo* info, const RouteInputs& inputs, const std::string& route_key,
+                              std::vector<TrpcEndpointInfo>& endpoints);
+
+  // Get the consistent hashing algorithm of the call, returns false if the call is not balanced by the plugin
+  bool GetLocalHashType(const SelectorInfo* info, naming::polarismesh::ConsistentHashType& type);
+
+  // Get the routed snapshot of route_key, refreshed from the SDK when it is too old. With the metadata index, the
+  // destination metadata is matched in the index of the snapshot routed without it
+  naming::polarismesh::RoutedSnapshotPtr GetRoutedSnapshot(const RouteInputs& inputs, const std::string& route_key);
+
+  // Route snapshot by locality when the plugin makes the nearby routing, otherwise snapshot itself
+  naming::polarismesh::RoutedSnapshotPtr ApplyLocalNearby(const std::string& route_key,
+                                                          const naming::polarismesh::RoutedSnapshotPtr& snapshot);
+
+  // Narrow snapshot to the zone picked for the call when the routing is zone-aware, otherwise snapshot itself
+  naming::polarismesh::RoutedSnapshotPtr ApplyZoneAware(const RouteInputs& inputs, const std::string& route_key,
+                                                        const naming::polarismesh::RoutedSnapshotPtr& snapshot);
+
+  // Leave out of snapshot the endpoints whose breaker of the method of the call is open
+  naming::polarismesh::RoutedSnapshotPtr ApplyMethodBreaker(const RouteInputs& inputs, const std::string& route_key,
+                                                            const naming::polarismesh::RoutedSnapshotPtr& snapshot);
+
+  // Whether the SDK selected an endpoint the plugin excludes for the call, ejected for its latency or whose breaker of
+  // the method or of the set is open
+  bool IsExcludedEndpoint(const RouteInputs& inputs, const TrpcEndpointInfo& endpoint);
+
+  // Leave out of snapshot the endpoints already tried by the call, snapshot itself if all of them were tried
+  naming::polarismesh::RoutedSnapshotPtr ExcludeTried(const RouteInputs& inputs,
+                                                      const naming::polarismesh::RoutedSnapshotPtr& snapshot);
+
+  // Leave out of snapshot the endpoints excluded by IsExcludedEndpoint, snapshot itself if all of them are
+  naming::polarismesh::RoutedSnapshotPtr ExcludeEndpoints(const RouteInputs& inputs,
+                                                          const naming::polarismesh::RoutedSnapshotPtr& snapshot);
+
+  // Whether the call is rejected at once because most of the routed endpoints of its callee are broken or unhealthy
+  bool IsFailingFast(const RouteInputs& inputs, const std::string& route_key);
+
+  // Report the outcome of a call under its static timeout and the recommended one to the metrics
+  void ReportTimeoutOutcome(const std::string& method, uint64_t static_timeout_ms, uint64_t adaptive_timeout_ms,
+                            uint64_t cost_ms, bool timed_out);
+
+  // Route the call to the other sets of the area when the breaker of its set is open, and out of the set division
+  // when all the known sets of the area are open
+  void FallbackFromOpenSet(RouteInputs& inputs);
+
+  // Get the instances of the caller service with their locations, refreshed from the SDK once per refresh interval
+  naming::polarismesh::RoutedSnapshotPtr GetCallerSnapshot(const polaris::ServiceKey& caller_key);
+
+  // Select the endpoints of the hash key of the call with the local consistent hashing tables
+  int SelectByLocalHash(const SelectorInfo* info, const RouteInputs& inputs, const std::string& route_key,
+                        naming::polarismesh::ConsistentHashType type, std::vector<TrpcEndpointInfo>& endpoints,
+                        bool need_meta);
+
+  // Append num replicas of the hash key of the call from the table, starting from the replicate index offset
+  void AppendHashReplicas(const SelectorInfo* info, const naming::polarismesh::ConsistentHashTable& table,
+                          uint32_t offset, uint32_t num, bool need_meta, std::vector<TrpcEndpointInfo>& endpoints);
+
+  // Create the contexts of the secondary clusters of the federation
+  void InitFederation();
+
+  // Get the routed instances of inputs discovered in a secondary cluster, refreshed once per refresh interval
+  naming::polarismesh::RoutedSnapshotPtr GetFederatedSnapshot(FederatedCluster& cluster, const RouteInputs& inputs,
+                                                              const std::string& route_key);
+
+  // Select the endpoints of the call in the secondary cluster it spills over to, returns -1 if the call stays in the
+  // primary cluster
+  int SelectFederated(const SelectorInfo* info, const RouteInputs& inputs, const std::string& route_key,
+                      std::vector<TrpcEndpointInfo>& endpoints, bool need_meta);
+
+  // Select an endpoint of the call on the local host, returns -1 if there is none or the call is not kept local
+  int SelectColocated(const SelectorInfo* info, const RouteInputs& inputs, const std::string& route_key,
+                      std::vector<TrpcEndpointInfo>& endpoints, bool need_meta);
+
+  // Whether the call is a weighted random one balanced by the plugin
+  bool IsLocalRandom(const SelectorInfo* info);
+
+  // Select the endpoints of the call by weight with the alias table of the routed snapshot, returns -1 if the snapshot
+  // is unavailable or too small, then the SDK is used
+  int SelectByLocalRandom(const SelectorInfo* info, const RouteInputs& inputs, const std::string& route_key,
+                          std::vector<TrpcEndpointInfo>& endpoints, bool need_meta);
+
+  // Loop of the background thread which refreshes the degraded snapshots
+  void SnapshotRefreshLoop();
+
+  // Admit a lookup in the SDK, fails fast if the service is known to be absent. lookup_key is the service id,
+  // prefixed by the cluster for the lookups in a federated cluster. timeout_ms bounds the wait for another lookup
+  bool AdmitLookup(const std::string& lookup_key, uint64_t timeout_ms,
+                   naming::polarismesh::ServiceLookupGuard::Admission& admission);
+
+  // Record the result of a lookup admitted by AdmitLookup
+  void CompleteLookup(const std::string& lookup_key, naming::polarismesh::ServiceLookupGuard::Admission admission,
+                      polaris::ReturnCode ret);
 
   // Set the main service information
   void FillMetadataOfSourceServiceInfo(const SelectorInfo* info, polaris::ServiceInfo& source_service_info);
@@ -240,6 +447,9 @@ class PolarisMeshSelector : public Selector {
   // Whether to enable the SET melting function
   bool enable_set_circuitbreaker_;
 
+  // Circuit breakers of the sets of every callee
+  naming::polarismesh::SetCircuitBreaker set_breaker_;
+
   // The TRPC protocol transmission field is passed to the polarismesh for the switch used by Meta matching. The meta
   // format is "Selector-Meta-"
   bool enable_polarismesh_trans_meta_{false};
@@ -250,25 +460,186 @@ class PolarisMeshSelector : public Selector {
   // Service discovery timeout time, compatible with old configuration logic
   uint64_t timeout_;
 
+  // Whether to bound the timeout of the lookups by the remaining deadline of the call
+  bool enable_deadline_{true};
+
+  // Time reserved for the call itself after the lookup, in ms
+  uint64_t deadline_reserve_{10};
+
+  // Whether to serve the last good routed snapshot when the polarismesh server is unavailable
+  bool enable_fail_static_{false};
+
+  // Last good routed snapshots used by the fail-static mode
+  naming::polarismesh::RoutedSnapshotCache snapshot_cache_;
+
+  // Background thread which refreshes the degraded snapshots with backoff
+  std::unique_ptr<std::thread> refresh_thread_;
+  std::mutex refresh_mutex_;
+  std::condition_variable refresh_cond_;
+  bool refresh_stop_{false};
+
+  // Whether the calls with a hash key are balanced by the plugin
+  bool enable_local_hash_{false};
+
+  // Default consistent hashing algorithm of the plugin
+  naming::polarismesh::ConsistentHashType local_hash_type_{naming::polarismesh::ConsistentHashType::kRingHash};
+
+  // Consistent hashing tables of the routed snapshots
+  naming::polarismesh::ConsistentHashTableCache hash_table_cache_;
+
+  // Load factor of the consistent hashing with bounded loads, 0 means the loads are not bounded
+  double bounded_load_factor_{0};
+
+  // Whether the routed subsets are memoized until the revisions of the SDK data change
+  bool enable_route_cache_{false};
+
+  // Whether the nearby routing is made by the plugin over the locality tiers of the routed subsets
+  bool enable_local_nearby_{false};
+
+  // Settings of the nearby routing made by the plugin, taken from the nearbyBasedRouter configuration
+  naming::polarismesh::NearbyOptions nearby_options_;
+
+  // Locality tiers of the routed subsets relative to the local location
+  naming::polarismesh::LocalityTiersCache locality_tiers_cache_;
+
+  // Whether a degraded nearby level falls back to the locality groups ranked by their measured latency
+  bool enable_latency_locality_{false};
+
+  // Interval of ranking the locality groups again, in ms
+  uint64_t latency_rank_interval_{1000};
+
+  // Latency of the locality groups measured from the cost of the calls
+  naming::polarismesh::LocalityLatencyTracker locality_latency_tracker_;
+
+  // Whether the callees are also discovered in the secondary clusters
+  bool enable_federation_{false};
+
+  // The secondary clusters, in configured order
+  std::vector<std::unique_ptr<FederatedCluster>> federated_clusters_;
+
+  // Share of the calls of the clusters of every routed subset
+  naming::polarismesh::FederationPlanCache federation_plan_cache_;
+
+  // Latency of the secondary clusters measured from the cost of the calls
+  naming::polarismesh::LocalityLatencyTracker cluster_latency_tracker_;
+
+  // Whether the endpoints whose latency is far above their peers are ejected
+  bool enable_latency_outlier_{false};
+
+  // Latencies of the endpoints and the ejected outliers of every callee
+  naming::polarismesh::LatencyOutlierDetector latency_outlier_detector_;
+
+  // Whether the results of the calls are counted per endpoint and method
+  bool enable_method_breaker_{false};
+
+  // Circuit breakers of the endpoints per method
+  naming::polarismesh::MethodCircuitBreaker method_breaker_;
+
+  // Whether the retries of a call avoid the endpoints already selected for it
+  bool enable_retry_aware_{false};
+
+  // Maximum number of endpoints remembered per call
+  uint32_t max_tried_endpoints_{5};
+
+  // Whether the calls of a callee whose endpoints are mostly broken are rejected at once, except for the probes
+  bool enable_fail_fast_{false};
+
+  // Breakers of the endpoints and fail-fast state of every callee
+  naming::polarismesh::ServiceFailFast fail_fast_;
+
+  // Whether the calls through the selector filter are hedged after the latency quantile of their callee
+  bool enable_hedging_{false};
+
+  // Latencies and hedge budgets of the callees
+  naming::polarismesh::HedgingPolicy hedging_policy_;
+
+  // Whether a timeout is recommended for every method of a callee from the latency of its calls
+  bool enable_adaptive_timeout_{false};
+
+  // Whether the recommended timeouts replace the static ones
+  bool apply_adaptive_timeout_{false};
+
+  // Latencies and recommended timeouts of the methods of the callees
+  naming::polarismesh::AdaptiveTimeout adaptive_timeout_;
+
+  // Whether the retries of the calls of a callee spend a budget filled by its successful calls
+  bool enable_retry_budget_{false};
+
+  // Retry budgets and breakers of the endpoints of every callee
+  naming::polarismesh::RetryBudget retry_budget_;
+
+  // Whether the weights of the newly discovered endpoints balanced by the plugin ramp up over a window
+  bool enable_slow_start_{false};
+
+  // Ramped snapshots of the routed subsets whose endpoints are in slow start
+  naming::polarismesh::SlowStartCache slow_start_cache_;
+
+  // Whether the callees on the local host are preferred
+  bool enable_colocation_{false};
+
+  // Co-located endpoints of the routed subsets
+  naming::polarismesh::ColocationCache colocation_cache_;
+
+  // Whether the calls are spread over the zones of the routed subsets in proportion to their capacity
+  bool enable_zone_aware_{false};
+
+  // Zone-aware plans of the routed subsets
+  naming::polarismesh::ZoneAwareCache zone_aware_cache_;
+
+  // Instances of the caller services, which give the distribution of the callers over the zones
+  naming::polarismesh::RoutedSnapshotCache caller_snapshot_cache_;
+
+  // Whether the destination metadata is matched with the inverted indexes of the routed subsets
+  bool enable_metadata_index_{false};
+
+  // Metadata indexes of the subsets routed without the destination metadata
+  naming::polarismesh::MetadataIndexCache metadata_index_cache_;
+
+  // Whether the weighted random calls are balanced by the plugin
+  bool enable_local_random_{false};
+
+  // Minimum number of routed instances for the plugin to balance the weighted random calls
+  uint32_t local_random_min_instances_{64};
+
+  // Alias tables of the routed snapshots
+  naming::polarismesh::AliasTableCache alias_table_cache_;
+
+  // In-flight calls of the endpoints selected with bounded loads
+  naming::polarismesh::InflightTracker inflight_tracker_;
+
+  // Single-flight of the first lookups and negative cache of the services not found
+  bool enable_lookup_guard_{false};
+  naming::polarismesh::ServiceLookupGuard lookup_guard_;
+
+  // Name of the trpc monitoring plugin used to report the snapshot staleness
+  std::string metrics_name_;
+
   naming::PolarisMeshNamingConfig plugin_config_;
   std::shared_ptr<polaris::Context> polarismesh_context_{nullptr};
   std::unique_ptr<polaris::ConsumerApi> consumer_api_{nullptr};
 
+  // Route rule data cached by a thread. It is a plain copy of the revision of the SDK data and holds no reference of
+  // it, so that nothing of the SDK outlives the destruction of the selector in the caches of the threads
   struct PolarisRuleRouteRaw {
-    explicit PolarisRuleRouteRaw(polaris::ServiceData* data) : rule_route_data(data) {
-      rule_route_data->IncrementRef();
-    }
-    ~PolarisRuleRouteRaw() {
-      if (rule_route_data) {
-        rule_route_data->DecrementRef();
-        rule_route_data = nullptr;
-      }
-    }
-
-    polaris::ServiceData* rule_route_data;
+    // Signature of the revision of the data
+    uint64_t version;
+    // Time of the last revision check against the SDK, in ms
+    uint64_t check_time_ms;
+    // Selector generation the data was cached in, the data of another generation is dropped
+    uint64_t epoch;
   };
 
+  // Route rules cached by the current thread, keyed by "namespace|service"
   static thread_local std::unordered_map<std::string, PolarisRuleRouteRaw> source_route_rule_map_;
+
+  // Generation of the selectors, bumped by Init and Destroy so that the threads drop the rules of the old contexts
+  static std::atomic<uint64_t> route_rule_epoch_;
+
+  // Interval of checking the revision of a route rule cached by a thread, in ms
+  uint64_t rule_check_interval_{1000};
+
+  // Maximum number of route rules cached by a thread
+  uint32_t max_thread_rules_{1024};
 };
 
 using PolarisMeshSelectorPtr = RefPtr<PolarisMeshSelector>;
@@ -18,6 +18,8 @@
 #include <vector>
 
 #include "trpc/filter/filter.h"
+#include "trpc/naming/polarismesh/polarismesh_selector.h"
+#include "trpc/naming/selector_factory.h"
 #include "trpc/naming/selector_workflow.h"
 
 namespace trpc {
@@ -30,7 +32,10 @@ class PolarisMeshSelectorFilter : public MessageClientFilter {
   ~PolarisMeshSelectorFilter() override {}
 
   /// @brief initialization
-  int Init() override { return selector_flow_->Init(); }
+  int Init() override {
+    selector_ = static_pointer_cast<PolarisMeshSelector>(SelectorFactory::GetInstance()->Get("polarismesh"));
+    return selector_flow_->Init();
+  }
 
   /// @brief Filter name
   std::string Name() override { return "polarismesh"; }
@@ -46,11 +51,29 @@ class PolarisMeshSelectorFilter : public MessageClientFilter {
 
   /// @brief Trigger the corresponding treatment at the buried point
   void operator()(FilterStatus& status, FilterPoint point, const ClientContextPtr& context) override {
+    if (point == FilterPoint::CLIENT_PRE_RPC_INVOKE && selector_) {
+      selector_->ApplyAdaptiveTimeout(context);
+      SetHedgeDelay(context);
+    }
     selector_flow_->RunFilter(status, point, context);
   }
 
+ private:
+  // A call without a backup request of its own is hedged after the latency quantile of its callee, the backup request
+  // makes the workflow select the backup endpoint with the call
+  void SetHedgeDelay(const ClientContextPtr& context) {
+    if (context->GetBackupRequestRetryInfo() != nullptr) {
+      return;
+    }
+    uint32_t delay_ms = selector_->GetHedgeDelay(context);
+    if (delay_ms > 0) {
+      context->SetBackupRequestDelay(delay_ms);
+    }
+  }
+
  private:
   std::unique_ptr<SelectorWorkFlow> selector_flow_;
+  PolarisMeshSelectorPtr selector_;
 };
 
 using PolarisMeshSelectorFilterPtr = RefPtr<PolarisMeshSelectorFilter>;
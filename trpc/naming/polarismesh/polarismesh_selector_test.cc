@@ -16,6 +16,13 @@
 #include <pthread.h>
 #include <stdint.h>
 
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "polaris/model/constants.h"
@@ -24,6 +31,8 @@
 #include "polaris/utils/time_clock.h"
 #include "yaml-cpp/yaml.h"
 
+#include "trpc/client/client_context.h"
+#include "trpc/common/config/trpc_config.h"
 #include "trpc/naming/polarismesh/mock_polarismesh_api_test.h"
 #include "trpc/naming/registry_factory.h"
 #include "trpc/naming/selector.h"
@@ -67,6 +76,7 @@ class PolarisSelectTest : public polaris::MockServerConnectorTest {
     YAML::Node root = YAML::Load(trpc::buildPolarisMeshNamingConfig(default_Switch));
     YAML::Node selector_node = root["selector"];
     trpc::naming::SelectorConfig selector_config = selector_node["polarismesh"].as<trpc::naming::SelectorConfig>();
+    CustomizeSelectorConfig(selector_config);
 
     selector_node["polarismesh"]["global"]["serverConnector"]["protocol"] = server_connector_plugin_name_;
     // Set local regional information that is the main service, and visit the nearest visit
@@ -102,6 +112,9 @@ class PolarisSelectTest : public polaris::MockServerConnectorTest {
     cb->mutable_namespace_()->set_value("xxx");
   }
 
+  // The features of the plugin are off by default, the tests of a feature turn it on here
+  virtual void CustomizeSelectorConfig(trpc::naming::SelectorConfig& /*selector_config*/) {}
+
   void InitServiceNormalData() {
     polaris::FakeServer::InstancesResponse(instances_response_, service_key_);
     v1::Service* service = instances_response_.mutable_service();
@@ -252,6 +265,7 @@ class PolarisSelectTest : public polaris::MockServerConnectorTest {
     polaris::ServiceData* service_data;
     if (data_type == polaris::kServiceDataInstances) {
       service_data = polaris::ServiceData::CreateFromPb(&instances_response_, polaris::kDataIsSyncing);
+      instances_handler_ = handler;
     } else if (data_type == polaris::kServiceDataRouteRule) {
       service_data = polaris::ServiceData::CreateFromPb(&routing_response_, polaris::kDataIsSyncing);
     } else if (data_type == polaris::kCircuitBreakerConfig) {
@@ -272,6 +286,72 @@ class PolarisSelectTest : public polaris::MockServerConnectorTest {
   }
 
  protected:
+  static constexpr uint64_t kLookupTimeoutMs = 300;
+
+  // The SDK looks up the service with the data fed by MockFireEventHandler
+  void ExpectFireEventHandler() {
+    EXPECT_CALL(*polaris::MockServerConnectorTest::server_connector_,
+                RegisterEventHandler(::testing::Eq(service_key_), ::testing::_, ::testing::_, ::testing::_,
+                                     ::testing::_))
+        .WillRepeatedly(::testing::DoAll(::testing::Invoke(this, &PolarisSelectTest::MockFireEventHandler),
+                                         ::testing::Return(polaris::kReturnOk)));
+  }
+
+  // Pushes the instances of the service to the SDK once more, as the server does when they change
+  void UpdateServiceInstances(const std::string& revision) {
+    ASSERT_TRUE(instances_handler_ != NULL);
+    instances_response_.mutable_service()->mutable_revision()->set_value(revision);
+    polaris::EventHandlerData* event_data = new polaris::EventHandlerData();
+    event_data->service_key_ = service_key_;
+    event_data->data_type_ = polaris::kServiceDataInstances;
+    event_data->service_data_ = polaris::ServiceData::CreateFromPb(&instances_response_, polaris::kDataIsSyncing);
+    event_data->handler_ = instances_handler_;
+    pthread_t tid;
+    pthread_create(&tid, NULL, AsyncEventUpdate, event_data);
+    pthread_join(tid, NULL);
+  }
+
+  trpc::ClientContextPtr MakeSelectContext() {
+    auto context = trpc::MakeRefCounted<trpc::ClientContext>();
+    // You must initialize the request before you can be selected
+    context->SetRequest(std::make_shared<MockProtocol>());
+    trpc::naming::polarismesh::SetSelectorExtendInfo(context, std::make_pair("namespace", service_key_.namespace_));
+    return context;
+  }
+
+  int SelectEndpoint(const trpc::ClientContextPtr& context, trpc::TrpcEndpointInfo& endpoint,
+                     const std::string& load_balance_name = polaris::kLoadBalanceTypeDefaultConfig) {
+    trpc::SelectorInfo info;
+    info.name = service_key_.name_;
+    info.context = context;
+    info.load_balance_name = load_balance_name;
+    return selector_->Select(&info, &endpoint);
+  }
+
+  uint64_t GetSnapshotStalenessMs() {
+    trpc::SelectorInfo info;
+    info.name = service_key_.name_;
+    info.context = MakeSelectContext();
+    info.load_balance_name = polaris::kLoadBalanceTypeDefaultConfig;
+    return selector_->GetSnapshotStalenessMs(&info);
+  }
+
+  void ReportResult(const std::string& host, uint16_t port, int framework_result, uint64_t cost_time,
+                    const std::string& func_name = "") {
+    trpc::InvokeResult result;
+    result.name = service_key_.name_;
+    result.framework_result = framework_result;
+    result.interface_result = 0;
+    result.cost_time = cost_time;
+    auto context = MakeSelectContext();
+    context->SetAddr(host, port);
+    if (!func_name.empty()) {
+      context->SetFuncName(func_name);
+    }
+    result.context = context;
+    selector_->ReportInvokeResult(&result);
+  }
+
   trpc::PolarisMeshSelectorPtr selector_;
   v1::DiscoverResponse instances_response_;
   v1::DiscoverResponse routing_response_;
@@ -279,6 +359,7 @@ class PolarisSelectTest : public polaris::MockServerConnectorTest {
   polaris::ServiceKey service_key_;
   std::string persist_dir_;
   std::vector<pthread_t> event_thread_list_;
+  polaris::ServiceEventHandler* instances_handler_ = NULL;
 };
 
 TEST_F(PolarisSelectTest, SelectNormal) {
@@ -555,6 +636,358 @@ TEST_F(PolarisSelectTest, ReportInvokeResult) {
   // ASSERT_EQ(0, selector_->ReportInvokeResult(&result));
 }
 
+TEST_F(PolarisSelectTest, CalleeKeyIgnoresEnvNamespace) {
+  // The env namespace of the caller, Development, differs from the namespace of the callee
+  ASSERT_EQ(0, trpc::TrpcConfig::GetInstance()->Init("./trpc/naming/polarismesh/testing/polarismesh_test.yaml"));
+  auto context = trpc::MakeRefCounted<trpc::ClientContext>();
+  context->SetRequest(std::make_shared<MockProtocol>());
+  trpc::naming::polarismesh::SetSelectorExtendInfo(context, std::make_pair("namespace", service_key_.namespace_));
+
+  trpc::RefPtr<trpc::PolarisMeshSelector> p = static_pointer_cast<trpc::PolarisMeshSelector>(selector_);
+  polaris::ServiceKey source_service_key;
+  p->GetSourceServiceKey(context, nullptr, source_service_key);
+  ASSERT_EQ("Development", source_service_key.namespace_);
+
+  // The selection and the report of the result key the callee the same way, by its own namespace
+  std::string expected = service_key_.namespace_ + "|" + service_key_.name_;
+  ASSERT_EQ(expected, p->GetCalleeKey(context, nullptr, service_key_.name_));
+  trpc::SelectorInfo info;
+  info.name = service_key_.name_;
+  info.context = context;
+  ASSERT_EQ(expected, p->GetCalleeKey(info.context, info.extend_select_info, info.name));
+
+  trpc::InvokeResult result;
+  result.name = service_key_.name_;
+  result.framework_result = trpc::TrpcRetCode::TRPC_INVOKE_SUCCESS;
+  result.cost_time = 10;
+  result.context = context;
+  ASSERT_EQ(expected, p->GetCalleeKey(result.context, nullptr, result.name));
+}
+
+class PolarisSelectFailStaticTest : public PolarisSelectTest {
+ protected:
+  void CustomizeSelectorConfig(trpc::naming::SelectorConfig& selector_config) override {
+    selector_config.global_config.server_connector_config.timeout = kLookupTimeoutMs;
+    selector_config.fail_static_config.enable = true;
+    selector_config.fail_static_config.min_backoff = 300;
+    selector_config.fail_static_config.max_backoff = 1000;
+  }
+};
+
+TEST_F(PolarisSelectFailStaticTest, ServeSnapshotWhenLookupFails) {
+  InitServiceNormalData();
+  ExpectFireEventHandler();
+
+  // The successful selection takes the routed snapshot, the nearby instances 1 and 2
+  trpc::TrpcEndpointInfo endpoint;
+  ASSERT_EQ(0, SelectEndpoint(MakeSelectContext(), endpoint));
+
+  // The service loses all its instances, the lookups of the SDK fail and the snapshot is served instead
+  instances_response_.clear_instances();
+  UpdateServiceInstances("version_two");
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ(0, SelectEndpoint(MakeSelectContext(), endpoint));
+    ASSERT_TRUE(endpoint.host == "host1" || endpoint.host == "host2");
+  }
+  ASSERT_GE(GetSnapshotStalenessMs(), 100);
+
+  // The service recovers, the snapshot is still served until the backoff ends
+  instances_response_.Clear();
+  InitServiceNormalData();
+  UpdateServiceInstances("version_three");
+  ASSERT_EQ(0, SelectEndpoint(MakeSelectContext(), endpoint));
+  ASSERT_GE(GetSnapshotStalenessMs(), 100);
+
+  // Then the SDK is looked up again and the snapshot is taken anew
+  std::this_thread::sleep_for(std::chrono::milliseconds(400));
+  ASSERT_EQ(0, SelectEndpoint(MakeSelectContext(), endpoint));
+  ASSERT_TRUE(endpoint.host == "host1" || endpoint.host == "host2");
+  ASSERT_LT(GetSnapshotStalenessMs(), 100);
+}
+
+class PolarisSelectNegativeCacheTest : public PolarisSelectTest {
+ protected:
+  void CustomizeSelectorConfig(trpc::naming::SelectorConfig& selector_config) override {
+    selector_config.global_config.server_connector_config.timeout = kLookupTimeoutMs;
+    selector_config.negative_cache_config.enable = true;
+    selector_config.negative_cache_config.ttl = 500;
+  }
+};
+
+TEST_F(PolarisSelectNegativeCacheTest, NotFoundFailsFast) {
+  // The server answers that the service does not exist
+  InitServiceNormalData();
+  instances_response_.mutable_code()->set_value(v1::NotFoundResource);
+  ExpectFireEventHandler();
+
+  trpc::TrpcEndpointInfo endpoint;
+  ASSERT_NE(0, SelectEndpoint(MakeSelectContext(), endpoint));
+
+  // The service is created, but the calls keep failing without asking the SDK until the ttl expires
+  instances_response_.Clear();
+  InitServiceNormalData();
+  UpdateServiceInstances("version_two");
+  ASSERT_NE(0, SelectEndpoint(MakeSelectContext(), endpoint));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(600));
+  ASSERT_EQ(0, SelectEndpoint(MakeSelectContext(), endpoint));
+  ASSERT_TRUE(endpoint.host == "host1" || endpoint.host == "host2");
+}
+
+TEST_F(PolarisSelectNegativeCacheTest, ConcurrentFirstLookups) {
+  InitServiceNormalData();
+  ExpectFireEventHandler();
+
+  // One of the callers fetches the service, the others wait for it and are then served from the local cache
+  std::atomic<int> succeeded{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; i++) {
+    threads.emplace_back([this, &succeeded]() {
+      trpc::TrpcEndpointInfo endpoint;
+      if (SelectEndpoint(MakeSelectContext(), endpoint) == 0) {
+        succeeded.fetch_add(1);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(8, succeeded.load());
+}
+
+class PolarisSelectLocalHashTest : public PolarisSelectTest {
+ protected:
+  void CustomizeSelectorConfig(trpc::naming::SelectorConfig& selector_config) override {
+    selector_config.global_config.server_connector_config.timeout = kLookupTimeoutMs;
+    selector_config.local_hash_config.enable = true;
+  }
+};
+
+TEST_F(PolarisSelectLocalHashTest, KeepEndpointOfKey) {
+  InitServiceNormalData();
+  ExpectFireEventHandler();
+
+  // The plugin hashes the key on the routed snapshot
+  trpc::TrpcEndpointInfo first;
+  auto context = MakeSelectContext();
+  context->SetHashKey("abc");
+  ASSERT_EQ(0, SelectEndpoint(context, first));
+  ASSERT_TRUE(first.host == "host1" || first.host == "host2");
+  for (int i = 0; i < 20; i++) {
+    trpc::TrpcEndpointInfo endpoint;
+    auto context = MakeSelectContext();
+    context->SetHashKey("abc");
+    ASSERT_EQ(0, SelectEndpoint(context, endpoint));
+    ASSERT_EQ(first.host, endpoint.host);
+  }
+
+  // The hashing the plugin does not make is left to the SDK, the numeric keys are mapped as before
+  trpc::TrpcEndpointInfo endpoint;
+  context = MakeSelectContext();
+  context->SetHashKey("0");
+  ASSERT_EQ(0, SelectEndpoint(context, endpoint, polaris::kLoadBalanceTypeSimpleHash));
+  ASSERT_EQ("host1", endpoint.host);
+  context = MakeSelectContext();
+  context->SetHashKey("1");
+  ASSERT_EQ(0, SelectEndpoint(context, endpoint, polaris::kLoadBalanceTypeSimpleHash));
+  ASSERT_EQ("host2", endpoint.host);
+}
+
+TEST_F(PolarisSelectLocalHashTest, FailedLookupWaitsOnce) {
+  // The server never answers for the service
+  service_key_.name_ = "unknown.service";
+  EXPECT_CALL(*polaris::MockServerConnectorTest::server_connector_,
+              RegisterEventHandler(::testing::Eq(service_key_), ::testing::_, ::testing::_, ::testing::_, ::testing::_))
+      .WillRepeatedly(
+          ::testing::DoAll(::testing::Invoke(this, &polaris::MockServerConnectorTest::MockIgnoreEventHandler),
+                           ::testing::Return(polaris::kReturnOk)));
+
+  // The failed lookup of the plugin is not followed by another one of the SDK
+  auto context = MakeSelectContext();
+  context->SetHashKey("abc");
+  trpc::TrpcEndpointInfo endpoint;
+  auto begin = std::chrono::steady_clock::now();
+  ASSERT_NE(0, SelectEndpoint(context, endpoint));
+  auto cost_ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin).count();
+  ASSERT_LT(static_cast<uint64_t>(cost_ms), 2 * kLookupTimeoutMs);
+}
+
+class PolarisSelectLocalRandomTest : public PolarisSelectTest {
+ protected:
+  void CustomizeSelectorConfig(trpc::naming::SelectorConfig& selector_config) override {
+    selector_config.local_random_config.enable = true;
+    selector_config.local_random_config.min_instances = 2;
+    selector_config.local_random_config.refresh_interval = 100;
+  }
+};
+
+TEST_F(PolarisSelectLocalRandomTest, FallBackToSdk) {
+  InitServiceNormalData();
+  ExpectFireEventHandler();
+
+  // The plugin balances the nearby instances 1 and 2
+  std::set<std::string> hosts;
+  for (int i = 0; i < 50; i++) {
+    trpc::TrpcEndpointInfo endpoint;
+    ASSERT_EQ(0, SelectEndpoint(MakeSelectContext(), endpoint));
+    hosts.insert(endpoint.host);
+  }
+  ASSERT_EQ(std::set<std::string>({"host1", "host2"}), hosts);
+
+  // Instance 2 is isolated, the routed snapshot is too small for the plugin and the SDK balances the calls
+  instances_response_.mutable_instances(1)->mutable_isolate()->set_value(true);
+  UpdateServiceInstances("version_two");
+  std::this_thread::sleep_for(std::chrono::milliseconds(150));
+  for (int i = 0; i < 10; i++) {
+    trpc::TrpcEndpointInfo endpoint;
+    ASSERT_EQ(0, SelectEndpoint(MakeSelectContext(), endpoint));
+    ASSERT_EQ("host1", endpoint.host);
+  }
+}
+
+class PolarisSelectRetryAwareTest : public PolarisSelectTest {
+ protected:
+  void CustomizeSelectorConfig(trpc::naming::SelectorConfig& selector_config) override {
+    selector_config.retry_aware_config.enable = true;
+  }
+};
+
+TEST_F(PolarisSelectRetryAwareTest, SkipExcludedEndpoints) {
+  InitServiceNormalData();
+  ExpectFireEventHandler();
+
+  for (int i = 0; i < 20; i++) {
+    auto context = MakeSelectContext();
+    trpc::naming::polarismesh::SetSelectorExtendInfo(context, std::make_pair("excluded_endpoints", "host1:8081"));
+    trpc::TrpcEndpointInfo endpoint;
+    ASSERT_EQ(0, SelectEndpoint(context, endpoint));
+    ASSERT_EQ("host2", endpoint.host);
+  }
+}
+
+TEST_F(PolarisSelectRetryAwareTest, RetryPicksAnotherEndpoint) {
+  InitServiceNormalData();
+  ExpectFireEventHandler();
+
+  for (int i = 0; i < 20; i++) {
+    // The selections of a call remember the endpoints tried, the retry goes to the other nearby instance
+    auto context = MakeSelectContext();
+    trpc::TrpcEndpointInfo first, retry;
+    ASSERT_EQ(0, SelectEndpoint(context, first));
+    ASSERT_EQ(0, SelectEndpoint(context, retry));
+    ASSERT_NE(first.host, retry.host);
+  }
+}
+
+class PolarisSelectFailFastTest : public PolarisSelectTest {
+ protected:
+  void CustomizeSelectorConfig(trpc::naming::SelectorConfig& selector_config) override {
+    selector_config.service_fail_fast_config.enable = true;
+    selector_config.service_fail_fast_config.broken_percent = 50;
+    selector_config.service_fail_fast_config.reject_percent = 100;
+    selector_config.service_fail_fast_config.min_requests = 2;
+  }
+};
+
+TEST_F(PolarisSelectFailFastTest, RejectWhenMostEndpointsBroken) {
+  InitServiceNormalData();
+  ExpectFireEventHandler();
+
+  trpc::TrpcEndpointInfo endpoint;
+  ASSERT_EQ(0, SelectEndpoint(MakeSelectContext(), endpoint));
+
+  // The calls to all the instances fail
+  for (int i = 1; i <= 6; i++) {
+    for (int j = 0; j < 2; j++) {
+      ReportResult("host" + std::to_string(i), 8080 + i, trpc::TrpcRetCode::TRPC_INVOKE_UNKNOWN_ERR, 10);
+    }
+  }
+  for (int i = 0; i < 10; i++) {
+    ASSERT_NE(0, SelectEndpoint(MakeSelectContext(), endpoint));
+  }
+}
+
+class PolarisSelectRetryBudgetTest : public PolarisSelectTest {
+ protected:
+  void CustomizeSelectorConfig(trpc::naming::SelectorConfig& selector_config) override {
+    selector_config.retry_budget_config.enable = true;
+    selector_config.retry_budget_config.ratio_percent = 10;
+    selector_config.retry_budget_config.max_tokens = 1;
+  }
+};
+
+TEST_F(PolarisSelectRetryBudgetTest, RefuseRetryOverBudget) {
+  InitServiceNormalData();
+  ExpectFireEventHandler();
+
+  // The first retry takes the only token of the budget
+  trpc::TrpcEndpointInfo endpoint;
+  auto context = MakeSelectContext();
+  ASSERT_EQ(0, SelectEndpoint(context, endpoint));
+  ASSERT_EQ(0, SelectEndpoint(context, endpoint));
+
+  // The first try of another call is not limited, its retry is refused
+  context = MakeSelectContext();
+  ASSERT_EQ(0, SelectEndpoint(context, endpoint));
+  ASSERT_NE(0, SelectEndpoint(context, endpoint));
+
+  // Ten successful calls earn a retry back
+  for (int i = 0; i < 10; i++) {
+    ReportResult("host1", 8081, trpc::TrpcRetCode::TRPC_INVOKE_SUCCESS, 10);
+  }
+  ASSERT_EQ(0, SelectEndpoint(context, endpoint));
+}
+
+class PolarisSelectAdaptiveTimeoutTest : public PolarisSelectTest {
+ protected:
+  void CustomizeSelectorConfig(trpc::naming::SelectorConfig& selector_config) override {
+    selector_config.adaptive_timeout_config.enable = true;
+    selector_config.adaptive_timeout_config.apply = true;
+    selector_config.adaptive_timeout_config.quantile = 0.5;
+    selector_config.adaptive_timeout_config.multiplier = 2.0;
+    selector_config.adaptive_timeout_config.min_timeout = 50;
+    selector_config.adaptive_timeout_config.max_timeout = 300;
+    selector_config.adaptive_timeout_config.min_samples = 5;
+    selector_config.adaptive_timeout_config.interval = 0;
+  }
+
+  uint32_t GetAppliedTimeout(const std::string& func_name) {
+    ServiceProxyOption option;
+    option.name = "test";
+    option.target = service_key_.name_;
+    option.name_space = service_key_.namespace_;
+    option.selector_name = "polarismesh";
+    auto context = MakeSelectContext();
+    context->SetServiceProxyOption(&option);
+    context->SetFuncName(func_name);
+    context->SetTimeout(1000);
+    selector_->ApplyAdaptiveTimeout(context);
+    return context->GetTimeout();
+  }
+};
+
+TEST_F(PolarisSelectAdaptiveTimeoutTest, ClampRecommendedTimeout) {
+  InitServiceNormalData();
+  ExpectFireEventHandler();
+
+  // The results are reported for the instances the SDK knows
+  trpc::TrpcEndpointInfo endpoint;
+  ASSERT_EQ(0, SelectEndpoint(MakeSelectContext(), endpoint));
+
+  // Too few samples, the timeout of the caller is kept
+  ASSERT_EQ(1000, GetAppliedTimeout("/test.service/fast"));
+
+  for (int i = 0; i < 10; i++) {
+    ReportResult(endpoint.host, endpoint.port, trpc::TrpcRetCode::TRPC_INVOKE_SUCCESS, 10, "/test.service/fast");
+    ReportResult(endpoint.host, endpoint.port, trpc::TrpcRetCode::TRPC_INVOKE_SUCCESS, 1000, "/test.service/slow");
+  }
+  // Twice the median latency, raised to the minimum timeout and lowered to the maximum one
+  ASSERT_EQ(50, GetAppliedTimeout("/test.service/fast"));
+  ASSERT_EQ(300, GetAppliedTimeout("/test.service/slow"));
+}
+
 }  // namespace trpc
 
 class PolarisTestEnvironment : public testing::Environment {
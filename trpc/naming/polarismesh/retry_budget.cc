@@ -0,0 +1,99 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#include "trpc/naming/polarismesh/retry_budget.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace trpc::naming::polarismesh {
+
+std::shared_ptr<RetryBudget::Bucket> RetryBudget::GetBucket(const std::string& service) {
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto iter = buckets_.find(service);
+    if (iter != buckets_.end()) {
+      return iter->second;
+    }
+  }
+
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  auto& entry = buckets_[service];
+  if (!entry) {
+    entry = std::make_shared<Bucket>();
+    entry->tokens.store(options_.max_tokens * kTokenUnits, std::memory_order_relaxed);
+  }
+  return entry;
+}
+
+void RetryBudget::Report(const std::string& service, const std::string& address, bool success, uint64_t now_ms) {
+  breakers_.Report(service, address, success, 0, now_ms);
+  if (!success) {
+    return;
+  }
+
+  auto bucket = GetBucket(service);
+  int64_t capacity = options_.max_tokens * kTokenUnits;
+  int64_t deposit = options_.ratio_percent * kTokenUnits / 100;
+  int64_t tokens = bucket->tokens.load(std::memory_order_relaxed);
+  while (tokens < capacity) {
+    if (bucket->tokens.compare_exchange_weak(tokens, std::min(capacity, tokens + deposit), std::memory_order_relaxed)) {
+      return;
+    }
+  }
+}
+
+uint32_t RetryBudget::GetHealthyPercent(const std::string& service, uint64_t now_ms) {
+  auto members = breakers_.GetMembers(service);
+  if (members.empty()) {
+    return 100;
+  }
+  auto open = breakers_.GetOpenBreakers(service, now_ms);
+  size_t open_num = 0;
+  if (open) {
+    for (const auto& member : members) {
+      open_num += open->members.count(member);
+    }
+  }
+  return static_cast<uint32_t>((members.size() - open_num) * 100 / members.size());
+}
+
+bool RetryBudget::TryRetry(const std::string& service, uint64_t now_ms) {
+  uint32_t healthy_percent = GetHealthyPercent(service, now_ms);
+  if (healthy_percent < options_.min_healthy_percent || healthy_percent == 0) {
+    return false;
+  }
+
+  auto bucket = GetBucket(service);
+  int64_t cost = kTokenUnits * 100 / healthy_percent;
+  int64_t tokens = bucket->tokens.load(std::memory_order_relaxed);
+  while (tokens >= cost) {
+    if (bucket->tokens.compare_exchange_weak(tokens, tokens - cost, std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int64_t RetryBudget::GetTokens(const std::string& service) {
+  return GetBucket(service)->tokens.load(std::memory_order_relaxed);
+}
+
+void RetryBudget::Clear() {
+  breakers_.Clear();
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  buckets_.clear();
+}
+
+}  // namespace trpc::naming::polarismesh
@@ -0,0 +1,87 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include "trpc/naming/polarismesh/circuit_breaker.h"
+
+namespace trpc::naming::polarismesh {
+
+/// @brief Retry budget of every callee, a token bucket filled by the successful calls and drained by the retries, so
+///        the retries are at most a ratio of the successes. The results of the calls of every endpoint also drive a
+///        breaker per endpoint: as the healthy fraction of the endpoints falls, a retry costs more tokens, and below a
+///        threshold the retries are refused, so they do not pile onto a struggling callee.
+class RetryBudget {
+ public:
+  /// Number of token units of a retry, the tokens are counted in units so that a success can deposit a fraction
+  static constexpr int64_t kTokenUnits = 1000;
+
+  struct Options {
+    /// Tokens deposited by a success in percent of a retry, which is the ratio of the retries to the successes
+    uint32_t ratio_percent{10};
+    /// Capacity of the bucket in retries, the bucket of a new callee starts full
+    uint32_t max_tokens{100};
+    /// Percentage of the endpoints with a closed breaker below which the retries are refused
+    uint32_t min_healthy_percent{50};
+    /// Breakers of the endpoints
+    CircuitBreakerOptions breaker;
+  };
+
+  void SetOptions(const Options& options) {
+    options_ = options;
+    breakers_.SetOptions(options.breaker);
+  }
+
+  const Options& GetOptions() const { return options_; }
+
+  /// @brief Record the result of a call
+  /// @param service Callee of the call
+  /// @param address Address of the endpoint called, "host:port"
+  void Report(const std::string& service, const std::string& address, bool success, uint64_t now_ms);
+
+  /// @brief Percentage of the endpoints of service seen in the window whose breaker is not open, 100 if none is seen
+  uint32_t GetHealthyPercent(const std::string& service, uint64_t now_ms);
+
+  /// @brief Take the tokens of a retry of a call to service, which costs one retry when all the endpoints are healthy
+  ///        and more as the healthy fraction falls
+  /// @return bool Whether the retry is allowed
+  bool TryRetry(const std::string& service, uint64_t now_ms);
+
+  /// @brief Tokens left in the bucket of service, in units
+  int64_t GetTokens(const std::string& service);
+
+  void Clear();
+
+ private:
+  struct Bucket {
+    std::atomic<int64_t> tokens{0};
+  };
+
+  std::shared_ptr<Bucket> GetBucket(const std::string& service);
+
+ private:
+  Options options_;
+  CircuitBreakerGroups breakers_;
+  std::shared_mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<Bucket>> buckets_;
+};
+
+}  // namespace trpc::naming::polarismesh
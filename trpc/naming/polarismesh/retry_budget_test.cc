@@ -0,0 +1,98 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#include "trpc/naming/polarismesh/retry_budget.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace trpc::naming::polarismesh::testing {
+
+RetryBudget::Options MakeOptions() {
+  RetryBudget::Options options;
+  options.ratio_percent = 10;
+  options.max_tokens = 5;
+  options.min_healthy_percent = 50;
+  options.breaker.window_ms = 10000;
+  options.breaker.min_requests = 5;
+  options.breaker.error_rate_percent = 50;
+  options.breaker.sleep_window_ms = 30000;
+  return options;
+}
+
+TEST(RetryBudgetTest, SuccessesRefillTheBudget) {
+  RetryBudget budget;
+  budget.SetOptions(MakeOptions());
+
+  // A new callee starts with a full bucket
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_TRUE(budget.TryRetry("service", 1000));
+  }
+  ASSERT_FALSE(budget.TryRetry("service", 1000));
+  ASSERT_EQ(0, budget.GetTokens("service"));
+
+  // Ten successes pay for one retry, failures pay for none
+  for (int i = 0; i < 9; ++i) {
+    budget.Report("service", "host:80", true, 1000);
+  }
+  budget.Report("service", "host:80", false, 1000);
+  ASSERT_FALSE(budget.TryRetry("service", 1000));
+  budget.Report("service", "host:80", true, 1000);
+  ASSERT_TRUE(budget.TryRetry("service", 1000));
+  ASSERT_FALSE(budget.TryRetry("service", 1000));
+
+  // The bucket is capped
+  for (int i = 0; i < 1000; ++i) {
+    budget.Report("service", "host:80", true, 1000);
+  }
+  ASSERT_EQ(5 * RetryBudget::kTokenUnits, budget.GetTokens("service"));
+
+  // The budgets of the callees are apart
+  ASSERT_EQ(5 * RetryBudget::kTokenUnits, budget.GetTokens("other"));
+}
+
+TEST(RetryBudgetTest, TightenedByBrokenEndpoints) {
+  RetryBudget budget;
+  budget.SetOptions(MakeOptions());
+  for (int i = 0; i < 4; ++i) {
+    for (int n = 0; n < 10; ++n) {
+      budget.Report("service", "host" + std::to_string(i) + ":80", true, 1000);
+    }
+  }
+  ASSERT_EQ(100, budget.GetHealthyPercent("service", 1000));
+
+  // With one endpoint of four broken, a retry costs 4/3 of a retry
+  for (int n = 0; n < 10; ++n) {
+    budget.Report("service", "host0:80", false, 1000);
+  }
+  ASSERT_EQ(75, budget.GetHealthyPercent("service", 1000));
+  ASSERT_TRUE(budget.TryRetry("service", 1000));
+  ASSERT_EQ(5 * RetryBudget::kTokenUnits - RetryBudget::kTokenUnits * 100 / 75, budget.GetTokens("service"));
+
+  // With more than half of them broken, the retries are refused
+  for (int i = 1; i < 3; ++i) {
+    for (int n = 0; n < 10; ++n) {
+      budget.Report("service", "host" + std::to_string(i) + ":80", false, 1000);
+    }
+  }
+  ASSERT_EQ(25, budget.GetHealthyPercent("service", 1000));
+  ASSERT_FALSE(budget.TryRetry("service", 1000));
+
+  budget.Clear();
+  ASSERT_EQ(100, budget.GetHealthyPercent("service", 1000));
+  ASSERT_TRUE(budget.TryRetry("service", 1000));
+}
+
+}  // namespace trpc::naming::polarismesh::testing
@@ -0,0 +1,43 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#include "trpc/naming/polarismesh/service_fail_fast.h"
+
+#include <memory>
+
+namespace trpc::naming::polarismesh {
+
+uint32_t ServiceFailFast::GetBrokenPercent(const std::string& service, const std::string& key,
+                                           const RoutedSnapshotPtr& snapshot, uint64_t now_ms) {
+  if (!snapshot || snapshot->endpoints.empty()) {
+    return 0;
+  }
+
+  auto open = breakers_.GetOpenBreakers(service, now_ms);
+  uint64_t revision = SignatureHasher().Add(snapshot->revision).Add(open ? open->revision : 0).Get();
+  auto broken = broken_percents_.Get(key, revision, snapshot, [&open](const RoutedSnapshotPtr& origin) {
+    uint64_t num = 0;
+    for (const auto& endpoint : origin->endpoints) {
+      if (!endpoint.status || (open && open->members.count(GetEndpointAddress(endpoint)) > 0)) {
+        ++num;
+      }
+    }
+    auto result = std::make_shared<BrokenPercent>();
+    result->percent = static_cast<uint32_t>(num * 100 / origin->endpoints.size());
+    return std::shared_ptr<const BrokenPercent>(result);
+  });
+  return broken ? broken->percent : 0;
+}
+
+}  // namespace trpc::naming::polarismesh
@@ -0,0 +1,83 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#pragma once
+
+#include <string>
+
+#include "trpc/naming/polarismesh/circuit_breaker.h"
+#include "trpc/naming/polarismesh/snapshot_cache.h"
+
+namespace trpc::naming::polarismesh {
+
+/// @brief Service-level fail-fast. The results of the calls of every endpoint of a callee drive a breaker per
+///        endpoint, and once more than a percentage of the routed endpoints of the callee are broken or unhealthy,
+///        the callee fails fast: a fraction of its calls is rejected at once, and the others go through as probes
+///        whose results close the breakers of the endpoints that recovered.
+class ServiceFailFast {
+ public:
+  struct Options {
+    /// Percentage of the endpoints broken or unhealthy above which the callee fails fast
+    uint32_t broken_percent{80};
+    /// Percentage of the calls rejected while the callee fails fast, the others probe it
+    uint32_t reject_percent{90};
+    /// Breakers of the endpoints
+    CircuitBreakerOptions breaker;
+  };
+
+  void SetOptions(const Options& options) {
+    options_ = options;
+    breakers_.SetOptions(options.breaker);
+  }
+
+  const Options& GetOptions() const { return options_; }
+
+  /// @brief Record the result of a call
+  /// @param service Callee of the call
+  /// @param address Address of the endpoint called, "host:port"
+  void Report(const std::string& service, const std::string& address, bool success, uint64_t now_ms) {
+    breakers_.Report(service, address, success, 0, now_ms);
+  }
+
+  /// @brief Percentage of the endpoints of snapshot which are unhealthy or whose breaker is open at now_ms. It is
+  ///        computed once per revision of the snapshot and of the open breakers
+  /// @param key Selection key of the snapshot
+  uint32_t GetBrokenPercent(const std::string& service, const std::string& key, const RoutedSnapshotPtr& snapshot,
+                            uint64_t now_ms);
+
+  /// @brief Whether a call to the snapshot of key is rejected
+  /// @param random Random number deciding whether the call is let through as a probe
+  bool ShouldReject(const std::string& service, const std::string& key, const RoutedSnapshotPtr& snapshot,
+                    uint64_t now_ms, uint64_t random) {
+    return random % 100 < options_.reject_percent &&
+           GetBrokenPercent(service, key, snapshot, now_ms) > options_.broken_percent;
+  }
+
+  void Clear() {
+    breakers_.Clear();
+    broken_percents_.Clear();
+  }
+
+ private:
+  struct BrokenPercent {
+    uint32_t percent{0};
+  };
+
+ private:
+  Options options_;
+  CircuitBreakerGroups breakers_;
+  SnapshotTableCache<BrokenPercent> broken_percents_;
+};
+
+}  // namespace trpc::naming::polarismesh
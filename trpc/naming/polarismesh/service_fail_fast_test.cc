@@ -0,0 +1,94 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#include "trpc/naming/polarismesh/service_fail_fast.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+
+namespace trpc::naming::polarismesh::testing {
+
+namespace {
+
+RoutedSnapshotPtr MakeSnapshot(uint32_t num, uint32_t unhealthy) {
+  auto snapshot = std::make_shared<RoutedSnapshot>();
+  for (uint32_t i = 0; i < num; ++i) {
+    TrpcEndpointInfo endpoint;
+    endpoint.host = "127.0.0." + std::to_string(i + 1);
+    endpoint.port = 80;
+    endpoint.weight = 100;
+    endpoint.status = i >= unhealthy;
+    snapshot->endpoints.push_back(endpoint);
+  }
+  snapshot->revision = CalculateEndpointsRevision(snapshot->endpoints);
+  return snapshot;
+}
+
+ServiceFailFast::Options MakeOptions() {
+  ServiceFailFast::Options options;
+  options.broken_percent = 50;
+  options.reject_percent = 90;
+  options.breaker.min_requests = 2;
+  options.breaker.error_rate_percent = 50;
+  options.breaker.sleep_window_ms = 1000;
+  options.breaker.success_to_close = 1;
+  return options;
+}
+
+}  // namespace
+
+TEST(ServiceFailFastTest, BrokenPercent) {
+  ServiceFailFast fail_fast;
+  fail_fast.SetOptions(MakeOptions());
+
+  auto snapshot = MakeSnapshot(4, 1);
+  ASSERT_EQ(25, fail_fast.GetBrokenPercent("svc", "key", snapshot, 0));
+  ASSERT_FALSE(fail_fast.ShouldReject("svc", "key", snapshot, 0, 0));
+
+  fail_fast.Report("svc", "127.0.0.2:80", false, 0);
+  fail_fast.Report("svc", "127.0.0.2:80", false, 0);
+  ASSERT_EQ(50, fail_fast.GetBrokenPercent("svc", "key", snapshot, 0));
+  ASSERT_FALSE(fail_fast.ShouldReject("svc", "key", snapshot, 0, 0));
+
+  fail_fast.Report("svc", "127.0.0.3:80", false, 0);
+  fail_fast.Report("svc", "127.0.0.3:80", false, 0);
+  ASSERT_EQ(75, fail_fast.GetBrokenPercent("svc", "key", snapshot, 0));
+  ASSERT_TRUE(fail_fast.ShouldReject("svc", "key", snapshot, 0, 0));
+  ASSERT_TRUE(fail_fast.ShouldReject("svc", "key", snapshot, 0, 89));
+  // The other calls probe the callee
+  ASSERT_FALSE(fail_fast.ShouldReject("svc", "key", snapshot, 0, 90));
+  // Other callees are not affected
+  ASSERT_EQ(25, fail_fast.GetBrokenPercent("other", "other_key", snapshot, 0));
+}
+
+TEST(ServiceFailFastTest, Recover) {
+  ServiceFailFast fail_fast;
+  fail_fast.SetOptions(MakeOptions());
+
+  auto snapshot = MakeSnapshot(2, 0);
+  for (const auto& address : {"127.0.0.1:80", "127.0.0.2:80"}) {
+    fail_fast.Report("svc", address, false, 0);
+    fail_fast.Report("svc", address, false, 0);
+  }
+  ASSERT_EQ(100, fail_fast.GetBrokenPercent("svc", "key", snapshot, 0));
+
+  // Half-open after the sleep window, a successful probe closes the breaker
+  ASSERT_EQ(0, fail_fast.GetBrokenPercent("svc", "key", snapshot, 1000));
+  fail_fast.Report("svc", "127.0.0.1:80", true, 1000);
+  fail_fast.Report("svc", "127.0.0.2:80", false, 1000);
+  ASSERT_EQ(50, fail_fast.GetBrokenPercent("svc", "key", snapshot, 1000));
+}
+
+}  // namespace trpc::naming::polarismesh::testing
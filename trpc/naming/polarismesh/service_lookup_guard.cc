@@ -0,0 +1,162 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#include "trpc/naming/polarismesh/service_lookup_guard.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+#include "trpc/coroutine/fiber.h"
+
+namespace trpc::naming::polarismesh {
+
+ServiceLookupGuard::Admission ServiceLookupGuard::Admit(const std::string& key, uint64_t now_ms,
+                                                        uint64_t wait_timeout_ms) {
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (IsNotFoundLocked(key, now_ms)) {
+      return Admission::kNotFound;
+    }
+    if (warm_keys_.count(key) > 0) {
+      return Admission::kWarm;
+    }
+  }
+
+  std::shared_ptr<Flight> flight;
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto not_found = not_found_keys_.find(key);
+    if (not_found != not_found_keys_.end()) {
+      if (now_ms < not_found->second) {
+        return Admission::kNotFound;
+      }
+      not_found_keys_.erase(not_found);
+    }
+    if (warm_keys_.count(key) > 0) {
+      return Admission::kWarm;
+    }
+
+    auto iter = flights_.find(key);
+    if (iter == flights_.end()) {
+      // First lookup, or the previous leader failed
+      flights_.emplace(key, std::make_shared<Flight>());
+      return Admission::kLeader;
+    }
+    flight = iter->second;
+  }
+
+  // Wait for the leader, if it takes too long or fails the follower looks up by itself, which is the behavior without
+  // guard
+  Wait(*flight, std::min(options_.wait_timeout_ms, wait_timeout_ms));
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return IsNotFoundLocked(key, now_ms) ? Admission::kNotFound : Admission::kWarm;
+}
+
+void ServiceLookupGuard::Complete(const std::string& key, Admission admission, Result result, uint64_t now_ms) {
+  if (admission != Admission::kLeader) {
+    if (result == Result::kError) {
+      return;
+    }
+    // The usual result of a warm lookup changes nothing
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (result == Result::kFound && warm_keys_.count(key) > 0 && not_found_keys_.count(key) == 0) {
+      return;
+    }
+  }
+
+  std::shared_ptr<Flight> flight;
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    switch (result) {
+      case Result::kFound:
+        warm_keys_.insert(key);
+        not_found_keys_.erase(key);
+        break;
+      case Result::kNotFound:
+        // The service may have been deleted since it was warm
+        warm_keys_.erase(key);
+        if (options_.enable_negative_cache) {
+          not_found_keys_[key] = now_ms + options_.negative_ttl_ms;
+        }
+        break;
+      default:
+        break;
+    }
+
+    if (admission == Admission::kLeader) {
+      auto iter = flights_.find(key);
+      if (iter != flights_.end()) {
+        flight = std::move(iter->second);
+        flights_.erase(iter);
+      }
+    }
+  }
+  if (flight) {
+    Finish(*flight);
+  }
+}
+
+bool ServiceLookupGuard::IsNotFound(const std::string& key, uint64_t now_ms) {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return IsNotFoundLocked(key, now_ms);
+}
+
+void ServiceLookupGuard::Clear() {
+  std::vector<std::shared_ptr<Flight>> flights;
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    for (auto& item : flights_) {
+      flights.push_back(std::move(item.second));
+    }
+    warm_keys_.clear();
+    flights_.clear();
+    not_found_keys_.clear();
+  }
+  for (auto& flight : flights) {
+    Finish(*flight);
+  }
+}
+
+void ServiceLookupGuard::Wait(Flight& flight, uint64_t timeout_ms) {
+  auto is_done = [&flight]() { return flight.done.load(std::memory_order_acquire); };
+  if (IsRunningInFiberWorker()) {
+    std::unique_lock<FiberMutex> lock(flight.fiber_mutex);
+    flight.fiber_cond.wait_for(lock, std::chrono::milliseconds(timeout_ms), is_done);
+  } else {
+    std::unique_lock<std::mutex> lock(flight.mutex);
+    flight.cond.wait_for(lock, std::chrono::milliseconds(timeout_ms), is_done);
+  }
+}
+
+void ServiceLookupGuard::Finish(Flight& flight) {
+  flight.done.store(true, std::memory_order_release);
+  // Taking the locks orders the wake-up after the check of the waiters which have not slept yet
+  {
+    std::lock_guard<FiberMutex> lock(flight.fiber_mutex);
+  }
+  flight.fiber_cond.notify_all();
+  {
+    std::lock_guard<std::mutex> lock(flight.mutex);
+  }
+  flight.cond.notify_all();
+}
+
+bool ServiceLookupGuard::IsNotFoundLocked(const std::string& key, uint64_t now_ms) const {
+  // The expired entries are removed by the next admission which takes the exclusive lock
+  auto iter = not_found_keys_.find(key);
+  return iter != not_found_keys_.end() && now_ms < iter->second;
+}
+
+}  // namespace trpc::naming::polarismesh
@@ -0,0 +1,110 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "trpc/coroutine/fiber_condition_variable.h"
+#include "trpc/coroutine/fiber_mutex.h"
+
+namespace trpc::naming::polarismesh {
+
+/// @brief Guards the lookups of services in the SDK.
+///        1. Single-flight: the first lookup of a service, which has to fetch the service data from the server, is
+///           performed by one caller only. The concurrent callers wait for it and then look up the warm local cache.
+///        2. Negative cache: a service which is not found fails fast until the ttl expires, instead of waiting for the
+///           SDK timeout every time.
+///        The lookups of the warm services only take a shared lock.
+class ServiceLookupGuard {
+ public:
+  struct Options {
+    /// Whether the "service not found" result is cached
+    bool enable_negative_cache{true};
+    /// How long the "service not found" result is cached, in ms
+    uint64_t negative_ttl_ms{5000};
+    /// Maximum time to wait for the lookup of the leader, in ms
+    uint64_t wait_timeout_ms{1000};
+  };
+
+  enum class Admission {
+    /// The service data is in the local cache, or the lookup of the leader took too long, look it up directly
+    kWarm,
+    /// First lookup of the service, the caller fetches it on behalf of the others
+    kLeader,
+    /// The service is known to be absent, fail fast
+    kNotFound,
+  };
+
+  enum class Result {
+    kFound,
+    kNotFound,
+    kError,
+  };
+
+  void SetOptions(const Options& options) { options_ = options; }
+
+  const Options& GetOptions() const { return options_; }
+
+  /// @brief Called before the lookup of a service, the caller may be blocked while another caller is fetching it. A
+  ///        caller in a fiber worker waits on a fiber primitive, so the worker keeps running the other fibers.
+  /// @param key Identity of the service, usually namespace and name
+  /// @param now_ms Current time in ms, used by the negative cache
+  /// @param wait_timeout_ms Maximum time to wait for the leader, usually the time left to the call, bounded by the
+  ///        wait timeout of the options
+  Admission Admit(const std::string& key, uint64_t now_ms, uint64_t wait_timeout_ms);
+
+  /// @brief Called after the lookup with the admission returned by Admit
+  void Complete(const std::string& key, Admission admission, Result result, uint64_t now_ms);
+
+  /// @brief Whether key is in the negative cache at now_ms
+  bool IsNotFound(const std::string& key, uint64_t now_ms);
+
+  void Clear();
+
+ private:
+  // Lookup of a service by a leader, which the followers wait for
+  struct Flight {
+    std::atomic<bool> done{false};
+    // The followers in fiber workers wait on the fiber primitives, the others on the standard ones
+    std::mutex mutex;
+    std::condition_variable cond;
+    FiberMutex fiber_mutex;
+    FiberConditionVariable fiber_cond;
+  };
+
+  static void Wait(Flight& flight, uint64_t timeout_ms);
+
+  static void Finish(Flight& flight);
+
+  bool IsNotFoundLocked(const std::string& key, uint64_t now_ms) const;
+
+ private:
+  Options options_;
+  std::shared_mutex mutex_;
+  // Services whose data has been fetched successfully
+  std::unordered_set<std::string> warm_keys_;
+  // Services being fetched by a leader
+  std::unordered_map<std::string, std::shared_ptr<Flight>> flights_;
+  // Services not found, with the expire time in ms
+  std::unordered_map<std::string, uint64_t> not_found_keys_;
+};
+
+}  // namespace trpc::naming::polarismesh
@@ -0,0 +1,116 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#include "trpc/naming/polarismesh/service_lookup_guard.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace trpc::naming::polarismesh::testing {
+
+TEST(ServiceLookupGuardTest, NegativeCache) {
+  ServiceLookupGuard guard;
+  ServiceLookupGuard::Options options;
+  options.negative_ttl_ms = 100;
+  guard.SetOptions(options);
+
+  auto admission = guard.Admit("Test|missing", 0, 1000);
+  ASSERT_EQ(ServiceLookupGuard::Admission::kLeader, admission);
+  guard.Complete("Test|missing", admission, ServiceLookupGuard::Result::kNotFound, 0);
+
+  ASSERT_TRUE(guard.IsNotFound("Test|missing", 50));
+  ASSERT_EQ(ServiceLookupGuard::Admission::kNotFound, guard.Admit("Test|missing", 50, 1000));
+
+  // Expired, looked up again
+  ASSERT_EQ(ServiceLookupGuard::Admission::kLeader, guard.Admit("Test|missing", 100, 1000));
+  guard.Complete("Test|missing", ServiceLookupGuard::Admission::kLeader, ServiceLookupGuard::Result::kFound, 100);
+  ASSERT_EQ(ServiceLookupGuard::Admission::kWarm, guard.Admit("Test|missing", 101, 1000));
+
+  // Deleted after it was warm
+  guard.Complete("Test|missing", ServiceLookupGuard::Admission::kWarm, ServiceLookupGuard::Result::kNotFound, 200);
+  ASSERT_EQ(ServiceLookupGuard::Admission::kNotFound, guard.Admit("Test|missing", 201, 1000));
+}
+
+TEST(ServiceLookupGuardTest, DisableNegativeCache) {
+  ServiceLookupGuard guard;
+  ServiceLookupGuard::Options options;
+  options.enable_negative_cache = false;
+  guard.SetOptions(options);
+
+  auto admission = guard.Admit("Test|missing", 0, 1000);
+  guard.Complete("Test|missing", admission, ServiceLookupGuard::Result::kNotFound, 0);
+  ASSERT_FALSE(guard.IsNotFound("Test|missing", 1));
+  ASSERT_EQ(ServiceLookupGuard::Admission::kLeader, guard.Admit("Test|missing", 1, 1000));
+}
+
+TEST(ServiceLookupGuardTest, SingleFlight) {
+  ServiceLookupGuard guard;
+  ServiceLookupGuard::Options options;
+  options.wait_timeout_ms = 5000;
+  guard.SetOptions(options);
+
+  ASSERT_EQ(ServiceLookupGuard::Admission::kLeader, guard.Admit("Test|svc", 0, 1000));
+
+  std::atomic<int> warm_count{0};
+  std::vector<std::thread> followers;
+  for (int i = 0; i < 4; i++) {
+    followers.emplace_back([&guard, &warm_count]() {
+      if (guard.Admit("Test|svc", 0, 1000) == ServiceLookupGuard::Admission::kWarm) {
+        ++warm_count;
+      }
+    });
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_EQ(0, warm_count);
+  guard.Complete("Test|svc", ServiceLookupGuard::Admission::kLeader, ServiceLookupGuard::Result::kFound, 0);
+  for (auto& follower : followers) {
+    follower.join();
+  }
+  ASSERT_EQ(4, warm_count);
+}
+
+TEST(ServiceLookupGuardTest, LeaderFailed) {
+  ServiceLookupGuard guard;
+  ASSERT_EQ(ServiceLookupGuard::Admission::kLeader, guard.Admit("Test|svc", 0, 1000));
+  guard.Complete("Test|svc", ServiceLookupGuard::Admission::kLeader, ServiceLookupGuard::Result::kError, 0);
+
+  // Errors other than not found are not cached, the next caller becomes the leader
+  ASSERT_EQ(ServiceLookupGuard::Admission::kLeader, guard.Admit("Test|svc", 1, 1000));
+}
+
+TEST(ServiceLookupGuardTest, WaitBoundedByCaller) {
+  ServiceLookupGuard guard;
+  ServiceLookupGuard::Options options;
+  options.wait_timeout_ms = 5000;
+  guard.SetOptions(options);
+
+  ASSERT_EQ(ServiceLookupGuard::Admission::kLeader, guard.Admit("Test|svc", 0, 1000));
+  // A follower with little time left does not wait for the whole lookup of the leader
+  auto begin = std::chrono::steady_clock::now();
+  ASSERT_EQ(ServiceLookupGuard::Admission::kWarm, guard.Admit("Test|svc", 0, 10));
+  ASSERT_LT(std::chrono::steady_clock::now() - begin, std::chrono::milliseconds(1000));
+  guard.Complete("Test|svc", ServiceLookupGuard::Admission::kLeader, ServiceLookupGuard::Result::kFound, 0);
+
+  // Warm, the result of the next lookups changes nothing
+  ASSERT_EQ(ServiceLookupGuard::Admission::kWarm, guard.Admit("Test|svc", 1, 1000));
+  guard.Complete("Test|svc", ServiceLookupGuard::Admission::kWarm, ServiceLookupGuard::Result::kFound, 1);
+  guard.Complete("Test|svc", ServiceLookupGuard::Admission::kWarm, ServiceLookupGuard::Result::kError, 1);
+  ASSERT_EQ(ServiceLookupGuard::Admission::kWarm, guard.Admit("Test|svc", 2, 1000));
+}
+
+}  // namespace trpc::naming::polarismesh::testing
@@ -0,0 +1,89 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#include "trpc/naming/polarismesh/set_circuit_breaker.h"
+
+#include <unordered_set>
+
+namespace trpc::naming::polarismesh {
+
+std::string GetEndpointSetName(const std::map<std::string, std::string>& metadata) {
+  auto enable = metadata.find(kEnableSetKey);
+  if (enable == metadata.end() || enable->second != "Y") {
+    return "";
+  }
+  auto name = metadata.find(kSetNameKey);
+  return name != metadata.end() ? name->second : "";
+}
+
+std::string GetSetAreaWildcard(const std::string& set_name) {
+  auto first = set_name.find('.');
+  auto second = first != std::string::npos ? set_name.find('.', first + 1) : std::string::npos;
+  if (second == std::string::npos || second + 1 == set_name.size() ||
+      set_name.find('.', second + 1) != std::string::npos) {
+    return "";
+  }
+  return set_name.substr(0, second + 1) + "*";
+}
+
+std::string SetCircuitBreaker::GetFallbackSetName(const std::string& service, const std::string& set_name,
+                                                  uint64_t now_ms) {
+  auto open = GetOpenSets(service, now_ms);
+  if (!open) {
+    return set_name;
+  }
+
+  std::string wildcard = GetSetAreaWildcard(set_name);
+  if (wildcard != set_name && open->members.count(set_name) == 0) {
+    return set_name;
+  }
+  if (wildcard.empty()) {
+    return "";
+  }
+
+  // The area is kept while one of its sets is not known to be broken
+  std::string prefix = wildcard.substr(0, wildcard.size() - 1);
+  for (const auto& member : breakers_.GetMembers(service)) {
+    if (member.compare(0, prefix.size(), prefix) == 0 && open->members.count(member) == 0) {
+      return wildcard;
+    }
+  }
+  return "";
+}
+
+RoutedSnapshotPtr SetCircuitBreaker::Apply(const std::string& service, const std::string& key,
+                                           const RoutedSnapshotPtr& snapshot, uint64_t now_ms) {
+  if (!snapshot) {
+    return nullptr;
+  }
+  auto open = GetOpenSets(service, now_ms);
+  if (!open) {
+    return snapshot;
+  }
+
+  uint64_t revision = SignatureHasher().Add(snapshot->revision).Add(open->revision).Get();
+  auto result = snapshots_.Get(key, revision, snapshot, [&open](const RoutedSnapshotPtr& origin) {
+    std::unordered_set<std::string> addresses;
+    for (const auto& endpoint : origin->endpoints) {
+      std::string set_name = GetEndpointSetName(endpoint.meta);
+      if (!set_name.empty() && open->members.count(set_name) > 0) {
+        addresses.insert(GetEndpointAddress(endpoint));
+      }
+    }
+    return RemoveEndpoints(origin, addresses);
+  });
+  return result ? result : snapshot;
+}
+
+}  // namespace trpc::naming::polarismesh
@@ -0,0 +1,98 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "trpc/naming/polarismesh/circuit_breaker.h"
+#include "trpc/naming/polarismesh/snapshot_cache.h"
+
+namespace trpc::naming::polarismesh {
+
+/// Metadata of an instance enabling the set division, the same key as the set router of the SDK
+constexpr char kEnableSetKey[] = "internal-enable-set";
+
+/// Metadata of an instance holding its set name, "app.area.group"
+constexpr char kSetNameKey[] = "internal-set-name";
+
+/// @brief Set of an endpoint from its metadata
+/// @return std::string Empty if the set division of the endpoint is off
+std::string GetEndpointSetName(const std::map<std::string, std::string>& metadata);
+
+/// @brief Wildcard set name of the area of a set, "app.area.*" for "app.area.group"
+/// @return std::string Empty if the set name is not made of three parts
+std::string GetSetAreaWildcard(const std::string& set_name);
+
+/// @brief Circuit breakers per set of a callee. The results and latencies of the calls routed to a set are counted
+///        together, and the breaker of the set opens when its error rate or slow call rate reaches the threshold, so
+///        a failing set is cut off as a whole instead of instance by instance, and its calls fall back to the other
+///        sets of its area.
+class SetCircuitBreaker {
+ public:
+  using Options = CircuitBreakerOptions;
+
+  void SetOptions(const Options& options) { breakers_.SetOptions(options); }
+
+  const Options& GetOptions() const { return breakers_.GetOptions(); }
+
+  /// @brief Record the result of a call routed to a set
+  /// @param service Callee of the call
+  /// @param set_name Set of the endpoint called
+  /// @param latency_ms Latency of the call, checked against the slow call threshold
+  void Report(const std::string& service, const std::string& set_name, bool success, uint64_t latency_ms,
+              uint64_t now_ms) {
+    breakers_.Report(service, set_name, success, latency_ms, now_ms);
+  }
+
+  /// @brief State of the breaker of a set at now_ms
+  BreakerState GetState(const std::string& service, const std::string& set_name, uint64_t now_ms) {
+    return breakers_.GetState(service, set_name, now_ms);
+  }
+
+  /// @brief A call was routed to a set, it takes a probe of the breaker of the set if half-open
+  void Acquire(const std::string& service, const std::string& set_name, uint64_t now_ms) {
+    breakers_.Acquire(service, set_name, now_ms);
+  }
+
+  /// @brief Get the sets of service whose breaker is open at now_ms
+  /// @return OpenBreakersPtr nullptr if none is open
+  OpenBreakersPtr GetOpenSets(const std::string& service, uint64_t now_ms) {
+    return breakers_.GetOpenBreakers(service, now_ms);
+  }
+
+  /// @brief Set name the calls to set_name should be routed with. It is set_name unless its breaker is open, then the
+  ///        wildcard of its area while some of the known sets of the area are not open
+  /// @param set_name Set name requested by the call, a set or the wildcard of an area
+  /// @return std::string Empty means the call should leave the set division
+  std::string GetFallbackSetName(const std::string& service, const std::string& set_name, uint64_t now_ms);
+
+  /// @brief Get the snapshot of key without the endpoints of the open sets, the filtered snapshot is kept until the
+  ///        open sets or the snapshot change
+  /// @return RoutedSnapshotPtr snapshot itself when none of its endpoints is cut off, or all of them are
+  RoutedSnapshotPtr Apply(const std::string& service, const std::string& key, const RoutedSnapshotPtr& snapshot,
+                          uint64_t now_ms);
+
+  void Clear() {
+    breakers_.Clear();
+    snapshots_.Clear();
+  }
+
+ private:
+  CircuitBreakerGroups breakers_;
+  SnapshotTableCache<RoutedSnapshot> snapshots_;
+};
+
+}  // namespace trpc::naming::polarismesh
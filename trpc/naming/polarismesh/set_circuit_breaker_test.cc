@@ -0,0 +1,106 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#include "trpc/naming/polarismesh/set_circuit_breaker.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+
+namespace trpc::naming::polarismesh::testing {
+
+namespace {
+
+TrpcEndpointInfo MakeEndpoint(const std::string& host, const std::string& set_name) {
+  TrpcEndpointInfo endpoint;
+  endpoint.host = host;
+  endpoint.port = 80;
+  endpoint.weight = 100;
+  if (!set_name.empty()) {
+    endpoint.meta[kEnableSetKey] = "Y";
+    endpoint.meta[kSetNameKey] = set_name;
+  }
+  return endpoint;
+}
+
+SetCircuitBreaker::Options MakeOptions() {
+  SetCircuitBreaker::Options options;
+  options.min_requests = 2;
+  options.error_rate_percent = 50;
+  options.sleep_window_ms = 1000;
+  return options;
+}
+
+}  // namespace
+
+TEST(SetCircuitBreakerTest, SetName) {
+  ASSERT_EQ("app.sz.1", GetEndpointSetName(MakeEndpoint("127.0.0.1", "app.sz.1").meta));
+  ASSERT_EQ("", GetEndpointSetName(MakeEndpoint("127.0.0.1", "").meta));
+  auto endpoint = MakeEndpoint("127.0.0.1", "app.sz.1");
+  endpoint.meta[kEnableSetKey] = "N";
+  ASSERT_EQ("", GetEndpointSetName(endpoint.meta));
+
+  ASSERT_EQ("app.sz.*", GetSetAreaWildcard("app.sz.1"));
+  ASSERT_EQ("app.sz.*", GetSetAreaWildcard("app.sz.*"));
+  ASSERT_EQ("", GetSetAreaWildcard("app.sz"));
+  ASSERT_EQ("", GetSetAreaWildcard("app.sz."));
+}
+
+TEST(SetCircuitBreakerTest, Fallback) {
+  SetCircuitBreaker breaker;
+  breaker.SetOptions(MakeOptions());
+
+  breaker.Report("svc", "app.sz.1", true, 10, 0);
+  breaker.Report("svc", "app.sz.2", true, 10, 0);
+  ASSERT_EQ("app.sz.1", breaker.GetFallbackSetName("svc", "app.sz.1", 0));
+
+  breaker.Report("svc", "app.sz.1", false, 10, 0);
+  ASSERT_EQ(BreakerState::kOpen, breaker.GetState("svc", "app.sz.1", 0));
+  ASSERT_EQ("app.sz.*", breaker.GetFallbackSetName("svc", "app.sz.1", 0));
+  ASSERT_EQ("app.sz.2", breaker.GetFallbackSetName("svc", "app.sz.2", 0));
+  ASSERT_EQ("app.sz.*", breaker.GetFallbackSetName("svc", "app.sz.*", 0));
+
+  // The whole area is broken, the calls leave the set division
+  breaker.Report("svc", "app.sz.2", false, 10, 0);
+  ASSERT_EQ("", breaker.GetFallbackSetName("svc", "app.sz.1", 0));
+  ASSERT_EQ("", breaker.GetFallbackSetName("svc", "app.sz.*", 0));
+
+  // Let through again once the sleep window is over
+  ASSERT_EQ("app.sz.1", breaker.GetFallbackSetName("svc", "app.sz.1", 1000));
+}
+
+TEST(SetCircuitBreakerTest, Apply) {
+  SetCircuitBreaker breaker;
+  breaker.SetOptions(MakeOptions());
+
+  auto snapshot = std::make_shared<RoutedSnapshot>();
+  snapshot->endpoints = {MakeEndpoint("127.0.0.1", "app.sz.1"), MakeEndpoint("127.0.0.2", "app.sz.2"),
+                         MakeEndpoint("127.0.0.3", "")};
+  snapshot->revision = CalculateEndpointsRevision(snapshot->endpoints);
+  RoutedSnapshotPtr origin = snapshot;
+
+  ASSERT_EQ(origin, breaker.Apply("svc", "key", origin, 0));
+
+  breaker.Report("svc", "app.sz.1", false, 10, 0);
+  breaker.Report("svc", "app.sz.1", false, 10, 0);
+  auto result = breaker.Apply("svc", "key", origin, 0);
+  ASSERT_EQ(2, result->endpoints.size());
+  ASSERT_EQ("127.0.0.2", result->endpoints[0].host);
+  ASSERT_EQ("127.0.0.3", result->endpoints[1].host);
+  ASSERT_EQ(result, breaker.Apply("svc", "key", origin, 0));
+
+  ASSERT_EQ(origin, breaker.Apply("svc", "key", origin, 1000));
+}
+
+}  // namespace trpc::naming::polarismesh::testing
@@ -0,0 +1,65 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#include "trpc/naming/polarismesh/sliding_window.h"
+
+#include <algorithm>
+
+namespace trpc::naming::polarismesh {
+
+SlidingWindow::SlidingWindow(uint64_t window_ms, uint32_t bucket_num) : bucket_num_(std::max<uint32_t>(1, bucket_num)) {
+  bucket_ms_ = std::max<uint64_t>(1, window_ms / bucket_num_);
+  buckets_ = std::make_unique<Bucket[]>(bucket_num_);
+}
+
+void SlidingWindow::Add(bool success, uint64_t now_ms, uint32_t count) {
+  uint64_t period = now_ms / bucket_ms_ + 1;
+  auto& bucket = buckets_[period % bucket_num_];
+  uint64_t current = bucket.period.load(std::memory_order_acquire);
+  if (current != period) {
+    if (current > period) {
+      // A late result of a bucket already recycled
+      return;
+    }
+    if (bucket.period.compare_exchange_strong(current, period, std::memory_order_acq_rel)) {
+      bucket.success.store(0, std::memory_order_relaxed);
+      bucket.failure.store(0, std::memory_order_relaxed);
+    }
+  }
+  (success ? bucket.success : bucket.failure).fetch_add(count, std::memory_order_relaxed);
+}
+
+SlidingWindow::Counts SlidingWindow::Get(uint64_t now_ms) const {
+  uint64_t period = now_ms / bucket_ms_ + 1;
+  Counts counts;
+  for (uint32_t i = 0; i < bucket_num_; ++i) {
+    const auto& bucket = buckets_[i];
+    uint64_t bucket_period = bucket.period.load(std::memory_order_acquire);
+    if (bucket_period != 0 && bucket_period <= period && bucket_period + bucket_num_ > period) {
+      counts.success += bucket.success.load(std::memory_order_relaxed);
+      counts.failure += bucket.failure.load(std::memory_order_relaxed);
+    }
+  }
+  return counts;
+}
+
+void SlidingWindow::Reset() {
+  for (uint32_t i = 0; i < bucket_num_; ++i) {
+    buckets_[i].period.store(0, std::memory_order_release);
+    buckets_[i].success.store(0, std::memory_order_relaxed);
+    buckets_[i].failure.store(0, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace trpc::naming::polarismesh
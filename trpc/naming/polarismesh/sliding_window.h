@@ -0,0 +1,61 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace trpc::naming::polarismesh {
+
+/// @brief Counts of successes and failures over a sliding time window, made of buckets which are recycled as the window
+///        moves. Adding a result is lock-free, a bucket is cleared by the first result of its new period: the results
+///        added to the bucket between the winning compare-and-swap of its period and the reset of its counts are lost,
+///        a small undercount the rates tolerate.
+class SlidingWindow {
+ public:
+  struct Counts {
+    uint64_t success{0};
+    uint64_t failure{0};
+
+    uint64_t Total() const { return success + failure; }
+  };
+
+  /// @param window_ms Length of the window, in ms
+  /// @param bucket_num Number of buckets of the window, the window moves by one bucket at a time
+  explicit SlidingWindow(uint64_t window_ms, uint32_t bucket_num = 10);
+
+  void Add(bool success, uint64_t now_ms, uint32_t count = 1);
+
+  /// @brief Counts of the buckets in the window of now_ms
+  Counts Get(uint64_t now_ms) const;
+
+  /// @brief Clear the counts of all the buckets
+  void Reset();
+
+ private:
+  struct Bucket {
+    // Period of the bucket, the time divided by the bucket length plus 1, 0 marks a bucket never used
+    std::atomic<uint64_t> period{0};
+    std::atomic<uint32_t> success{0};
+    std::atomic<uint32_t> failure{0};
+  };
+
+  uint64_t bucket_ms_;
+  uint32_t bucket_num_;
+  std::unique_ptr<Bucket[]> buckets_;
+};
+
+}  // namespace trpc::naming::polarismesh
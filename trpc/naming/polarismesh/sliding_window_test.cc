@@ -0,0 +1,48 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#include "trpc/naming/polarismesh/sliding_window.h"
+
+#include "gtest/gtest.h"
+
+namespace trpc::naming::polarismesh::testing {
+
+TEST(SlidingWindowTest, Window) {
+  SlidingWindow window(10000, 10);
+  window.Add(true, 500, 8);
+  window.Add(false, 500, 2);
+  window.Add(false, 5500);
+
+  auto counts = window.Get(6000);
+  ASSERT_EQ(8, counts.success);
+  ASSERT_EQ(3, counts.failure);
+  ASSERT_EQ(11, counts.Total());
+
+  // The first bucket leaves the window
+  counts = window.Get(10500);
+  ASSERT_EQ(0, counts.success);
+  ASSERT_EQ(1, counts.failure);
+
+  // Its slot is recycled by a new period, a late result of the old one is dropped
+  window.Add(true, 10500);
+  window.Add(true, 500);
+  counts = window.Get(10500);
+  ASSERT_EQ(1, counts.success);
+  ASSERT_EQ(1, counts.failure);
+
+  window.Reset();
+  ASSERT_EQ(0, window.Get(10500).Total());
+}
+
+}  // namespace trpc::naming::polarismesh::testing
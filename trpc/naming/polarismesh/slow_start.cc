@@ -0,0 +1,78 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#include "trpc/naming/polarismesh/slow_start.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace trpc::naming::polarismesh {
+
+bool ParseSlowStartCurve(const std::string& name, SlowStartCurve& curve) {
+  if (name == "linear") {
+    curve = SlowStartCurve::kLinear;
+    return true;
+  }
+  if (name == "aggressive") {
+    curve = SlowStartCurve::kAggressive;
+    return true;
+  }
+  return false;
+}
+
+double GetSlowStartFactor(uint64_t elapsed_ms, const SlowStartOptions& options) {
+  if (elapsed_ms >= options.window_ms) {
+    return 1.0;
+  }
+
+  double progress = static_cast<double>(elapsed_ms) / options.window_ms;
+  if (options.curve == SlowStartCurve::kAggressive) {
+    progress = std::pow(progress, 1.0 / std::max(options.aggression, 1.0));
+  }
+  double min_factor = std::min<uint32_t>(options.min_weight_percent, 100) / 100.0;
+  return std::max(progress, min_factor);
+}
+
+RoutedSnapshotPtr BuildSlowStartSnapshot(const RoutedSnapshot& snapshot, const SlowStartOptions& options,
+                                         uint64_t now_ms) {
+  auto ramped = std::make_shared<RoutedSnapshot>(snapshot);
+  for (size_t i = 0; i < ramped->endpoints.size() && i < ramped->first_seen_ms.size(); ++i) {
+    auto& endpoint = ramped->endpoints[i];
+    uint64_t first_seen_ms = ramped->first_seen_ms[i];
+    if (first_seen_ms == 0 || endpoint.weight == 0) {
+      continue;
+    }
+    double factor = GetSlowStartFactor(now_ms > first_seen_ms ? now_ms - first_seen_ms : 0, options);
+    endpoint.weight = std::max<uint32_t>(1, static_cast<uint32_t>(std::lround(endpoint.weight * factor)));
+  }
+  ramped->revision = CalculateEndpointsRevision(ramped->endpoints);
+  return ramped;
+}
+
+RoutedSnapshotPtr SlowStartCache::Apply(const std::string& key, const RoutedSnapshotPtr& snapshot, uint64_t now_ms) {
+  if (!snapshot || options_.window_ms == 0 || snapshot->last_join_ms == 0 ||
+      now_ms >= snapshot->last_join_ms + options_.window_ms) {
+    return snapshot;
+  }
+
+  uint64_t step_ms = std::max<uint64_t>(1, options_.window_ms / std::max<uint32_t>(options_.steps, 1));
+  uint64_t step = now_ms / step_ms;
+  uint64_t revision = SignatureHasher().Add(snapshot->revision).Add(step).Get();
+  auto ramped = snapshots_.Get(key, revision, snapshot, [this, now_ms](const RoutedSnapshotPtr& origin) {
+    return BuildSlowStartSnapshot(*origin, options_, now_ms);
+  });
+  return ramped ? ramped : snapshot;
+}
+
+}  // namespace trpc::naming::polarismesh
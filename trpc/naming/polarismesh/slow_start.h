@@ -0,0 +1,78 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "trpc/naming/polarismesh/snapshot_cache.h"
+
+namespace trpc::naming::polarismesh {
+
+/// @brief Shapes of the weight ramp of the endpoints in slow start
+enum class SlowStartCurve {
+  /// The weight grows in proportion to the elapsed part of the window
+  kLinear,
+  /// The weight grows as the aggression-th root of the elapsed part of the window, fast at first and slowly at last
+  kAggressive,
+};
+
+/// @brief Parse the curve name used in the configuration
+/// @param name "linear" or "aggressive"
+/// @param[out] curve The curve
+/// @return bool Whether the name is a known curve
+bool ParseSlowStartCurve(const std::string& name, SlowStartCurve& curve);
+
+struct SlowStartOptions {
+  /// Time for a new endpoint to ramp up to its full weight, in ms
+  uint64_t window_ms{60000};
+  SlowStartCurve curve{SlowStartCurve::kLinear};
+  /// Root of the aggressive curve, not less than 1
+  double aggression{2.0};
+  /// Weight of an endpoint which just joined, in percent of its full weight
+  uint32_t min_weight_percent{10};
+  /// Number of steps of the ramp, the weights and the balancing tables built from them change once per step
+  uint32_t steps{10};
+};
+
+/// @brief Fraction of its full weight given to an endpoint which joined elapsed_ms ago, in (0, 1]
+double GetSlowStartFactor(uint64_t elapsed_ms, const SlowStartOptions& options);
+
+/// @brief Build a copy of the snapshot with the weights of the endpoints in slow start ramped at now_ms
+/// @return RoutedSnapshotPtr The ramped snapshot, its revision is the content revision of the ramped endpoints
+RoutedSnapshotPtr BuildSlowStartSnapshot(const RoutedSnapshot& snapshot, const SlowStartOptions& options,
+                                         uint64_t now_ms);
+
+/// @brief Keeps the ramped snapshot of every selection key whose endpoints are in slow start. It is rebuilt once per
+///        step of the ramp, so the weighted balancers built from it follow the ramp without paying the build on every
+///        call
+class SlowStartCache {
+ public:
+  void SetOptions(const SlowStartOptions& options) { options_ = options; }
+
+  const SlowStartOptions& GetOptions() const { return options_; }
+
+  /// @brief Get the snapshot of key with the weights of the endpoints in slow start ramped at now_ms
+  /// @return RoutedSnapshotPtr snapshot itself when none of its endpoints is in slow start
+  RoutedSnapshotPtr Apply(const std::string& key, const RoutedSnapshotPtr& snapshot, uint64_t now_ms);
+
+  void Clear() { snapshots_.Clear(); }
+
+ private:
+  SlowStartOptions options_;
+  SnapshotTableCache<RoutedSnapshot> snapshots_;
+};
+
+}  // namespace trpc::naming::polarismesh
@@ -0,0 +1,101 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+
+#include "trpc/naming/polarismesh/slow_start.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace trpc::naming::polarismesh::testing {
+
+RoutedSnapshotPtr MakeSnapshot(const std::vector<uint64_t>& first_seen_ms) {
+  auto snapshot = std::make_shared<RoutedSnapshot>();
+  for (size_t i = 0; i < first_seen_ms.size(); ++i) {
+    TrpcEndpointInfo endpoint;
+    endpoint.host = "host" + std::to_string(i);
+    endpoint.port = 8080;
+    endpoint.weight = 100;
+    endpoint.status = 1;
+    snapshot->endpoints.push_back(endpoint);
+    snapshot->last_join_ms = std::max(snapshot->last_join_ms, first_seen_ms[i]);
+  }
+  snapshot->first_seen_ms = first_seen_ms;
+  snapshot->revision = CalculateEndpointsRevision(snapshot->endpoints);
+  return snapshot;
+}
+
+TEST(SlowStartTest, Factor) {
+  SlowStartCurve curve;
+  ASSERT_TRUE(ParseSlowStartCurve("aggressive", curve));
+  ASSERT_EQ(SlowStartCurve::kAggressive, curve);
+  ASSERT_FALSE(ParseSlowStartCurve("unknown", curve));
+
+  SlowStartOptions options;
+  options.window_ms = 10000;
+  options.min_weight_percent = 10;
+  ASSERT_DOUBLE_EQ(0.1, GetSlowStartFactor(0, options));
+  ASSERT_DOUBLE_EQ(0.5, GetSlowStartFactor(5000, options));
+  ASSERT_DOUBLE_EQ(1.0, GetSlowStartFactor(20000, options));
+
+  // The aggressive curve gives more weight early in the window
+  options.curve = SlowStartCurve::kAggressive;
+  options.aggression = 2.0;
+  ASSERT_DOUBLE_EQ(0.5, GetSlowStartFactor(2500, options));
+  ASSERT_DOUBLE_EQ(1.0, GetSlowStartFactor(10000, options));
+}
+
+TEST(SlowStartTest, BuildSnapshot) {
+  SlowStartOptions options;
+  options.window_ms = 10000;
+  auto snapshot = MakeSnapshot({0, 1000, 6000});
+
+  auto ramped = BuildSlowStartSnapshot(*snapshot, options, 6000);
+  ASSERT_EQ(100, ramped->endpoints[0].weight);
+  ASSERT_EQ(50, ramped->endpoints[1].weight);
+  ASSERT_EQ(10, ramped->endpoints[2].weight);
+  ASSERT_EQ(CalculateEndpointsRevision(ramped->endpoints), ramped->revision);
+  ASSERT_NE(snapshot->revision, ramped->revision);
+  // The original snapshot is left untouched
+  ASSERT_EQ(100, snapshot->endpoints[2].weight);
+}
+
+TEST(SlowStartTest, Cache) {
+  SlowStartCache cache;
+  SlowStartOptions options;
+  options.window_ms = 10000;
+  options.steps = 10;
+  cache.SetOptions(options);
+
+  // Nothing to ramp
+  auto settled = MakeSnapshot({0, 0});
+  ASSERT_EQ(settled, cache.Apply("key", settled, 5000));
+
+  auto snapshot = MakeSnapshot({0, 1000});
+  auto ramped = cache.Apply("key", snapshot, 6000);
+  ASSERT_NE(snapshot, ramped);
+  ASSERT_EQ(50, ramped->endpoints[1].weight);
+  // Reused in the same step, rebuilt in the next one
+  ASSERT_EQ(ramped, cache.Apply("key", snapshot, 6500));
+  auto next = cache.Apply("key", snapshot, 7000);
+  ASSERT_NE(ramped, next);
+  ASSERT_EQ(60, next->endpoints[1].weight);
+
+  // The window has passed
+  ASSERT_EQ(snapshot, cache.Apply("key", snapshot, 11000));
+}
+
+}  // namespace trpc::naming::polarismesh::testing
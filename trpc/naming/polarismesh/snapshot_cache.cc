@@ -0,0 +1,378 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#include "trpc/naming/polarismesh/snapshot_cache.h"
+
+#include <algorithm>
+#include <random>
+
+namespace trpc::naming::polarismesh {
+
+namespace {
+
+constexpr uint64_t kFnvOffsetBasis = 14695981039346656037ULL;
+constexpr uint64_t kFnvPrime = 1099511628211ULL;
+
+inline void FnvMix(uint64_t& hash, const void* data, size_t len) {
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < len; ++i) {
+    hash ^= bytes[i];
+    hash *= kFnvPrime;
+  }
+}
+
+}  // namespace
+
+SignatureHasher& SignatureHasher::Add(const std::string& value) {
+  FnvMix(hash_, value.data(), value.size());
+  // Not a valid byte of UTF-8, so "a" + "bc" and "ab" + "c" sign differently
+  constexpr unsigned char kSeparator = 0xFF;
+  FnvMix(hash_, &kSeparator, sizeof(kSeparator));
+  return *this;
+}
+
+SignatureHasher& SignatureHasher::Add(uint64_t value) {
+  FnvMix(hash_, &value, sizeof(value));
+  return *this;
+}
+
+uint64_t CalculateEndpointsRevision(const std::vector<TrpcEndpointInfo>& endpoints) {
+  uint64_t hash = kFnvOffsetBasis;
+  for (const auto& endpoint : endpoints) {
+    FnvMix(hash, endpoint.host.data(), endpoint.host.size());
+    FnvMix(hash, &endpoint.port, sizeof(endpoint.port));
+    FnvMix(hash, &endpoint.weight, sizeof(endpoint.weight));
+    FnvMix(hash, &endpoint.status, sizeof(endpoint.status));
+  }
+  return hash;
+}
+
+std::string GetEndpointAddress(const TrpcEndpointInfo& endpoint) {
+  return endpoint.host + ":" + std::to_string(endpoint.port);
+}
+
+RoutedSnapshotPtr RemoveEndpoints(const RoutedSnapshotPtr& snapshot, const std::unordered_set<std::string>& addresses) {
+  const auto& endpoints = snapshot->endpoints;
+  std::vector<uint32_t> kept;
+  kept.reserve(endpoints.size());
+  for (uint32_t i = 0; i < endpoints.size(); ++i) {
+    if (addresses.count(GetEndpointAddress(endpoints[i])) == 0) {
+      kept.push_back(i);
+    }
+  }
+  if (kept.size() == endpoints.size()) {
+    return snapshot;
+  }
+  if (kept.empty()) {
+    return nullptr;
+  }
+
+  auto result = std::make_shared<RoutedSnapshot>();
+  bool has_locations = snapshot->locations.size() == endpoints.size();
+  bool has_first_seen = snapshot->first_seen_ms.size() == endpoints.size();
+  for (auto index : kept) {
+    result->endpoints.push_back(endpoints[index]);
+    if (has_locations) {
+      result->locations.push_back(snapshot->locations[index]);
+    }
+    if (has_first_seen) {
+      result->first_seen_ms.push_back(snapshot->first_seen_ms[index]);
+    }
+  }
+  result->revision = CalculateEndpointsRevision(result->endpoints);
+  result->update_time_ms = snapshot->update_time_ms;
+  result->source_version = snapshot->source_version;
+  result->last_join_ms = snapshot->last_join_ms;
+  return result;
+}
+
+int PickFromSnapshot(const RoutedSnapshot& snapshot, const std::string& hash_key, uint32_t num,
+                     std::vector<TrpcEndpointInfo>& endpoints) {
+  if (snapshot.endpoints.empty()) {
+    return -1;
+  }
+
+  // Prefer the healthy endpoints, fall back to all of them when none is healthy
+  std::vector<const TrpcEndpointInfo*> candidates;
+  candidates.reserve(snapshot.endpoints.size());
+  for (const auto& endpoint : snapshot.endpoints) {
+    if (endpoint.status) {
+      candidates.push_back(&endpoint);
+    }
+  }
+  if (candidates.empty()) {
+    for (const auto& endpoint : snapshot.endpoints) {
+      candidates.push_back(&endpoint);
+    }
+  }
+
+  num = std::max<uint32_t>(1, std::min<uint32_t>(num, candidates.size()));
+  size_t first = 0;
+  if (!hash_key.empty()) {
+    first = std::hash<std::string>{}(hash_key) % candidates.size();
+  } else {
+    thread_local std::mt19937_64 generator{std::random_device{}()};
+    uint64_t total_weight = 0;
+    for (const auto* candidate : candidates) {
+      total_weight += candidate->weight;
+    }
+    if (total_weight == 0) {
+      first = generator() % candidates.size();
+    } else {
+      uint64_t point = generator() % total_weight;
+      for (first = 0; first < candidates.size(); ++first) {
+        if (point < candidates[first]->weight) {
+          break;
+        }
+        point -= candidates[first]->weight;
+      }
+    }
+  }
+
+  // The rest are the neighbors of the first one, which keeps the backup nodes stable as well
+  endpoints.reserve(endpoints.size() + num);
+  for (uint32_t i = 0; i < num; ++i) {
+    endpoints.push_back(*candidates[(first + i) % candidates.size()]);
+  }
+  return 0;
+}
+
+void RoutedSnapshotCache::SetAsyncRefresh(bool async_refresh) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  async_refresh_ = async_refresh;
+}
+
+bool RoutedSnapshotCache::NeedSnapshot(const std::string& key, uint64_t now_ms, uint64_t source_version) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = entries_.find(key);
+  if (iter == entries_.end() || !iter->second.snapshot || iter->second.degraded) {
+    return true;
+  }
+  const auto& snapshot = iter->second.snapshot;
+  if (source_version != 0 && snapshot->source_version != source_version) {
+    return true;
+  }
+  return now_ms >= snapshot->update_time_ms + options_.snapshot_interval_ms;
+}
+
+void RoutedSnapshotCache::Update(const std::string& key, std::vector<TrpcEndpointInfo>&& endpoints, uint64_t now_ms,
+                                 uint64_t source_version, std::vector<EndpointLocation>&& locations) {
+  auto snapshot = std::make_shared<RoutedSnapshot>();
+  snapshot->revision = CalculateEndpointsRevision(endpoints);
+  snapshot->endpoints = std::move(endpoints);
+  if (locations.size() == snapshot->endpoints.size()) {
+    snapshot->locations = std::move(locations);
+  }
+  snapshot->update_time_ms = now_ms;
+  snapshot->source_version = source_version;
+  if (options_.track_first_seen) {
+    // Matched out of the lock, a concurrent update of the same key only tracks the joins against an older snapshot
+    TrackFirstSeen(Get(key), *snapshot, now_ms);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (entries_.find(key) == entries_.end()) {
+    EvictIfFull(now_ms);
+  }
+  auto& entry = entries_[key];
+  entry.snapshot = std::move(snapshot);
+  entry.degraded = false;
+  entry.scheduled = false;
+  entry.refreshing = false;
+  entry.backoff_ms = 0;
+  entry.next_refresh_ms = 0;
+  entry.refresher = nullptr;
+}
+
+void RoutedSnapshotCache::TrackFirstSeen(const RoutedSnapshotPtr& previous, RoutedSnapshot& snapshot,
+                                         uint64_t now_ms) {
+  snapshot.first_seen_ms.assign(snapshot.endpoints.size(), 0);
+  if (!previous) {
+    return;
+  }
+
+  std::unordered_map<std::string, uint64_t> first_seen;
+  first_seen.reserve(previous->endpoints.size());
+  for (size_t i = 0; i < previous->endpoints.size(); ++i) {
+    const auto& endpoint = previous->endpoints[i];
+    uint64_t seen_ms = i < previous->first_seen_ms.size() ? previous->first_seen_ms[i] : 0;
+    first_seen.emplace(GetEndpointAddress(endpoint), seen_ms);
+  }
+  for (size_t i = 0; i < snapshot.endpoints.size(); ++i) {
+    const auto& endpoint = snapshot.endpoints[i];
+    auto iter = first_seen.find(GetEndpointAddress(endpoint));
+    snapshot.first_seen_ms[i] = iter != first_seen.end() ? iter->second : now_ms;
+    snapshot.last_join_ms = std::max(snapshot.last_join_ms, snapshot.first_seen_ms[i]);
+  }
+}
+
+RoutedSnapshotPtr RoutedSnapshotCache::Get(const std::string& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = entries_.find(key);
+  if (iter == entries_.end()) {
+    return nullptr;
+  }
+  return iter->second.snapshot;
+}
+
+RoutedSnapshotPtr RoutedSnapshotCache::OnFailure(const std::string& key, uint64_t now_ms, Refresher refresher) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = entries_.find(key);
+  if (iter == entries_.end()) {
+    // Nothing to serve, no entry is created so that the failures of unknown keys do not grow the cache
+    return nullptr;
+  }
+
+  auto& entry = iter->second;
+  if (!entry.snapshot) {
+    // Only scheduled for its first snapshot, which failed
+    entries_.erase(iter);
+    return nullptr;
+  }
+  entry.scheduled = false;
+  if (!entry.degraded) {
+    entry.degraded = true;
+    entry.backoff_ms = options_.min_backoff_ms;
+  } else {
+    entry.backoff_ms = std::min(std::max(entry.backoff_ms * 2, options_.min_backoff_ms), options_.max_backoff_ms);
+  }
+  entry.refreshing = false;
+  entry.next_refresh_ms = now_ms + entry.backoff_ms;
+  entry.refresher = std::move(refresher);
+  return GetServable(entry, now_ms);
+}
+
+RoutedSnapshotPtr RoutedSnapshotCache::GetIfDegraded(const std::string& key, uint64_t now_ms) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = entries_.find(key);
+  if (iter == entries_.end() || !iter->second.degraded) {
+    return nullptr;
+  }
+
+  auto& entry = iter->second;
+  auto snapshot = GetServable(entry, now_ms);
+  if (!snapshot) {
+    // Nothing can be served anymore, go back to the normal lookup
+    return nullptr;
+  }
+
+  if (!async_refresh_ && !entry.refreshing && now_ms >= entry.next_refresh_ms) {
+    // No background thread, this caller performs the refresh and the others keep being served from the snapshot
+    entry.refreshing = true;
+    return nullptr;
+  }
+
+  return snapshot;
+}
+
+bool RoutedSnapshotCache::ScheduleRefresh(const std::string& key, uint64_t now_ms, Refresher refresher) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!async_refresh_) {
+    return false;
+  }
+
+  auto iter = entries_.find(key);
+  if (iter == entries_.end()) {
+    EvictIfFull(now_ms);
+    iter = entries_.emplace(key, Entry()).first;
+  }
+  auto& entry = iter->second;
+  // A degraded key is already refreshed with backoff
+  if (!entry.degraded && !entry.scheduled && !entry.refreshing) {
+    entry.scheduled = true;
+    entry.next_refresh_ms = now_ms;
+    entry.refresher = std::move(refresher);
+  }
+  return true;
+}
+
+void RoutedSnapshotCache::Erase(const std::string& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.erase(key);
+}
+
+std::vector<RoutedSnapshotCache::Refresher> RoutedSnapshotCache::ClaimDueRefreshes(uint64_t now_ms) {
+  std::vector<Refresher> refreshers;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& item : entries_) {
+    auto& entry = item.second;
+    if ((entry.degraded || entry.scheduled) && !entry.refreshing && entry.refresher &&
+        now_ms >= entry.next_refresh_ms) {
+      entry.refreshing = true;
+      refreshers.push_back(entry.refresher);
+    }
+  }
+  return refreshers;
+}
+
+uint64_t RoutedSnapshotCache::GetStalenessMs(const std::string& key, uint64_t now_ms) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = entries_.find(key);
+  if (iter == entries_.end() || !iter->second.snapshot || now_ms < iter->second.snapshot->update_time_ms) {
+    return 0;
+  }
+  return now_ms - iter->second.snapshot->update_time_ms;
+}
+
+size_t RoutedSnapshotCache::GetDegradedCount() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return std::count_if(entries_.begin(), entries_.end(), [](const auto& item) { return item.second.degraded; });
+}
+
+size_t RoutedSnapshotCache::Size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+void RoutedSnapshotCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+}
+
+RoutedSnapshotPtr RoutedSnapshotCache::GetServable(const Entry& entry, uint64_t now_ms) const {
+  if (!entry.snapshot || entry.snapshot->endpoints.empty()) {
+    return nullptr;
+  }
+  if (now_ms > entry.snapshot->update_time_ms + options_.max_staleness_ms) {
+    return nullptr;
+  }
+  return entry.snapshot;
+}
+
+void RoutedSnapshotCache::EvictIfFull(uint64_t now_ms) {
+  if (options_.max_entries == 0 || entries_.size() < options_.max_entries) {
+    return;
+  }
+
+  // The degraded keys are kept while their snapshot can be served, it may be the only thing that can be
+  auto victim = entries_.end();
+  uint64_t victim_update_time_ms = 0;
+  for (auto iter = entries_.begin(); iter != entries_.end(); ++iter) {
+    if (iter->second.degraded && GetServable(iter->second, now_ms)) {
+      continue;
+    }
+    uint64_t update_time_ms = iter->second.snapshot ? iter->second.snapshot->update_time_ms : 0;
+    if (victim == entries_.end() || update_time_ms < victim_update_time_ms) {
+      victim = iter;
+      victim_update_time_ms = update_time_ms;
+      if (update_time_ms == 0) {
+        break;
+      }
+    }
+  }
+  if (victim != entries_.end()) {
+    entries_.erase(victim);
+  }
+}
+
+}  // namespace trpc::naming::polarismesh
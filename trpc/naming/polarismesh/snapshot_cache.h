@@ -0,0 +1,321 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "trpc/naming/common/common_defs.h"
+
+namespace trpc::naming::polarismesh {
+
+/// @brief Location of an endpoint, as registered in the polarismesh server
+struct EndpointLocation {
+  std::string region;
+  std::string zone;
+  std::string campus;
+};
+
+/// @brief Routed endpoint set of one selection key, shared read-only between callers
+struct RoutedSnapshot {
+  std::vector<TrpcEndpointInfo> endpoints;
+  /// Locations of the endpoints in the same order, empty if unknown
+  std::vector<EndpointLocation> locations;
+  /// Content hash of the endpoint set, it changes whenever the routing result changes
+  uint64_t revision{0};
+  /// Time when the snapshot was fetched from the SDK, in ms
+  uint64_t update_time_ms{0};
+  /// Signature of the revisions of the SDK data the snapshot was routed with, 0 if unknown
+  uint64_t source_version{0};
+  /// Time when each endpoint was first seen in the snapshots of the key, in the same order, in ms. It is 0 for the
+  /// endpoints of the first snapshot of the key, whose age is unknown. Empty if not tracked
+  std::vector<uint64_t> first_seen_ms;
+  /// Latest of first_seen_ms
+  uint64_t last_join_ms{0};
+};
+
+using RoutedSnapshotPtr = std::shared_ptr<const RoutedSnapshot>;
+
+/// @brief Incremental 64-bit FNV-1a hash, used to sign the routing inputs and the revisions of the data they are routed
+///        with. The same values added in the same order give the same signature.
+class SignatureHasher {
+ public:
+  /// @brief Add a string, followed by a separator so that the boundaries of the values are part of the signature
+  SignatureHasher& Add(const std::string& value);
+
+  SignatureHasher& Add(uint64_t value);
+
+  uint64_t Get() const { return hash_; }
+
+ private:
+  uint64_t hash_{14695981039346656037ULL};
+};
+
+/// @brief Calculate the content revision of a batch of endpoints
+uint64_t CalculateEndpointsRevision(const std::vector<TrpcEndpointInfo>& endpoints);
+
+/// @brief Address of an endpoint, "host:port"
+std::string GetEndpointAddress(const TrpcEndpointInfo& endpoint);
+
+/// @brief Remove endpoints from a snapshot by their addresses
+/// @param addresses Addresses of the endpoints removed, "host:port"
+/// @return RoutedSnapshotPtr The endpoints left, snapshot itself if none is removed and nullptr if all of them are
+RoutedSnapshotPtr RemoveEndpoints(const RoutedSnapshotPtr& snapshot, const std::unordered_set<std::string>& addresses);
+
+/// @brief Pick endpoints from a snapshot without the help of the SDK.
+///        Healthy endpoints are preferred, the pick is stable for the same hash key and weighted random otherwise
+/// @param snapshot The snapshot to pick from
+/// @param hash_key Hash key of the request, can be empty
+/// @param num Number of distinct endpoints needed
+/// @param[out] endpoints Picked endpoints
+/// @return int Success is 0, failure (empty snapshot) is -1
+int PickFromSnapshot(const RoutedSnapshot& snapshot, const std::string& hash_key, uint32_t num,
+                     std::vector<TrpcEndpointInfo>& endpoints);
+
+/// @brief Keeps a table derived from the routed snapshot of every selection key, such as a load balancing table. A
+///        table is rebuilt only when the revision of the snapshot changes, so the build cost is paid once per revision.
+///        The tables of the last few revisions of a key are kept, a key alternating between a few subsets (zones,
+///        locality tiers) does not rebuild them on every switch. The number of keys is bounded, the key whose table
+///        was built least recently is dropped for a new one.
+/// @tparam Table Type of the table
+template <typename Table>
+class SnapshotTableCache {
+ public:
+  using TablePtr = std::shared_ptr<const Table>;
+
+  /// Number of revisions whose tables are kept per key by default
+  static constexpr size_t kMaxRevisionsPerKey = 8;
+
+  /// Number of keys kept by default, the same as the default number of routed snapshots
+  static constexpr size_t kMaxKeys = 10000;
+
+  /// @param max_revisions_per_key Number of revisions whose tables are kept per key, the large tables keep fewer
+  /// @param max_keys Number of keys whose tables are kept
+  explicit SnapshotTableCache(size_t max_revisions_per_key = kMaxRevisionsPerKey, size_t max_keys = kMaxKeys)
+      : max_revisions_per_key_(std::max<size_t>(1, max_revisions_per_key)), max_keys_(std::max<size_t>(1, max_keys)) {}
+
+  /// @brief Get the table of key, build it from snapshot with builder if absent or built from another revision
+  /// @param builder Callable which takes the snapshot and returns the TablePtr, nullptr if it can not be built
+  template <typename Builder>
+  TablePtr Get(const std::string& key, const RoutedSnapshotPtr& snapshot, Builder&& builder) {
+    if (!snapshot) {
+      return nullptr;
+    }
+    return Get(key, snapshot->revision, snapshot, std::forward<Builder>(builder));
+  }
+
+  /// @brief The same as above, for the tables built from more than the snapshot
+  /// @param revision Revision of all the inputs of the table
+  template <typename Builder>
+  TablePtr Get(const std::string& key, uint64_t revision, const RoutedSnapshotPtr& snapshot, Builder&& builder) {
+    if (!snapshot) {
+      return nullptr;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto table = Find(key, revision);
+      if (table) {
+        return table;
+      }
+    }
+
+    // Built out of the lock, a concurrent build of the same revision is harmless
+    TablePtr table = builder(snapshot);
+    if (!table) {
+      return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto existing = Find(key, revision);
+    if (existing) {
+      return existing;
+    }
+    auto iter = tables_.find(key);
+    if (iter == tables_.end()) {
+      if (tables_.size() >= max_keys_) {
+        tables_.erase(build_order_.front());
+        build_order_.pop_front();
+      }
+      build_order_.push_back(key);
+      iter = tables_.emplace(key, KeyTables()).first;
+      iter->second.order = std::prev(build_order_.end());
+    } else {
+      build_order_.splice(build_order_.end(), build_order_, iter->second.order);
+    }
+    auto& tables = iter->second.tables;
+    while (tables.size() >= max_revisions_per_key_) {
+      tables.erase(tables.begin());
+    }
+    tables.emplace_back(revision, table);
+    return table;
+  }
+
+  /// @brief Number of keys
+  size_t Size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tables_.size();
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tables_.clear();
+    build_order_.clear();
+  }
+
+ private:
+  struct KeyTables {
+    // Oldest revision first
+    std::vector<std::pair<uint64_t, TablePtr>> tables;
+    // Position of the key in build_order_
+    std::list<std::string>::iterator order;
+  };
+
+  TablePtr Find(const std::string& key, uint64_t revision) const {
+    auto iter = tables_.find(key);
+    if (iter == tables_.end()) {
+      return nullptr;
+    }
+    for (const auto& item : iter->second.tables) {
+      if (item.first == revision) {
+        return item.second;
+      }
+    }
+    return nullptr;
+  }
+
+ private:
+  size_t max_revisions_per_key_;
+  size_t max_keys_;
+  std::mutex mutex_;
+  std::unordered_map<std::string, KeyTables> tables_;
+  // Keys by the time their last table was built, least recent first
+  std::list<std::string> build_order_;
+};
+
+/// @brief Keeps the last good routed snapshot of every selection key, and tracks the degraded state of the keys whose
+///        lookups in the SDK failed. Degraded keys are served from memory while the refresh is retried with backoff,
+///        so an unavailable control plane does not turn every selection into a timeout.
+class RoutedSnapshotCache {
+ public:
+  /// Refresh task of a degraded key, returns whether the refresh succeeded
+  using Refresher = std::function<bool()>;
+
+  struct Options {
+    /// Maximum age of a snapshot that can still be served, in ms
+    uint64_t max_staleness_ms{300000};
+    /// Interval of refreshing the snapshot while the SDK lookups are healthy, in ms
+    uint64_t snapshot_interval_ms{10000};
+    /// Initial backoff of the refresh after a failure, in ms
+    uint64_t min_backoff_ms{1000};
+    /// Maximum backoff of the refresh after continuous failures, in ms
+    uint64_t max_backoff_ms{30000};
+    /// Maximum number of keys, the least recently updated healthy key is evicted for a new one. 0 means unbounded
+    size_t max_entries{0};
+    /// Whether the time when every endpoint joined the key is tracked across the snapshots
+    bool track_first_seen{false};
+  };
+
+  void SetOptions(const Options& options) { options_ = options; }
+
+  const Options& GetOptions() const { return options_; }
+
+  /// @brief Set whether the due refreshes are run by a background thread. If not, the first caller of a due key
+  ///        performs the refresh inline while the others keep being served from the snapshot
+  void SetAsyncRefresh(bool async_refresh);
+
+  /// @brief Whether the snapshot of key is missing, degraded or older than the snapshot interval
+  /// @param source_version Current signature of the revisions of the SDK data, the snapshot is also needed when it was
+  ///                       routed with other revisions. 0 means the revisions are unknown and only the age is checked
+  bool NeedSnapshot(const std::string& key, uint64_t now_ms, uint64_t source_version = 0);
+
+  /// @brief Store a good snapshot of key and clear its degraded state
+  /// @param source_version Signature of the revisions of the SDK data the endpoints were routed with
+  /// @param locations Locations of the endpoints in the same order, empty if unknown
+  void Update(const std::string& key, std::vector<TrpcEndpointInfo>&& endpoints, uint64_t now_ms,
+              uint64_t source_version = 0, std::vector<EndpointLocation>&& locations = {});
+
+  /// @brief Get the snapshot of key whatever its age, nullptr if absent
+  RoutedSnapshotPtr Get(const std::string& key);
+
+  /// @brief Record a failed lookup of key, the key turns degraded and its next refresh is delayed by the backoff. A
+  ///        key without a snapshot is not recorded, there is nothing to serve instead of the lookup
+  /// @param refresher Task used to refresh the key later
+  /// @return RoutedSnapshotPtr The snapshot that can be served instead, nullptr if absent or too stale
+  RoutedSnapshotPtr OnFailure(const std::string& key, uint64_t now_ms, Refresher refresher);
+
+  /// @brief Called before the lookup in the SDK
+  /// @return RoutedSnapshotPtr The snapshot to serve if key is degraded, nullptr means the caller should do the lookup
+  RoutedSnapshotPtr GetIfDegraded(const std::string& key, uint64_t now_ms);
+
+  /// @brief Hand the refresh of a key whose snapshot is missing or old to the background refresh thread
+  /// @param refresher Task used to refresh the key
+  /// @return bool false if there is no background thread, the caller refreshes the key itself
+  bool ScheduleRefresh(const std::string& key, uint64_t now_ms, Refresher refresher);
+
+  /// @brief Drop the snapshot of key, such as when its service does not exist any more
+  void Erase(const std::string& key);
+
+  /// @brief Claim the refresh tasks of the degraded and the scheduled keys that are due, used by the background
+  ///        refresh thread
+  std::vector<Refresher> ClaimDueRefreshes(uint64_t now_ms);
+
+  /// @brief Age of the snapshot of key, 0 if absent
+  uint64_t GetStalenessMs(const std::string& key, uint64_t now_ms);
+
+  /// @brief Number of keys in degraded state
+  size_t GetDegradedCount();
+
+  /// @brief Number of keys
+  size_t Size();
+
+  void Clear();
+
+ private:
+  struct Entry {
+    RoutedSnapshotPtr snapshot;
+    bool degraded{false};
+    // Whether the refresh of the healthy key is handed to the background thread
+    bool scheduled{false};
+    bool refreshing{false};
+    uint64_t backoff_ms{0};
+    uint64_t next_refresh_ms{0};
+    Refresher refresher;
+  };
+
+  RoutedSnapshotPtr GetServable(const Entry& entry, uint64_t now_ms) const;
+
+  // Make room for a new key when the cache is full, called with the lock held
+  void EvictIfFull(uint64_t now_ms);
+
+  // Carry the first seen time of the endpoints over from the previous snapshot of the key
+  static void TrackFirstSeen(const RoutedSnapshotPtr& previous, RoutedSnapshot& snapshot, uint64_t now_ms);
+
+ private:
+  Options options_;
+  bool async_refresh_{false};
+  std::mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+};
+
+}  // namespace trpc::naming::polarismesh
@@ -0,0 +1,369 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#include "trpc/naming/polarismesh/snapshot_cache.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace trpc::naming::polarismesh::testing {
+
+std::vector<TrpcEndpointInfo> MakeEndpoints(int num) {
+  std::vector<TrpcEndpointInfo> endpoints;
+  for (int i = 1; i <= num; i++) {
+    TrpcEndpointInfo endpoint;
+    endpoint.host = "host" + std::to_string(i);
+    endpoint.port = 8080 + i;
+    endpoint.weight = 100;
+    endpoint.status = 1;
+    endpoints.push_back(endpoint);
+  }
+  return endpoints;
+}
+
+RoutedSnapshotCache::Options MakeOptions() {
+  RoutedSnapshotCache::Options options;
+  options.max_staleness_ms = 10000;
+  options.snapshot_interval_ms = 1000;
+  options.min_backoff_ms = 100;
+  options.max_backoff_ms = 400;
+  return options;
+}
+
+TEST(RoutedSnapshotCacheTest, UpdateAndNeedSnapshot) {
+  RoutedSnapshotCache cache;
+  cache.SetOptions(MakeOptions());
+
+  ASSERT_TRUE(cache.NeedSnapshot("key", 0));
+  cache.Update("key", MakeEndpoints(3), 1000);
+  ASSERT_FALSE(cache.NeedSnapshot("key", 1500));
+  ASSERT_TRUE(cache.NeedSnapshot("key", 2000));
+
+  auto snapshot = cache.Get("key");
+  ASSERT_NE(nullptr, snapshot);
+  ASSERT_EQ(3, snapshot->endpoints.size());
+  ASSERT_EQ(CalculateEndpointsRevision(MakeEndpoints(3)), snapshot->revision);
+  ASSERT_NE(CalculateEndpointsRevision(MakeEndpoints(2)), snapshot->revision);
+  ASSERT_EQ(500, cache.GetStalenessMs("key", 1500));
+}
+
+TEST(RoutedSnapshotCacheTest, SourceVersion) {
+  RoutedSnapshotCache cache;
+  cache.SetOptions(MakeOptions());
+
+  cache.Update("key", MakeEndpoints(3), 1000, 1);
+  ASSERT_FALSE(cache.NeedSnapshot("key", 1500, 1));
+  // The SDK data changed, the snapshot is needed at once
+  ASSERT_TRUE(cache.NeedSnapshot("key", 1500, 2));
+  // Unknown revisions only check the age
+  ASSERT_FALSE(cache.NeedSnapshot("key", 1500));
+  ASSERT_EQ(1, cache.Get("key")->source_version);
+}
+
+TEST(RoutedSnapshotCacheTest, MaxEntries) {
+  RoutedSnapshotCache cache;
+  auto options = MakeOptions();
+  options.max_entries = 2;
+  cache.SetOptions(options);
+
+  cache.Update("key1", MakeEndpoints(1), 1000);
+  cache.Update("key2", MakeEndpoints(1), 2000);
+  // A degraded key is kept whatever its age
+  cache.OnFailure("key1", 2500, nullptr);
+  cache.Update("key3", MakeEndpoints(1), 3000);
+  ASSERT_EQ(2, cache.Size());
+  ASSERT_NE(nullptr, cache.Get("key1"));
+  ASSERT_EQ(nullptr, cache.Get("key2"));
+
+  // Updating an existing key evicts nothing
+  cache.Update("key3", MakeEndpoints(2), 4000);
+  ASSERT_EQ(2, cache.Size());
+}
+
+TEST(RoutedSnapshotCacheTest, DegradedKeysBounded) {
+  RoutedSnapshotCache cache;
+  auto options = MakeOptions();
+  options.max_entries = 2;
+  cache.SetOptions(options);
+
+  // The failures of the keys without a snapshot add no entry
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(nullptr, cache.OnFailure("unknown" + std::to_string(i), 1000, nullptr));
+  }
+  ASSERT_EQ(0, cache.Size());
+  ASSERT_EQ(0, cache.GetDegradedCount());
+
+  // A degraded key whose snapshot is too stale to be served is evicted like the others
+  cache.Update("key1", MakeEndpoints(1), 1000);
+  cache.Update("key2", MakeEndpoints(1), 2000);
+  cache.OnFailure("key1", 2500, nullptr);
+  cache.OnFailure("key2", 2500, nullptr);
+  uint64_t stale_ms = 1000 + options.max_staleness_ms + 1;
+  cache.Update("key3", MakeEndpoints(1), stale_ms);
+  ASSERT_EQ(2, cache.Size());
+  ASSERT_EQ(nullptr, cache.Get("key1"));
+  ASSERT_NE(nullptr, cache.Get("key2"));
+}
+
+TEST(RoutedSnapshotCacheTest, TrackFirstSeen) {
+  RoutedSnapshotCache cache;
+  auto options = MakeOptions();
+  options.track_first_seen = true;
+  cache.SetOptions(options);
+
+  // The age of the endpoints of the first snapshot is unknown
+  cache.Update("key", MakeEndpoints(2), 1000);
+  ASSERT_EQ(std::vector<uint64_t>({0, 0}), cache.Get("key")->first_seen_ms);
+  ASSERT_EQ(0, cache.Get("key")->last_join_ms);
+
+  cache.Update("key", MakeEndpoints(3), 2000);
+  ASSERT_EQ(std::vector<uint64_t>({0, 0, 2000}), cache.Get("key")->first_seen_ms);
+  cache.Update("key", MakeEndpoints(4), 3000);
+  ASSERT_EQ(std::vector<uint64_t>({0, 0, 2000, 3000}), cache.Get("key")->first_seen_ms);
+  ASSERT_EQ(3000, cache.Get("key")->last_join_ms);
+
+  // An endpoint leaving and joining again starts over
+  cache.Update("key", MakeEndpoints(2), 4000);
+  cache.Update("key", MakeEndpoints(3), 5000);
+  ASSERT_EQ(std::vector<uint64_t>({0, 0, 5000}), cache.Get("key")->first_seen_ms);
+}
+
+TEST(SnapshotTableCacheTest, KeepsRecentRevisions) {
+  struct Table {
+    explicit Table(RoutedSnapshotPtr snapshot) : snapshot(std::move(snapshot)) {}
+    RoutedSnapshotPtr snapshot;
+  };
+  SnapshotTableCache<Table> cache;
+  int builds = 0;
+  auto builder = [&builds](const RoutedSnapshotPtr& snapshot) {
+    ++builds;
+    return std::make_shared<const Table>(snapshot);
+  };
+
+  RoutedSnapshotCache snapshots;
+  snapshots.Update("a", MakeEndpoints(1), 0);
+  snapshots.Update("b", MakeEndpoints(2), 0);
+  auto first = cache.Get("key", snapshots.Get("a"), builder);
+  auto second = cache.Get("key", snapshots.Get("b"), builder);
+  // Switching back to a recent revision reuses its table
+  ASSERT_EQ(first, cache.Get("key", snapshots.Get("a"), builder));
+  ASSERT_EQ(second, cache.Get("key", snapshots.Get("b"), builder));
+  ASSERT_EQ(2, builds);
+
+  // An explicit revision covers the inputs other than the snapshot
+  ASSERT_NE(first, cache.Get("key", 1, snapshots.Get("a"), builder));
+  ASSERT_EQ(3, builds);
+  ASSERT_EQ(nullptr, cache.Get("key", nullptr, builder));
+}
+
+TEST(SnapshotTableCacheTest, MaxRevisionsPerKey) {
+  struct Table {
+    explicit Table(RoutedSnapshotPtr snapshot) : snapshot(std::move(snapshot)) {}
+    RoutedSnapshotPtr snapshot;
+  };
+  SnapshotTableCache<Table> cache(2);
+  int builds = 0;
+  auto builder = [&builds](const RoutedSnapshotPtr& snapshot) {
+    ++builds;
+    return std::make_shared<const Table>(snapshot);
+  };
+
+  RoutedSnapshotCache snapshots;
+  snapshots.Update("a", MakeEndpoints(1), 0);
+  auto snapshot = snapshots.Get("a");
+  auto first = cache.Get("key", 1, snapshot, builder);
+  auto second = cache.Get("key", 2, snapshot, builder);
+  ASSERT_EQ(first, cache.Get("key", 1, snapshot, builder));
+  ASSERT_EQ(2, builds);
+
+  // The third revision drops the oldest one
+  cache.Get("key", 3, snapshot, builder);
+  ASSERT_EQ(second, cache.Get("key", 2, snapshot, builder));
+  ASSERT_NE(first, cache.Get("key", 1, snapshot, builder));
+  ASSERT_EQ(4, builds);
+}
+
+TEST(SnapshotTableCacheTest, MaxKeys) {
+  struct Table {
+    explicit Table(RoutedSnapshotPtr snapshot) : snapshot(std::move(snapshot)) {}
+    RoutedSnapshotPtr snapshot;
+  };
+  SnapshotTableCache<Table> cache(2, 2);
+  int builds = 0;
+  auto builder = [&builds](const RoutedSnapshotPtr& snapshot) {
+    ++builds;
+    return std::make_shared<const Table>(snapshot);
+  };
+
+  RoutedSnapshotCache snapshots;
+  snapshots.Update("a", MakeEndpoints(1), 0);
+  auto snapshot = snapshots.Get("a");
+  auto first = cache.Get("first", 1, snapshot, builder);
+  auto second = cache.Get("second", 1, snapshot, builder);
+  // A new table of the first key makes the second one the least recently built
+  cache.Get("first", 2, snapshot, builder);
+  ASSERT_EQ(3, builds);
+
+  cache.Get("third", 1, snapshot, builder);
+  ASSERT_EQ(2, cache.Size());
+  ASSERT_EQ(first, cache.Get("first", 1, snapshot, builder));
+  ASSERT_NE(second, cache.Get("second", 1, snapshot, builder));
+  ASSERT_EQ(5, builds);
+  ASSERT_EQ(2, cache.Size());
+}
+
+TEST(SignatureHasherTest, Boundaries) {
+  ASSERT_EQ(SignatureHasher().Add("ab").Add(1).Get(), SignatureHasher().Add("ab").Add(1).Get());
+  ASSERT_NE(SignatureHasher().Add("a").Add("bc").Get(), SignatureHasher().Add("ab").Add("c").Get());
+  ASSERT_NE(SignatureHasher().Add(1).Get(), SignatureHasher().Add(2).Get());
+}
+
+TEST(RoutedSnapshotCacheTest, ServeStaleWithBackoff) {
+  RoutedSnapshotCache cache;
+  cache.SetOptions(MakeOptions());
+
+  // No snapshot yet, nothing to serve
+  ASSERT_EQ(nullptr, cache.OnFailure("key", 0, nullptr));
+
+  cache.Update("key", MakeEndpoints(2), 1000);
+  ASSERT_EQ(nullptr, cache.GetIfDegraded("key", 1000));
+
+  int refresh_count = 0;
+  auto refresher = [&refresh_count]() {
+    ++refresh_count;
+    return false;
+  };
+  ASSERT_NE(nullptr, cache.OnFailure("key", 2000, refresher));
+  ASSERT_EQ(1, cache.GetDegradedCount());
+  ASSERT_TRUE(cache.NeedSnapshot("key", 2000));
+
+  // Within the backoff, the snapshot is served without the lookup
+  ASSERT_NE(nullptr, cache.GetIfDegraded("key", 2050));
+  ASSERT_TRUE(cache.ClaimDueRefreshes(2050).empty());
+
+  // Due: without background thread, only the first caller goes to the lookup
+  ASSERT_EQ(nullptr, cache.GetIfDegraded("key", 2100));
+  ASSERT_NE(nullptr, cache.GetIfDegraded("key", 2100));
+
+  // Failed again, the backoff doubles
+  cache.OnFailure("key", 2100, refresher);
+  ASSERT_NE(nullptr, cache.GetIfDegraded("key", 2250));
+  cache.SetAsyncRefresh(true);
+  ASSERT_NE(nullptr, cache.GetIfDegraded("key", 2300));
+  auto refreshers = cache.ClaimDueRefreshes(2300);
+  ASSERT_EQ(1, refreshers.size());
+  ASSERT_FALSE(refreshers[0]());
+  ASSERT_EQ(1, refresh_count);
+  ASSERT_TRUE(cache.ClaimDueRefreshes(2300).empty());
+
+  // Too stale to be served
+  ASSERT_EQ(nullptr, cache.GetIfDegraded("key", 20000));
+
+  // Recovered
+  cache.Update("key", MakeEndpoints(2), 20000);
+  ASSERT_EQ(0, cache.GetDegradedCount());
+  ASSERT_EQ(nullptr, cache.GetIfDegraded("key", 20000));
+}
+
+TEST(RoutedSnapshotCacheTest, ScheduleRefresh) {
+  RoutedSnapshotCache cache;
+  cache.SetOptions(MakeOptions());
+
+  int refresh_count = 0;
+  auto refresher = [&refresh_count]() {
+    ++refresh_count;
+    return false;
+  };
+  // Without background thread, the caller refreshes the key itself
+  ASSERT_FALSE(cache.ScheduleRefresh("key", 0, refresher));
+
+  cache.SetAsyncRefresh(true);
+  cache.Update("key", MakeEndpoints(2), 1000);
+  ASSERT_TRUE(cache.ScheduleRefresh("key", 2000, refresher));
+  ASSERT_TRUE(cache.ScheduleRefresh("key", 2000, refresher));
+  auto refreshers = cache.ClaimDueRefreshes(2000);
+  ASSERT_EQ(1, refreshers.size());
+  ASSERT_TRUE(cache.ClaimDueRefreshes(2000).empty());
+  refreshers[0]();
+  ASSERT_EQ(1, refresh_count);
+
+  // The scheduled refresh failed, the key is served from its snapshot with backoff
+  ASSERT_NE(nullptr, cache.OnFailure("key", 2000, refresher));
+  ASSERT_NE(nullptr, cache.GetIfDegraded("key", 2050));
+
+  // A key without a snapshot is dropped when its first refresh fails
+  ASSERT_TRUE(cache.ScheduleRefresh("other", 2000, refresher));
+  ASSERT_EQ(2, cache.Size());
+  ASSERT_EQ(1, cache.ClaimDueRefreshes(2000).size());
+  ASSERT_EQ(nullptr, cache.OnFailure("other", 2000, refresher));
+  ASSERT_EQ(1, cache.Size());
+
+  cache.Erase("key");
+  ASSERT_EQ(0, cache.Size());
+}
+
+TEST(PickFromSnapshotTest, Pick) {
+  RoutedSnapshot snapshot;
+  std::vector<TrpcEndpointInfo> endpoints;
+  ASSERT_EQ(-1, PickFromSnapshot(snapshot, "", 1, endpoints));
+
+  snapshot.endpoints = MakeEndpoints(4);
+  snapshot.endpoints[0].status = 0;
+
+  // Unhealthy endpoints are skipped
+  for (int i = 0; i < 100; i++) {
+    endpoints.clear();
+    ASSERT_EQ(0, PickFromSnapshot(snapshot, "", 1, endpoints));
+    ASSERT_EQ(1, endpoints.size());
+    ASSERT_NE("host1", endpoints[0].host);
+  }
+
+  // Stable for the same hash key
+  std::vector<TrpcEndpointInfo> hash_endpoints;
+  ASSERT_EQ(0, PickFromSnapshot(snapshot, "abc", 1, hash_endpoints));
+  for (int i = 0; i < 10; i++) {
+    endpoints.clear();
+    ASSERT_EQ(0, PickFromSnapshot(snapshot, "abc", 1, endpoints));
+    ASSERT_EQ(hash_endpoints[0].host, endpoints[0].host);
+  }
+
+  // Distinct endpoints for backup
+  endpoints.clear();
+  ASSERT_EQ(0, PickFromSnapshot(snapshot, "", 5, endpoints));
+  ASSERT_EQ(3, endpoints.size());
+  std::set<std::string> hosts;
+  for (const auto& endpoint : endpoints) {
+    hosts.insert(endpoint.host);
+  }
+  ASSERT_EQ(3, hosts.size());
+}
+
+TEST(RemoveEndpointsTest, Remove) {
+  auto snapshot = std::make_shared<RoutedSnapshot>();
+  snapshot->endpoints = MakeEndpoints(3);
+  snapshot->first_seen_ms = {0, 1000, 2000};
+  snapshot->revision = CalculateEndpointsRevision(snapshot->endpoints);
+
+  ASSERT_EQ(snapshot, RemoveEndpoints(snapshot, {"host1:8080"}));
+  auto result = RemoveEndpoints(snapshot, {"host2:8082"});
+  ASSERT_EQ(2, result->endpoints.size());
+  ASSERT_EQ("host3", result->endpoints[1].host);
+  ASSERT_EQ(std::vector<uint64_t>({0, 2000}), result->first_seen_ms);
+  ASSERT_EQ(CalculateEndpointsRevision(result->endpoints), result->revision);
+  ASSERT_EQ(nullptr, RemoveEndpoints(snapshot, {"host1:8081", "host2:8082", "host3:8083"}));
+}
+
+}  // namespace trpc::naming::polarismesh::testing
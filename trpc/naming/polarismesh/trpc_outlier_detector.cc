@@ -0,0 +1,110 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#include "trpc/naming/polarismesh/trpc_outlier_detector.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "trpc/client/make_client_context.h"
+#include "trpc/client/trpc_client.h"
+#include "trpc/codec/trpc/trpc.pb.h"
+#include "trpc/common/future/future_utility.h"
+#include "trpc/coroutine/fiber.h"
+#include "trpc/serialization/serialization_type.h"
+#include "trpc/util/log/logging.h"
+#include "trpc/util/time.h"
+
+namespace trpc {
+
+namespace {
+
+// Type of the results of the probes, as the tcp probe reports "tcp"
+constexpr char kDetectType[] = "trpc";
+
+// Sequence of the detectors, which names their proxies
+std::atomic<uint64_t> detector_seq{0};
+
+}  // namespace
+
+polaris::Plugin* TrpcOutlierDetectorFactory() { return new trpc::TrpcOutlierDetector(); }
+
+bool IsProbeAnswered(int framework_ret) {
+  // The codes of the server side are below the ones of the client side
+  return framework_ret >= 0 && framework_ret < trpc::TrpcRetCode::TRPC_CLIENT_INVOKE_TIMEOUT_ERR;
+}
+
+polaris::ReturnCode TrpcOutlierDetector::Init(polaris::Config* config, polaris::Context* context) {
+  func_name_ = config->GetStringOrDefault("func_name", "/trpc.polarismesh.probe.Probe/Ping");
+  timeout_ms_ = config->GetMsOrDefault("timeout", 1000);
+  protocol_ = config->GetStringOrDefault("protocol", "trpc");
+  proxy_name_ = "polarismesh_probe_" + std::to_string(detector_seq.fetch_add(1, std::memory_order_relaxed));
+  return polaris::ReturnCode::kReturnOk;
+}
+
+polaris::ReturnCode TrpcOutlierDetector::DetectInstance(polaris::Instance& instance,
+                                                       polaris::DetectResult& detect_result) {
+  detect_result.detect_type = kDetectType;
+  // A probe waiting for its answer would block the fiber worker and the fibers scheduled on it
+  if (IsRunningInFiberWorker()) {
+    TRPC_FMT_ERROR("Probe of {}:{} refused in a fiber worker", instance.GetHost(), instance.GetPort());
+    detect_result.elapse = 0;
+    detect_result.return_code = polaris::ReturnCode::kReturnInvalidState;
+    return polaris::ReturnCode::kReturnInvalidState;
+  }
+
+  uint64_t begin_ms = trpc::time::GetMilliSeconds();
+  int framework_ret = Probe(instance.GetHost(), instance.GetPort());
+  detect_result.elapse = trpc::time::GetMilliSeconds() - begin_ms;
+  if (IsProbeAnswered(framework_ret)) {
+    detect_result.return_code = polaris::ReturnCode::kReturnOk;
+  } else {
+    TRPC_FMT_DEBUG("Probe of {}:{} failed, framework ret:{}", instance.GetHost(), instance.GetPort(), framework_ret);
+    detect_result.return_code = polaris::ReturnCode::kReturnNetworkFailed;
+  }
+  return static_cast<polaris::ReturnCode>(detect_result.return_code);
+}
+
+int TrpcOutlierDetector::Probe(const std::string& host, int port) {
+  auto proxy = GetProxy(host + ":" + std::to_string(port));
+  auto context = MakeClientContext(proxy);
+  // The instance probed is set on the context, the proxy is shared by the instances of the service
+  context->SetAddr(host, port);
+  context->SetFuncName(func_name_);
+  context->SetTimeout(timeout_ms_);
+  context->SetReqEncodeType(serialization::kNoopType);
+  std::string request;
+  auto fut = future::BlockingGet(proxy->AsyncUnaryInvoke<std::string, std::string>(context, request));
+  if (fut.IsFailed()) {
+    TRPC_FMT_DEBUG("Probe of {}:{} failed: {}", host, port, fut.GetException().what());
+    return fut.GetException().GetExceptionCode();
+  }
+  return trpc::TrpcRetCode::TRPC_INVOKE_SUCCESS;
+}
+
+std::shared_ptr<RpcServiceProxy> TrpcOutlierDetector::GetProxy(const std::string& target) {
+  // Created by the first probe, the connections are reused by the next probes
+  std::call_once(proxy_once_, [this, &target]() {
+    ServiceProxyOption option;
+    option.name = proxy_name_;
+    option.codec_name = protocol_;
+    option.selector_name = "direct";
+    option.target = target;
+    option.timeout = timeout_ms_;
+    proxy_ = GetTrpcClient()->GetProxy<RpcServiceProxy>(option.name, &option);
+  });
+  return proxy_;
+}
+
+}  // namespace trpc
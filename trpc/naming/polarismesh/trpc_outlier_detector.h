@@ -0,0 +1,73 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "polaris/plugin.h"
+
+#include "trpc/client/rpc_service_proxy.h"
+
+namespace trpc {
+
+/// @brief Factory of the trpc outlier detection plugin of the polarismesh SDK
+polaris::Plugin* TrpcOutlierDetectorFactory();
+
+/// @brief Whether a probe was answered by the instance. Any answer of the server, including an error such as an
+///        unknown function, proves the instance is serving, while the errors of the client side (timeout, connection
+///        or network failure) do not
+/// @param framework_ret Framework return code of the probe
+bool IsProbeAnswered(int framework_ret);
+
+/// @brief Outlier detection plugin of the polarismesh SDK, enabled with "trpc" in the chain of outlierDetection.
+///        Unlike the tcp probe, which only checks that the port accepts connections, it sends a lightweight call
+///        through the transport of the framework, so an instance which listens but no longer serves is detected.
+///        The probe does not need to be implemented by the callee: a call of an unknown function answered by the
+///        server proves it is alive. Options under outlierDetection.plugin.trpc:
+/// - func_name: function called, "/trpc.polarismesh.probe.Probe/Ping" by default
+/// - timeout: timeout of a probe, 1s by default
+/// - protocol: protocol of the probes, "trpc" by default
+/// @note The SDK creates a detector per service, which sends the probes of all its instances through one proxy. The
+///       probes wait for their answer, they are sent only from the detection thread of the SDK and never from a
+///       fiber worker.
+class TrpcOutlierDetector : public polaris::OutlierDetector {
+ public:
+  polaris::ReturnCode Init(polaris::Config* config, polaris::Context* context) override;
+
+  /// @brief Probe an instance, called by the detection thread of the SDK once per check period
+  polaris::ReturnCode DetectInstance(polaris::Instance& instance, polaris::DetectResult& detect_result) override;
+
+  /// @brief Name of the proxy the probes of the detector are sent through
+  const std::string& GetProxyName() const { return proxy_name_; }
+
+ protected:
+  /// @brief Send a probe to an instance and wait for its answer
+  /// @return int Framework return code of the probe
+  virtual int Probe(const std::string& host, int port);
+
+ private:
+  std::shared_ptr<RpcServiceProxy> GetProxy(const std::string& target);
+
+ private:
+  std::string func_name_;
+  uint64_t timeout_ms_{1000};
+  std::string protocol_;
+  std::string proxy_name_;
+  std::once_flag proxy_once_;
+  std::shared_ptr<RpcServiceProxy> proxy_;
+};
+
+}  // namespace trpc
@@ -0,0 +1,112 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#include "trpc/naming/polarismesh/trpc_outlier_detector.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "trpc/codec/trpc/trpc.pb.h"
+
+namespace trpc {
+
+TEST(TrpcOutlierDetector, ProbeAnswered) {
+  ASSERT_TRUE(IsProbeAnswered(trpc::TrpcRetCode::TRPC_INVOKE_SUCCESS));
+  // The server is alive whatever its answer
+  ASSERT_TRUE(IsProbeAnswered(trpc::TrpcRetCode::TRPC_SERVER_NOFUNC_ERR));
+  ASSERT_TRUE(IsProbeAnswered(trpc::TrpcRetCode::TRPC_SERVER_OVERLOAD_ERR));
+
+  ASSERT_FALSE(IsProbeAnswered(trpc::TrpcRetCode::TRPC_CLIENT_INVOKE_TIMEOUT_ERR));
+  ASSERT_FALSE(IsProbeAnswered(trpc::TrpcRetCode::TRPC_CLIENT_CONNECT_ERR));
+  ASSERT_FALSE(IsProbeAnswered(trpc::TrpcRetCode::TRPC_CLIENT_NETWORK_ERR));
+}
+
+TEST(TrpcOutlierDetector, Init) {
+  std::string content = "{func_name: /trpc.test.Probe/Check, timeout: 200ms}";
+  std::string err_msg;
+  std::unique_ptr<polaris::Config> config(polaris::Config::CreateFromString(content, err_msg));
+  ASSERT_TRUE(nullptr != config);
+
+  std::unique_ptr<polaris::Plugin> plugin(TrpcOutlierDetectorFactory());
+  auto* detector = dynamic_cast<TrpcOutlierDetector*>(plugin.get());
+  ASSERT_TRUE(nullptr != detector);
+  ASSERT_EQ(polaris::ReturnCode::kReturnOk, detector->Init(config.get(), nullptr));
+}
+
+// Answers the probes with a given framework return code instead of sending them
+class FakeOutlierDetector : public TrpcOutlierDetector {
+ public:
+  int framework_ret{trpc::TrpcRetCode::TRPC_INVOKE_SUCCESS};
+  std::vector<std::string> probed;
+
+ protected:
+  int Probe(const std::string& host, int port) override {
+    probed.push_back(host + ":" + std::to_string(port));
+    return framework_ret;
+  }
+};
+
+std::unique_ptr<polaris::Config> MakeConfig() {
+  std::string err_msg;
+  return std::unique_ptr<polaris::Config>(polaris::Config::CreateFromString("{timeout: 200ms}", err_msg));
+}
+
+TEST(TrpcOutlierDetector, DetectInstance) {
+  auto config = MakeConfig();
+  FakeOutlierDetector detector;
+  ASSERT_EQ(polaris::ReturnCode::kReturnOk, detector.Init(config.get(), nullptr));
+
+  polaris::Instance instance("instance_1", "127.0.0.1", 10001, 100);
+  polaris::DetectResult detect_result;
+  ASSERT_EQ(polaris::ReturnCode::kReturnOk, detector.DetectInstance(instance, detect_result));
+  ASSERT_EQ("trpc", detect_result.detect_type);
+  ASSERT_EQ(polaris::ReturnCode::kReturnOk, detect_result.return_code);
+
+  // An instance answering with an error of the server is alive
+  detector.framework_ret = trpc::TrpcRetCode::TRPC_SERVER_NOFUNC_ERR;
+  ASSERT_EQ(polaris::ReturnCode::kReturnOk, detector.DetectInstance(instance, detect_result));
+
+  // One which does not answer is not
+  detector.framework_ret = trpc::TrpcRetCode::TRPC_CLIENT_INVOKE_TIMEOUT_ERR;
+  ASSERT_EQ(polaris::ReturnCode::kReturnNetworkFailed, detector.DetectInstance(instance, detect_result));
+  ASSERT_EQ(polaris::ReturnCode::kReturnNetworkFailed, detect_result.return_code);
+  detector.framework_ret = trpc::TrpcRetCode::TRPC_CLIENT_CONNECT_ERR;
+  ASSERT_EQ(polaris::ReturnCode::kReturnNetworkFailed, detector.DetectInstance(instance, detect_result));
+
+  std::vector<std::string> expected(4, "127.0.0.1:10001");
+  ASSERT_EQ(expected, detector.probed);
+}
+
+TEST(TrpcOutlierDetector, ProxyPerDetector) {
+  auto config = MakeConfig();
+  FakeOutlierDetector detector1, detector2;
+  ASSERT_EQ(polaris::ReturnCode::kReturnOk, detector1.Init(config.get(), nullptr));
+  ASSERT_EQ(polaris::ReturnCode::kReturnOk, detector2.Init(config.get(), nullptr));
+
+  // The instances of a service share the proxy of its detector, the services do not
+  ASSERT_FALSE(detector1.GetProxyName().empty());
+  ASSERT_NE(detector1.GetProxyName(), detector2.GetProxyName());
+
+  polaris::Instance instance1("instance_1", "127.0.0.1", 10001, 100);
+  polaris::Instance instance2("instance_2", "127.0.0.1", 10002, 100);
+  polaris::DetectResult detect_result;
+  std::string proxy_name = detector1.GetProxyName();
+  detector1.DetectInstance(instance1, detect_result);
+  detector1.DetectInstance(instance2, detect_result);
+  ASSERT_EQ(proxy_name, detector1.GetProxyName());
+  ASSERT_EQ((std::vector<std::string>{"127.0.0.1:10001", "127.0.0.1:10002"}), detector1.probed);
+}
+
+}  // namespace trpc
@@ -14,6 +14,7 @@
 #include "trpc/naming/polarismesh/trpc_server_metric.h"
 
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "trpc/codec/trpc/trpc.pb.h"
@@ -44,6 +45,44 @@ static void FixMetricName(std::string& metrics_name) {
   return;
 }
 
+std::string GetPluginMetricsName(const std::string& metrics_name) {
+  std::string name = metrics_name;
+  if (name.empty()) {
+    FixMetricName(name);
+  }
+  return name;
+}
+
+void ReportPluginMetric(const std::string& metrics_name, const std::string& name, const std::string& dimension,
+                        double value) {
+  if (metrics_name.empty()) {
+    return;
+  }
+
+  trpc::TrpcSingleAttrMetricsInfo metrics_info;
+  metrics_info.plugin_name = metrics_name;
+  metrics_info.single_attr_info.policy = trpc::MetricsPolicy::SET;
+  metrics_info.single_attr_info.name = name;
+  metrics_info.single_attr_info.dimension = dimension;
+  metrics_info.single_attr_info.value = value;
+  trpc::metrics::SingleAttrReport(std::move(metrics_info));
+}
+
+void ReportPluginCounter(const std::string& metrics_name, const std::string& name, const std::string& dimension,
+                         double value) {
+  if (metrics_name.empty()) {
+    return;
+  }
+
+  trpc::TrpcSingleAttrMetricsInfo metrics_info;
+  metrics_info.plugin_name = metrics_name;
+  metrics_info.single_attr_info.policy = trpc::MetricsPolicy::SUM;
+  metrics_info.single_attr_info.name = name;
+  metrics_info.single_attr_info.dimension = dimension;
+  metrics_info.single_attr_info.value = value;
+  trpc::metrics::SingleAttrReport(std::move(metrics_info));
+}
+
 polaris::ReturnCode TrpcServerMetric::Init(polaris::Config* config, polaris::Context* context) {
   enable_ = config->GetBoolOrDefault("enable", false);
   metrics_name_ = config->GetStringOrDefault("metrics_name", "");
@@ -24,6 +24,28 @@ namespace trpc {
 /// @brief Factory of reporting plug -ins on the TRPC monitoring of the polarismesh SDK
 polaris::Plugin* TrpcServerMetricFactory();
 
+/// @brief Get the name of the trpc monitoring plugin used by the polarismesh plugin
+/// @param metrics_name The configured name, the first monitoring plugin in the frame configuration is used if empty
+/// @return std::string Name of the monitoring plugin, empty if there is none
+std::string GetPluginMetricsName(const std::string& metrics_name);
+
+/// @brief Report a metric of the polarismesh plugin itself, e.g. the staleness of the snapshot served by the selector
+/// @param metrics_name Name of the trpc monitoring plugin
+/// @param name Metric name
+/// @param dimension Metric dimension, e.g. the called service name
+/// @param value Metric value
+void ReportPluginMetric(const std::string& metrics_name, const std::string& name, const std::string& dimension,
+                        double value);
+
+/// @brief Report a count of the polarismesh plugin itself, the values of the same metric and dimension are summed,
+///        e.g. the calls timed out under the adaptive timeout
+/// @param metrics_name Name of the trpc monitoring plugin
+/// @param name Metric name
+/// @param dimension Metric dimension, e.g. the called method
+/// @param value Count added
+void ReportPluginCounter(const std::string& metrics_name, const std::string& name, const std::string& dimension,
+                         double value = 1);
+
 /// @brief polarismesh SDK's TRPC monitoring plug -in
 class TrpcServerMetric : public polaris::ServerMetric {
  public:
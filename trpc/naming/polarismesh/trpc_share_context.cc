@@ -13,11 +13,14 @@
 
 #include "trpc/naming/polarismesh/trpc_share_context.h"
 
+#include <sstream>
 #include <string>
 
 #include "polaris/context/context_impl.h"
 #include "polaris/log.h"
+#include "yaml-cpp/yaml.h"
 
+#include "trpc/naming/polarismesh/trpc_outlier_detector.h"
 #include "trpc/naming/polarismesh/trpc_server_metric.h"
 #include "trpc/util/log/logging.h"
 
@@ -39,6 +42,8 @@ int TrpcShareContext::Init(const trpc::naming::PolarisMeshNamingConfig& config)
 
   // Register the polarismesh monitoring plugin
   polaris::RegisterPlugin("trpc", polaris::kPluginServerMetric, trpc::TrpcServerMetricFactory);
+  // Register the trpc probe of the outlier detection, used when "trpc" is in the chain of outlierDetection
+  polaris::RegisterPlugin("trpc", polaris::kPluginOutlierDetector, trpc::TrpcOutlierDetectorFactory);
 
   // Initialize the polarismesh Context
   polarismesh_context_ = std::shared_ptr<polaris::Context>(
@@ -63,6 +68,40 @@ void TrpcShareContext::Destroy() {
   init_ = false;
 }
 
+std::shared_ptr<polaris::Context> TrpcShareContext::CreateClusterContext(
+    const trpc::naming::PolarisMeshNamingConfig& config, const trpc::naming::FederationClusterConfig& cluster) {
+  YAML::Node node;
+  try {
+    node = YAML::Load(config.orig_selector_config);
+  } catch (const std::exception& e) {
+    TRPC_FMT_ERROR("Parse polarismesh config failed, error:{}", e.what());
+    return nullptr;
+  }
+  node["global"]["serverConnector"]["addresses"] = cluster.addresses;
+  if (!cluster.join_point.empty()) {
+    node["global"]["serverConnector"]["joinPoint"] = cluster.join_point;
+  }
+  // The services of the clusters would overwrite each other in a shared cache directory
+  node["consumer"]["localCache"]["persistDir"] =
+      config.selector_config.consumer_config.local_cache_config.persist_dir + "/" + cluster.name;
+
+  std::stringstream strstream;
+  strstream << node;
+  std::string err_msg;
+  std::shared_ptr<polaris::Config> polarismesh_config(polaris::Config::CreateFromString(strstream.str(), err_msg));
+  if (!polarismesh_config) {
+    TRPC_FMT_ERROR("Create polarismesh config of cluster {} failed, error:{}", cluster.name, err_msg);
+    return nullptr;
+  }
+
+  std::shared_ptr<polaris::Context> context(
+      polaris::Context::Create(polarismesh_config.get(), polaris::ContextMode::kPrivateContext));
+  if (!context) {
+    TRPC_FMT_ERROR("Create polarismesh context of cluster {} failed", cluster.name);
+  }
+  return context;
+}
+
 polaris::ServerConnector* TrpcShareContext::GetServerConnector() {
   if (polarismesh_context_) {
     auto server_connector = polarismesh_context_->GetContextImpl()->GetServerConnector();
@@ -55,6 +55,14 @@ class TrpcShareContext {
   /// @return ServerConnector* References of the polarismesh Internal Server Connector object
   polaris::ServerConnector* GetServerConnector();
 
+  /// @brief Create a context connected to another polarismesh cluster, for the federation of the selector. The context
+  ///        has the same SDK configuration as the shared one except the server and the local cache directory
+  /// @param config polarismesh plugin configuration
+  /// @param cluster The cluster to connect to
+  /// @return std::shared_ptr<polaris::Context> The context owned by the caller, nullptr on failure
+  std::shared_ptr<polaris::Context> CreateClusterContext(const trpc::naming::PolarisMeshNamingConfig& config,
+                                                         const trpc::naming::FederationClusterConfig& cluster);
+
  private:
   TrpcShareContext() = default;
 
@@ -0,0 +1,151 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#include "trpc/naming/polarismesh/weighted_random.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace trpc::naming::polarismesh {
+
+namespace {
+
+constexpr uint64_t kOne = 1ULL << 32;
+
+uint64_t InitialSeed() {
+  uint64_t seed = std::chrono::steady_clock::now().time_since_epoch().count();
+  return seed ^ (std::hash<std::thread::id>{}(std::this_thread::get_id()) << 1);
+}
+
+}  // namespace
+
+uint64_t FastRandom() {
+  thread_local uint64_t state = InitialSeed();
+  uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+AliasTable::AliasTable(RoutedSnapshotPtr snapshot) : snapshot_(std::move(snapshot)) {
+  const auto& endpoints = snapshot_->endpoints;
+  uint64_t total_weight = 0;
+  for (uint32_t i = 0; i < endpoints.size(); i++) {
+    if (endpoints[i].status && endpoints[i].weight > 0) {
+      indexes_.push_back(i);
+      total_weight += endpoints[i].weight;
+    }
+  }
+
+  // No weighted candidate, every candidate gets the same weight
+  bool uniform = indexes_.empty();
+  if (uniform) {
+    for (uint32_t i = 0; i < endpoints.size(); i++) {
+      if (endpoints[i].status) {
+        indexes_.push_back(i);
+      }
+    }
+  }
+  if (indexes_.empty()) {
+    for (uint32_t i = 0; i < endpoints.size(); i++) {
+      indexes_.push_back(i);
+    }
+  }
+
+  size_t n = indexes_.size();
+  columns_.resize(n);
+  if (uniform) {
+    for (uint32_t i = 0; i < n; i++) {
+      columns_[i] = Column{kOne, i};
+    }
+    return;
+  }
+
+  // Vose's method, the weights are scaled so that the average column holds exactly kOne
+  std::vector<uint64_t> scaled(n);
+  std::vector<uint32_t> small, large;
+  for (uint32_t i = 0; i < n; i++) {
+    __uint128_t weight = endpoints[indexes_[i]].weight;
+    scaled[i] = static_cast<uint64_t>(weight * n * kOne / total_weight);
+    (scaled[i] < kOne ? small : large).push_back(i);
+  }
+  while (!small.empty() && !large.empty()) {
+    uint32_t less = small.back();
+    small.pop_back();
+    uint32_t more = large.back();
+    columns_[less] = Column{scaled[less], more};
+    scaled[more] -= kOne - scaled[less];
+    if (scaled[more] < kOne) {
+      large.pop_back();
+      small.push_back(more);
+    }
+  }
+  // The rest are full up to the rounding errors
+  for (uint32_t i : large) {
+    columns_[i] = Column{kOne, i};
+  }
+  for (uint32_t i : small) {
+    columns_[i] = Column{kOne, i};
+  }
+}
+
+uint32_t AliasTable::Pick(uint64_t random) const {
+  uint64_t column = ((random >> 32) * columns_.size()) >> 32;
+  const auto& entry = columns_[column];
+  uint32_t position = (random & 0xFFFFFFFFULL) < entry.threshold ? static_cast<uint32_t>(column) : entry.alias;
+  return indexes_[position];
+}
+
+AliasTablePtr BuildAliasTable(const RoutedSnapshotPtr& snapshot) {
+  if (!snapshot || snapshot->endpoints.empty()) {
+    return nullptr;
+  }
+  return std::make_shared<const AliasTable>(snapshot);
+}
+
+void PickDistinct(const AliasTable& table, uint32_t num, std::vector<uint32_t>& indexes) {
+  num = std::min<uint32_t>(num, table.GetEndpointNum());
+  if (num == 0) {
+    return;
+  }
+
+  std::vector<bool> taken(table.GetSnapshot()->endpoints.size(), false);
+  uint32_t picked = 0;
+  // A bounded number of draws keeps the cost predictable when few heavy endpoints dominate
+  for (uint32_t draw = 0; draw < num * 4 && picked < num; draw++) {
+    uint32_t index = table.Pick();
+    if (!taken[index]) {
+      taken[index] = true;
+      indexes.push_back(index);
+      picked++;
+    }
+  }
+  if (picked == num) {
+    return;
+  }
+
+  // Fill up with the candidates not taken yet, starting at a random one
+  const auto& candidates = table.GetCandidates();
+  size_t start = FastRandom() % candidates.size();
+  for (size_t i = 0; i < candidates.size() && picked < num; i++) {
+    uint32_t index = candidates[(start + i) % candidates.size()];
+    if (!taken[index]) {
+      taken[index] = true;
+      indexes.push_back(index);
+      picked++;
+    }
+  }
+}
+
+}  // namespace trpc::naming::polarismesh
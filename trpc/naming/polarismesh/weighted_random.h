@@ -0,0 +1,92 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "trpc/naming/polarismesh/snapshot_cache.h"
+
+namespace trpc::naming::polarismesh {
+
+/// @brief Fast pseudo random number of the calling thread (splitmix64), it is not cryptographically secure
+uint64_t FastRandom();
+
+/// @brief Walker/Vose alias table of the endpoint weights of a snapshot, a weighted random pick costs O(1) whatever
+///        the number of endpoints. The healthy endpoints with positive weight are candidates, falling back to the
+///        healthy ones and then to all of them, the same as the fail-static pick.
+class AliasTable {
+ public:
+  explicit AliasTable(RoutedSnapshotPtr snapshot);
+
+  /// @brief Pick an endpoint with a random number
+  /// @param random Uniformly distributed random number, its high half selects the column and the low half the side
+  /// @return uint32_t Index of the endpoint in the snapshot
+  uint32_t Pick(uint64_t random) const;
+
+  /// @brief Pick an endpoint with the random number of the calling thread
+  uint32_t Pick() const { return Pick(FastRandom()); }
+
+  /// @brief The snapshot the table is built from
+  const RoutedSnapshotPtr& GetSnapshot() const { return snapshot_; }
+
+  /// @brief Indexes in the snapshot of the candidate endpoints
+  const std::vector<uint32_t>& GetCandidates() const { return indexes_; }
+
+  /// @brief Number of candidate endpoints
+  size_t GetEndpointNum() const { return indexes_.size(); }
+
+ private:
+  struct Column {
+    // Probability to keep the column's own endpoint, scaled to 2^32
+    uint64_t threshold;
+    // Position of the endpoint taken otherwise
+    uint32_t alias;
+  };
+
+  RoutedSnapshotPtr snapshot_;
+  // Index in the snapshot of every candidate
+  std::vector<uint32_t> indexes_;
+  std::vector<Column> columns_;
+};
+
+using AliasTablePtr = std::shared_ptr<const AliasTable>;
+
+/// @brief Build the alias table of a snapshot
+/// @return AliasTablePtr nullptr if the snapshot is empty
+AliasTablePtr BuildAliasTable(const RoutedSnapshotPtr& snapshot);
+
+/// @brief Pick distinct endpoints at random by weight, the first one follows the weights exactly and the others are
+///        drawn again on collision, then taken in order when the draws are exhausted
+/// @param table The alias table
+/// @param num Number of endpoints needed, less are returned if there are not enough candidates
+/// @param[out] indexes Indexes of the endpoints in the snapshot
+void PickDistinct(const AliasTable& table, uint32_t num, std::vector<uint32_t>& indexes);
+
+/// @brief Keeps the alias table of every selection key, it is rebuilt only when the snapshot revision changes
+class AliasTableCache {
+ public:
+  /// @brief Get the table of the snapshot of key, build it if absent or built from another revision
+  AliasTablePtr Get(const std::string& key, const RoutedSnapshotPtr& snapshot) {
+    return tables_.Get(key, snapshot, BuildAliasTable);
+  }
+
+  void Clear() { tables_.Clear(); }
+
+ private:
+  SnapshotTableCache<AliasTable> tables_;
+};
+
+}  // namespace trpc::naming::polarismesh
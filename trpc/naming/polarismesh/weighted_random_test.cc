@@ -0,0 +1,90 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#include "trpc/naming/polarismesh/weighted_random.h"
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace trpc::naming::polarismesh::testing {
+
+namespace {
+
+RoutedSnapshotPtr MakeSnapshot(const std::vector<uint32_t>& weights) {
+  auto snapshot = std::make_shared<RoutedSnapshot>();
+  for (size_t i = 0; i < weights.size(); i++) {
+    TrpcEndpointInfo endpoint;
+    endpoint.host = "127.0.0.1";
+    endpoint.port = 10000 + i;
+    endpoint.weight = weights[i];
+    endpoint.status = 1;
+    snapshot->endpoints.push_back(endpoint);
+  }
+  snapshot->revision = CalculateEndpointsRevision(snapshot->endpoints);
+  return snapshot;
+}
+
+}  // namespace
+
+TEST(AliasTableTest, FollowsWeights) {
+  auto table = BuildAliasTable(MakeSnapshot({100, 300, 0, 600}));
+  ASSERT_NE(nullptr, table);
+  ASSERT_EQ(3, table->GetEndpointNum());
+
+  std::vector<int> counts(4, 0);
+  constexpr int kTimes = 100000;
+  for (int i = 0; i < kTimes; i++) {
+    counts[table->Pick()]++;
+  }
+  ASSERT_EQ(0, counts[2]);
+  ASSERT_NEAR(0.1, counts[0] / static_cast<double>(kTimes), 0.01);
+  ASSERT_NEAR(0.3, counts[1] / static_cast<double>(kTimes), 0.01);
+  ASSERT_NEAR(0.6, counts[3] / static_cast<double>(kTimes), 0.01);
+}
+
+TEST(AliasTableTest, ZeroWeightsAndUnhealthy) {
+  auto table = BuildAliasTable(MakeSnapshot({0, 0}));
+  ASSERT_EQ(2, table->GetEndpointNum());
+
+  auto snapshot = std::const_pointer_cast<RoutedSnapshot>(MakeSnapshot({100, 100}));
+  snapshot->endpoints[0].status = 0;
+  table = BuildAliasTable(snapshot);
+  ASSERT_EQ(1, table->GetEndpointNum());
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(1, table->Pick());
+  }
+
+  ASSERT_EQ(nullptr, BuildAliasTable(MakeSnapshot({})));
+}
+
+TEST(AliasTableTest, PickDistinct) {
+  auto table = BuildAliasTable(MakeSnapshot({1, 1000, 1, 0}));
+  std::vector<uint32_t> indexes;
+  PickDistinct(*table, 5, indexes);
+  ASSERT_EQ(3, indexes.size());
+  ASSERT_EQ(3, std::set<uint32_t>(indexes.begin(), indexes.end()).size());
+  ASSERT_EQ(0, std::count(indexes.begin(), indexes.end(), 3));
+}
+
+TEST(AliasTableTest, Cache) {
+  AliasTableCache cache;
+  auto snapshot = MakeSnapshot({100, 200});
+  auto table = cache.Get("key", snapshot);
+  ASSERT_EQ(table, cache.Get("key", MakeSnapshot({100, 200})));
+  ASSERT_NE(table, cache.Get("key", MakeSnapshot({100, 300})));
+}
+
+}  // namespace trpc::naming::polarismesh::testing
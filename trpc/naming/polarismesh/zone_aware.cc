@@ -0,0 +1,146 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#include "trpc/naming/polarismesh/zone_aware.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+namespace trpc::naming::polarismesh {
+
+namespace {
+
+constexpr uint64_t kOne = 1ULL << 32;
+
+std::string GetZoneKey(const EndpointLocation& location) { return location.region + "/" + location.zone; }
+
+}  // namespace
+
+ZoneAwareTable::ZoneAwareTable(RoutedSnapshotPtr snapshot, const RoutedSnapshot& callers,
+                               const EndpointLocation& local, size_t min_cluster_size)
+    : snapshot_(std::move(snapshot)) {
+  const auto& endpoints = snapshot_->endpoints;
+  const auto& locations = snapshot_->locations;
+  if (local.zone.empty() || endpoints.size() < min_cluster_size || locations.size() != endpoints.size() ||
+      callers.locations.size() != callers.endpoints.size()) {
+    return;
+  }
+
+  // Share of the callers of every zone
+  std::map<std::string, double> caller_percent;
+  for (const auto& location : callers.locations) {
+    caller_percent[GetZoneKey(location)] += 1.0 / callers.locations.size();
+  }
+  std::string local_zone = GetZoneKey(local);
+  double local_caller_percent = caller_percent[local_zone];
+  if (local_caller_percent <= 0) {
+    return;
+  }
+
+  // Share of the healthy capacity of every zone, the endpoints count the same when none has a weight
+  std::map<std::string, std::vector<uint32_t>> zone_indexes;
+  std::map<std::string, double> capacity;
+  double total_capacity = 0;
+  bool weighted = std::any_of(endpoints.begin(), endpoints.end(),
+                              [](const TrpcEndpointInfo& endpoint) { return endpoint.status && endpoint.weight > 0; });
+  for (uint32_t i = 0; i < endpoints.size(); i++) {
+    std::string zone = GetZoneKey(locations[i]);
+    zone_indexes[zone].push_back(i);
+    if (endpoints[i].status) {
+      double weight = weighted ? endpoints[i].weight : 1;
+      capacity[zone] += weight;
+      total_capacity += weight;
+    }
+  }
+  if (total_capacity <= 0 || capacity[local_zone] <= 0) {
+    return;
+  }
+
+  auto make_zone = [this, &endpoints, &locations](const std::vector<uint32_t>& indexes) {
+    auto zone = std::make_shared<RoutedSnapshot>();
+    for (uint32_t index : indexes) {
+      zone->endpoints.push_back(endpoints[index]);
+      zone->locations.push_back(locations[index]);
+    }
+    zone->revision = CalculateEndpointsRevision(zone->endpoints);
+    zone->update_time_ms = snapshot_->update_time_ms;
+    zone->source_version = snapshot_->source_version;
+    return zone;
+  };
+  zones_.push_back(make_zone(zone_indexes[local_zone]));
+
+  double local_capacity_percent = capacity[local_zone] / total_capacity;
+  if (local_capacity_percent >= local_caller_percent) {
+    // The local zone can take all the calls of its callers
+    local_threshold_ = kOne;
+    return;
+  }
+  local_threshold_ = static_cast<uint64_t>(local_capacity_percent / local_caller_percent * kOne);
+
+  // The excess goes to the zones having more capacity than callers
+  double residual_total = 0;
+  std::vector<std::pair<std::string, double>> spill_zones;
+  for (const auto& item : capacity) {
+    if (item.first == local_zone || item.second <= 0) {
+      continue;
+    }
+    double residual = std::max(0.0, item.second / total_capacity - caller_percent[item.first]);
+    spill_zones.emplace_back(item.first, residual);
+    residual_total += residual;
+  }
+  for (const auto& item : spill_zones) {
+    // No zone has spare capacity, spill by the capacity instead
+    double share = residual_total > 0 ? item.second : capacity[item.first];
+    if (share <= 0) {
+      continue;
+    }
+    double previous = residual_cumulative_.empty() ? 0 : residual_cumulative_.back();
+    residual_cumulative_.push_back(previous + share);
+    zones_.push_back(make_zone(zone_indexes[item.first]));
+  }
+  if (residual_cumulative_.empty()) {
+    local_threshold_ = kOne;
+  }
+}
+
+RoutedSnapshotPtr ZoneAwareTable::Pick(uint64_t random) const {
+  if (zones_.empty()) {
+    return snapshot_;
+  }
+  if ((random & 0xFFFFFFFFULL) < local_threshold_) {
+    return zones_[0];
+  }
+
+  double point = static_cast<double>(random >> 32) / kOne * residual_cumulative_.back();
+  auto iter = std::upper_bound(residual_cumulative_.begin(), residual_cumulative_.end(), point);
+  size_t zone = std::min<size_t>(iter - residual_cumulative_.begin(), residual_cumulative_.size() - 1);
+  return zones_[zone + 1];
+}
+
+double ZoneAwareTable::GetLocalPercent() const {
+  return zones_.empty() ? 0 : static_cast<double>(local_threshold_) / kOne;
+}
+
+ZoneAwareTablePtr ZoneAwareCache::Get(const std::string& key, const RoutedSnapshotPtr& snapshot,
+                                      const RoutedSnapshotPtr& callers) {
+  if (!snapshot || !callers) {
+    return nullptr;
+  }
+  uint64_t revision = SignatureHasher().Add(snapshot->revision).Add(callers->revision).Get();
+  return tables_.Get(key, revision, snapshot, [this, &callers](const RoutedSnapshotPtr& snapshot) {
+    return std::make_shared<const ZoneAwareTable>(snapshot, *callers, local_, min_cluster_size_);
+  });
+}
+
+}  // namespace trpc::naming::polarismesh
@@ -0,0 +1,83 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "trpc/naming/polarismesh/snapshot_cache.h"
+
+namespace trpc::naming::polarismesh {
+
+/// @brief Zone-aware routing plan of a callee snapshot for the callers of a zone. Every zone takes the share of the
+///        calls matching its share of the callee capacity: the callers stay in their zone as long as it has at least
+///        their share of the capacity, and only the excess spills over to the zones having more capacity than
+///        callers, in proportion to that residual capacity.
+class ZoneAwareTable {
+ public:
+  /// @param snapshot The callee endpoints, with their locations
+  /// @param callers The caller instances, with their locations
+  /// @param local Location of the caller itself
+  /// @param min_cluster_size Minimum number of callee endpoints for the zone-aware routing, all the endpoints are used
+  ///                         below it
+  ZoneAwareTable(RoutedSnapshotPtr snapshot, const RoutedSnapshot& callers, const EndpointLocation& local,
+                 size_t min_cluster_size);
+
+  /// @brief Pick the zone of a call
+  /// @param random Uniformly distributed random number
+  /// @return RoutedSnapshotPtr The endpoints of the zone, the whole snapshot when the routing is not zone-aware
+  RoutedSnapshotPtr Pick(uint64_t random) const;
+
+  /// @brief Whether the routing is zone-aware, it is not when the locations are unknown or the cluster is too small
+  bool IsActive() const { return !zones_.empty(); }
+
+  /// @brief Probability of a call to stay in the local zone
+  double GetLocalPercent() const;
+
+  /// @brief The callee snapshot the plan is built from
+  const RoutedSnapshotPtr& GetSnapshot() const { return snapshot_; }
+
+ private:
+  RoutedSnapshotPtr snapshot_;
+  // Endpoints of every zone, the local zone first
+  std::vector<RoutedSnapshotPtr> zones_;
+  // Probability to stay in the local zone, scaled to 2^32
+  uint64_t local_threshold_{0};
+  // Cumulative residual capacity of the other zones
+  std::vector<double> residual_cumulative_;
+};
+
+using ZoneAwareTablePtr = std::shared_ptr<const ZoneAwareTable>;
+
+/// @brief Keeps the zone-aware plan of every selection key, it is rebuilt only when the revision of the callee
+///        snapshot or of the caller distribution changes
+class ZoneAwareCache {
+ public:
+  void SetLocalLocation(const EndpointLocation& local) { local_ = local; }
+
+  void SetMinClusterSize(size_t min_cluster_size) { min_cluster_size_ = min_cluster_size; }
+
+  /// @brief Get the plan of the snapshot of key for the callers, build it if absent or built from other revisions
+  ZoneAwareTablePtr Get(const std::string& key, const RoutedSnapshotPtr& snapshot, const RoutedSnapshotPtr& callers);
+
+  void Clear() { tables_.Clear(); }
+
+ private:
+  EndpointLocation local_;
+  size_t min_cluster_size_{6};
+  SnapshotTableCache<ZoneAwareTable> tables_;
+};
+
+}  // namespace trpc::naming::polarismesh
@@ -0,0 +1,112 @@
+//
+//
+// Tencent is pleased to support the open source community by making tRPC available.
+//
+// Copyright (C) 2023 THL A29 Limited, a Tencent company.
+// All rights reserved.
+//
+// If you have downloaded a copy of the tRPC source code from Tencent,
+// please note that tRPC source code is licensed under the  Apache 2.0 License,
+// A copy of the Apache 2.0 License is included in this file.
+//
+//
+
+#include "trpc/naming/polarismesh/zone_aware.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "trpc/naming/polarismesh/weighted_random.h"
+
+namespace trpc::naming::polarismesh::testing {
+
+namespace {
+
+// Endpoints of the zones, num of them in each zone
+RoutedSnapshotPtr MakeSnapshot(const std::map<std::string, int>& zones) {
+  auto snapshot = std::make_shared<RoutedSnapshot>();
+  int port = 10000;
+  for (const auto& zone : zones) {
+    for (int i = 0; i < zone.second; i++) {
+      TrpcEndpointInfo endpoint;
+      endpoint.host = "127.0.0.1";
+      endpoint.port = port++;
+      endpoint.weight = 100;
+      endpoint.status = 1;
+      snapshot->endpoints.push_back(endpoint);
+      snapshot->locations.push_back({"south", zone.first, ""});
+    }
+  }
+  snapshot->revision = CalculateEndpointsRevision(snapshot->endpoints);
+  return snapshot;
+}
+
+std::map<std::string, double> PickZones(const ZoneAwareTable& table, int times) {
+  std::map<std::string, double> shares;
+  for (int i = 0; i < times; i++) {
+    auto zone = table.Pick(FastRandom());
+    shares[zone->locations[0].zone] += 1.0 / times;
+  }
+  return shares;
+}
+
+const EndpointLocation kLocal{"south", "sz", ""};
+
+}  // namespace
+
+TEST(ZoneAwareTableTest, StayLocalWithEnoughCapacity) {
+  // 50% of the capacity for 50% of the callers
+  ZoneAwareTable table(MakeSnapshot({{"sz", 5}, {"gz", 5}}), *MakeSnapshot({{"sz", 1}, {"gz", 1}}), kLocal, 6);
+  ASSERT_TRUE(table.IsActive());
+  ASSERT_DOUBLE_EQ(1.0, table.GetLocalPercent());
+  ASSERT_EQ("sz", table.Pick(FastRandom())->locations[0].zone);
+}
+
+TEST(ZoneAwareTableTest, SpillExcess) {
+  // The local zone has 20% of the capacity for 50% of the callers, 60% of its calls spill over. The spare capacity of
+  // gz is 50% - 25% = 25% and of sh is 30% - 25% = 5%
+  ZoneAwareTable table(MakeSnapshot({{"sz", 2}, {"gz", 5}, {"sh", 3}}),
+                       *MakeSnapshot({{"sz", 2}, {"gz", 1}, {"sh", 1}}), kLocal, 6);
+  ASSERT_NEAR(0.4, table.GetLocalPercent(), 1e-6);
+
+  auto shares = PickZones(table, 100000);
+  ASSERT_NEAR(0.4, shares["sz"], 0.01);
+  ASSERT_NEAR(0.5, shares["gz"], 0.01);
+  ASSERT_NEAR(0.1, shares["sh"], 0.01);
+}
+
+TEST(ZoneAwareTableTest, Inactive) {
+  auto snapshot = MakeSnapshot({{"sz", 2}, {"gz", 2}});
+  // Too small
+  ZoneAwareTable small(snapshot, *MakeSnapshot({{"sz", 1}}), kLocal, 6);
+  ASSERT_FALSE(small.IsActive());
+  ASSERT_EQ(snapshot, small.Pick(FastRandom()));
+
+  // No caller in the local zone
+  ZoneAwareTable no_caller(snapshot, *MakeSnapshot({{"gz", 1}}), kLocal, 1);
+  ASSERT_FALSE(no_caller.IsActive());
+
+  // No callee in the local zone
+  ZoneAwareTable no_local(MakeSnapshot({{"gz", 2}}), *MakeSnapshot({{"sz", 1}}), kLocal, 1);
+  ASSERT_FALSE(no_local.IsActive());
+}
+
+TEST(ZoneAwareCacheTest, RebuildOnCallersChange) {
+  ZoneAwareCache cache;
+  cache.SetLocalLocation(kLocal);
+  auto snapshot = MakeSnapshot({{"sz", 2}, {"gz", 5}, {"sh", 3}});
+  auto callers = MakeSnapshot({{"sz", 2}, {"gz", 1}, {"sh", 1}});
+
+  auto table = cache.Get("key", snapshot, callers);
+  ASSERT_EQ(table, cache.Get("key", snapshot, callers));
+
+  auto more_callers = MakeSnapshot({{"sz", 1}, {"gz", 1}, {"sh", 1}});
+  auto rebuilt = cache.Get("key", snapshot, more_callers);
+  ASSERT_NE(table, rebuilt);
+  ASSERT_NEAR(0.6, rebuilt->GetLocalPercent(), 1e-6);
+}
+
+}  // namespace trpc::naming::polarismesh::testing